@@ -237,8 +237,8 @@ private:
 	// specified scene node.
 	void turnOnZoneLights(scene::ISceneNode * node)
 	{
-		core::list<scene::ISceneNode*> const & children = node->getChildren();
-		for (core::list<scene::ISceneNode*>::ConstIterator child = children.begin();
+		scene::ISceneNodeList const & children = node->getChildren();
+		for (scene::ISceneNodeList::ConstIterator child = children.begin();
 			child != children.end();
 			++child)
 		{
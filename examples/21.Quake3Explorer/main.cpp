@@ -1131,7 +1131,7 @@ void CQuake3EventHandler::addSceneTreeItem( ISceneNode * parent, IGUITreeViewNod
 	wchar_t msg[128];
 
 	s32 imageIndex;
-	list<ISceneNode*>::ConstIterator it = parent->getChildren().begin();
+	ISceneNodeList::ConstIterator it = parent->getChildren().begin();
 	for (; it != parent->getChildren().end(); ++it)
 	{
 		switch ( (*it)->getType () )
@@ -1164,7 +1164,7 @@ void CQuake3EventHandler::addSceneTreeItem( ISceneNode * parent, IGUITreeViewNod
 		node = nodeParent->addChildBack( msg, 0, imageIndex );
 
 		// Add all Animators
-		list<ISceneNodeAnimator*>::ConstIterator ait = (*it)->getAnimators().begin();
+		ISceneNodeAnimatorList::ConstIterator ait = (*it)->getAnimators().begin();
 		for (; ait != (*it)->getAnimators().end(); ++ait)
 		{
 			imageIndex = -1;
@@ -1555,7 +1555,7 @@ bool CQuake3EventHandler::OnEvent(const SEvent& eve)
 */
 			if ( ItemParent )
 			{
-				list<ISceneNode*>::ConstIterator it = ItemParent->getChildren().begin();
+				ISceneNodeList::ConstIterator it = ItemParent->getChildren().begin();
 				for (; it != ItemParent->getChildren().end(); ++it)
 				{
 					(*it)->setDebugDataVisible ( value );
@@ -1564,7 +1564,7 @@ bool CQuake3EventHandler::OnEvent(const SEvent& eve)
 
 			if ( ShaderParent )
 			{
-				list<ISceneNode*>::ConstIterator it = ShaderParent->getChildren().begin();
+				ISceneNodeList::ConstIterator it = ShaderParent->getChildren().begin();
 				for (; it != ShaderParent->getChildren().end(); ++it)
 				{
 					(*it)->setDebugDataVisible ( value );
@@ -1573,7 +1573,7 @@ bool CQuake3EventHandler::OnEvent(const SEvent& eve)
 
 			if ( UnresolvedParent )
 			{
-				list<ISceneNode*>::ConstIterator it = UnresolvedParent->getChildren().begin();
+				ISceneNodeList::ConstIterator it = UnresolvedParent->getChildren().begin();
 				for (; it != UnresolvedParent->getChildren().end(); ++it)
 				{
 					(*it)->setDebugDataVisible ( value );
@@ -1582,7 +1582,7 @@ bool CQuake3EventHandler::OnEvent(const SEvent& eve)
 
 			if ( FogParent )
 			{
-				list<ISceneNode*>::ConstIterator it = FogParent->getChildren().begin();
+				ISceneNodeList::ConstIterator it = FogParent->getChildren().begin();
 				for (; it != FogParent->getChildren().end(); ++it)
 				{
 					(*it)->setDebugDataVisible ( value );
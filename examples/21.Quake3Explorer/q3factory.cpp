@@ -795,7 +795,7 @@ ISceneNodeAnimatorCollisionResponse* camCollisionResponse( IrrlichtDevice * devi
 	ICameraSceneNode *camera = device->getSceneManager()->getActiveCamera();
 	ISceneNodeAnimatorCollisionResponse *a = 0;
 
-	list<ISceneNodeAnimator*>::ConstIterator it = camera->getAnimators().begin();
+	ISceneNodeAnimatorList::ConstIterator it = camera->getAnimators().begin();
 	for (; it != camera->getAnimators().end(); ++it)
 	{
 		a = (ISceneNodeAnimatorCollisionResponse*) (*it);
@@ -42,6 +42,14 @@ namespace irr
 		mouse and keyboard in Windows operating systems. */
 		EIDT_CONSOLE,
 
+		//! A device without any window, rendering into memory.
+		/** Renders with the software drivers into images in memory, which are
+		written in the background as image files or as a raw stream of pixels,
+		see SIrrlichtCreationParameters::FrameOutput. Meant for servers rendering
+		previews and for batch runs. It has no input and is never chosen by
+		EIDT_BEST. */
+		EIDT_HEADLESS,
+
 		//! This selection allows Irrlicht to choose the best device from the ones available.
 		/** If this selection is chosen then Irrlicht will try to use the IrrlichtDevice native
 		to your operating system. If this is unavailable then the X11, SDL and then console device
@@ -106,6 +106,12 @@ namespace video
 		//! Supports geometry shaders
 		EVDF_GEOMETRY_SHADER,
 
+		//! Supports textures created from DXT1 and DXT5 compressed images
+		EVDF_TEXTURE_COMPRESSED_DXT,
+
+		//! Supports drawing mesh buffers with 32 bit indices
+		EVDF_INDEX_32BIT,
+
 		//! Only used for counting the elements of this enum
 		EVDF_COUNT
 	};
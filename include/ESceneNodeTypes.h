@@ -72,6 +72,9 @@ namespace scene
 		//! Quake3 Shader Scene Node
 		ESNT_Q3SHADER_SCENE_NODE  = MAKE_IRR_ID('q','3','s','h'),
 
+		//! Quake3 Level Scene Node, renders the geometry using the bsp visibility
+		ESNT_Q3_LEVEL  = MAKE_IRR_ID('q','3','l','v'),
+
 		//! Quake3 Model Scene Node ( has tag to link to )
 		ESNT_MD3_SCENE_NODE  = MAKE_IRR_ID('m','d','3','_'),
 
@@ -149,6 +149,19 @@ public:
 	//! Get the archive at a given index.
 	virtual IFileArchive* getFileArchive(u32 index) =0;
 
+	//! Sets the amount of memory used to keep decompressed archive files.
+	/** Files which are opened repeatedly from compressed archives, e.g.
+	textures and shaders from .pk3 files, are only decompressed once as
+	long as they stay in this cache. The cache is shared by all zip archives
+	and removes the least recently used files first. Files bigger than the
+	cache are not kept. Deflated files of 1MB or more are not cached either,
+	they are decompressed while being read instead. Files compressed with
+	bzip2 or LZMA are always decompressed at once, and cached like the others.
+	Encrypted files are never cached.
+	\param sizeInBytes Maximum size of all cached files together. The
+	default is 0, which disables the cache. */
+	virtual void setDecompressedFileCacheSize(u32 sizeInBytes) =0;
+
 	//! Adds a zip archive to the file system.
 	/** \deprecated This function is provided for compatibility
 	with older versions of Irrlicht and may be removed in future versions,
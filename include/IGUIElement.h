@@ -34,7 +34,7 @@ public:
 		MaxSize(0,0), MinSize(1,1), IsVisible(true), IsEnabled(true),
 		IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 		AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
-		Environment(environment), Type(type)
+		Environment(environment), Type(type), HitBoundsValid(false)
 	{
 		#ifdef _DEBUG
 		setDebugName("IGUIElement");
@@ -45,6 +45,7 @@ public:
 		{
 			parent->addChildToEnd(this);
 			recalculateAbsolutePosition(true);
+			invalidate();
 		}
 	}
 
@@ -241,29 +242,11 @@ public:
 	*/
 	IGUIElement* getElementFromPoint(const core::position2d<s32>& point)
 	{
-		IGUIElement* target = 0;
-
-		// we have to search from back to front, because later children
-		// might be drawn over the top of earlier ones.
-
-		core::list<IGUIElement*>::Iterator it = Children.getLast();
-
-		if (isVisible())
-		{
-			while(it != Children.end())
-			{
-				target = (*it)->getElementFromPoint(point);
-				if (target)
-					return target;
+		if (!isVisible())
+			return 0;
 
-				--it;
-			}
-		}
-
-		if (isVisible() && isPointInside(point))
-			target = this;
-
-		return target;
+		updateHitBounds();
+		return findElementFromPoint(point);
 	}
 
 
@@ -275,6 +258,17 @@ public:
 	}
 
 
+	//! Returns the rectangle outside of which isPointInside() is always false
+	/** getElementFromPoint() skips elements and their children when a
+	point is outside of the rectangles of all of them. Elements which
+	override isPointInside() to accept points outside of their clipping
+	rectangle have to override this method too. */
+	virtual core::rect<s32> getHitRect() const
+	{
+		return AbsoluteClippingRect;
+	}
+
+
 	//! Adds a GUI element as new child of this element.
 	virtual void addChild(IGUIElement* child)
 	{
@@ -282,6 +276,7 @@ public:
 		if (child)
 		{
 			child->updateAbsolutePosition();
+			child->invalidate();
 		}
 	}
 
@@ -292,9 +287,11 @@ public:
 		for (; it != Children.end(); ++it)
 			if ((*it) == child)
 			{
+				(*it)->invalidate();
 				(*it)->Parent = 0;
 				(*it)->drop();
 				Children.erase(it);
+				invalidateHitBounds();
 				return;
 			}
 	}
@@ -320,6 +317,35 @@ public:
 	}
 
 
+	//! Marks the area of this element and its children to be repainted
+	/** Only has an effect if the gui environment draws in retained
+	mode, see IGUIEnvironment::setRetainedMode(). Elements call this
+	themselves when their text, visibility, enabled state or position
+	changes, and the environment does it for hovered and focused
+	elements. Elements which change on their own, for example with
+	the time or with a texture rendered to, have to call it as well. */
+	inline void invalidate();
+
+
+	//! Draws the element and its children only inside of a rectangle
+	/** Elements which are completely outside of the rectangle are
+	skipped. Used by the gui environment to repaint changed areas.
+	\param rect Absolute rectangle to draw into. */
+	void drawClipped(const core::rect<s32>& rect)
+	{
+		core::array<SClipState> states;
+		clipTo(rect, states);
+
+		draw();
+
+		for (u32 i=0; i<states.size(); ++i)
+		{
+			states[i].Element->AbsoluteClippingRect = states[i].ClippingRect;
+			states[i].Element->IsVisible = states[i].Visible;
+		}
+	}
+
+
 	//! animate the element and its children.
 	virtual void OnPostRender(u32 timeMs)
 	{
@@ -350,6 +376,8 @@ public:
 	//! Sets the visible state of this element.
 	virtual void setVisible(bool visible)
 	{
+		if (IsVisible != visible)
+			invalidate();
 		IsVisible = visible;
 	}
 
@@ -465,6 +493,8 @@ public:
 	//! Sets the enabled state of this element.
 	virtual void setEnabled(bool enabled)
 	{
+		if (IsEnabled != enabled)
+			invalidate();
 		IsEnabled = enabled;
 	}
 
@@ -473,6 +503,7 @@ public:
 	virtual void setText(const wchar_t* text)
 	{
 		Text = text;
+		invalidate();
 	}
 
 
@@ -527,8 +558,13 @@ public:
 		{
 			if (element == (*it))
 			{
+				if (element == *Children.getLast())
+					return true;
+
+				element->invalidate();
 				Children.erase(it);
 				Children.push_back(element);
+				invalidateHitBounds();
 				return true;
 			}
 		}
@@ -771,6 +807,7 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			Children.push_back(child);
+			invalidateHitBounds();
 		}
 	}
 
@@ -887,11 +924,23 @@ protected:
 		if (!Parent)
 			parentAbsoluteClip = AbsoluteRect;
 
+		const core::rect<s32> lastClip(AbsoluteClippingRect);
+
 		AbsoluteClippingRect = AbsoluteRect;
 		AbsoluteClippingRect.clipAgainst(parentAbsoluteClip);
 
 		LastParentRect = parentAbsolute;
 
+		// repaint the old and the new area in retained mode
+		if (lastClip != AbsoluteClippingRect)
+		{
+			invalidateArea(lastClip);
+			invalidateArea(AbsoluteClippingRect);
+		}
+
+		if (AbsoluteClippingRect != HitClip)
+			invalidateHitBounds();
+
 		if ( recursive )
 		{
 			// update all children
@@ -971,9 +1020,260 @@ protected:
 
 	//! type of element
 	EGUI_ELEMENT_TYPE Type;
+
+private:
+
+	//! Marks an absolute area to be repainted in retained mode
+	inline void invalidateArea(const core::rect<s32>& area);
+
+	//! marks the hit bounds of this element and its parents as outdated
+	/** When the hit bounds of an element are outdated, those of all its
+	parents are outdated too. */
+	void invalidateHitBounds()
+	{
+		IGUIElement* element = this;
+		while (element && element->HitBoundsValid)
+		{
+			element->HitBoundsValid = false;
+			element = element->Parent;
+		}
+	}
+
+	//! returns if two rectangles have a point in common, borders included like in rect::isPointInside()
+	static bool hitRectsTouch(const core::rect<s32>& a, const core::rect<s32>& b)
+	{
+		return a.UpperLeftCorner.X <= b.LowerRightCorner.X && a.LowerRightCorner.X >= b.UpperLeftCorner.X &&
+			a.UpperLeftCorner.Y <= b.LowerRightCorner.Y && a.LowerRightCorner.Y >= b.UpperLeftCorner.Y;
+	}
+
+	//! recalculates the hit bounds of this element and its children if they are outdated
+	void updateHitBounds()
+	{
+		if (HitBoundsValid)
+			return;
+
+		HitClip = AbsoluteClippingRect;
+		HitBounds = getHitRect();
+		HitGridRect = core::rect<s32>(0,0,-1,-1);
+
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+		{
+			IGUIElement* child = *it;
+			child->updateHitBounds();
+			HitBounds.addInternalPoint(child->HitBounds.UpperLeftCorner);
+			HitBounds.addInternalPoint(child->HitBounds.LowerRightCorner);
+
+			// the grid only covers the parts of the children inside of this element
+			if (hitRectsTouch(child->HitBounds, AbsoluteClippingRect))
+			{
+				core::rect<s32> bounds(child->HitBounds);
+				bounds.clipAgainst(AbsoluteClippingRect);
+				if (HitGridRect.isValid())
+				{
+					HitGridRect.addInternalPoint(bounds.UpperLeftCorner);
+					HitGridRect.addInternalPoint(bounds.LowerRightCorner);
+				}
+				else
+					HitGridRect = bounds;
+			}
+		}
+
+		HitBoundsValid = true;
+		HitGridStarts.set_used(0);
+		HitGridChildren.set_used(0);
+
+		// few children are faster to test one after another
+		const u32 count = Children.size();
+		if (count < 16 || !HitGridRect.isValid())
+			return;
+
+		HitGridColumns = core::clamp(core::round32(core::squareroot((f32)count)), 1, 64);
+		HitGridRows = HitGridColumns;
+		HitGridCellWidth = HitGridRect.getWidth() / HitGridColumns + 1;
+		HitGridCellHeight = HitGridRect.getHeight() / HitGridRows + 1;
+
+		// count the children of each cell, then store them in drawing order
+		const u32 cells = HitGridColumns * HitGridRows;
+		HitGridStarts.set_used(cells + 1);
+		for (u32 i=0; i<=cells; ++i)
+			HitGridStarts[i] = 0;
+
+		for (u32 pass=0; pass<2; ++pass)
+		{
+			for (it = Children.begin(); it != Children.end(); ++it)
+			{
+				if (!hitRectsTouch((*it)->HitBounds, HitGridRect))
+					continue;
+
+				core::rect<s32> bounds((*it)->HitBounds);
+				bounds.clipAgainst(HitGridRect);
+				const s32 x0 = (bounds.UpperLeftCorner.X - HitGridRect.UpperLeftCorner.X) / HitGridCellWidth;
+				const s32 x1 = (bounds.LowerRightCorner.X - HitGridRect.UpperLeftCorner.X) / HitGridCellWidth;
+				const s32 y0 = (bounds.UpperLeftCorner.Y - HitGridRect.UpperLeftCorner.Y) / HitGridCellHeight;
+				const s32 y1 = (bounds.LowerRightCorner.Y - HitGridRect.UpperLeftCorner.Y) / HitGridCellHeight;
+
+				for (s32 y=y0; y<=y1; ++y)
+					for (s32 x=x0; x<=x1; ++x)
+					{
+						if (pass)
+							HitGridChildren[HitGridStarts[y*HitGridColumns + x]++] = *it;
+						else
+							++HitGridStarts[y*HitGridColumns + x + 1];
+					}
+			}
+
+			if (!pass)
+			{
+				for (u32 i=0; i<cells; ++i)
+					HitGridStarts[i+1] += HitGridStarts[i];
+				HitGridChildren.set_used(HitGridStarts[cells]);
+			}
+		}
+
+		// filling moved the starts of the cells to their ends
+		for (u32 i=cells; i>0; --i)
+			HitGridStarts[i] = HitGridStarts[i-1];
+		HitGridStarts[0] = 0;
+	}
+
+	//! returns the topmost visible element at a point, the hit bounds have to be up to date
+	IGUIElement* findElementFromPoint(const core::position2d<s32>& point)
+	{
+		if (!HitBounds.isPointInside(point) || !isVisible())
+			return 0;
+
+		IGUIElement* target = 0;
+
+		// we have to search from back to front, because later children
+		// might be drawn over the top of earlier ones.
+		if (HitGridStarts.size() && HitGridRect.isPointInside(point))
+		{
+			const s32 x = (point.X - HitGridRect.UpperLeftCorner.X) / HitGridCellWidth;
+			const s32 y = (point.Y - HitGridRect.UpperLeftCorner.Y) / HitGridCellHeight;
+			const u32 cell = y*HitGridColumns + x;
+
+			for (u32 i=HitGridStarts[cell+1]; i>HitGridStarts[cell]; --i)
+			{
+				target = HitGridChildren[i-1]->findElementFromPoint(point);
+				if (target)
+					return target;
+			}
+		}
+		else
+		{
+			core::list<IGUIElement*>::Iterator it = Children.getLast();
+			for (; it != Children.end(); --it)
+			{
+				target = (*it)->findElementFromPoint(point);
+				if (target)
+					return target;
+			}
+		}
+
+		if (isPointInside(point))
+			target = this;
+
+		return target;
+	}
+
+	//! clipping state of an element before drawClipped()
+	struct SClipState
+	{
+		IGUIElement* Element;
+		core::rect<s32> ClippingRect;
+		bool Visible;
+	};
+
+	//! clips the element and its children to a rectangle and hides those outside of it
+	/** \return True if anything of the element or its children is inside. */
+	bool clipTo(const core::rect<s32>& rect, core::array<SClipState>& states)
+	{
+		SClipState state;
+		state.Element = this;
+		state.ClippingRect = AbsoluteClippingRect;
+		state.Visible = IsVisible;
+		states.push_back(state);
+
+		AbsoluteClippingRect.clipAgainst(rect);
+		bool inside = AbsoluteClippingRect.getArea() > 0;
+
+		// children which are not clipped may be inside although this is not
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+		{
+			if ((*it)->clipTo(rect, states))
+				inside = true;
+		}
+
+		if (!inside)
+			IsVisible = false;
+
+		return IsVisible;
+	}
+
+	//! invalidates all children which are drawn outside of this element
+	void invalidateNotClippedChildren()
+	{
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+		{
+			if ((*it)->NoClip)
+				(*it)->invalidate();
+			else
+				(*it)->invalidateNotClippedChildren();
+		}
+	}
+
+	//! rectangle around the hit rectangles of this element and all its children
+	core::rect<s32> HitBounds;
+
+	//! clipping rectangle when the hit bounds were calculated
+	core::rect<s32> HitClip;
+
+	//! grid of the children by their hit bounds, in drawing order per cell
+	/** Only used for elements with many children. The children of a cell
+	are HitGridChildren[HitGridStarts[cell]] up to
+	HitGridChildren[HitGridStarts[cell+1]]. */
+	core::array<u32> HitGridStarts;
+	core::array<IGUIElement*> HitGridChildren;
+	core::rect<s32> HitGridRect;
+	s32 HitGridColumns, HitGridRows;
+	s32 HitGridCellWidth, HitGridCellHeight;
+
+	//! are the hit bounds up to date?
+	bool HitBoundsValid;
 };
 
 
+} // end namespace gui
+} // end namespace irr
+
+// the environment needs to be known for the retained mode methods only
+#include "IGUIEnvironment.h"
+
+namespace irr
+{
+namespace gui
+{
+
+void IGUIElement::invalidate()
+{
+	if (!Environment || !Environment->isRetainedMode())
+		return;
+
+	Environment->invalidate(AbsoluteClippingRect);
+	invalidateNotClippedChildren();
+}
+
+
+void IGUIElement::invalidateArea(const core::rect<s32>& area)
+{
+	if (Environment && Environment->isRetainedMode())
+		Environment->invalidate(area);
+}
+
+
 } // end namespace gui
 } // end namespace irr
 
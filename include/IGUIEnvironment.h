@@ -69,6 +69,33 @@ public:
 	//! Draws all gui elements by traversing the GUI environment starting at the root node.
 	virtual void drawAll() = 0;
 
+	//! Enables or disables drawing the gui in retained mode.
+	/** In retained mode the gui is kept in a texture which is drawn to
+	the screen by drawAll(), only the areas of changed elements are
+	repainted into it, through two render target textures. Elements mark themselves as changed when their
+	text, visibility, enabled state or position changes, and the
+	environment marks hovered and focused elements on user input. Other
+	changes, like a different skin color or a texture of an image which was
+	rendered to, have to be marked with IGUIElement::invalidate() or
+	invalidate(). The textures are sized like the screen and drawAll()
+	has to be called while the screen is the render target.
+	\param retained True to draw in retained mode, false to draw all
+	elements each frame again.
+	\return True on success, false if the driver can't render into
+	textures. */
+	virtual bool setRetainedMode(bool retained) = 0;
+
+	//! Returns if the gui is drawn in retained mode.
+	virtual bool isRetainedMode() const = 0;
+
+	//! Marks a rectangle of the screen to be repainted in retained mode.
+	/** \param rect Absolute rectangle which changed. */
+	virtual void invalidate(const core::rect<s32>& rect) = 0;
+
+	//! Returns the amount of pixels repainted by the last drawAll().
+	/** Without retained mode this is the size of the screen. */
+	virtual u32 getRepaintedArea() const = 0;
+
 	//! Sets the focus to an element.
 	/** Causes a EGET_ELEMENT_FOCUS_LOST event followed by a
 	EGET_ELEMENT_FOCUSED event. If someone absorbed either of the events,
@@ -95,6 +95,17 @@ public:
 	\param s String of symbols which are not send down to the videodriver
 	*/
 	virtual void setInvisibleCharacters( const wchar_t *s ) = 0;
+
+	//! Starts to collect the text of the following draw calls.
+	/** Until endBatch() is called, draw() only stores the glyphs of the
+	text. endBatch() then draws all of them with one draw call per
+	texture, color and clip rectangle. Use this for huds drawing many
+	strings per frame. Batched text is drawn on top of everything else
+	drawn before endBatch(). Fonts which can't batch draw immediately. */
+	virtual void beginBatch() {}
+
+	//! Draws all text collected since beginBatch().
+	virtual void endBatch() {}
 };
 
 } // end namespace gui
@@ -6,6 +6,7 @@
 #define __I_GUI_TABLE_H_INCLUDED__
 
 #include "IGUIElement.h"
+#include "IReferenceCounted.h"
 #include "irrTypes.h"
 #include "SColor.h"
 #include "IGUISkin.h"
@@ -80,6 +81,30 @@ namespace gui
 		EGTDF_COUNT
 	};
 
+	//! Supplies the rows of a table on demand
+	/** Tables with very many rows don't have to keep the cells of all rows.
+	The table only asks the provider for the cells of the rows it draws, and
+	for the cells of the ordered column when it orders its rows. */
+	class IGUITableDataProvider : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the amount of rows
+		virtual u32 getRowCount() const = 0;
+
+		//! Returns the text of a cell
+		/** The text only has to stay valid until the next call. */
+		virtual const wchar_t* getCellText(u32 rowIndex, u32 columnIndex) const = 0;
+
+		//! Returns the color of a cell text
+		/** \param defaultColor The color cells added to the table would get from the skin. */
+		virtual video::SColor getCellColor(u32 rowIndex, u32 columnIndex, video::SColor defaultColor) const
+		{
+			return defaultColor;
+		}
+	};
+
+
 	//! Default list box GUI element.
 	class IGUITable : public IGUIElement
 	{
@@ -187,6 +212,17 @@ namespace gui
 
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const = 0;
+
+		//! Sets a provider which supplies the rows instead of the rows added to the table
+		/** The rows added to the table are removed. Set the provider again
+		when its amount of rows changed, this keeps the selection and the
+		scroll position, but not the ordering.
+		\param provider The provider of the rows, or 0 to use the rows added
+		to the table again. */
+		virtual void setDataProvider(IGUITableDataProvider* provider) = 0;
+
+		//! Returns the provider which supplies the rows, or 0 if the table has its own rows
+		virtual IGUITableDataProvider* getDataProvider() const = 0;
 	};
 
 
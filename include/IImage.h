@@ -54,6 +54,14 @@ enum ECOLOR_FORMAT
 	//! 128 bit floating point format. 32 bits are used for the red, green, blue and alpha channels.
 	ECF_A32B32G32R32F,
 
+	/** Compressed formats. The image is stored in blocks of 4x4 pixels. */
+
+	//! DXT1 compressed format, 8 bytes per block, with an optional 1 bit alpha.
+	ECF_DXT1,
+
+	//! DXT5 compressed format, 16 bytes per block, with interpolated 8 bit alpha.
+	ECF_DXT5,
+
 	//! Unknown color format:
 	ECF_UNKNOWN
 };
@@ -117,6 +125,7 @@ public:
 	virtual u32 getAlphaMask() const = 0;
 
 	//! Returns pitch of image
+	/** For compressed formats this is the size of a row of 4x4 blocks. */
 	virtual u32 getPitch() const =0;
 
 	//! Copies the image into the target, scaling the image to fit
@@ -142,6 +151,21 @@ public:
 	//! fills the surface with black or white
 	virtual void fill(const SColor &color) =0;
 
+	//! Returns the prepared mip map levels of the image
+	/** Images loaded from formats with mip maps, like DDS, keep the
+	levels below the image itself, from half its size down to a single
+	pixel, in the color format of the image. Textures created from the
+	image use them instead of creating the levels.
+	\return Pointer to the mip map data, or 0 if the image has none. */
+	virtual void* getMipMapsData() const =0;
+
+	//! Sets the prepared mip map levels of the image
+	/** \param data The levels below the image, from half its size down
+	to a single pixel, in the color format of the image. 0 removes them.
+	\param ownForeignMemory If true, the image takes the data, which has
+	to be allocated with new u8[], otherwise the data is copied. */
+	virtual void setMipMapsData(void* data, bool ownForeignMemory=false) =0;
+
 	//! get the amount of Bits per Pixel of the given color format
 	static u32 getBitsPerPixelFromFormat(const ECOLOR_FORMAT format)
 	{
@@ -167,11 +191,43 @@ public:
 			return 64;
 		case ECF_A32B32G32R32F:
 			return 128;
+		case ECF_DXT1:
+			return 4;
+		case ECF_DXT5:
+			return 8;
 		default:
 			return 0;
 		}
 	}
 
+	//! test if the color format is stored in compressed blocks of 4x4 pixels
+	static bool isCompressedFormat(const ECOLOR_FORMAT format)
+	{
+		return format == ECF_DXT1 || format == ECF_DXT5;
+	}
+
+	//! get the size in bytes of image data with the given color format and dimension
+	static u32 getDataSizeFromFormat(const ECOLOR_FORMAT format, u32 width, u32 height)
+	{
+		if (isCompressedFormat(format))
+			return ((width + 3) / 4) * ((height + 3) / 4) * (format == ECF_DXT1 ? 8 : 16);
+
+		return width * height * (getBitsPerPixelFromFormat(format) / 8);
+	}
+
+	//! get the size in bytes of the mip map levels below an image with the given color format and dimension
+	static u32 getMipMapsDataSizeFromFormat(const ECOLOR_FORMAT format, u32 width, u32 height)
+	{
+		u32 size = 0;
+		while (width > 1 || height > 1)
+		{
+			width = core::max_(width >> 1, 1u);
+			height = core::max_(height >> 1, 1u);
+			size += getDataSizeFromFormat(format, width, height);
+		}
+		return size;
+	}
+
 	//! test if the color format is only viable for RenderTarget textures
 	/** Since we don't have support for e.g. floating point iimage formats
 	one should test if the color format can be used for arbitrary usage, or
@@ -184,6 +240,8 @@ public:
 			case ECF_R5G6B5:
 			case ECF_R8G8B8:
 			case ECF_A8R8G8B8:
+			case ECF_DXT1:
+			case ECF_DXT5:
 				return false;
 			default:
 				return true;
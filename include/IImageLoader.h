@@ -43,6 +43,41 @@ public:
 	/** \param file File handle to check.
 	\return Pointer to newly created image, or 0 upon error. */
 	virtual IImage* loadImage(io::IReadFile* file) const = 0;
+
+	//! Creates a surface from the file, which may be smaller than the stored image
+	/** Loaders which can decode smaller versions of their images
+	cheaply, like the JPG and PNG loaders, reduce both sides by 2, 4 or 8
+	as long as they do not get smaller than maxSize, or the stored image
+	if that is smaller. Other loaders return the full image.
+	\param file File handle to check.
+	\param maxSize Largest size at which the image is used, e.g. the
+	maximum texture size of a driver. A side of 0 keeps the full image.
+	\return Pointer to newly created image, or 0 upon error. */
+	virtual IImage* loadScaledImage(io::IReadFile* file, const core::dimension2d<u32>& maxSize) const
+	{
+		return loadImage(file);
+	}
+
+protected:
+
+	//! Returns by how many bits both sides of an image can be reduced for loadScaledImage
+	/** The reduced sides are rounded up. */
+	static u32 getScaleShift(const core::dimension2d<u32>& size, const core::dimension2d<u32>& maxSize, u32 maxShift)
+	{
+		if (!maxSize.Width || !maxSize.Height)
+			return 0;
+
+		u32 shift = 0;
+		while (shift < maxShift)
+		{
+			const u32 next = 1 << (shift + 1);
+			if ((size.Width + next - 1) / next < core::min_(size.Width, maxSize.Width) ||
+				(size.Height + next - 1) / next < core::min_(size.Height, maxSize.Height))
+				break;
+			++shift;
+		}
+		return shift;
+	}
 };
 
 
@@ -0,0 +1,173 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_LOAD_PROFILER_H_INCLUDED__
+#define __I_LOAD_PROFILER_H_INCLUDED__
+
+#include "IReferenceCounted.h"
+#include "path.h"
+
+namespace irr
+{
+namespace io
+{
+	class IWriteFile;
+} // end namespace io
+
+//! Kinds of work the load profiler measures
+enum E_LOAD_PROFILE_EVENT
+{
+	//! Loading an asset as a whole, e.g. by ISceneManager::getMesh or IVideoDriver::getTexture.
+	/** Time spent in other events of the load is not counted as time of this event. */
+	ELPE_LOAD = 0,
+
+	//! Opening a file, including looking it up in the archives of the file system
+	ELPE_OPEN,
+
+	//! Reading from a file on disk or mapped into memory
+	ELPE_READ,
+
+	//! Decompressing a file of an archive
+	ELPE_DECOMPRESS,
+
+	//! Parsing a mesh or decoding an image by its loader
+	ELPE_PARSE,
+
+	//! Creating a texture of the video driver from a decoded image
+	ELPE_UPLOAD,
+
+	//! Not used, counts the number of kinds
+	ELPE_COUNT
+};
+
+//! Names of the kinds of work, as used in summaries and traces
+const c8* const LoadProfileEventNames[] =
+{
+	"load",
+	"open",
+	"read",
+	"decompress",
+	"parse",
+	"upload",
+	0
+};
+
+
+//! What loading an asset cost
+struct SLoadProfileAsset
+{
+	SLoadProfileAsset() : Vertices(0), Indices(0), Texels(0), BytesAllocated(0)
+	{
+		for (u32 i=0; i<ELPE_COUNT; ++i)
+		{
+			Time[i] = 0;
+			Count[i] = 0;
+		}
+	}
+
+	//! Returns the sum of all times in microseconds
+	u32 getTotalTime() const
+	{
+		u32 total = 0;
+		for (u32 i=0; i<ELPE_COUNT; ++i)
+			total += Time[i];
+		return total;
+	}
+
+	//! Name of the asset, usually the file name it was loaded with
+	io::path Name;
+
+	//! Microseconds spent for each kind of work, without the time of nested work
+	/** Assets loaded while loading this one, like the textures of a
+	mesh, are counted as separate assets. */
+	u32 Time[ELPE_COUNT];
+
+	//! How often each kind of work was done, e.g. the number of reads
+	u32 Count[ELPE_COUNT];
+
+	//! Number of vertices of a mesh
+	u32 Vertices;
+
+	//! Number of indices of a mesh
+	u32 Indices;
+
+	//! Number of texels of a decoded image
+	u32 Texels;
+
+	//! Bytes allocated for mesh buffers, images and textures
+	u32 BytesAllocated;
+};
+
+
+//! Records where the time goes while meshes and textures are loaded
+/** The profiler of a device is disabled initially, so loading is not
+slowed down by measuring it. Once enabled, the engine reports the work it does
+for each asset: opening and reading files, decompressing files of archives,
+parsing meshes and decoding images, and creating textures. The results can
+be queried per asset, logged as a summary, or written as a trace which
+the Chrome browser shows at chrome://tracing.
+Events have to be reported from one thread only. */
+class ILoadProfiler : public virtual IReferenceCounted
+{
+public:
+
+	//! Destructor
+	virtual ~ILoadProfiler() {}
+
+	//! Enables or disables recording
+	virtual void setEnabled(bool enabled) = 0;
+
+	//! Returns if events are recorded
+	virtual bool isEnabled() const = 0;
+
+	//! Sets the shortest duration of events kept for the trace
+	/** Shorter events are still counted for their asset, but left out of
+	the trace, so that many small reads don't need much memory. Default is
+	10 microseconds.
+	\param microseconds Shortest duration of events in the trace. */
+	virtual void setTraceThreshold(u32 microseconds) = 0;
+
+	//! Removes all recorded assets and events
+	virtual void clear() = 0;
+
+	//! Starts measuring some work
+	/** Each call has to be followed by a call of endEvent(). Events may be
+	nested, the time of inner events is not counted for the outer ones.
+	\param type Kind of work which is done.
+	\param name Name of the asset for ELPE_LOAD, else of the file or asset
+	the work is done for. Work inside a load event is counted for the loaded
+	asset. The string has to stay valid until endEvent() is called. */
+	virtual void beginEvent(E_LOAD_PROFILE_EVENT type, const io::path& name) = 0;
+
+	//! Ends measuring the work of the last begun event
+	virtual void endEvent() = 0;
+
+	//! Adds sizes to the asset of the current event
+	/** Does nothing if no event is measured at the moment. */
+	virtual void addAssetSizes(u32 vertices, u32 indices, u32 texels, u32 bytesAllocated) = 0;
+
+	//! Returns the number of assets recorded so far
+	virtual u32 getAssetCount() const = 0;
+
+	//! Returns what loading an asset cost
+	/** \param index Index of the asset, in the order of their first event. */
+	virtual const SLoadProfileAsset& getAsset(u32 index) const = 0;
+
+	//! Returns the asset with the given name, or 0 if it was not recorded
+	virtual const SLoadProfileAsset* getAsset(const io::path& name) const = 0;
+
+	//! Logs the sums of all kinds of work and the slowest assets
+	/** \param maxAssets Number of assets to list, the slowest first. */
+	virtual void logSummary(u32 maxAssets=20) const = 0;
+
+	//! Writes the recorded events in the JSON format of Chrome traces
+	/** \param file File to write to.
+	\return True if successful. */
+	virtual bool writeChromeTrace(io::IWriteFile* file) const = 0;
+};
+
+} // end namespace irr
+
+#endif
+
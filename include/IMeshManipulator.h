@@ -220,6 +220,22 @@ namespace scene
 		IReferenceCounted::drop() for more information. */
 		virtual IMesh* createMeshWelded(IMesh* mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const = 0;
 
+		//! Adds a mesh buffer to a mesh, split into smaller buffers if needed
+		/** Mesh loaders build large triangle lists with 32 bit indices
+		and add them with this method. A buffer of S3DVertex vertices
+		which needs 32 bit indices is added unchanged if they are
+		allowed, else it is split into SMeshBuffers of at most 65535
+		vertices. The triangles are distributed along a z-order curve
+		through the bounding box, so each part covers a compact region
+		and can be culled on its own. Buffers which fit into 16 bit
+		indices are added as SMeshBuffers, all others unchanged.
+		\param mesh Mesh to add the buffers to.
+		\param buffer Triangle list to add, it is not changed.
+		\param allow32BitIndices Whether the video driver can draw 32
+		bit indices, see video::EVDF_INDEX_32BIT.
+		\return Number of mesh buffers added to the mesh. */
+		virtual u32 addSplitMeshBuffer(SMesh* mesh, IMeshBuffer* buffer, bool allow32BitIndices) const = 0;
+
 		//! Get amount of polygons in mesh.
 		/** \param mesh Input mesh
 		\return Number of polygons in mesh. */
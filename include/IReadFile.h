@@ -42,6 +42,15 @@ namespace io
 		//! Get name of file.
 		/** \return File name as zero terminated character string. */
 		virtual const io::path& getFileName() const = 0;
+
+		//! Get the whole file content as a block of memory, if possible.
+		/** Files which are mapped into memory or which are read from
+		memory anyway can return their content here, so that loaders can
+		use it directly instead of copying it with read(). The pointer
+		stays valid as long as the file is not dropped.
+		\return Pointer to the first byte of the file, or 0 if the
+		content is not available in memory. */
+		virtual const void* getMappedPointer() const { return 0; }
 	};
 
 	//! Internal function, please do not use.
@@ -123,6 +123,7 @@ namespace scene
 	class ISceneNodeAnimatorFactory;
 	class ISceneUserDataSerializer;
 	class ILightManager;
+	class IQ3LevelMesh;
 
 	namespace quake3
 	{
@@ -861,6 +862,18 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node rendering the geometry of a quake3 level to the scene graph.
+		/** Instead of an octree the node uses the bsp tree and the cluster
+		visibility of the level. Only faces of leafs which are potentially
+		visible from the camera cluster and inside the view frustum are drawn.
+		\param mesh: The level, as returned by getMesh() for a .bsp file.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\return Pointer to the created scene node, or NULL if the mesh is no quake3 level.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IMeshSceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -24,10 +24,17 @@ namespace scene
 {
 	class ISceneManager;
 
+#ifdef _IRR_USE_POOLED_SCENE_NODE_LISTS_
+	//! Typedef for list of scene nodes
+	typedef core::list<ISceneNode*, core::irrAllocatorPool> ISceneNodeList;
+	//! Typedef for list of scene node animators
+	typedef core::list<ISceneNodeAnimator*, core::irrAllocatorPool> ISceneNodeAnimatorList;
+#else
 	//! Typedef for list of scene nodes
 	typedef core::list<ISceneNode*> ISceneNodeList;
 	//! Typedef for list of scene node animators
 	typedef core::list<ISceneNodeAnimator*> ISceneNodeAnimatorList;
+#endif
 
 	//! Scene node interface.
 	/** A scene node is a node in the hierarchical scene graph. Every scene
@@ -353,7 +360,7 @@ namespace scene
 
 		//! Get a list of all scene node animators.
 		/** \return The list of animators attached to this node. */
-		const core::list<ISceneNodeAnimator*>& getAnimators() const
+		const ISceneNodeAnimatorList& getAnimators() const
 		{
 			return Animators;
 		}
@@ -577,7 +584,7 @@ namespace scene
 
 		//! Returns a const reference to the list of all children.
 		/** \return The list of all children of this node. */
-		const core::list<ISceneNode*>& getChildren() const
+		const ISceneNodeList& getChildren() const
 		{
 			return Children;
 		}
@@ -811,10 +818,10 @@ namespace scene
 		ISceneNode* Parent;
 
 		//! List of all children of this node
-		core::list<ISceneNode*> Children;
+		ISceneNodeList Children;
 
 		//! List of all animator nodes
-		core::list<ISceneNodeAnimator*> Animators;
+		ISceneNodeAnimatorList Animators;
 
 		//! Pointer to the scene manager
 		ISceneManager* SceneManager;
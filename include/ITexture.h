@@ -65,6 +65,12 @@ enum E_TEXTURE_CREATION_FLAG
 	/** BurningVideo can handle Non-Power-2 Textures in 2D (GUI), but not in 3D. */
 	ETCF_ALLOW_NON_POWER_2 = 0x00000040,
 
+	//! Average the colors of created mip map levels in linear space
+	/** Textures in sRGB space keep their brightness in smaller mip
+	map levels. Only used for 32 and 16 bit textures by the drivers
+	which create the levels themselves. */
+	ETCF_GAMMA_CORRECT_MIP_MAPS = 0x00000080,
+
 	/** This flag is never used, it only forces the compiler to compile
 	these enumeration values to 32 bit. */
 	ETCF_FORCE_32_BIT_DO_NOT_USE = 0x7fffffff
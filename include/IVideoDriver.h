@@ -997,6 +997,23 @@ namespace video
 		\return Amount of primitives drawn in the last frame. */
 		virtual u32 getPrimitiveCountDrawn( u32 mode =0 ) const =0;
 
+		//! Returns amount of triangles which were skipped because they were hidden in the last frame.
+		/** Only drivers which test whole triangles against the depth
+		buffer before rasterizing them count these, currently Burning's
+		Video. The triangles are also counted by getPrimitiveCountDrawn().
+		\param mode 0 for the last frame, otherwise the amount
+		accumulated over all frames.
+		\return Amount of hidden triangles, 0 for the other drivers. */
+		virtual u32 getPrimitiveCountRejected( u32 mode =0 ) const =0;
+
+		//! Returns how often each pixel of the screen was drawn on average in the last frame.
+		/** Estimated from the screen area of the rasterized triangles,
+		which is only known to the software renderers, currently
+		Burning's Video.
+		\return Rasterized area divided by the screen area, 0 for the
+		other drivers. */
+		virtual f32 getOverdraw() const =0;
+
 		//! Deletes all dynamic lights which were previously added with addDynamicLight().
 		virtual void deleteAllDynamicLights() =0;
 
@@ -35,6 +35,7 @@
 //! _IRR_COMPILE_WITH_X11_DEVICE_ for Linux X11 based device
 //! _IRR_COMPILE_WITH_SDL_DEVICE_ for platform independent SDL framework
 //! _IRR_COMPILE_WITH_CONSOLE_DEVICE_ for no windowing system, used as a fallback
+//! _IRR_COMPILE_WITH_HEADLESS_DEVICE_ for rendering into memory without any window
 //! _IRR_COMPILE_WITH_FB_DEVICE_ for framebuffer systems
 
 
@@ -44,6 +45,9 @@
 //! Comment this line to compile without the fallback console device.
 #define _IRR_COMPILE_WITH_CONSOLE_DEVICE_
 
+//! Comment this line to compile without the headless device, which renders into memory.
+#define _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+
 //! WIN32 for Windows32
 //! WIN64 for Windows64
 // The windows platform and API support SDL and WINDOW device
@@ -336,6 +340,8 @@ B3D, MS3D or X meshes */
 #define _IRR_COMPILE_WITH_WAL_LOADER_
 //! Define _IRR_COMPILE_WITH_RGB_LOADER_ if you want to load Silicon Graphics .rgb/.rgba/.sgi/.int/.inta/.bw files
 #define _IRR_COMPILE_WITH_RGB_LOADER_
+//! Define _IRR_COMPILE_WITH_DDS_LOADER_ if you want to load DXT1/DXT5 compressed and uncompressed .dds files
+#define _IRR_COMPILE_WITH_DDS_LOADER_
 
 //! Define _IRR_COMPILE_WITH_BMP_WRITER_ if you want to write .bmp files
 #define _IRR_COMPILE_WITH_BMP_WRITER_
@@ -351,6 +357,8 @@ B3D, MS3D or X meshes */
 #define _IRR_COMPILE_WITH_PSD_WRITER_
 //! Define _IRR_COMPILE_WITH_TGA_WRITER_ if you want to write .tga files
 #define _IRR_COMPILE_WITH_TGA_WRITER_
+//! Define _IRR_COMPILE_WITH_DDS_WRITER_ if you want to write DXT1/DXT5 compressed .dds files
+#define _IRR_COMPILE_WITH_DDS_WRITER_
 
 //! Define __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_ if you want to open ZIP and GZIP archives
 /** ZIP reading has several more options below to configure. */
@@ -401,6 +409,31 @@ precision will be lower but speed higher. currently X86 only
 	//#define IRRLICHT_FAST_MATH
 #endif
 
+//! Define _IRR_COMPILE_WITH_SSE2_ to use SSE2 intrinsics in some performance critical loops
+/** This is enabled automatically if the compiler generates SSE2 code anyway,
+which is always the case for x86_64 targets. Define NO_IRR_COMPILE_WITH_SSE2_
+to use the plain C++ code paths only. */
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))) && !defined(NO_IRR_COMPILE_WITH_SSE2_)
+#define _IRR_COMPILE_WITH_SSE2_
+#endif
+
+//! Define _IRR_COMPILE_WITH_THREADS_ to let mesh loaders parse large files on several threads
+/** Uses Windows threads or pthreads, so applications on other systems than
+Windows have to link with -lpthread. Define NO_IRR_COMPILE_WITH_THREADS_ to do
+all work on the calling thread. */
+#if !defined(NO_IRR_COMPILE_WITH_THREADS_) && !defined(_IRR_XBOX_PLATFORM_) && !defined(_WIN32_WCE)
+#define _IRR_COMPILE_WITH_THREADS_
+#endif
+
+//! Define _IRR_USE_POOLED_SCENE_NODE_LISTS_ to keep the children and animators of scene nodes in pools
+/** The list nodes are then taken from chunks owned by each scene node
+instead of one heap block per child, which helps when scenes with many
+nodes are built and torn down often. Code which names the list types of
+ISceneNode::getChildren() and getAnimators() has to use ISceneNodeList and
+ISceneNodeAnimatorList then. Changes the interface, so the library and the
+application have to be compiled with the same setting. */
+//#define _IRR_USE_POOLED_SCENE_NODE_LISTS_
+
 // Some cleanup and standard stuff
 
 #ifdef _IRR_WINDOWS_API_
@@ -496,6 +529,7 @@ precision will be lower but speed higher. currently X86 only
 	#undef _IRR_COMPILE_WITH_PSD_LOADER_
 	//#undef _IRR_COMPILE_WITH_TGA_LOADER_
 	#undef _IRR_COMPILE_WITH_WAL_LOADER_
+	#undef _IRR_COMPILE_WITH_DDS_LOADER_
 	#undef _IRR_COMPILE_WITH_BMP_WRITER_
 	#undef _IRR_COMPILE_WITH_JPG_WRITER_
 	#undef _IRR_COMPILE_WITH_PCX_WRITER_
@@ -503,6 +537,7 @@ precision will be lower but speed higher. currently X86 only
 	#undef _IRR_COMPILE_WITH_PPM_WRITER_
 	#undef _IRR_COMPILE_WITH_PSD_WRITER_
 	#undef _IRR_COMPILE_WITH_TGA_WRITER_
+	#undef _IRR_COMPILE_WITH_DDS_WRITER_
 
 #endif
 
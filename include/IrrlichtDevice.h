@@ -15,6 +15,7 @@
 #include "IVideoModeList.h"
 #include "ITimer.h"
 #include "IOSOperator.h"
+#include "ILoadProfiler.h"
 
 namespace irr
 {
@@ -106,6 +107,13 @@ namespace irr
 		/** \return Pointer to the logger. */
 		virtual ILogger* getLogger() = 0;
 
+		//! Provides access to the profiler of loading meshes and textures.
+		/** The profiler is disabled until enabled with
+		ILoadProfiler::setEnabled(). Devices created while another one
+		exists share its profiler.
+		\return Pointer to the load profiler. */
+		virtual ILoadProfiler* getLoadProfiler() = 0;
+
 		//! Gets a list with all video modes available.
 		/** If you are confused now, because you think you have to
 		create an Irrlicht Device with a video mode before being able
@@ -9,6 +9,7 @@
 #include "EDeviceTypes.h"
 #include "dimension2d.h"
 #include "ILogger.h"
+#include "path.h"
 
 namespace irr
 {
@@ -37,6 +38,7 @@ namespace irr
 			EventReceiver(0),
 			WindowId(0),
 			LoggingLevel(ELL_INFORMATION),
+			FrameOutputBuffers(2),
 			SDK_version_do_not_use(IRRLICHT_SDK_VERSION)
 		{
 		}
@@ -64,6 +66,8 @@ namespace irr
 			EventReceiver = other.EventReceiver;
 			WindowId = other.WindowId;
 			LoggingLevel = other.LoggingLevel;
+			FrameOutput = other.FrameOutput;
+			FrameOutputBuffers = other.FrameOutputBuffers;
 			return *this;
 		}
 
@@ -76,6 +80,7 @@ namespace irr
 		EIDT_X11 is available on Linux, Solaris, BSD and other operating systems which use X11,
 		EIDT_SDL is available on most systems if compiled in,
 		EIDT_CONSOLE is usually available but can only render to text,
+		EIDT_HEADLESS is usually available and renders into memory,
 		EIDT_BEST will select the best available device for your operating system.
 		Default: EIDT_BEST. */
 		E_DEVICE_TYPE DeviceType;
@@ -239,6 +244,24 @@ namespace irr
 		*/
 		ELOG_LEVEL LoggingLevel;
 
+		//! Where the headless device writes the rendered frames.
+		/** Only used by EIDT_HEADLESS. A name with a number pattern like
+		"frames/shot%04d.png" writes each frame as an image file, using the
+		image writer of the file extension. Any other name is opened once,
+		and the raw pixels of all frames are written to it one after the
+		other, row by row from the top, in the color format of the video
+		driver. This may be a named pipe read by a video encoder.
+		Default: empty, frames are not written. */
+		io::path FrameOutput;
+
+		//! Number of frame buffers of the headless device.
+		/** Only used by EIDT_HEADLESS. The frames are written in the
+		background, while the next ones are rendered. 2 means double
+		buffering, where a frame is written while the next one is rendered.
+		With 3, rendering can get two frames ahead of writing, and so on.
+		1 writes each frame before endScene() returns. Default: 2. */
+		u32 FrameOutputBuffers;
+
 		//! Don't use or change this parameter.
 		/** Always set it to IRRLICHT_SDK_VERSION, which is done by default.
 		This is needed for sdk version checks. */
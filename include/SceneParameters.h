@@ -137,6 +137,17 @@ namespace scene
 	const c8* const OBJ_LOADER_IGNORE_MATERIAL_FILES = "OBJ_IgnoreMaterialFiles";
 
 
+	//! Name of the parameter for the number of threads used by mesh loaders
+	/** The obj and ply loaders parse parts of large text files on
+	several threads. The default of 0 uses one thread per processor, 1
+	parses everything on the calling thread. Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::MESH_LOADER_THREADS, 1);
+	\endcode
+	**/
+	const c8* const MESH_LOADER_THREADS = "MESH_LoaderThreads";
+
+
 	//! Flag to ignore the b3d file's mipmapping flag
 	/** Instead Irrlicht's texture creation flag is used. Use it like this:
 	\code
@@ -101,6 +101,336 @@ public:
 	}
 };
 
+//! Allocator which keeps single elements in chunks and reuses them
+/** Containers which allocate one node at a time, like core::list and
+core::map, get their nodes from chunks which grow with the container,
+instead of one heap block per node. Freed nodes are reused by the same
+container, the chunks are released with the allocator. Allocations of
+more than one element, like those of core::array, are taken from the heap.
+Each allocator has its own chunks, copies of it start empty and swapping
+two allocators with core::swap() exchanges their chunks. Not thread safe.
+Containers using it are NOT able to be used across dll boundaries. */
+template<typename T>
+class irrAllocatorPool
+{
+public:
+
+	//! Default constructor
+	irrAllocatorPool()
+		: Chunks(0), FreeBlocks(0), NextChunkSize(4), Allocations(0), HeapAllocations(0) {}
+
+	//! Copy constructor, the copy does not share the chunks
+	irrAllocatorPool(const irrAllocatorPool<T>& other)
+		: Chunks(0), FreeBlocks(0), NextChunkSize(4), Allocations(0), HeapAllocations(0) {}
+
+	//! Destructor, releases all chunks
+	~irrAllocatorPool()
+	{
+		while (Chunks)
+		{
+			SChunk* next = Chunks->Next;
+			operator delete(Chunks);
+			Chunks = next;
+		}
+	}
+
+	//! Assignment keeps the own chunks, which still hold the elements of this allocator
+	irrAllocatorPool<T>& operator=(const irrAllocatorPool<T>& other)
+	{
+		return *this;
+	}
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		++Allocations;
+		if (cnt != 1)
+		{
+			++HeapAllocations;
+			return (T*)operator new(cnt* sizeof(T));
+		}
+
+		if (!FreeBlocks)
+			addChunk();
+
+		SBlock* block = FreeBlocks;
+		FreeBlocks = block->Next;
+		return (T*)block;
+	}
+
+	//! Deallocate memory for an array of objects
+	void deallocate(T* ptr)
+	{
+		if (!ptr)
+			return;
+
+		SBlock* block = (SBlock*)ptr;
+		for (SChunk* chunk = Chunks; chunk; chunk = chunk->Next)
+		{
+			if (block >= chunk->Blocks && block < chunk->Blocks + chunk->Size)
+			{
+				block->Next = FreeBlocks;
+				FreeBlocks = block;
+				return;
+			}
+		}
+
+		operator delete(ptr);
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+	//! Exchanges the chunks with another allocator
+	void swap(irrAllocatorPool<T>& other)
+	{
+		SChunk* chunks = Chunks; Chunks = other.Chunks; other.Chunks = chunks;
+		SBlock* blocks = FreeBlocks; FreeBlocks = other.FreeBlocks; other.FreeBlocks = blocks;
+		u32 size = NextChunkSize; NextChunkSize = other.NextChunkSize; other.NextChunkSize = size;
+	}
+
+	//! Returns how often memory was allocated
+	u32 getAllocationCount() const
+	{
+		return Allocations;
+	}
+
+	//! Returns how often memory was allocated from the heap, including the chunks
+	u32 getHeapAllocationCount() const
+	{
+		return HeapAllocations;
+	}
+
+private:
+
+	//! storage of an element, or a link to the next free one
+	union SBlock
+	{
+		SBlock* Next;
+		f64 Align;
+		c8 Data[sizeof(T)];
+	};
+
+	//! elements allocated at once, the blocks follow the header
+	struct SChunk
+	{
+		SChunk* Next;
+		u32 Size;
+		SBlock Blocks[1];
+	};
+
+	//! adds a chunk twice as large as the last one to the free blocks
+	void addChunk()
+	{
+		++HeapAllocations;
+		SChunk* chunk = (SChunk*)operator new(sizeof(SChunk) + (NextChunkSize-1)*sizeof(SBlock));
+		chunk->Next = Chunks;
+		chunk->Size = NextChunkSize;
+		Chunks = chunk;
+
+		for (u32 i=0; i<chunk->Size; ++i)
+			chunk->Blocks[i].Next = (i+1 < chunk->Size) ? &chunk->Blocks[i+1] : FreeBlocks;
+		FreeBlocks = chunk->Blocks;
+
+		NextChunkSize *= 2;
+	}
+
+	SChunk* Chunks;
+	SBlock* FreeBlocks;
+	u32 NextChunkSize;
+	u32 Allocations;
+	u32 HeapAllocations;
+};
+
+
+//! Swaps two pool allocators, so each container keeps the chunks holding its elements
+template<typename T>
+inline void swap(irrAllocatorPool<T>& a, irrAllocatorPool<T>& b)
+{
+	a.swap(b);
+}
+
+
+//! Memory which is handed out piece after piece and released all at once
+/** Allocations are taken from large blocks one after another, without any
+bookkeeping per allocation. Nothing is freed until reset() is called, for
+example at the end of each frame for lists which only live during a frame.
+Not thread safe. */
+class irrMemoryArena
+{
+public:
+
+	//! Constructor
+	/** \param blockSize Size of the first block in bytes. */
+	irrMemoryArena(size_t blockSize=16384)
+		: Blocks(0), BlockSize(blockSize), Allocations(0), HeapAllocations(0) {}
+
+	//! Destructor, releases all memory
+	~irrMemoryArena()
+	{
+		release();
+	}
+
+	//! Returns memory, aligned to 16 bytes
+	void* allocate(size_t bytes)
+	{
+		++Allocations;
+		bytes = (bytes + 15) & ~(size_t)15;
+		if (!Blocks || Blocks->Used + bytes > Blocks->Size)
+			addBlock(bytes);
+
+		void* ptr = (c8*)(Blocks + 1) + Blocks->Used;
+		Blocks->Used += bytes;
+		return ptr;
+	}
+
+	//! Makes all memory available again, nothing allocated before may be used anymore
+	/** When more than one block was needed, they are replaced by a single
+	block large enough for all of them. */
+	void reset()
+	{
+		if (Blocks && Blocks->Next)
+		{
+			size_t size = 0;
+			for (SBlock* block = Blocks; block; block = block->Next)
+				size += block->Size;
+			release();
+			addBlock(size);
+		}
+		else if (Blocks)
+			Blocks->Used = 0;
+	}
+
+	//! Returns how often memory was allocated
+	u32 getAllocationCount() const
+	{
+		return Allocations;
+	}
+
+	//! Returns how often the arena allocated a block from the heap
+	u32 getHeapAllocationCount() const
+	{
+		return HeapAllocations;
+	}
+
+	//! Returns the amount of bytes handed out since the last reset
+	size_t getUsedBytes() const
+	{
+		size_t used = 0;
+		for (SBlock* block = Blocks; block; block = block->Next)
+			used += block->Used;
+		return used;
+	}
+
+private:
+
+	//! header of a block, the memory follows it
+	struct SBlock
+	{
+		SBlock* Next;
+		size_t Size;
+		size_t Used;
+		size_t Padding;
+	};
+
+	void addBlock(size_t bytes)
+	{
+		++HeapAllocations;
+		size_t size = BlockSize;
+		while (size < bytes)
+			size *= 2;
+		BlockSize = size;
+
+		SBlock* block = (SBlock*)operator new(sizeof(SBlock) + size);
+		block->Next = Blocks;
+		block->Size = size;
+		block->Used = 0;
+		Blocks = block;
+	}
+
+	void release()
+	{
+		while (Blocks)
+		{
+			SBlock* next = Blocks->Next;
+			operator delete(Blocks);
+			Blocks = next;
+		}
+	}
+
+	SBlock* Blocks;
+	size_t BlockSize;
+	u32 Allocations;
+	u32 HeapAllocations;
+};
+
+
+//! Allocator which takes its memory from an irrMemoryArena
+/** Deallocating does nothing, the memory is released when the arena is
+reset. Set the arena with setArena() before the container allocates, for
+example with array::getAllocator(). Without an arena it uses the heap.
+Containers using it are NOT able to be used across dll boundaries. */
+template<typename T>
+class irrAllocatorArena
+{
+public:
+
+	//! Default constructor, allocates from the heap until an arena is set
+	irrAllocatorArena() : Arena(0) {}
+
+	//! Sets the arena to allocate from
+	void setArena(irrMemoryArena* arena)
+	{
+		Arena = arena;
+	}
+
+	//! Returns the arena, or 0 if the heap is used
+	irrMemoryArena* getArena() const
+	{
+		return Arena;
+	}
+
+	//! Allocate memory for an array of objects
+	T* allocate(size_t cnt)
+	{
+		if (Arena)
+			return (T*)Arena->allocate(cnt* sizeof(T));
+		return (T*)operator new(cnt* sizeof(T));
+	}
+
+	//! Deallocate memory for an array of objects
+	void deallocate(T* ptr)
+	{
+		if (!Arena)
+			operator delete(ptr);
+	}
+
+	//! Construct an element
+	void construct(T* ptr, const T&e)
+	{
+		new ((void*)ptr) T(e);
+	}
+
+	//! Destruct an element
+	void destruct(T* ptr)
+	{
+		ptr->~T();
+	}
+
+private:
+
+	irrMemoryArena* Arena;
+};
+
 
 
 #ifdef DEBUG_CLIENTBLOCK
@@ -599,6 +599,12 @@ public:
 		other.is_sorted = helper_is_sorted;
 	}
 
+	//! Returns the allocator of the array, for example to set its arena or read its counters
+	TAlloc& getAllocator()
+	{
+		return allocator;
+	}
+
 
 private:
 	T* data;
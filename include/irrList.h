@@ -16,7 +16,9 @@ namespace core
 
 
 //! Doubly linked list template.
-template <class T>
+/** The nodes are allocated with TAlloc, instantiated for the node type of
+the list. Use irrAllocatorPool to keep the nodes of a list in chunks. */
+template <class T, template <class> class TAlloc = irrAllocator>
 class list
 {
 private:
@@ -79,7 +81,7 @@ public:
 
 		SKListNode* Current;
 
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 		friend class ConstIterator;
 	};
 
@@ -129,7 +131,7 @@ public:
 		SKListNode* Current;
 
 		friend class Iterator;
-		friend class list<T>;
+		friend class list<T, TAlloc>;
 	};
 
 	//! Default constructor for empty list.
@@ -138,7 +140,7 @@ public:
 
 
 	//! Copy constructor.
-	list(const list<T>& other) : First(0), Last(0), Size(0)
+	list(const list<T, TAlloc>& other) : First(0), Last(0), Size(0)
 	{
 		*this = other;
 	}
@@ -152,7 +154,7 @@ public:
 
 
 	//! Assignment operator
-	void operator=(const list<T>& other)
+	void operator=(const list<T, TAlloc>& other)
 	{
 		if(&other == this)
 		{
@@ -390,7 +392,7 @@ public:
 	object will contain the content of this object. Iterators will afterwards be valid for
 	the swapped object.
 	\param other Swap content with this object	*/
-	void swap(list<T>& other)
+	void swap(list<T, TAlloc>& other)
 	{
 		core::swap(First, other.First);
 		core::swap(Last, other.Last);
@@ -398,13 +400,19 @@ public:
 		core::swap(allocator, other.allocator);	// memory is still released by the same allocator used for allocation
 	}
 
+	//! Returns the allocator of the nodes, for example to read its counters
+	TAlloc<SKListNode>& getAllocator()
+	{
+		return allocator;
+	}
+
 
 private:
 
 	SKListNode* First;
 	SKListNode* Last;
 	u32 Size;
-	irrAllocator<SKListNode> allocator;
+	TAlloc<SKListNode> allocator;
 
 };
 
@@ -102,6 +102,7 @@
 #include "IImageWriter.h"
 #include "IIndexBuffer.h"
 #include "ILightSceneNode.h"
+#include "ILoadProfiler.h"
 #include "ILogger.h"
 #include "IMaterialRenderer.h"
 #include "IMaterialRendererServices.h"
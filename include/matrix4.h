@@ -13,6 +13,10 @@
 #include "rect.h"
 #include "irrString.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 // enable this to keep track of changes to the matrix
 // and make simpler identity check for seldomly changing matrices
 // otherwise identity check will always compare the elements
@@ -216,6 +220,28 @@ namespace core
 			//! An alternate transform vector method, writing into an array of 4 floats
 			void transformVect(T *out,const core::vector3df &in) const;
 
+			//! Transforms many vectors by this matrix, like transformVect() for each of them
+			/** \param out First transformed vector, may be the same as in.
+			\param in First vector to transform.
+			\param count Amount of vectors.
+			\param inStride Bytes from one input vector to the next, for example
+			sizeof(video::S3DVertex) to transform the positions of vertices.
+			\param outStride Bytes from one output vector to the next. */
+			void transformVects(vector3df* out, const vector3df* in, u32 count,
+				u32 inStride=sizeof(vector3df), u32 outStride=sizeof(vector3df)) const;
+
+			//! Transforms many vectors by this matrix into 4 floats each, like transformVect(T*, const vector3df&)
+			/** \param out First of the 4 floats of the first transformed vector.
+			The other parameters are the same as for transformVects(), the
+			output stride defaults to 4 floats. */
+			void transformVects(T* out, const vector3df* in, u32 count,
+				u32 inStride=sizeof(vector3df), u32 outStride=4*sizeof(T)) const;
+
+			//! Rotates many vectors by this matrix, like rotateVect() for each of them
+			/** Parameters are the same as for transformVects(). */
+			void rotateVects(vector3df* out, const vector3df* in, u32 count,
+				u32 inStride=sizeof(vector3df), u32 outStride=sizeof(vector3df)) const;
+
 			//! Translate a vector by the translation part of this matrix.
 			void translateVect( vector3df& vect ) const;
 
@@ -235,6 +261,11 @@ namespace core
 			is slower than transformBox(). */
 			void transformBoxEx(core::aabbox3d<f32>& box) const;
 
+			//! Transforms many axis aligned bounding boxes like transformBoxEx()
+			/** \param boxes First box to transform.
+			\param count Amount of boxes. */
+			void transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const;
+
 			//! Multiplies this matrix by a 1x4 matrix
 			void multiplyWith1x4Matrix(T* matrix) const;
 
@@ -1182,6 +1213,53 @@ namespace core
 	}
 
 
+	template <class T>
+	inline void CMatrix4<T>::transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+		for (u32 i=0; i<count; ++i)
+			transformBoxEx(boxes[i]);
+	}
+
+
+	template <class T>
+	inline void CMatrix4<T>::transformVects(vector3df* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+		{
+			const vector3df v(*(const vector3df*)src);
+			transformVect(*(vector3df*)dst, v);
+		}
+	}
+
+
+	template <class T>
+	inline void CMatrix4<T>::transformVects(T* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+			transformVect((T*)dst, *(const vector3df*)src);
+	}
+
+
+	template <class T>
+	inline void CMatrix4<T>::rotateVects(vector3df* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+		{
+			const vector3df v(*(const vector3df*)src);
+			rotateVect(*(vector3df*)dst, v);
+		}
+	}
+
+
 	//! Multiplies this matrix by a 1x4 matrix
 	template <class T>
 	inline void CMatrix4<T>::multiplyWith1x4Matrix(T* matrix) const
@@ -2109,6 +2187,314 @@ namespace core
 		return true;
 	}
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	// SSE2 versions of the most used f32 operations. The products are summed
+	// in the same order as in the generic code, so the results are the same
+	// except for the inverse. Matrices are not aligned to 16 bytes when they
+	// are stored in arrays, so all loads and stores are unaligned.
+
+	template <>
+	inline CMatrix4<f32>& CMatrix4<f32>::setbyproduct_nocheck(const CMatrix4<f32>& other_a,const CMatrix4<f32>& other_b )
+	{
+		const __m128 a0 = _mm_loadu_ps(other_a.M);
+		const __m128 a1 = _mm_loadu_ps(other_a.M+4);
+		const __m128 a2 = _mm_loadu_ps(other_a.M+8);
+		const __m128 a3 = _mm_loadu_ps(other_a.M+12);
+
+		// other_b may be this matrix, so it is loaded completely before storing
+		__m128 r0 = _mm_loadu_ps(other_b.M);
+		__m128 r1 = _mm_loadu_ps(other_b.M+4);
+		__m128 r2 = _mm_loadu_ps(other_b.M+8);
+		__m128 r3 = _mm_loadu_ps(other_b.M+12);
+
+#define _IRR_MATRIX_ROW_SSE2(r) _mm_add_ps(_mm_add_ps(_mm_add_ps( \
+			_mm_mul_ps(a0, _mm_shuffle_ps(r, r, 0x00)), \
+			_mm_mul_ps(a1, _mm_shuffle_ps(r, r, 0x55))), \
+			_mm_mul_ps(a2, _mm_shuffle_ps(r, r, 0xAA))), \
+			_mm_mul_ps(a3, _mm_shuffle_ps(r, r, 0xFF)))
+
+		r0 = _IRR_MATRIX_ROW_SSE2(r0);
+		r1 = _IRR_MATRIX_ROW_SSE2(r1);
+		r2 = _IRR_MATRIX_ROW_SSE2(r2);
+		r3 = _IRR_MATRIX_ROW_SSE2(r3);
+
+#undef _IRR_MATRIX_ROW_SSE2
+
+		_mm_storeu_ps(M, r0);
+		_mm_storeu_ps(M+4, r1);
+		_mm_storeu_ps(M+8, r2);
+		_mm_storeu_ps(M+12, r3);
+#if defined ( USE_MATRIX_TEST )
+		definitelyIdentityMatrix=false;
+#endif
+		return *this;
+	}
+
+
+	template <>
+	inline CMatrix4<f32> CMatrix4<f32>::operator*(const CMatrix4<f32>& m2) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		// Testing purpose..
+		if ( this->isIdentity() )
+			return m2;
+		if ( m2.isIdentity() )
+			return *this;
+#endif
+
+		CMatrix4<f32> m3 ( EM4CONST_NOTHING );
+		m3.setbyproduct_nocheck(*this, m2);
+		return m3;
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformVects(vector3df* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+		const __m128 r3 = _mm_loadu_ps(M+12);
+
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+		{
+			const f32* v = (const f32*)src;
+			const __m128 p = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(v[0]), r0),
+				_mm_mul_ps(_mm_set1_ps(v[1]), r1)),
+				_mm_mul_ps(_mm_set1_ps(v[2]), r2)), r3);
+
+			// only write three floats, the vector may be part of a vertex
+			f32* d = (f32*)dst;
+			_mm_storel_pi((__m64*)d, p);
+			_mm_store_ss(d+2, _mm_movehl_ps(p, p));
+		}
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformVects(f32* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+		const __m128 r3 = _mm_loadu_ps(M+12);
+
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+		{
+			const f32* v = (const f32*)src;
+			_mm_storeu_ps((f32*)dst, _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(v[0]), r0),
+				_mm_mul_ps(_mm_set1_ps(v[1]), r1)),
+				_mm_mul_ps(_mm_set1_ps(v[2]), r2)), r3));
+		}
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::rotateVects(vector3df* out, const vector3df* in, u32 count,
+		u32 inStride, u32 outStride) const
+	{
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+
+		const u8* src = (const u8*)in;
+		u8* dst = (u8*)out;
+		for (u32 i=0; i<count; ++i, src+=inStride, dst+=outStride)
+		{
+			const f32* v = (const f32*)src;
+			const __m128 p = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(v[0]), r0),
+				_mm_mul_ps(_mm_set1_ps(v[1]), r1)),
+				_mm_mul_ps(_mm_set1_ps(v[2]), r2));
+
+			f32* d = (f32*)dst;
+			_mm_storel_pi((__m64*)d, p);
+			_mm_store_ss(d+2, _mm_movehl_ps(p, p));
+		}
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformVect( vector3df& vect) const
+	{
+		transformVects(&vect, &vect, 1);
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformVect( vector3df& out, const vector3df& in) const
+	{
+		transformVects(&out, &in, 1);
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformVect(f32 *out, const vector3df &in) const
+	{
+		transformVects(out, &in, 1);
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformBoxesEx(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if (isIdentity())
+			return;
+#endif
+
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+		const __m128 r3 = _mm_loadu_ps(M+12);
+
+		for (u32 i=0; i<count; ++i)
+		{
+			f32* minEdge = &boxes[i].MinEdge.X;
+			f32* maxEdge = &boxes[i].MaxEdge.X;
+			__m128 bmin = r3;
+			__m128 bmax = r3;
+
+			__m128 a = _mm_mul_ps(r0, _mm_set1_ps(minEdge[0]));
+			__m128 b = _mm_mul_ps(r0, _mm_set1_ps(maxEdge[0]));
+			bmin = _mm_add_ps(bmin, _mm_min_ps(a, b));
+			bmax = _mm_add_ps(bmax, _mm_max_ps(b, a));
+
+			a = _mm_mul_ps(r1, _mm_set1_ps(minEdge[1]));
+			b = _mm_mul_ps(r1, _mm_set1_ps(maxEdge[1]));
+			bmin = _mm_add_ps(bmin, _mm_min_ps(a, b));
+			bmax = _mm_add_ps(bmax, _mm_max_ps(b, a));
+
+			a = _mm_mul_ps(r2, _mm_set1_ps(minEdge[2]));
+			b = _mm_mul_ps(r2, _mm_set1_ps(maxEdge[2]));
+			bmin = _mm_add_ps(bmin, _mm_min_ps(a, b));
+			bmax = _mm_add_ps(bmax, _mm_max_ps(b, a));
+
+			_mm_storel_pi((__m64*)minEdge, bmin);
+			_mm_store_ss(minEdge+2, _mm_movehl_ps(bmin, bmin));
+			_mm_storel_pi((__m64*)maxEdge, bmax);
+			_mm_store_ss(maxEdge+2, _mm_movehl_ps(bmax, bmax));
+		}
+	}
+
+
+	template <>
+	inline void CMatrix4<f32>::transformBoxEx(core::aabbox3d<f32>& box) const
+	{
+		transformBoxesEx(&box, 1);
+	}
+
+
+	//! Calculates the inverse with the cofactors of 2x2 sub matrices
+	/** Based on Intel's "Streaming SIMD Extensions - Inverse of 4x4 Matrix". */
+	template <>
+	inline bool CMatrix4<f32>::getInverse(CMatrix4<f32>& out) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if ( this->isIdentity() )
+		{
+			out=*this;
+			return true;
+		}
+#endif
+		__m128 minor0, minor1, minor2, minor3;
+		__m128 row0, row1, row2, row3;
+		__m128 det, tmp1;
+
+		// transpose while loading
+		tmp1 = _mm_loadu_ps(M);
+		row1 = _mm_loadu_ps(M+4);
+		row2 = _mm_loadu_ps(M+8);
+		row3 = _mm_loadu_ps(M+12);
+		row0 = _mm_shuffle_ps(_mm_movelh_ps(tmp1, row1), _mm_movelh_ps(row2, row3), 0x88);
+		const __m128 r1 = _mm_shuffle_ps(_mm_movelh_ps(row2, row3), _mm_movelh_ps(tmp1, row1), 0xDD);
+		const __m128 r2 = _mm_shuffle_ps(_mm_movehl_ps(row1, tmp1), _mm_movehl_ps(row3, row2), 0x88);
+		row3 = _mm_shuffle_ps(_mm_movehl_ps(row3, row2), _mm_movehl_ps(row1, tmp1), 0xDD);
+		row1 = r1;
+		row2 = r2;
+
+		tmp1 = _mm_mul_ps(row2, row3);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		minor0 = _mm_mul_ps(row1, tmp1);
+		minor1 = _mm_mul_ps(row0, tmp1);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp1), minor0);
+		minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor1);
+		minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+		tmp1 = _mm_mul_ps(row1, row2);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor0);
+		minor3 = _mm_mul_ps(row0, tmp1);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp1));
+		minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor3);
+		minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+		tmp1 = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+		minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor0);
+		minor2 = _mm_mul_ps(row0, tmp1);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp1));
+		minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor2);
+		minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+		tmp1 = _mm_mul_ps(row0, row1);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor2);
+		minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp1), minor3);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp1), minor2);
+		minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp1));
+
+		tmp1 = _mm_mul_ps(row0, row3);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp1));
+		minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor2);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor1);
+		minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp1));
+
+		tmp1 = _mm_mul_ps(row0, row2);
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+		minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor1);
+		minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp1));
+		tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+		minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp1));
+		minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor3);
+
+		det = _mm_mul_ps(row0, minor0);
+		det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+		det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+
+		f32 d = _mm_cvtss_f32(det);
+		if( core::iszero ( d ) )
+			return false;
+
+		det = _mm_set1_ps(core::reciprocal ( d ));
+
+		_mm_storeu_ps(out.M, _mm_mul_ps(det, minor0));
+		_mm_storeu_ps(out.M+4, _mm_mul_ps(det, minor1));
+		_mm_storeu_ps(out.M+8, _mm_mul_ps(det, minor2));
+		_mm_storeu_ps(out.M+12, _mm_mul_ps(det, minor3));
+
+#if defined ( USE_MATRIX_TEST )
+		out.definitelyIdentityMatrix = definitelyIdentityMatrix;
+#endif
+		return true;
+	}
+#endif // _IRR_COMPILE_WITH_SSE2_
+
 
 	// Multiply by scalar.
 	template <class T>
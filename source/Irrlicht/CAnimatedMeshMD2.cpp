@@ -18,173 +18,6 @@ const s32 MD2_FRAME_SHIFT	= 2;
 const f32 MD2_FRAME_SHIFT_RECIPROCAL = 1.f / ( 1 << MD2_FRAME_SHIFT );
 
 
-const s32 Q2_VERTEX_NORMAL_TABLE_SIZE = 162;
-
-static const f32 Q2_VERTEX_NORMAL_TABLE[Q2_VERTEX_NORMAL_TABLE_SIZE][3] = {
-	{-0.525731f, 0.000000f, 0.850651f},
-	{-0.442863f, 0.238856f, 0.864188f},
-	{-0.295242f, 0.000000f, 0.955423f},
-	{-0.309017f, 0.500000f, 0.809017f},
-	{-0.162460f, 0.262866f, 0.951056f},
-	{0.000000f, 0.000000f, 1.000000f},
-	{0.000000f, 0.850651f, 0.525731f},
-	{-0.147621f, 0.716567f, 0.681718f},
-	{0.147621f, 0.716567f, 0.681718f},
-	{0.000000f, 0.525731f, 0.850651f},
-	{0.309017f, 0.500000f, 0.809017f},
-	{0.525731f, 0.000000f, 0.850651f},
-	{0.295242f, 0.000000f, 0.955423f},
-	{0.442863f, 0.238856f, 0.864188f},
-	{0.162460f, 0.262866f, 0.951056f},
-	{-0.681718f, 0.147621f, 0.716567f},
-	{-0.809017f, 0.309017f, 0.500000f},
-	{-0.587785f, 0.425325f, 0.688191f},
-	{-0.850651f, 0.525731f, 0.000000f},
-	{-0.864188f, 0.442863f, 0.238856f},
-	{-0.716567f, 0.681718f, 0.147621f},
-	{-0.688191f, 0.587785f, 0.425325f},
-	{-0.500000f, 0.809017f, 0.309017f},
-	{-0.238856f, 0.864188f, 0.442863f},
-	{-0.425325f, 0.688191f, 0.587785f},
-	{-0.716567f, 0.681718f, -0.147621f},
-	{-0.500000f, 0.809017f, -0.309017f},
-	{-0.525731f, 0.850651f, 0.000000f},
-	{0.000000f, 0.850651f, -0.525731f},
-	{-0.238856f, 0.864188f, -0.442863f},
-	{0.000000f, 0.955423f, -0.295242f},
-	{-0.262866f, 0.951056f, -0.162460f},
-	{0.000000f, 1.000000f, 0.000000f},
-	{0.000000f, 0.955423f, 0.295242f},
-	{-0.262866f, 0.951056f, 0.162460f},
-	{0.238856f, 0.864188f, 0.442863f},
-	{0.262866f, 0.951056f, 0.162460f},
-	{0.500000f, 0.809017f, 0.309017f},
-	{0.238856f, 0.864188f, -0.442863f},
-	{0.262866f, 0.951056f, -0.162460f},
-	{0.500000f, 0.809017f, -0.309017f},
-	{0.850651f, 0.525731f, 0.000000f},
-	{0.716567f, 0.681718f, 0.147621f},
-	{0.716567f, 0.681718f, -0.147621f},
-	{0.525731f, 0.850651f, 0.000000f},
-	{0.425325f, 0.688191f, 0.587785f},
-	{0.864188f, 0.442863f, 0.238856f},
-	{0.688191f, 0.587785f, 0.425325f},
-	{0.809017f, 0.309017f, 0.500000f},
-	{0.681718f, 0.147621f, 0.716567f},
-	{0.587785f, 0.425325f, 0.688191f},
-	{0.955423f, 0.295242f, 0.000000f},
-	{1.000000f, 0.000000f, 0.000000f},
-	{0.951056f, 0.162460f, 0.262866f},
-	{0.850651f, -0.525731f, 0.000000f},
-	{0.955423f, -0.295242f, 0.000000f},
-	{0.864188f, -0.442863f, 0.238856f},
-	{0.951056f, -0.162460f, 0.262866f},
-	{0.809017f, -0.309017f, 0.500000f},
-	{0.681718f, -0.147621f, 0.716567f},
-	{0.850651f, 0.000000f, 0.525731f},
-	{0.864188f, 0.442863f, -0.238856f},
-	{0.809017f, 0.309017f, -0.500000f},
-	{0.951056f, 0.162460f, -0.262866f},
-	{0.525731f, 0.000000f, -0.850651f},
-	{0.681718f, 0.147621f, -0.716567f},
-	{0.681718f, -0.147621f, -0.716567f},
-	{0.850651f, 0.000000f, -0.525731f},
-	{0.809017f, -0.309017f, -0.500000f},
-	{0.864188f, -0.442863f, -0.238856f},
-	{0.951056f, -0.162460f, -0.262866f},
-	{0.147621f, 0.716567f, -0.681718f},
-	{0.309017f, 0.500000f, -0.809017f},
-	{0.425325f, 0.688191f, -0.587785f},
-	{0.442863f, 0.238856f, -0.864188f},
-	{0.587785f, 0.425325f, -0.688191f},
-	{0.688191f, 0.587785f, -0.425325f},
-	{-0.147621f, 0.716567f, -0.681718f},
-	{-0.309017f, 0.500000f, -0.809017f},
-	{0.000000f, 0.525731f, -0.850651f},
-	{-0.525731f, 0.000000f, -0.850651f},
-	{-0.442863f, 0.238856f, -0.864188f},
-	{-0.295242f, 0.000000f, -0.955423f},
-	{-0.162460f, 0.262866f, -0.951056f},
-	{0.000000f, 0.000000f, -1.000000f},
-	{0.295242f, 0.000000f, -0.955423f},
-	{0.162460f, 0.262866f, -0.951056f},
-	{-0.442863f, -0.238856f, -0.864188f},
-	{-0.309017f, -0.500000f, -0.809017f},
-	{-0.162460f, -0.262866f, -0.951056f},
-	{0.000000f, -0.850651f, -0.525731f},
-	{-0.147621f, -0.716567f, -0.681718f},
-	{0.147621f, -0.716567f, -0.681718f},
-	{0.000000f, -0.525731f, -0.850651f},
-	{0.309017f, -0.500000f, -0.809017f},
-	{0.442863f, -0.238856f, -0.864188f},
-	{0.162460f, -0.262866f, -0.951056f},
-	{0.238856f, -0.864188f, -0.442863f},
-	{0.500000f, -0.809017f, -0.309017f},
-	{0.425325f, -0.688191f, -0.587785f},
-	{0.716567f, -0.681718f, -0.147621f},
-	{0.688191f, -0.587785f, -0.425325f},
-	{0.587785f, -0.425325f, -0.688191f},
-	{0.000000f, -0.955423f, -0.295242f},
-	{0.000000f, -1.000000f, 0.000000f},
-	{0.262866f, -0.951056f, -0.162460f},
-	{0.000000f, -0.850651f, 0.525731f},
-	{0.000000f, -0.955423f, 0.295242f},
-	{0.238856f, -0.864188f, 0.442863f},
-	{0.262866f, -0.951056f, 0.162460f},
-	{0.500000f, -0.809017f, 0.309017f},
-	{0.716567f, -0.681718f, 0.147621f},
-	{0.525731f, -0.850651f, 0.000000f},
-	{-0.238856f, -0.864188f, -0.442863f},
-	{-0.500000f, -0.809017f, -0.309017f},
-	{-0.262866f, -0.951056f, -0.162460f},
-	{-0.850651f, -0.525731f, 0.000000f},
-	{-0.716567f, -0.681718f, -0.147621f},
-	{-0.716567f, -0.681718f, 0.147621f},
-	{-0.525731f, -0.850651f, 0.000000f},
-	{-0.500000f, -0.809017f, 0.309017f},
-	{-0.238856f, -0.864188f, 0.442863f},
-	{-0.262866f, -0.951056f, 0.162460f},
-	{-0.864188f, -0.442863f, 0.238856f},
-	{-0.809017f, -0.309017f, 0.500000f},
-	{-0.688191f, -0.587785f, 0.425325f},
-	{-0.681718f, -0.147621f, 0.716567f},
-	{-0.442863f, -0.238856f, 0.864188f},
-	{-0.587785f, -0.425325f, 0.688191f},
-	{-0.309017f, -0.500000f, 0.809017f},
-	{-0.147621f, -0.716567f, 0.681718f},
-	{-0.425325f, -0.688191f, 0.587785f},
-	{-0.162460f, -0.262866f, 0.951056f},
-	{0.442863f, -0.238856f, 0.864188f},
-	{0.162460f, -0.262866f, 0.951056f},
-	{0.309017f, -0.500000f, 0.809017f},
-	{0.147621f, -0.716567f, 0.681718f},
-	{0.000000f, -0.525731f, 0.850651f},
-	{0.425325f, -0.688191f, 0.587785f},
-	{0.587785f, -0.425325f, 0.688191f},
-	{0.688191f, -0.587785f, 0.425325f},
-	{-0.955423f, 0.295242f, 0.000000f},
-	{-0.951056f, 0.162460f, 0.262866f},
-	{-1.000000f, 0.000000f, 0.000000f},
-	{-0.850651f, 0.000000f, 0.525731f},
-	{-0.955423f, -0.295242f, 0.000000f},
-	{-0.951056f, -0.162460f, 0.262866f},
-	{-0.864188f, 0.442863f, -0.238856f},
-	{-0.951056f, 0.162460f, -0.262866f},
-	{-0.809017f, 0.309017f, -0.500000f},
-	{-0.864188f, -0.442863f, -0.238856f},
-	{-0.951056f, -0.162460f, -0.262866f},
-	{-0.809017f, -0.309017f, -0.500000f},
-	{-0.681718f, 0.147621f, -0.716567f},
-	{-0.681718f, -0.147621f, -0.716567f},
-	{-0.850651f, 0.000000f, -0.525731f},
-	{-0.688191f, 0.587785f, -0.425325f},
-	{-0.587785f, 0.425325f, -0.688191f},
-	{-0.425325f, 0.688191f, -0.587785f},
-	{-0.425325f, -0.688191f, -0.587785f},
-	{-0.587785f, -0.425325f, -0.688191f},
-	{-0.688191f, -0.587785f, -0.425325f},
-	};
-
 struct SMD2AnimationType
 {
 	s32 begin;
@@ -257,7 +90,13 @@ IMesh* CAnimatedMeshMD2::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		endFrameLoop = getFrameCount();
 	}
 
+	// nodes showing the same frame share the interpolated result
+	const SCacheInfo candidate(frame, startFrameLoop, endFrameLoop);
+	if (candidate == Current)
+		return this;
+
 	updateInterpolationBuffer(frame, startFrameLoop, endFrameLoop);
+	Current = candidate;
 	return this;
 }
 
@@ -294,7 +133,6 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 {
 	u32 firstFrame, secondFrame;
 	f32 div;
-	core::vector3df* NormalTable = (core::vector3df*)&Q2_VERTEX_NORMAL_TABLE;
 
 	// TA: resolve missing ipol in loop between end-start
 
@@ -321,29 +159,10 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 		div = frame * MD2_FRAME_SHIFT_RECIPROCAL;
 	}
 
-	video::S3DVertex* target = static_cast<video::S3DVertex*>(InterpolationBuffer->getVertices());
-	SMD2Vert*         first  = FrameList[firstFrame].pointer();
-	SMD2Vert*         second = FrameList[secondFrame].pointer();
-
 	// interpolate both frames
-	const u32 count = FrameList[firstFrame].size();
-	for (u32 i=0; i<count; ++i)
-	{
-		core::vector3df one, two;
-		one.X = f32(first->Pos.X) * FrameTransforms[firstFrame].scale.X + FrameTransforms[firstFrame].translate.X;
-		one.Y = f32(first->Pos.Y) * FrameTransforms[firstFrame].scale.Y + FrameTransforms[firstFrame].translate.Y;
-		one.Z = f32(first->Pos.Z) * FrameTransforms[firstFrame].scale.Z + FrameTransforms[firstFrame].translate.Z;
-		two.X = f32(second->Pos.X) * FrameTransforms[secondFrame].scale.X + FrameTransforms[secondFrame].translate.X;
-		two.Y = f32(second->Pos.Y) * FrameTransforms[secondFrame].scale.Y + FrameTransforms[secondFrame].translate.Y;
-		two.Z = f32(second->Pos.Z) * FrameTransforms[secondFrame].scale.Z + FrameTransforms[secondFrame].translate.Z;
-		target->Pos    = (two - one) * div + one;
-
-		target->Normal = (NormalTable[second->NormalIdx] - NormalTable[first->NormalIdx]) * div 
-			           +  NormalTable[first->NormalIdx];
-		++target;
-		++first;
-		++second;
-	}
+	interpolateFrameVertices(static_cast<video::S3DVertex*>(InterpolationBuffer->getVertices()),
+		FrameList[firstFrame].const_pointer(), FrameList[secondFrame].const_pointer(),
+		FrameVertexIndices.const_pointer(), FrameVertexIndices.size(), div);
 
 	//update bounding box
 	InterpolationBuffer->setBoundingBox(BoxList[secondFrame].getInterpolated(BoxList[firstFrame], div));
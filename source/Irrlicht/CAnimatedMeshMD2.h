@@ -10,6 +10,7 @@
 #include "CMeshBuffer.h"
 #include "IReadFile.h"
 #include "S3DVertex.h"
+#include "SFrameVertex.h"
 #include "irrArray.h"
 #include "irrString.h"
 
@@ -96,26 +97,12 @@ namespace scene
 			s32 fps;
 		};
 
-		//! scale and translations for keyframes
-		struct SKeyFrameTransform
-		{
-			core::vector3df scale;
-			core::vector3df translate;
-		};
+		//! keyframe vertex data, decoded by the loader
+		core::array<SFrameVertex> *FrameList;
 
-		//! md2 vertex data
-		struct SMD2Vert
-		{
-			core::vector3d<u8> Pos;
-			u8                 NormalIdx;
-		};
+		//! index into the keyframe vertices for each vertex of the interpolation buffer
+		core::array<u16> FrameVertexIndices;
 
-		//! keyframe transformations
-		core::array<SKeyFrameTransform> FrameTransforms; 
-
-		//! keyframe vertex data
-		core::array<SMD2Vert> *FrameList;
-		
 		//! bounding boxes for each keyframe
 		core::array<core::aabbox3d<f32> > BoxList;
 
@@ -129,6 +116,23 @@ namespace scene
 		//! updates the interpolation buffer
 		void updateInterpolationBuffer(s32 frame, s32 startFrame, s32 endFrame);
 
+		//! frame and loop the interpolation buffer was last updated for
+		struct SCacheInfo
+		{
+			SCacheInfo ( s32 frame = -1, s32 start = -1, s32 end = -1 )
+				:	Frame ( frame ), startFrameLoop ( start ),
+					endFrameLoop ( end ) {}
+
+			bool operator == ( const SCacheInfo &other ) const
+			{
+				return Frame == other.Frame && startFrameLoop == other.startFrameLoop &&
+					endFrameLoop == other.endFrameLoop;
+			}
+			s32 Frame;
+			s32 startFrameLoop;
+			s32 endFrameLoop;
+		};
+		SCacheInfo Current;
 
 	};
 
@@ -177,6 +177,7 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 	{
 		buildVertexArray(frameA, frameB, iPol,
 					Mesh->Buffer[i],
+					FrameVertices[i],
 					(SMeshBufferLightMap*) MeshIPol.getMeshBuffer(i)
 				);
 	}
@@ -231,36 +232,46 @@ IMeshBuffer * CAnimatedMeshMD3::createMeshBuffer(const SMD3MeshBuffer* source,
 }
 
 
-//! build final mesh's vertices from frames frameA and frameB with linear interpolation.
-void CAnimatedMeshMD3::buildVertexArray ( u32 frameA, u32 frameB, f32 interpolate,
-						const SMD3MeshBuffer * source,
-						SMeshBufferLightMap * dest
-					)
+//! decode the compressed vertices of all frames of a MD3 MeshBuffer
+void CAnimatedMeshMD3::decodeFrameVertices ( const SMD3MeshBuffer * source,
+						core::array< SFrameVertex > &dest )
 {
-	const u32 frameOffsetA = frameA * source->MeshHeader.numVertices;
-	const u32 frameOffsetB = frameB * source->MeshHeader.numVertices;
 	const f32 scale = ( 1.f/ 64.f );
 
-	for (s32 i = 0; i != source->MeshHeader.numVertices; ++i)
+	dest.set_used ( source->Vertices.size () );
+	for ( u32 i = 0; i != source->Vertices.size (); ++i )
 	{
-		video::S3DVertex2TCoords &v = dest->Vertices [ i ];
-
-		const SMD3Vertex &vA = source->Vertices [ frameOffsetA + i ];
-		const SMD3Vertex &vB = source->Vertices [ frameOffsetB + i ];
+		const SMD3Vertex &v = source->Vertices [ i ];
+		SFrameVertex &d = dest [ i ];
 
 		// position
-		v.Pos.X = scale * ( vA.position[0] + interpolate * ( vB.position[0] - vA.position[0] ) );
-		v.Pos.Y = scale * ( vA.position[2] + interpolate * ( vB.position[2] - vA.position[2] ) );
-		v.Pos.Z = scale * ( vA.position[1] + interpolate * ( vB.position[1] - vA.position[1] ) );
+		d.Pos.X = scale * v.position[0];
+		d.Pos.Y = scale * v.position[2];
+		d.Pos.Z = scale * v.position[1];
 
 		// normal
-		const core::vector3df nA( quake3::getMD3Normal ( vA.normal[0], vA.normal[1] ));
-		const core::vector3df nB( quake3::getMD3Normal ( vB.normal[0], vB.normal[1] ));
-
-		v.Normal.X = nA.X + interpolate * ( nB.X - nA.X );
-		v.Normal.Y = nA.Z + interpolate * ( nB.Z - nA.Z );
-		v.Normal.Z = nA.Y + interpolate * ( nB.Y - nA.Y );
+		const core::vector3df n( quake3::getMD3Normal ( v.normal[0], v.normal[1] ));
+		d.Normal.X = n.X;
+		d.Normal.Y = n.Z;
+		d.Normal.Z = n.Y;
 	}
+}
+
+
+//! build final mesh's vertices from frames frameA and frameB with linear interpolation.
+void CAnimatedMeshMD3::buildVertexArray ( u32 frameA, u32 frameB, f32 interpolate,
+						const SMD3MeshBuffer * source,
+						const core::array< SFrameVertex > &frames,
+						SMeshBufferLightMap * dest
+					)
+{
+	const u32 frameOffsetA = frameA * source->MeshHeader.numVertices;
+	const u32 frameOffsetB = frameB * source->MeshHeader.numVertices;
+
+	interpolateFrameVertices ( dest->Vertices.pointer (),
+			frames.const_pointer () + frameOffsetA,
+			frames.const_pointer () + frameOffsetB,
+			0, source->MeshHeader.numVertices, interpolate );
 
 	dest->recalculateBoundingBox ();
 }
@@ -411,6 +422,9 @@ bool CAnimatedMeshMD3::loadModelFile( u32 modelIndex, io::IReadFile* file,
 		IMeshBuffer * buffer = createMeshBuffer ( Mesh->Buffer[i], fs, driver );
 		MeshIPol.addMeshBuffer ( buffer );
 		buffer->drop ();
+
+		FrameVertices.push_back ( core::array< SFrameVertex > () );
+		decodeFrameVertices ( Mesh->Buffer[i], FrameVertices.getLast () );
 	}
 	MeshIPol.recalculateBoundingBox ();
 
@@ -13,6 +13,7 @@
 #include "SMesh.h"
 #include "SMeshBuffer.h"
 #include "IQ3Shader.h"
+#include "SFrameVertex.h"
 
 namespace irr
 {
@@ -118,10 +119,16 @@ namespace scene
 		SMesh MeshIPol;
 		SMD3QuaternionTagList TagListIPol;
 
+		//! decoded vertices of all frames, one array per MD3 MeshBuffer
+		core::array< core::array< SFrameVertex > > FrameVertices;
+
 		IMeshBuffer * createMeshBuffer ( const SMD3MeshBuffer *source, io::IFileSystem* fs, video::IVideoDriver * driver );
 
+		void decodeFrameVertices ( const SMD3MeshBuffer * source, core::array< SFrameVertex > &dest );
+
 		void buildVertexArray ( u32 frameA, u32 frameB, f32 interpolate,
 								const SMD3MeshBuffer * source,
+								const core::array< SFrameVertex > &frames,
 								SMeshBufferLightMap * dest
 							);
 
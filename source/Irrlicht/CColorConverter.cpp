@@ -7,6 +7,10 @@
 #include "os.h"
 #include "irrString.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace video
@@ -524,6 +528,13 @@ void CColorConverter::convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP)
 void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 				void* dP, ECOLOR_FORMAT dF)
 {
+	// blocks of compressed pixels are converted with decompressDXT and compressDXT
+	if (IImage::isCompressedFormat(sF) || IImage::isCompressedFormat(dF))
+	{
+		os::Printer::log("convert_viaFormat cannot convert compressed pixels", ELL_ERROR);
+		return;
+	}
+
 	switch (sF)
 	{
 		case ECF_A1R5G5B5:
@@ -541,6 +552,8 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A1R5G5B5toR8G8B8(sP, sN, dP);
 				break;
+				default:
+				break;
 			}
 		break;
 		case ECF_R5G6B5:
@@ -558,6 +571,8 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R5G6B5toR8G8B8(sP, sN, dP);
 				break;
+				default:
+				break;
 			}
 		break;
 		case ECF_A8R8G8B8:
@@ -575,6 +590,8 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A8R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				default:
+				break;
 			}
 		break;
 		case ECF_R8G8B8:
@@ -592,9 +609,628 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				default:
+				break;
 			}
 		break;
+		default:
+		break;
+	}
+}
+
+
+//! expands a R5G6B5 color of a DXT block to A8R8G8B8
+static inline u32 expandDXTColor(u32 c)
+{
+	const u32 r = (c >> 11) & 0x1F;
+	const u32 g = (c >> 5) & 0x3F;
+	const u32 b = c & 0x1F;
+	return 0xFF000000 | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+}
+
+
+//! mixes two colors of a DXT palette
+static inline u32 mixDXTColor(u32 c0, u32 c1, u32 w0, u32 w1)
+{
+	const u32 div = w0 + w1;
+	const u32 r = (((c0 >> 16) & 0xFF) * w0 + ((c1 >> 16) & 0xFF) * w1) / div;
+	const u32 g = (((c0 >> 8) & 0xFF) * w0 + ((c1 >> 8) & 0xFF) * w1) / div;
+	const u32 b = ((c0 & 0xFF) * w0 + (c1 & 0xFF) * w1) / div;
+	return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+
+//! the four colors of a DXT color block
+/** Blocks with the first end point not above the second one have three
+colors and a transparent black. DXT5 blocks always have four colors. */
+static void getDXTPalette(u32 c0, u32 c1, bool fourColors, u32* palette)
+{
+	palette[0] = expandDXTColor(c0);
+	palette[1] = expandDXTColor(c1);
+	if (fourColors || c0 > c1)
+	{
+		palette[2] = mixDXTColor(palette[0], palette[1], 2, 1);
+		palette[3] = mixDXTColor(palette[0], palette[1], 1, 2);
+	}
+	else
+	{
+		palette[2] = mixDXTColor(palette[0], palette[1], 1, 1);
+		palette[3] = 0;
+	}
+}
+
+
+//! the eight alpha values of a DXT5 alpha block
+static void getDXTAlphaPalette(u32 a0, u32 a1, u32* palette)
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1)
+	{
+		for (u32 i=1; i<7; ++i)
+			palette[i+1] = ((7 - i) * a0 + i * a1) / 7;
+	}
+	else
+	{
+		for (u32 i=1; i<5; ++i)
+			palette[i+1] = ((5 - i) * a0 + i * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+
+//! squared distance of two colors
+static inline u32 getDXTDistance(u32 c0, u32 c1)
+{
+	const s32 r = (s32)((c0 >> 16) & 0xFF) - (s32)((c1 >> 16) & 0xFF);
+	const s32 g = (s32)((c0 >> 8) & 0xFF) - (s32)((c1 >> 8) & 0xFF);
+	const s32 b = (s32)(c0 & 0xFF) - (s32)(c1 & 0xFF);
+	return r * r + g * g + b * b;
+}
+
+
+//! compresses 16 A8R8G8B8 colors into a DXT1 or DXT5 block
+/** The end points lie on the principal axis through the mean of the colors,
+at the outermost projected colors inset a little to use the range better,
+and each pixel takes the nearest color in between. */
+static void compressDXTBlock(const u32* colors, ECOLOR_FORMAT format, u8* block)
+{
+	u32 i;
+
+	if (format == ECF_DXT5)
+	{
+		u32 minA = 255;
+		u32 maxA = 0;
+		for (i=0; i<16; ++i)
+		{
+			const u32 a = colors[i] >> 24;
+			minA = core::min_(minA, a);
+			maxA = core::max_(maxA, a);
+		}
+
+		u32 palette[8];
+		getDXTAlphaPalette(maxA, minA, palette);
+
+		block[0] = (u8)maxA;
+		block[1] = (u8)minA;
+		for (u32 half=0; half<2; ++half)
+		{
+			u32 bits = 0;
+			for (i=0; i<8; ++i)
+			{
+				const s32 a = colors[half * 8 + i] >> 24;
+				u32 best = 0;
+				for (u32 j=1; j<8; ++j)
+				{
+					if (core::abs_(a - (s32)palette[j]) < core::abs_(a - (s32)palette[best]))
+						best = j;
+				}
+				bits |= best << (i * 3);
+			}
+			block[2 + half * 3] = (u8)bits;
+			block[3 + half * 3] = (u8)(bits >> 8);
+			block[4 + half * 3] = (u8)(bits >> 16);
+		}
+		block += 8;
+	}
+
+	// DXT1 blocks with transparent pixels use the three color mode
+	bool transparent = false;
+	u32 count = 0;
+	f32 mean[3] = { 0.f, 0.f, 0.f };
+	for (i=0; i<16; ++i)
+	{
+		if (format == ECF_DXT1 && (colors[i] >> 24) < 128)
+		{
+			transparent = true;
+			continue;
+		}
+
+		for (u32 c=0; c<3; ++c)
+			mean[c] += (f32)((colors[i] >> (16 - c * 8)) & 0xFF);
+		++count;
+	}
+
+	u32 c0 = 0;
+	u32 c1 = 0;
+	if (count)
+	{
+		for (u32 c=0; c<3; ++c)
+			mean[c] /= (f32)count;
+
+		// covariance of the colors
+		f32 cov[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+		for (i=0; i<16; ++i)
+		{
+			if (format == ECF_DXT1 && (colors[i] >> 24) < 128)
+				continue;
+
+			const f32 r = (f32)((colors[i] >> 16) & 0xFF) - mean[0];
+			const f32 g = (f32)((colors[i] >> 8) & 0xFF) - mean[1];
+			const f32 b = (f32)(colors[i] & 0xFF) - mean[2];
+			cov[0] += r * r;
+			cov[1] += r * g;
+			cov[2] += r * b;
+			cov[3] += g * g;
+			cov[4] += g * b;
+			cov[5] += b * b;
+		}
+
+		// the principal axis by a few power iterations
+		f32 axis[3] = { 1.f, 1.f, 1.f };
+		for (u32 n=0; n<4; ++n)
+		{
+			const f32 r = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+			const f32 g = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+			const f32 b = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+			const f32 m = core::max_(core::abs_(r), core::abs_(g), core::abs_(b));
+			if (m < 1.f)
+				break;
+			axis[0] = r / m;
+			axis[1] = g / m;
+			axis[2] = b / m;
+		}
+
+		const f32 length = core::squareroot(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		for (u32 c=0; c<3; ++c)
+			axis[c] /= length;
+
+		// the outermost colors projected onto the axis
+		f32 minP = 0.f;
+		f32 maxP = 0.f;
+		for (i=0; i<16; ++i)
+		{
+			if (format == ECF_DXT1 && (colors[i] >> 24) < 128)
+				continue;
+
+			const f32 p = axis[0] * ((f32)((colors[i] >> 16) & 0xFF) - mean[0]) +
+				axis[1] * ((f32)((colors[i] >> 8) & 0xFF) - mean[1]) +
+				axis[2] * ((f32)(colors[i] & 0xFF) - mean[2]);
+			minP = core::min_(minP, p);
+			maxP = core::max_(maxP, p);
+		}
+
+		const f32 inset = (maxP - minP) / 16.f;
+		minP += inset;
+		maxP -= inset;
+
+		u32 rgb0[3];
+		u32 rgb1[3];
+		for (u32 c=0; c<3; ++c)
+		{
+			rgb0[c] = (u32)core::s32_clamp(core::round32(mean[c] + axis[c] * maxP), 0, 255);
+			rgb1[c] = (u32)core::s32_clamp(core::round32(mean[c] + axis[c] * minP), 0, 255);
+		}
+		c0 = (((rgb0[0] * 31 + 127) / 255) << 11) | (((rgb0[1] * 63 + 127) / 255) << 5) | ((rgb0[2] * 31 + 127) / 255);
+		c1 = (((rgb1[0] * 31 + 127) / 255) << 11) | (((rgb1[1] * 63 + 127) / 255) << 5) | ((rgb1[2] * 31 + 127) / 255);
+	}
+
+	if (transparent ? c0 > c1 : c0 < c1)
+		core::swap(c0, c1);
+
+	u32 palette[4];
+	getDXTPalette(c0, c1, format == ECF_DXT5, palette);
+	const u32 paletteSize = (format == ECF_DXT5 || c0 > c1) ? 4 : 3;
+
+	u32 bits = 0;
+	for (i=0; i<16; ++i)
+	{
+		u32 best = 0;
+		if (format == ECF_DXT1 && (colors[i] >> 24) < 128)
+			best = 3;
+		else
+		{
+			for (u32 j=1; j<paletteSize; ++j)
+			{
+				if (getDXTDistance(colors[i], palette[j]) < getDXTDistance(colors[i], palette[best]))
+					best = j;
+			}
+		}
+		bits |= best << (i * 2);
+	}
+
+	block[0] = (u8)c0;
+	block[1] = (u8)(c0 >> 8);
+	block[2] = (u8)c1;
+	block[3] = (u8)(c1 >> 8);
+	block[4] = (u8)bits;
+	block[5] = (u8)(bits >> 8);
+	block[6] = (u8)(bits >> 16);
+	block[7] = (u8)(bits >> 24);
+}
+
+
+//! decompresses a 4x4 block of a DXT1 or DXT5 image into 16 A8R8G8B8 colors
+void CColorConverter::decompressDXTBlock(const u8* block, ECOLOR_FORMAT format, u32* colors)
+{
+	const u8* alpha = 0;
+	if (format == ECF_DXT5)
+	{
+		alpha = block;
+		block += 8;
+	}
+
+	u32 palette[8];
+	getDXTPalette(block[0] | (block[1] << 8), block[2] | (block[3] << 8), alpha != 0, palette);
+
+	u32 bits = block[4] | (block[5] << 8) | (block[6] << 16) | ((u32)block[7] << 24);
+	u32 i;
+	for (i=0; i<16; ++i)
+	{
+		colors[i] = palette[bits & 3];
+		bits >>= 2;
+	}
+
+	if (!alpha)
+		return;
+
+	getDXTAlphaPalette(alpha[0], alpha[1], palette);
+	for (u32 half=0; half<2; ++half)
+	{
+		bits = alpha[2 + half * 3] | (alpha[3 + half * 3] << 8) | (alpha[4 + half * 3] << 16);
+		for (i=half*8; i<half*8+8; ++i)
+		{
+			colors[i] = (colors[i] & 0x00FFFFFF) | (palette[bits & 7] << 24);
+			bits >>= 3;
+		}
+	}
+}
+
+
+//! decompresses a DXT1 or DXT5 image into an uncompressed format
+void CColorConverter::decompressDXT(const void* in, ECOLOR_FORMAT inFormat, u32 width, u32 height,
+				void* out, ECOLOR_FORMAT outFormat, u32 outPitch)
+{
+	if (!in || !out)
+		return;
+
+	const u32 blockSize = (inFormat == ECF_DXT1) ? 8 : 16;
+	const u32 blocksX = (width + 3) / 4;
+	const u32 blocksY = (height + 3) / 4;
+	const u32 rowWidth = blocksX * 4;
+
+	const u8* block = (const u8*) in;
+	u32* row = new u32[rowWidth * 4];
+	u32 colors[16];
+
+	for (u32 by=0; by<blocksY; ++by)
+	{
+		for (u32 bx=0; bx<blocksX; ++bx)
+		{
+			decompressDXTBlock(block, inFormat, colors);
+			block += blockSize;
+
+			for (u32 y=0; y<4; ++y)
+				memcpy(row + y * rowWidth + bx * 4, colors + y * 4, 4 * sizeof(u32));
+		}
+
+		const u32 rows = core::min_(4u, height - by * 4);
+		for (u32 y=0; y<rows; ++y)
+			convert_viaFormat(row + y * rowWidth, ECF_A8R8G8B8, width,
+				(u8*)out + (by * 4 + y) * outPitch, outFormat);
+	}
+
+	delete [] row;
+}
+
+
+//! compresses an A8R8G8B8 image into DXT1 or DXT5
+void CColorConverter::compressDXT(const void* in, u32 width, u32 height, u32 inPitch,
+				void* out, ECOLOR_FORMAT outFormat)
+{
+	if (!in || !out || !width || !height)
+		return;
+
+	const u32 blockSize = (outFormat == ECF_DXT1) ? 8 : 16;
+	u8* block = (u8*) out;
+	u32 colors[16];
+
+	for (u32 by=0; by<height; by+=4)
+	{
+		for (u32 bx=0; bx<width; bx+=4)
+		{
+			// blocks at the border of the image repeat the last pixels
+			for (u32 y=0; y<4; ++y)
+			{
+				const u32* src = (const u32*)((const u8*)in + core::min_(by + y, height - 1) * inPitch);
+				for (u32 x=0; x<4; ++x)
+					colors[y * 4 + x] = src[core::min_(bx + x, width - 1)];
+			}
+
+			compressDXTBlock(colors, outFormat, block);
+			block += blockSize;
+		}
+	}
+}
+
+
+namespace
+{
+	//! conversions between sRGB values and linear intensities
+	/** Built once when the library is loaded, so threads creating mip
+	map levels only read them. */
+	struct SGammaTables
+	{
+		SGammaTables()
+		{
+			for (u32 i=0; i<256; ++i)
+			{
+				const f32 c = i / 255.f;
+				const f32 l = (c <= 0.04045f) ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+				SRGBToLinear[i] = (u16)core::round32(l * 65535.f);
+			}
+
+			// each entry is the sRGB value of the center of its range
+			for (u32 i=0; i<4096; ++i)
+			{
+				const f32 l = (i + 0.5f) / 4096.f;
+				const f32 c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * powf(l, 1.f / 2.4f) - 0.055f;
+				LinearToSRGB[i] = (u8)core::round32(c * 255.f);
+			}
+		}
+
+		//! linear intensities of the 8 bit sRGB values, in 16 bit
+		u16 SRGBToLinear[256];
+		//! 8 bit sRGB values of the linear intensities, in 12 bit
+		u8 LinearToSRGB[4096];
+	};
+
+	const SGammaTables GammaTables;
+}
+
+
+//! averages four A8R8G8B8 colors
+static inline u32 averageA8R8G8B8(u32 a, u32 b, u32 c, u32 d)
+{
+	// two channels at once, the sums of four channels fit into 16 bit
+	const u32 rb = (a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002;
+	const u32 ag = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) +
+			((c >> 8) & 0x00FF00FF) + ((d >> 8) & 0x00FF00FF) + 0x00020002;
+	return ((rb >> 2) & 0x00FF00FF) | (((ag >> 2) & 0x00FF00FF) << 8);
+}
+
+
+//! averages four A8R8G8B8 colors in linear space
+static inline u32 averageA8R8G8B8Linear(u32 a, u32 b, u32 c, u32 d)
+{
+	u32 result = (((a >> 24) + (b >> 24) + (c >> 24) + (d >> 24) + 2) >> 2) << 24;
+	for (u32 shift=0; shift<24; shift+=8)
+	{
+		const u32 sum = GammaTables.SRGBToLinear[(a >> shift) & 0xFF] + GammaTables.SRGBToLinear[(b >> shift) & 0xFF] +
+				GammaTables.SRGBToLinear[(c >> shift) & 0xFF] + GammaTables.SRGBToLinear[(d >> shift) & 0xFF];
+		result |= GammaTables.LinearToSRGB[sum >> 6] << shift;
 	}
+	return result;
+}
+
+
+//! averages four A1R5G5B5 colors, alpha is set if at least two of them are opaque
+static inline u16 averageA1R5G5B5(u32 a, u32 b, u32 c, u32 d)
+{
+	const u32 alpha = ((a >> 15) + (b >> 15) + (c >> 15) + (d >> 15) + 2) >> 2;
+	const u32 red = (((a >> 10) & 0x1F) + ((b >> 10) & 0x1F) + ((c >> 10) & 0x1F) + ((d >> 10) & 0x1F) + 2) >> 2;
+	const u32 green = (((a >> 5) & 0x1F) + ((b >> 5) & 0x1F) + ((c >> 5) & 0x1F) + ((d >> 5) & 0x1F) + 2) >> 2;
+	const u32 blue = ((a & 0x1F) + (b & 0x1F) + (c & 0x1F) + (d & 0x1F) + 2) >> 2;
+	return (u16)((alpha << 15) | (red << 10) | (green << 5) | blue);
+}
+
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+//! sums a channel of eight A1R5G5B5 pixels of two rows and then of the neighbours
+/** The four sums are returned in 32 bit lanes. */
+static inline __m128i sumA1R5G5B5Channel(const __m128i& a, const __m128i& b, const __m128i& shift, const __m128i& mask)
+{
+	const __m128i v = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(a, shift), mask),
+			_mm_and_si128(_mm_srl_epi16(b, shift), mask));
+	return _mm_and_si128(_mm_add_epi16(v, _mm_srli_epi32(v, 16)), _mm_set1_epi32(0xFFFF));
+}
+
+
+//! averages a channel of sixteen A1R5G5B5 pixels of two rows into eight pixels
+static inline __m128i averageA1R5G5B5Channel(const __m128i* a, const __m128i* b, s32 shift, u16 mask)
+{
+	const __m128i count = _mm_cvtsi32_si128(shift);
+	const __m128i m = _mm_set1_epi16(mask);
+	const __m128i sum = _mm_packs_epi32(sumA1R5G5B5Channel(a[0], b[0], count, m),
+			sumA1R5G5B5Channel(a[1], b[1], count, m));
+	return _mm_sll_epi16(_mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2), count);
+}
+#endif
+
+
+namespace
+{
+	//! a mip map level which is created in bands of rows
+	struct SMipMapLevel
+	{
+		const void* In;
+		ECOLOR_FORMAT Format;
+		u32 Width;
+		u32 Height;
+		u32 InPitch;
+		void* Out;
+		u32 OutPitch;
+		bool Gamma;
+		u32 JobCount;
+	};
+
+	//! levels with fewer pixels per thread are created on the calling thread
+	const u32 MIP_MAP_PIXELS_PER_JOB = 65536;
+}
+
+
+//! creates the rows firstRow to endRow of the next mip map level
+static void createMipMapRows(const SMipMapLevel& level, u32 firstRow, u32 endRow)
+{
+	const ECOLOR_FORMAT format = level.Format;
+	const u32 inPitch = level.InPitch;
+	const u32 outPitch = level.OutPitch;
+	const bool gamma = level.Gamma;
+	const u32 outWidth = core::max_(1u, level.Width >> 1);
+
+	// sides of a single pixel use the same pixel twice
+	const u32 dx = (level.Width > 1) ? 1 : 0;
+	const u32 dy = (level.Height > 1) ? inPitch : 0;
+
+	for (u32 y=firstRow; y<endRow; ++y)
+	{
+		const u8* row0 = (const u8*)level.In + 2 * y * inPitch;
+		const u8* row1 = row0 + dy;
+		u32 x = 0;
+
+		if (format == ECF_A8R8G8B8)
+		{
+			const u32* s0 = (const u32*)row0;
+			const u32* s1 = (const u32*)row1;
+			u32* dest = (u32*)((u8*)level.Out + y * outPitch);
+
+			if (gamma)
+			{
+				for (; x<outWidth; ++x)
+					dest[x] = averageA8R8G8B8Linear(s0[2*x], s0[2*x+dx], s1[2*x], s1[2*x+dx]);
+				continue;
+			}
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+			// four pixels of eight pairs in 16 bit lanes
+			if (dx)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i round = _mm_set1_epi16(2);
+				for (; x+4<=outWidth; x+=4)
+				{
+					const __m128i a0 = _mm_loadu_si128((const __m128i*)(s0 + 2*x));
+					const __m128i a1 = _mm_loadu_si128((const __m128i*)(s0 + 2*x + 4));
+					const __m128i b0 = _mm_loadu_si128((const __m128i*)(s1 + 2*x));
+					const __m128i b1 = _mm_loadu_si128((const __m128i*)(s1 + 2*x + 4));
+
+					// vertical sums of two pixels each
+					const __m128i v0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+					const __m128i v1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+					const __m128i v2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+					const __m128i v3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+					// add the odd to the even columns
+					__m128i h0 = _mm_add_epi16(_mm_unpacklo_epi64(v0, v1), _mm_unpackhi_epi64(v0, v1));
+					__m128i h1 = _mm_add_epi16(_mm_unpacklo_epi64(v2, v3), _mm_unpackhi_epi64(v2, v3));
+					h0 = _mm_srli_epi16(_mm_add_epi16(h0, round), 2);
+					h1 = _mm_srli_epi16(_mm_add_epi16(h1, round), 2);
+
+					_mm_storeu_si128((__m128i*)(dest + x), _mm_packus_epi16(h0, h1));
+				}
+			}
+#endif
+
+			for (; x<outWidth; ++x)
+				dest[x] = averageA8R8G8B8(s0[2*x], s0[2*x+dx], s1[2*x], s1[2*x+dx]);
+		}
+		else
+		{
+			const u16* s0 = (const u16*)row0;
+			const u16* s1 = (const u16*)row1;
+			u16* dest = (u16*)((u8*)level.Out + y * outPitch);
+
+			if (gamma)
+			{
+				for (; x<outWidth; ++x)
+					dest[x] = A8R8G8B8toA1R5G5B5(averageA8R8G8B8Linear(
+							A1R5G5B5toA8R8G8B8(s0[2*x]), A1R5G5B5toA8R8G8B8(s0[2*x+dx]),
+							A1R5G5B5toA8R8G8B8(s1[2*x]), A1R5G5B5toA8R8G8B8(s1[2*x+dx])));
+				continue;
+			}
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+			// eight pixels of sixteen pairs, each channel on its own
+			if (dx)
+			{
+				for (; x+8<=outWidth; x+=8)
+				{
+					__m128i a[2], b[2];
+					a[0] = _mm_loadu_si128((const __m128i*)(s0 + 2*x));
+					a[1] = _mm_loadu_si128((const __m128i*)(s0 + 2*x + 8));
+					b[0] = _mm_loadu_si128((const __m128i*)(s1 + 2*x));
+					b[1] = _mm_loadu_si128((const __m128i*)(s1 + 2*x + 8));
+
+					const __m128i result = _mm_or_si128(
+						_mm_or_si128(averageA1R5G5B5Channel(a, b, 15, 0x01), averageA1R5G5B5Channel(a, b, 10, 0x1F)),
+						_mm_or_si128(averageA1R5G5B5Channel(a, b, 5, 0x1F), averageA1R5G5B5Channel(a, b, 0, 0x1F)));
+
+					_mm_storeu_si128((__m128i*)(dest + x), result);
+				}
+			}
+#endif
+
+			for (; x<outWidth; ++x)
+				dest[x] = averageA1R5G5B5(s0[2*x], s0[2*x+dx], s1[2*x], s1[2*x+dx]);
+		}
+	}
+}
+
+
+//! creates a band of rows of a mip map level, runs on one of the threads
+static void createMipMapJob(void* data, u32 index)
+{
+	const SMipMapLevel& level = *(const SMipMapLevel*)data;
+	const u32 outHeight = core::max_(1u, level.Height >> 1);
+	createMipMapRows(level, outHeight * index / level.JobCount, outHeight * (index + 1) / level.JobCount);
+}
+
+
+//! creates the next mip map level of an A8R8G8B8 or A1R5G5B5 image
+void CColorConverter::createMipMapLevel(const void* in, ECOLOR_FORMAT format, u32 width, u32 height,
+				u32 inPitch, void* out, u32 outPitch, bool gamma)
+{
+	if (!in || !out || !width || !height)
+		return;
+
+	if (format != ECF_A8R8G8B8 && format != ECF_A1R5G5B5)
+	{
+		os::Printer::log("CColorConverter::createMipMapLevel unsupported color format", ELL_ERROR);
+		return;
+	}
+
+	SMipMapLevel level;
+	level.In = in;
+	level.Format = format;
+	level.Width = width;
+	level.Height = height;
+	level.InPitch = inPitch;
+	level.Out = out;
+	level.OutPitch = outPitch;
+	level.Gamma = gamma;
+
+	// large levels are split into bands of rows, one per thread
+	const u32 outHeight = core::max_(1u, height >> 1);
+	const u32 pixels = core::max_(1u, width >> 1) * outHeight;
+	level.JobCount = 1;
+	if (pixels >= 2 * MIP_MAP_PIXELS_PER_JOB)
+		level.JobCount = core::min_(pixels / MIP_MAP_PIXELS_PER_JOB, os::Threads::getProcessorCount(), outHeight);
+
+	if (level.JobCount > 1)
+		os::Threads::run(createMipMapJob, &level, level.JobCount, level.JobCount);
+	else
+		createMipMapRows(level, 0, outHeight);
 }
 
 
@@ -76,6 +76,26 @@ public:
 	static void convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP);
 	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 				void* dP, ECOLOR_FORMAT dF);
+
+	//! decompresses a 4x4 block of a DXT1 or DXT5 image into 16 A8R8G8B8 colors
+	static void decompressDXTBlock(const u8* block, ECOLOR_FORMAT format, u32* colors);
+
+	//! decompresses a DXT1 or DXT5 image into an uncompressed format
+	/** The image is decoded one row of blocks at a time. */
+	static void decompressDXT(const void* in, ECOLOR_FORMAT inFormat, u32 width, u32 height,
+				void* out, ECOLOR_FORMAT outFormat, u32 outPitch);
+
+	//! compresses an A8R8G8B8 image into DXT1 or DXT5
+	/** DXT1 keeps pixels with less than half alpha as transparent. */
+	static void compressDXT(const void* in, u32 width, u32 height, u32 inPitch,
+				void* out, ECOLOR_FORMAT outFormat);
+
+	//! creates the next mip map level of an A8R8G8B8 or A1R5G5B5 image
+	/** Each output pixel is the average of a 2x2 box of the input, so the
+	output has half the width and height, but at least one pixel. With
+	gamma set the colors are averaged in linear instead of sRGB space. */
+	static void createMipMapLevel(const void* in, ECOLOR_FORMAT format, u32 width, u32 height,
+				u32 inPitch, void* out, u32 outPitch, bool gamma=false);
 };
 
 
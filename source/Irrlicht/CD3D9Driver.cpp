@@ -636,6 +636,8 @@ bool CD3D9Driver::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 		return (Caps.PrimitiveMiscCaps & D3DPMISCCAPS_INDEPENDENTWRITEMASKS) != 0;
 	case EVDF_MRT_BLEND:
 		return (Caps.PrimitiveMiscCaps & D3DPMISCCAPS_MRTPOSTPIXELSHADERBLENDING) != 0;
+	case EVDF_INDEX_32BIT:
+		return Caps.MaxVertexIndex > 0x0000FFFF;
 	default:
 		return false;
 	};
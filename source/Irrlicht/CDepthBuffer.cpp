@@ -50,6 +50,13 @@ void CDepthBuffer::clear()
 	zMaxValue = IR(zMax);
 
 	memset32 ( Buffer, zMaxValue, TotalSize );
+
+	if ( TileDepth.size() )
+	{
+		memset32 ( TileDepth.pointer(), zMaxValue, TileDepth.size() * sizeof ( fp24 ) );
+		memset ( TileDirty.pointer(), 0, TileDirty.size() );
+	}
+	DirtyTiles.set_used ( 0 );
 }
 
 
@@ -68,6 +75,19 @@ void CDepthBuffer::setSize(const core::dimension2d<u32>& size)
 	Pitch = size.Width * sizeof ( fp24 );
 	TotalSize = Pitch * size.Height;
 	Buffer = new u8[TotalSize];
+
+	TileCount.Width = ( size.Width + ( 1 << TILE_SIZE_LOG2 ) - 1 ) >> TILE_SIZE_LOG2;
+	TileCount.Height = ( size.Height + ( 1 << TILE_SIZE_LOG2 ) - 1 ) >> TILE_SIZE_LOG2;
+	TileDepth.set_used ( TileCount.Width * TileCount.Height );
+	TileDirty.set_used ( TileCount.Width * TileCount.Height );
+
+	// the new buffer isn't cleared yet
+	DirtyTiles.set_used ( TileDirty.size() );
+	for ( u32 i = 0; i != TileDirty.size(); ++i )
+	{
+		TileDirty[i] = 1;
+		DirtyTiles[i] = i;
+	}
 }
 
 
@@ -79,6 +99,123 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 }
 
 
+//! returns if a depth value fails the depth test against all values up to the farthest one
+static inline bool isBehind(f32 nearest, fp24 farthest)
+{
+#ifdef SOFTWARE_DRIVER_2_USE_WBUFFER
+	// the rasterizers interpolate 1/w with small errors, keep some distance
+	return nearest * 1.001f < farthest;
+#else
+	return nearest >= farthest + 0.00001f;
+#endif
+}
+
+
+//! returns the tiles of an area, false if it is outside
+bool CDepthBuffer::getTiles(const core::rect<s32>& area, core::rect<s32>& tiles) const
+{
+	const s32 x0 = core::s32_max ( area.UpperLeftCorner.X, 0 );
+	const s32 y0 = core::s32_max ( area.UpperLeftCorner.Y, 0 );
+	const s32 x1 = core::s32_min ( area.LowerRightCorner.X, Size.Width );
+	const s32 y1 = core::s32_min ( area.LowerRightCorner.Y, Size.Height );
+
+	if ( x0 >= x1 || y0 >= y1 )
+		return false;
+
+	tiles.UpperLeftCorner.X = x0 >> TILE_SIZE_LOG2;
+	tiles.UpperLeftCorner.Y = y0 >> TILE_SIZE_LOG2;
+	tiles.LowerRightCorner.X = ( x1 - 1 ) >> TILE_SIZE_LOG2;
+	tiles.LowerRightCorner.Y = ( y1 - 1 ) >> TILE_SIZE_LOG2;
+	return true;
+}
+
+
+//! searches the farthest depth value of a tile
+void CDepthBuffer::updateTile(u32 x, u32 y)
+{
+	const u32 x0 = x << TILE_SIZE_LOG2;
+	const u32 y0 = y << TILE_SIZE_LOG2;
+	const u32 x1 = core::min_ ( x0 + ( 1 << TILE_SIZE_LOG2 ), Size.Width );
+	const u32 y1 = core::min_ ( y0 + ( 1 << TILE_SIZE_LOG2 ), Size.Height );
+
+	const fp24* z = (fp24*) Buffer + y0 * Size.Width;
+	fp24 farthest = z[x0];
+
+	for ( u32 j = y0; j != y1; ++j )
+	{
+		for ( u32 i = x0; i != x1; ++i )
+		{
+#ifdef SOFTWARE_DRIVER_2_USE_WBUFFER
+			if ( z[i] < farthest )
+				farthest = z[i];
+#else
+			if ( z[i] > farthest )
+				farthest = z[i];
+#endif
+		}
+		z += Size.Width;
+	}
+
+	const u32 tile = y * TileCount.Width + x;
+	TileDepth[tile] = farthest;
+	TileDirty[tile] = 0;
+}
+
+
+//! marks the depth tiles of an area as changed
+void CDepthBuffer::invalidateTiles(const core::rect<s32>& area)
+{
+	core::rect<s32> tiles;
+	if ( !getTiles ( area, tiles ) )
+		return;
+
+	for ( s32 y = tiles.UpperLeftCorner.Y; y <= tiles.LowerRightCorner.Y; ++y )
+	{
+		const u32 row = y * TileCount.Width;
+		for ( s32 x = tiles.UpperLeftCorner.X; x <= tiles.LowerRightCorner.X; ++x )
+		{
+			if ( !TileDirty[row + x] )
+			{
+				TileDirty[row + x] = 1;
+				DirtyTiles.push_back ( row + x );
+			}
+		}
+	}
+}
+
+
+//! searches the farthest depth value of all changed tiles again
+void CDepthBuffer::updateTiles()
+{
+	for ( u32 i = 0; i != DirtyTiles.size(); ++i )
+		updateTile ( DirtyTiles[i] % TileCount.Width, DirtyTiles[i] / TileCount.Width );
+
+	DirtyTiles.set_used ( 0 );
+}
+
+
+//! returns if a primitive would fail the depth test in a whole area
+bool CDepthBuffer::isOccluded(const core::rect<s32>& area, f32 nearest)
+{
+	core::rect<s32> tiles;
+	if ( !getTiles ( area, tiles ) )
+		return false;
+
+	for ( s32 y = tiles.UpperLeftCorner.Y; y <= tiles.LowerRightCorner.Y; ++y )
+	{
+		for ( s32 x = tiles.UpperLeftCorner.X; x <= tiles.LowerRightCorner.X; ++x )
+		{
+			// tiles changed by this batch may be nearer or farther now
+			const u32 tile = y * TileCount.Width + x;
+			if ( TileDirty[tile] || !isBehind ( nearest, TileDepth[tile] ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
 
 } // end namespace video
 } // end namespace irr
@@ -6,6 +6,7 @@
 #define __C_Z_BUFFER_H_INCLUDED__
 
 #include "IDepthBuffer.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -48,13 +49,37 @@ namespace video
 			return Pitch;
 		}
 
+		//! marks the depth tiles of an area as changed
+		virtual void invalidateTiles(const core::rect<s32>& area);
+
+		//! searches the farthest depth value of all changed tiles again
+		virtual void updateTiles();
+
+		//! returns if a primitive would fail the depth test in a whole area
+		virtual bool isOccluded(const core::rect<s32>& area, f32 nearest);
+
 
 	private:
 
+		//! searches the farthest depth value of a tile
+		void updateTile(u32 x, u32 y);
+
+		//! returns the tiles of an area, false if it is outside
+		bool getTiles(const core::rect<s32>& area, core::rect<s32>& tiles) const;
+
+		// tiles have 8x8 pixels
+		enum { TILE_SIZE_LOG2 = 3 };
+
 		u8* Buffer;
 		core::dimension2d<u32> Size;
 		u32 TotalSize;
 		u32 Pitch;
+
+		// farthest depth value of each tile, and if it has to be searched again
+		core::array<fp24> TileDepth;
+		core::array<u8> TileDirty;
+		core::array<u32> DirtyTiles;
+		core::dimension2d<u32> TileCount;
 	};
 
 } // end namespace video
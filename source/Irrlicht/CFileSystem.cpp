@@ -45,8 +45,84 @@ namespace irr
 namespace io
 {
 
+namespace
+{
+	//! Flags stored for each archive to look up its files in the path index
+	enum E_FILE_ARCHIVE_INDEX_FLAGS
+	{
+		//! The files of the archive are in the path index
+		EFAIF_INDEXED = 1,
+		//! The archive was added with ignorePaths
+		EFAIF_IGNORE_PATHS = 2
+	};
+
+	//! Marks unused entries of the path index
+	const u32 PATH_INDEX_EMPTY = 0xffffffff;
+
+	//! Returns where the name used for looking up a file starts
+	/** Works like core::deletePathFromFilename, which is used by the file
+	lists of archives which ignore paths. */
+	u32 getPathIndexNameStart(const io::path& filename, bool ignorePaths)
+	{
+		if (!ignorePaths)
+			return 0;
+
+		s32 i = (s32)filename.size();
+		while (i > 0 && filename[i] != '/' && filename[i] != '\\')
+			--i;
+		return i > 0 ? (u32)i + 1 : 0;
+	}
+
+	//! Lower case, slash normalized character, as compared by CFileList
+	inline u32 getPathIndexLowerChar(fschar_t c)
+	{
+		return c == '\\' ? '/' : core::locale_lower(c);
+	}
+
+	//! FNV-1a hash of a file name
+	/** Ignores case, like the entries of CFileList, which are compared with
+	equals_ignore_case also in archives which don't ignore case. */
+	u32 hashPathIndexName(const io::path& filename, u32 start)
+	{
+		u32 hash = 2166136261u;
+		for (u32 i=start; i<filename.size(); ++i)
+			hash = (hash ^ getPathIndexLowerChar(filename[i])) * 16777619u;
+		return hash;
+	}
+
+	//! Compares a lookup name with the full name of a file list entry
+	bool equalsPathIndexName(const io::path& filename, u32 start, const io::path& entry)
+	{
+		if (filename.size() - start != entry.size())
+			return false;
+
+		for (u32 i=0; i<entry.size(); ++i)
+			if (getPathIndexLowerChar(filename[start+i]) != getPathIndexLowerChar(entry[i]))
+				return false;
+		return true;
+	}
+
+	//! True if the archive type is one of ours, which all use a CFileList
+	bool isIndexableArchive(const IFileArchive* archive)
+	{
+		switch (archive->getType())
+		{
+			case EFAT_ZIP:
+			case EFAT_GZIP:
+			case EFAT_FOLDER:
+			case EFAT_PAK:
+			case EFAT_NPK:
+			case EFAT_TAR:
+				return true;
+			default:
+				return false;
+		}
+	}
+}
+
 //! constructor
 CFileSystem::CFileSystem()
+	: PathIndexDirty(false), DecompressedFileCache(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CFileSystem");
@@ -57,7 +133,8 @@ CFileSystem::CFileSystem()
 	getWorkingDirectory();
 
 #ifdef __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
-	ArchiveLoader.push_back(new CArchiveLoaderZIP(this));
+	DecompressedFileCache = new CZipFileCache();
+	ArchiveLoader.push_back(new CArchiveLoaderZIP(this, DecompressedFileCache));
 #endif
 
 #ifdef __IRR_COMPILE_WITH_MOUNT_ARCHIVE_LOADER_
@@ -92,22 +169,37 @@ CFileSystem::~CFileSystem()
 	{
 		ArchiveLoader[i]->drop();
 	}
+
+#ifdef __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+	if (DecompressedFileCache)
+		DecompressedFileCache->drop();
+#endif
 }
 
 
 //! opens a file for read access
 IReadFile* CFileSystem::createAndOpenFile(const io::path& filename)
 {
-	IReadFile* file = 0;
-	u32 i;
+	os::LoadEvent event(ELPE_OPEN, filename);
+
+	u32 fileIndex = 0;
+	const u32 found = findIndexedFile(filename, fileIndex);
 
-	for (i=0; i< FileArchives.size(); ++i)
+	// archives which are not indexed have to be asked one by one, but only
+	// those with a higher priority than the one holding the file
+	for (u32 i=0; i < found; ++i)
 	{
-		file = FileArchives[i]->createAndOpenFile(filename);
-		if (file)
-			return file;
+		if (!(FileArchiveFlags[i] & EFAIF_INDEXED))
+		{
+			IReadFile* file = FileArchives[i]->createAndOpenFile(filename);
+			if (file)
+				return file;
+		}
 	}
 
+	if (found < FileArchives.size())
+		return FileArchives[found]->createAndOpenFile(fileIndex);
+
 	// Create the file using an absolute path so that it matches
 	// the scheme used by CNullDriver::getTexture().
 	return createReadFile(getAbsolutePath(filename));
@@ -182,8 +274,15 @@ bool CFileSystem::moveFileArchive(u32 sourceIndex, s32 relative)
 		t = FileArchives[s + dir];
 		FileArchives[s + dir] = FileArchives[s];
 		FileArchives[s] = t;
+
+		const u32 flags = FileArchiveFlags[s + dir];
+		FileArchiveFlags[s + dir] = FileArchiveFlags[s];
+		FileArchiveFlags[s] = flags;
 		r = true;
 	}
+
+	if (r)
+		PathIndexDirty = true;
 	return r;
 }
 
@@ -198,9 +297,10 @@ bool CFileSystem::addFileArchive(const io::path& filename, bool ignoreCase,
 	u32 i;
 
 	// check if the archive was already loaded
+	const io::path absolutePath = getAbsolutePath(filename);
 	for (i = 0; i < FileArchives.size(); ++i)
 	{
-		if (getAbsolutePath(filename) == FileArchives[i]->getFileList()->getPath())
+		if (absolutePath == FileArchives[i]->getFileList()->getPath())
 		{
 			if (password.size())
 				FileArchives[i]->Password=password;
@@ -286,6 +386,9 @@ bool CFileSystem::addFileArchive(const io::path& filename, bool ignoreCase,
 	if (archive)
 	{
 		FileArchives.push_back(archive);
+		FileArchiveFlags.push_back((isIndexableArchive(archive) ? EFAIF_INDEXED : 0) |
+				(ignorePaths ? EFAIF_IGNORE_PATHS : 0));
+		PathIndexDirty = true;
 		if (password.size())
 			archive->Password=password;
 		ret = true;
@@ -308,6 +411,8 @@ bool CFileSystem::removeFileArchive(u32 index)
 	{
 		FileArchives[index]->drop();
 		FileArchives.erase(index);
+		FileArchiveFlags.erase(index);
+		PathIndexDirty = true;
 		ret = true;
 	}
 	_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
@@ -328,6 +433,116 @@ bool CFileSystem::removeFileArchive(const io::path& filename)
 }
 
 
+//! Rebuilds the path index after archives were added, removed or moved
+void CFileSystem::buildPathIndex() const
+{
+	PathIndexDirty = false;
+
+	u32 fileCount = 0;
+	for (u32 i=0; i < FileArchives.size(); ++i)
+		if (FileArchiveFlags[i] & EFAIF_INDEXED)
+			fileCount += FileArchives[i]->getFileList()->getFileCount();
+
+	// keep the table at most half full
+	u32 size = 16;
+	while (size < fileCount * 2)
+		size <<= 1;
+
+	SPathIndexEntry empty;
+	empty.Hash = 0;
+	empty.Archive = PATH_INDEX_EMPTY;
+	empty.File = 0;
+
+	PathIndex.set_used(0);
+	PathIndex.reallocate(size);
+	for (u32 i=0; i < size; ++i)
+		PathIndex.push_back(empty);
+
+	const u32 mask = size - 1;
+
+	// archives are added by priority, so the first entry for a name wins
+	for (u32 a=0; a < FileArchives.size(); ++a)
+	{
+		if (!(FileArchiveFlags[a] & EFAIF_INDEXED))
+			continue;
+
+		const u32 ignorePaths = FileArchiveFlags[a] & EFAIF_IGNORE_PATHS;
+		const IFileList* list = FileArchives[a]->getFileList();
+		for (u32 f=0; f < list->getFileCount(); ++f)
+		{
+			if (list->isDirectory(f))
+				continue;
+
+			const io::path& name = list->getFullFileName(f);
+			const u32 hash = hashPathIndexName(name, 0);
+
+			u32 slot = hash & mask;
+			for (; PathIndex[slot].Archive != PATH_INDEX_EMPTY; slot = (slot + 1) & mask)
+			{
+				SPathIndexEntry& e = PathIndex[slot];
+				if (e.Hash == hash &&
+					(FileArchiveFlags[e.Archive] & EFAIF_IGNORE_PATHS) == ignorePaths &&
+					equalsPathIndexName(name, 0, FileArchives[e.Archive]->getFileList()->getFullFileName(e.File)))
+				{
+					// names of one archive which only differ in case are
+					// resolved to the entry which findFile would return
+					if (e.Archive == a)
+					{
+						const s32 found = list->findFile(name);
+						if (found >= 0)
+							e.File = (u32)found;
+					}
+					break;
+				}
+			}
+
+			if (PathIndex[slot].Archive == PATH_INDEX_EMPTY)
+			{
+				PathIndex[slot].Hash = hash;
+				PathIndex[slot].Archive = a;
+				PathIndex[slot].File = f;
+			}
+		}
+	}
+}
+
+
+//! Looks up a file in all indexed archives
+u32 CFileSystem::findIndexedFile(const io::path& filename, u32& fileIndex) const
+{
+	if (PathIndexDirty)
+		buildPathIndex();
+
+	u32 found = FileArchives.size();
+	if (PathIndex.empty())
+		return found;
+
+	const u32 mask = PathIndex.size() - 1;
+
+	// archives with and without paths need different names for the lookup
+	for (u32 ignorePaths=0; ignorePaths <= EFAIF_IGNORE_PATHS; ignorePaths += EFAIF_IGNORE_PATHS)
+	{
+		const u32 start = getPathIndexNameStart(filename, ignorePaths != 0);
+		const u32 hash = hashPathIndexName(filename, start);
+
+		for (u32 slot = hash & mask; PathIndex[slot].Archive != PATH_INDEX_EMPTY; slot = (slot + 1) & mask)
+		{
+			const SPathIndexEntry& e = PathIndex[slot];
+			if (e.Hash == hash && e.Archive < found &&
+				(FileArchiveFlags[e.Archive] & EFAIF_IGNORE_PATHS) == ignorePaths &&
+				equalsPathIndexName(filename, start, FileArchives[e.Archive]->getFileList()->getFullFileName(e.File)))
+			{
+				found = e.Archive;
+				fileIndex = e.File;
+				break;
+			}
+		}
+	}
+
+	return found;
+}
+
+
 //! gets an archive
 u32 CFileSystem::getFileArchiveCount() const
 {
@@ -341,6 +556,16 @@ IFileArchive* CFileSystem::getFileArchive(u32 index)
 }
 
 
+//! Sets the amount of memory used to keep decompressed archive files.
+void CFileSystem::setDecompressedFileCacheSize(u32 sizeInBytes)
+{
+#ifdef __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_
+	if (DecompressedFileCache)
+		DecompressedFileCache->setMaxSize(sizeInBytes);
+#endif
+}
+
+
 //! Returns the string of the current working directory
 const io::path& CFileSystem::getWorkingDirectory()
 {
@@ -744,8 +969,14 @@ IFileList* CFileSystem::createEmptyFileList(const io::path& path, bool ignoreCas
 //! determines if a file exists and would be able to be opened.
 bool CFileSystem::existFile(const io::path& filename) const
 {
+	u32 fileIndex = 0;
+	const u32 found = findIndexedFile(filename, fileIndex);
+	if (found < FileArchives.size())
+		return true;
+
 	for (u32 i=0; i < FileArchives.size(); ++i)
-		if (FileArchives[i]->getFileList()->findFile(filename)!=-1)
+		if (!(FileArchiveFlags[i] & EFAIF_INDEXED) &&
+			FileArchives[i]->getFileList()->findFile(filename)!=-1)
 			return true;
 
 #if defined(_IRR_WINDOWS_CE_PLATFORM_)
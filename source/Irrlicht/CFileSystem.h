@@ -14,6 +14,7 @@ namespace io
 {
 
 	class CZipReader;
+	class CZipFileCache;
 	class CPakReader;
 	class CMountPointReader;
 
@@ -63,6 +64,9 @@ public:
 	//! gets an archive
 	virtual IFileArchive* getFileArchive(u32 index);
 
+	//! Sets the amount of memory used to keep decompressed archive files.
+	virtual void setDecompressedFileCacheSize(u32 sizeInBytes);
+
 	//! removes an archive from the file system.
 	virtual bool removeFileArchive(u32 index);
 
@@ -127,6 +131,24 @@ public:
 
 private:
 
+	//! Entry of the path index, refers to a file in one of the archives
+	struct SPathIndexEntry
+	{
+		u32 Hash;
+		u32 Archive;
+		u32 File;
+	};
+
+	//! Rebuilds the path index after archives were added, removed or moved
+	void buildPathIndex() const;
+
+	//! Looks up a file in all indexed archives
+	/** \param filename Name of the file as passed to createAndOpenFile.
+	\param fileIndex Receives the index of the file in the archive's file list.
+	\return Index of the archive with the highest priority which holds the
+	file, or the archive count if no indexed archive holds it. */
+	u32 findIndexedFile(const io::path& filename, u32& fileIndex) const;
+
 	//! Currently used FileSystemType
 	EFileSystemType FileSystemType;
 	//! WorkingDirectory for Native and Virtual filesystems
@@ -135,6 +157,14 @@ private:
 	core::array<IArchiveLoader*> ArchiveLoader;
 	//! currently attached Archives
 	core::array<IFileArchive*> FileArchives;
+	//! flags of the attached archives, see E_FILE_ARCHIVE_INDEX_FLAGS
+	core::array<u32> FileArchiveFlags;
+	//! hash table of the files in all indexed archives
+	mutable core::array<SPathIndexEntry> PathIndex;
+	//! true if the path index has to be rebuilt before the next lookup
+	mutable bool PathIndexDirty;
+	//! decompressed files, shared by all zip archives
+	CZipFileCache* DecompressedFileCache;
 };
 
 
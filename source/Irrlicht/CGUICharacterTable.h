@@ -0,0 +1,87 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_GUI_CHARACTER_TABLE_H_INCLUDED__
+#define __C_GUI_CHARACTER_TABLE_H_INCLUDED__
+
+#include "irrArray.h"
+#include "irrMap.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! Maps characters to indices without searching a tree for the common ones
+/** Each block of 256 characters of the basic multilingual plane which
+contains a character gets a flat table. Characters above it are kept in a
+map. */
+class CGUICharacterTable
+{
+public:
+
+	CGUICharacterTable()
+	{
+		clear();
+	}
+
+	//! stores the index of a character
+	void set(u32 c, s32 index)
+	{
+		if (c >= 0x10000)
+		{
+			Others.set(c, index);
+			return;
+		}
+
+		s32& block = Blocks[c >> 8];
+		if (block < 0)
+		{
+			block = Table.size();
+			for (u32 i=0; i<256; ++i)
+				Table.push_back(-1);
+		}
+
+		Table[block + (c & 0xff)] = index;
+	}
+
+	//! returns the index of a character, or notFound if none is stored
+	s32 get(u32 c, s32 notFound) const
+	{
+		if (c < 0x10000)
+		{
+			const s32 block = Blocks[c >> 8];
+			if (block >= 0 && Table[block + (c & 0xff)] >= 0)
+				return Table[block + (c & 0xff)];
+			return notFound;
+		}
+
+		core::map<u32, s32>::Node* n = Others.find(c);
+		return n ? n->getValue() : notFound;
+	}
+
+	//! removes all characters
+	void clear()
+	{
+		Blocks.set_used(256);
+		for (u32 i=0; i<256; ++i)
+			Blocks[i] = -1;
+
+		Table.clear();
+		Others.clear();
+	}
+
+private:
+
+	//! start of the table of each block, -1 for blocks without characters
+	core::array<s32> Blocks;
+	core::array<s32> Table;
+	core::map<u32, s32> Others;
+};
+
+} // end namespace gui
+} // end namespace irr
+
+#endif
+
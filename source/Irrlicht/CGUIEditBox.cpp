@@ -979,6 +979,10 @@ void CGUIEditBox::draw()
 		charcursorpos = font->getDimension(s.c_str()).Width +
 			font->getKerningWidth(L"_", CursorPos-startPos > 0 ? &((*txtLine)[CursorPos-startPos-1]) : 0);
 
+		// the cursor blinks
+		if (focus)
+			invalidate();
+
 		if (focus && (os::Timer::getTime() - BlinkStartTime) % 700 < 350)
 		{
 			setTextRect(cursorLine);
@@ -998,7 +1002,7 @@ void CGUIEditBox::draw()
 //! Sets the new caption of this element.
 void CGUIEditBox::setText(const wchar_t* text)
 {
-	Text = text;
+	IGUIElement::setText(text);
 	if (u32(CursorPos) > Text.size())
 		CursorPos = Text.size();
 	HScrollPos = 0;
@@ -1223,97 +1227,34 @@ void CGUIEditBox::breakText()
 
 	LastBreakFont = font;
 
-	core::stringw line;
-	core::stringw word;
-	core::stringw whitespace;
-	s32 lastLineStart = 0;
-	s32 size = Text.size();
-	s32 length = 0;
-	s32 elWidth = RelativeRect.getWidth() - 6;
-	wchar_t c;
-
-	for (s32 i=0; i<size; ++i)
+	// windows breaks are kept as a single character
+	for (s32 i=Text.findFirst(L'\r'); i >= 0; i=Text.findNext(L'\r', i+1))
 	{
-		c = Text[i];
-		bool lineBreak = false;
-
-		if (c == L'\r') // Mac or Windows breaks
-		{
-			lineBreak = true;
-			c = ' ';
-			if (Text[i+1] == L'\n') // Windows breaks
-			{
-				Text.erase(i+1);
-				--size;
-			}
-		}
-		else if (c == L'\n') // Unix breaks
-		{
-			lineBreak = true;
-			c = ' ';
-		}
-
-		// don't break if we're not a multi-line edit box
-		if (!MultiLine)
-			lineBreak = false;
-
-		if (c == L' ' || c == 0 || i == (size-1))
-		{
-			if (word.size())
-			{
-				// here comes the next whitespace, look if
-				// we can break the last word to the next line.
-				s32 whitelgth = font->getDimension(whitespace.c_str()).Width;
-				s32 worldlgth = font->getDimension(word.c_str()).Width;
+		if (Text[i+1] == L'\n')
+			Text.erase(i+1);
+	}
 
-				if (WordWrap && length + worldlgth + whitelgth > elWidth)
-				{
-					// break to next line
-					length = worldlgth;
-					BrokenText.push_back(line);
-					BrokenTextPositions.push_back(lastLineStart);
-					lastLineStart = i - (s32)word.size();
-					line = word;
-				}
-				else
-				{
-					// add word to line
-					line += whitespace;
-					line += word;
-					length += whitelgth + worldlgth;
-				}
+	// only the lines of changed paragraphs are broken again
+	Layout.update(Text, font, RelativeRect.getWidth() - 6, WordWrap, MultiLine);
 
-				word = L"";
-				whitespace = L"";
-			}
+	BrokenText.reallocate(Layout.getLineCount());
+	BrokenTextPositions.reallocate(Layout.getLineCount());
+	for (u32 i=0; i<Layout.getLineCount(); ++i)
+	{
+		BrokenText.push_back(Layout.getLineText(i));
+		BrokenTextPositions.push_back(Layout.getLineStart(i));
 
-			whitespace += c;
+		// line breaks are spaces at the end of the line
+		core::stringw& line = BrokenText.getLast();
+		if (Layout.hasLineBreak(i))
+			line.append(L' ');
 
-			// compute line break
-			if (lineBreak)
-			{
-				line += whitespace;
-				line += word;
-				BrokenText.push_back(line);
-				BrokenTextPositions.push_back(lastLineStart);
-				lastLineStart = i+1;
-				line = L"";
-				word = L"";
-				whitespace = L"";
-				length = 0;
-			}
-		}
-		else
+		for (u32 c=0; !MultiLine && c<line.size(); ++c)
 		{
-			// yippee this is a word..
-			word += c;
+			if (line[c] == L'\r' || line[c] == L'\n')
+				line[c] = L' ';
 		}
 	}
-
-	line += whitespace;
-	line += word;
-	BrokenText.push_back(line);
-	BrokenTextPositions.push_back(lastLineStart);
 }
 
 
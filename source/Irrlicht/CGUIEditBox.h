@@ -10,6 +10,7 @@
 
 #include "IGUIEditBox.h"
 #include "irrArray.h"
+#include "CGUITextLayout.h"
 #include "IOSOperator.h"
 
 namespace irr
@@ -152,6 +153,7 @@ namespace gui
 
 		core::array< core::stringw > BrokenText;
 		core::array< s32 > BrokenTextPositions;
+		CGUITextLayout Layout;
 
 		core::rect<s32> CurrentTextRect, FrameRect; // temporary values
 	};
@@ -59,7 +59,8 @@ const wchar_t* IRR_XML_FORMAT_GUI_ELEMENT_ATTR_TYPE	= L"type";
 CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IOSOperator* op)
 : IGUIElement(EGUIET_ELEMENT, 0, 0, 0, core::rect<s32>(core::position2d<s32>(0,0), driver ? core::dimension2d<s32>(driver->getScreenSize()) : core::dimension2d<s32>(0,0))),
 	Driver(driver), Hovered(0), HoveredNoSubelement(0), Focus(0), LastHoveredMousePos(0,0), CurrentSkin(0),
-	FileSystem(fs), UserReceiver(0), Operator(op)
+	FileSystem(fs), UserReceiver(0), Operator(op), Cache(0), CacheBlack(0), CacheWhite(0),
+	RepaintedArea(0), RetainedMode(false)
 {
 	if (Driver)
 		Driver->grab();
@@ -113,6 +114,8 @@ CGUIEnvironment::~CGUIEnvironment()
 		Hovered = 0;
 	}
 
+	removeCache();
+
 	if (Driver)
 	{
 		Driver->drop();
@@ -218,11 +221,278 @@ void CGUIEnvironment::drawAll()
 	if (ToolTip.Element)
 		bringToFront(ToolTip.Element);
 
-	draw();
+	if (RetainedMode && updateCache())
+	{
+		// elements may invalidate themselves again while they are drawn
+		core::array<core::rect<s32> > rects;
+		rects.swap(DirtyRects);
+
+		RepaintedArea = 0;
+		for (u32 i=0; i<rects.size(); ++i)
+			RepaintedArea += rects[i].getArea();
+
+		if (!rects.empty())
+			repaintCache(rects);
+
+		const core::dimension2du size(Cache->getSize());
+		Driver->draw2DImage(Cache, core::position2d<s32>(0,0),
+			core::rect<s32>(0, 0, size.Width, size.Height), 0,
+			video::SColor(255,255,255,255), true);
+	}
+	else
+	{
+		draw();
+		RepaintedArea = AbsoluteRect.getArea();
+	}
+
 	OnPostRender ( os::Timer::getTime () );
 }
 
 
+//! Enables or disables drawing the gui in retained mode.
+bool CGUIEnvironment::setRetainedMode(bool retained)
+{
+	RetainedMode = retained;
+
+	if (!RetainedMode)
+	{
+		removeCache();
+		DirtyRects.clear();
+		return true;
+	}
+
+	if (!updateCache())
+	{
+		RetainedMode = false;
+		return false;
+	}
+
+	return true;
+}
+
+
+//! Returns if the gui is drawn in retained mode.
+bool CGUIEnvironment::isRetainedMode() const
+{
+	return RetainedMode;
+}
+
+
+//! Marks a rectangle of the screen to be repainted in retained mode.
+void CGUIEnvironment::invalidate(const core::rect<s32>& rect)
+{
+	if (!RetainedMode)
+		return;
+
+	core::rect<s32> r(rect);
+	r.clipAgainst(AbsoluteRect);
+	if (r.getArea() <= 0)
+		return;
+
+	// merge overlapping rectangles, so no pixel is repainted twice
+	for (u32 i=0; i<DirtyRects.size(); )
+	{
+		if (DirtyRects[i].isRectCollided(r))
+		{
+			r.addInternalPoint(DirtyRects[i].UpperLeftCorner);
+			r.addInternalPoint(DirtyRects[i].LowerRightCorner);
+			DirtyRects.erase(i);
+			i = 0;
+		}
+		else
+			++i;
+	}
+
+	// each rectangle traverses the whole gui, so keep their number small
+	if (DirtyRects.size() == 16)
+	{
+		for (u32 i=0; i<DirtyRects.size(); ++i)
+		{
+			r.addInternalPoint(DirtyRects[i].UpperLeftCorner);
+			r.addInternalPoint(DirtyRects[i].LowerRightCorner);
+		}
+		DirtyRects.set_used(0);
+	}
+
+	DirtyRects.push_back(r);
+}
+
+
+//! Returns the amount of pixels repainted by the last drawAll().
+u32 CGUIEnvironment::getRepaintedArea() const
+{
+	return RepaintedArea;
+}
+
+
+//! creates or resizes the retained mode render targets
+bool CGUIEnvironment::updateCache()
+{
+	if (!Driver)
+		return false;
+
+	const core::dimension2du size(Driver->getScreenSize());
+	if (Cache && Cache->getSize() == size)
+		return true;
+
+	removeCache();
+
+	if (!Driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+		return false;
+
+	// the cache is only written by the cpu and drawn at its full size
+	const bool mipmaps = Driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
+	const bool nonPowerOfTwo = Driver->getTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2);
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, false);
+	Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, true);
+	Cache = Driver->addTexture(size, "irr_gui_cache", video::ECF_A8R8G8B8);
+	Driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, mipmaps);
+	Driver->setTextureCreationFlag(video::ETCF_ALLOW_NON_POWER_2, nonPowerOfTwo);
+	if (Cache)
+		Cache->grab();
+
+	CacheBlack = Driver->addRenderTargetTexture(size, "irr_gui_cache_black", video::ECF_A8R8G8B8);
+	if (CacheBlack)
+		CacheBlack->grab();
+
+	CacheWhite = Driver->addRenderTargetTexture(size, "irr_gui_cache_white", video::ECF_A8R8G8B8);
+	if (CacheWhite)
+		CacheWhite->grab();
+
+	if (!Cache || !CacheBlack || !CacheWhite || Cache->getSize() != size ||
+		CacheBlack->getSize() != size || CacheWhite->getSize() != size ||
+		Cache->getColorFormat() != video::ECF_A8R8G8B8 ||
+		CacheBlack->getColorFormat() != video::ECF_A8R8G8B8 ||
+		CacheWhite->getColorFormat() != video::ECF_A8R8G8B8)
+	{
+		os::Printer::log("Could not create render targets for the gui retained mode.", ELL_WARNING);
+		removeCache();
+		return false;
+	}
+
+	// the new render targets are empty
+	DirtyRects.set_used(0);
+	invalidate(AbsoluteRect);
+
+	return true;
+}
+
+
+//! removes the retained mode render targets
+void CGUIEnvironment::removeCache()
+{
+	if (Cache)
+	{
+		if (Driver)
+			Driver->removeTexture(Cache);
+		Cache->drop();
+		Cache = 0;
+	}
+
+	if (CacheBlack)
+	{
+		if (Driver)
+			Driver->removeTexture(CacheBlack);
+		CacheBlack->drop();
+		CacheBlack = 0;
+	}
+
+	if (CacheWhite)
+	{
+		if (Driver)
+			Driver->removeTexture(CacheWhite);
+		CacheWhite->drop();
+		CacheWhite = 0;
+	}
+}
+
+
+//! turns a pixel of the gui drawn over black and over white into a color with alpha
+static inline u32 getStraightAlphaColor(u32 black, u32 white)
+{
+	if ((black & 0x00FFFFFF) == (white & 0x00FFFFFF))
+		return black | 0xFF000000;
+
+	const s32 r = (black >> 16) & 0xFF;
+	const s32 g = (black >> 8) & 0xFF;
+	const s32 b = black & 0xFF;
+	const s32 wr = (white >> 16) & 0xFF;
+	const s32 wg = (white >> 8) & 0xFF;
+	const s32 wb = white & 0xFF;
+
+	// white shines through the same amount in each channel
+	const s32 transparency = (wr - r + wg - g + wb - b) / 3;
+	const s32 alpha = 255 - core::s32_clamp(transparency, 0, 255);
+	if (!alpha)
+		return 0;
+
+	// black is the color multiplied with the alpha
+	return video::SColor(alpha,
+		core::s32_min((r * 255 + alpha / 2) / alpha, 255),
+		core::s32_min((g * 255 + alpha / 2) / alpha, 255),
+		core::s32_min((b * 255 + alpha / 2) / alpha, 255)).color;
+}
+
+
+//! repaints the dirty rectangles of the retained mode render target
+void CGUIEnvironment::repaintCache(const core::array<core::rect<s32> >& rects)
+{
+	// The gui is drawn over black and over white, the difference of both
+	// gives the alpha of each pixel. Drivers blend the alpha channel of
+	// render targets like a color, so it can't be used directly. Elements
+	// may draw outside of the dirty rectangles, which only reaches the
+	// render targets, the cache only takes the pixels inside of them.
+	for (u32 pass=0; pass<2; ++pass)
+	{
+		Driver->setRenderTarget(pass ? CacheWhite : CacheBlack, false, false);
+
+		const video::SColor background = pass ?
+			video::SColor(255,255,255,255) : video::SColor(255,0,0,0);
+
+		for (u32 i=0; i<rects.size(); ++i)
+		{
+			Driver->draw2DRectangle(background, rects[i]);
+			drawClipped(rects[i]);
+		}
+	}
+
+	Driver->setRenderTarget(0, false, false);
+
+	u32* cache = (u32*)Cache->lock();
+	const u32* black = (const u32*)CacheBlack->lock(true);
+	const u32* white = (const u32*)CacheWhite->lock(true);
+
+	if (cache && black && white)
+	{
+		const u32 pitch = Cache->getPitch() / 4;
+		const u32 blackPitch = CacheBlack->getPitch() / 4;
+		const u32 whitePitch = CacheWhite->getPitch() / 4;
+
+		for (u32 i=0; i<rects.size(); ++i)
+		{
+			const core::rect<s32>& r = rects[i];
+
+			for (s32 y=r.UpperLeftCorner.Y; y<r.LowerRightCorner.Y; ++y)
+			{
+				u32* dst = cache + y * pitch;
+				const u32* b = black + y * blackPitch;
+				const u32* w = white + y * whitePitch;
+
+				for (s32 x=r.UpperLeftCorner.X; x<r.LowerRightCorner.X; ++x)
+					dst[x] = getStraightAlphaColor(b[x], w[x]);
+			}
+		}
+	}
+
+	if (white)
+		CacheWhite->unlock();
+	if (black)
+		CacheBlack->unlock();
+	if (cache)
+		Cache->unlock();
+}
+
+
 //! sets the focus to an element
 bool CGUIEnvironment::setFocus(IGUIElement* element)
 {
@@ -289,6 +559,9 @@ bool CGUIEnvironment::setFocus(IGUIElement* element)
 	if (currentFocus)
 		currentFocus->drop();
 
+	invalidateElement(Focus);
+	invalidateElement(element);
+
 	if (Focus)
 		Focus->drop();
 
@@ -324,6 +597,7 @@ bool CGUIEnvironment::removeFocus(IGUIElement* element)
 	}
 	if (Focus)
 	{
+		invalidateElement(Focus);
 		Focus->drop();
 		Focus = 0;
 	}
@@ -501,6 +775,8 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 
 	if (Hovered != lastHovered)
 	{
+		invalidateElement(lastHovered);
+
 		SEvent event;
 		event.EventType = EET_GUI_EVENT;
 
@@ -543,6 +819,17 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 }
 
 
+//! invalidates an element, or its parent if it is a sub element
+void CGUIEnvironment::invalidateElement(IGUIElement* element)
+{
+	while (element && element->isSubElement())
+		element = element->getParent();
+
+	if (element && element != this)
+		element->invalidate();
+}
+
+
 //! This sets a new event receiver for gui events. Usually you do not have to
 //! use this method, it is used by the internal engine.
 void CGUIEnvironment::setUserEventReceiver(IEventReceiver* evr)
@@ -563,6 +850,10 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 
 		updateHoveredElement(core::position2d<s32>(event.MouseInput.X, event.MouseInput.Y));
 
+		// hovered elements may highlight parts of them, and the focus gets the input
+		invalidateElement(Hovered);
+		invalidateElement(Focus);
+
 		if (event.MouseInput.Event == EMIE_LMOUSE_PRESSED_DOWN)
 			if ( (Hovered && Hovered != Focus) || !Focus )
 		{
@@ -583,6 +874,8 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 		break;
 	case EET_KEY_INPUT_EVENT:
 		{
+			invalidateElement(Focus);
+
 			// send focus changing event
 			if (event.EventType == EET_KEY_INPUT_EVENT &&
 				event.KeyInput.PressedDown &&
@@ -643,6 +936,8 @@ void CGUIEnvironment::setSkin(IGUISkin* skin)
 
 	if (CurrentSkin)
 		CurrentSkin->grab();
+
+	invalidate(AbsoluteRect);
 }
 
 
@@ -36,6 +36,18 @@ public:
 	//! draws all gui elements
 	virtual void drawAll();
 
+	//! Enables or disables drawing the gui in retained mode.
+	virtual bool setRetainedMode(bool retained);
+
+	//! Returns if the gui is drawn in retained mode.
+	virtual bool isRetainedMode() const;
+
+	//! Marks a rectangle of the screen to be repainted in retained mode.
+	virtual void invalidate(const core::rect<s32>& rect);
+
+	//! Returns the amount of pixels repainted by the last drawAll().
+	virtual u32 getRepaintedArea() const;
+
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver() const;
 
@@ -259,6 +271,18 @@ private:
 
 	void updateHoveredElement(core::position2d<s32> mousePos);
 
+	//! invalidates an element, or its parent if it is a sub element
+	void invalidateElement(IGUIElement* element);
+
+	//! creates or resizes the retained mode render targets
+	bool updateCache();
+
+	//! removes the retained mode render targets
+	void removeCache();
+
+	//! repaints the dirty rectangles of the retained mode render target
+	void repaintCache(const core::array<core::rect<s32> >& rects);
+
 	void loadBuiltInFont();
 
 	struct SFont
@@ -327,6 +351,16 @@ private:
 	io::IFileSystem* FileSystem;
 	IEventReceiver* UserReceiver;
 	IOSOperator* Operator;
+
+	//! the drawn gui with straight alpha, only changed inside the dirty rectangles
+	video::ITexture* Cache;
+	//! render targets with the gui drawn over black and over white, the
+	//! difference of both gives the alpha
+	video::ITexture* CacheBlack;
+	video::ITexture* CacheWhite;
+	core::array<core::rect<s32> > DirtyRects;
+	u32 RepaintedArea;
+	bool RetainedMode;
 };
 
 } // end namespace gui
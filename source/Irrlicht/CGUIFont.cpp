@@ -157,7 +157,8 @@ bool CGUIFont::load(io::IXMLReader* xml)
 				}
 				rectangle.LowerRightCorner.Y = val;
 
-				CharacterMap.insert(ch,Areas.size());
+				if (CharacterMap.get(ch, -1) < 0)
+					CharacterMap.set(ch, Areas.size());
 
 				// make frame
 				f.rectNumber = SpriteBank->getPositions().size();
@@ -249,10 +250,17 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 	case video::ECF_A8R8G8B8:
 		break;
 	case video::ECF_R8G8B8:
+	case video::ECF_DXT1:
+	case video::ECF_DXT5:
+		// the corner pixels are read from an uncompressed copy
 		tmpImage = new video::CImage(video::ECF_A8R8G8B8,image->getDimension());
 		image->copyTo(tmpImage);
 		deleteTmpImage=true;
 		break;
+	default:
+		os::Printer::log("Unsupported color format of the font texture", name, ELL_ERROR);
+		image->drop();
+		return false;
 	}
 	readPositions(tmpImage, lowerRightPositions);
 
@@ -407,11 +415,7 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
-	core::map<wchar_t, s32>::Node* n = CharacterMap.find(c);
-	if (n)
-		return n->getValue();
-	else
-		return WrongCharacter;
+	return CharacterMap.get(c, WrongCharacter);
 }
 
 void CGUIFont::setInvisibleCharacters( const wchar_t *s )
@@ -490,8 +494,8 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 			return;
 	}
 
-	core::array<u32> indices(text.size());
-	core::array<core::position2di> offsets(text.size());
+	const core::array<SGUISprite>& sprites = SpriteBank->getSprites();
+	const core::array<core::rect<s32> >& rects = SpriteBank->getPositions();
 
 	for(u32 i = 0;i < text.size();i++)
 	{
@@ -524,16 +528,33 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 		SFontArea& area = Areas[getAreaFromCharacter(c)];
 
 		offset.X += area.underhang;
-		if ( Invisible.findFirst ( c ) < 0 )
+		if ( Invisible.findFirst ( c ) < 0 && area.spriteno < sprites.size() &&
+			!sprites[area.spriteno].Frames.empty() )
 		{
-			indices.push_back(area.spriteno);
-			offsets.push_back(offset);
+			const SGUISpriteFrame& frame = sprites[area.spriteno].Frames[0];
+			if (frame.rectNumber < rects.size())
+				Batch.add(SpriteBank->getTexture(frame.textureNumber), offset,
+					rects[frame.rectNumber], color, clip);
 		}
 
 		offset.X += area.width + area.overhang + GlobalKerningWidth;
 	}
 
-	SpriteBank->draw2DSpriteBatch(indices, offsets, clip, color);
+	Batch.draw(Driver);
+}
+
+
+//! starts to collect the text of the following draw calls
+void CGUIFont::beginBatch()
+{
+	Batch.begin();
+}
+
+
+//! draws all text collected since beginBatch()
+void CGUIFont::endBatch()
+{
+	Batch.end(Driver);
 }
 
 
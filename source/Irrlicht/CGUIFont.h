@@ -10,7 +10,8 @@
 
 #include "IGUIFontBitmap.h"
 #include "irrString.h"
-#include "irrMap.h"
+#include "CGUICharacterTable.h"
+#include "CGUITextBatch.h"
 #include "IXMLReader.h"
 #include "IReadFile.h"
 #include "irrArray.h"
@@ -78,6 +79,12 @@ public:
 
 	virtual void setInvisibleCharacters( const wchar_t *s );
 
+	//! starts to collect the text of the following draw calls
+	virtual void beginBatch();
+
+	//! draws all text collected since beginBatch()
+	virtual void endBatch();
+
 private:
 
 	struct SFontArea
@@ -98,7 +105,8 @@ private:
 	void setMaxHeight();
 
 	core::array<SFontArea>		Areas;
-	core::map<wchar_t, s32>		CharacterMap;
+	CGUICharacterTable		CharacterMap;
+	CGUITextBatch			Batch;
 	video::IVideoDriver*		Driver;
 	IGUISpriteBank*			SpriteBank;
 	IGUIEnvironment*		Environment;
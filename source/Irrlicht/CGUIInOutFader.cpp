@@ -41,9 +41,14 @@ void CGUIInOutFader::draw()
 	if (now > EndTime && Action == EFA_FADE_IN)
 	{
 		Action = EFA_NOTHING;
+		invalidate();
 		return;
 	}
 
+	// the color changes until the fade is finished
+	if (now <= EndTime)
+		invalidate();
+
 	video::IVideoDriver* driver = Environment->getVideoDriver();
 
 	if (driver)
@@ -118,6 +123,7 @@ void CGUIInOutFader::setColor(video::SColor source, video::SColor dest)
 		TransColor = Color[1];
 	}
 
+	invalidate();
 }
 
 
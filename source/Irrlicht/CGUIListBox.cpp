@@ -517,10 +517,21 @@ void CGUIListBox::draw()
 
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 
-	for (s32 i=0; i<(s32)Items.size(); ++i)
+	// start at the first item reaching into the list, so only visible items are visited
+	s32 first = 0;
+	if (ItemHeight > 0 && ScrollBar->getPos() > ItemHeight)
 	{
-		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		first = ScrollBar->getPos() / ItemHeight - 1;
+		frameRect.UpperLeftCorner.Y += first * ItemHeight;
+		frameRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
+	for (s32 i=first; i<(s32)Items.size(); ++i)
+	{
+		if (frameRect.UpperLeftCorner.Y > AbsoluteRect.LowerRightCorner.Y)
+			break;
+
+		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
 			if (i == Selected && hl)
 				skin->draw2DRectangle(this, skin->getColor(EGDC_HIGH_LIGHT), frameRect, &clientClip);
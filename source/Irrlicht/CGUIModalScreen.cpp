@@ -74,6 +74,12 @@ bool CGUIModalScreen::isPointInside(const core::position2d<s32>& point) const
     return true;
 }
 
+//! Modal screens catch all points
+core::rect<s32> CGUIModalScreen::getHitRect() const
+{
+	return core::rect<s32>(-0x3fffffff, -0x3fffffff, 0x3fffffff, 0x3fffffff);
+}
+
 //! called if an event happened.
 bool CGUIModalScreen::OnEvent(const SEvent& event)
 {
@@ -46,6 +46,9 @@ namespace gui
 		//! Modals are infinite so every point is inside
 		virtual bool isPointInside(const core::position2d<s32>& point) const;
 
+		//! Modal screens catch all points
+		virtual core::rect<s32> getHitRect() const;
+
 		//! Writes attributes of the element.
 		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const;
 
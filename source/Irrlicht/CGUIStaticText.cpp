@@ -91,10 +91,13 @@ void CGUIStaticText::draw()
 					frameRect.UpperLeftCorner.Y = frameRect.LowerRightCorner.Y -
 						font->getDimension(L"A").Height - font->getKerningHeight();
 				}
+				if (font != LastBreakFont)
+					breakText();
+
 				if (HAlign == EGUIA_LOWERRIGHT)
 				{
 					frameRect.UpperLeftCorner.X = frameRect.LowerRightCorner.X -
-						font->getDimension(Text.c_str()).Width;
+						Layout.getWidth();
 				}
 
 				font->draw(Text.c_str(), frameRect,
@@ -108,7 +111,7 @@ void CGUIStaticText::draw()
 
 				core::rect<s32> r = frameRect;
 				s32 height = font->getDimension(L"A").Height + font->getKerningHeight();
-				s32 totalHeight = height * BrokenText.size();
+				s32 totalHeight = height * Layout.getLineCount();
 				if (VAlign == EGUIA_CENTER)
 				{
 					r.UpperLeftCorner.Y = r.getCenter().Y - (totalHeight / 2);
@@ -118,15 +121,15 @@ void CGUIStaticText::draw()
 					r.UpperLeftCorner.Y = r.LowerRightCorner.Y - totalHeight;
 				}
 
-				for (u32 i=0; i<BrokenText.size(); ++i)
+				for (u32 i=0; i<Layout.getLineCount(); ++i)
 				{
 					if (HAlign == EGUIA_LOWERRIGHT)
 					{
 						r.UpperLeftCorner.X = frameRect.LowerRightCorner.X -
-							font->getDimension(BrokenText[i].c_str()).Width;
+							Layout.getLineWidth(i);
 					}
 
-					font->draw(BrokenText[i].c_str(), r,
+					font->draw(Layout.getLineText(i), r,
 						OverrideColorEnabled ? OverrideColor : skin->getColor(IsEnabled ? EGDC_BUTTON_TEXT : EGDC_GRAY_TEXT),
 						HAlign == EGUIA_CENTER, false, &AbsoluteClippingRect);
 
@@ -239,106 +242,22 @@ bool CGUIStaticText::isWordWrapEnabled() const
 }
 
 
-//! Breaks the single text line.
+//! Lays out the text, only changed lines are broken again.
 void CGUIStaticText::breakText()
 {
 	IGUISkin* skin = Environment->getSkin();
 
-	if (!WordWrap || !skin)
+	if (!skin)
 		return;
 
-	BrokenText.clear();
-
 	IGUIFont* font = OverrideFont;
 	if (!OverrideFont)
 		font = skin->getFont();
 
-	if (!font)
-		return;
-
 	LastBreakFont = font;
 
-	core::stringw line;
-	core::stringw word;
-	core::stringw whitespace;
-	s32 size = Text.size();
-	s32 length = 0;
-	s32 elWidth = RelativeRect.getWidth() - 6;
-	wchar_t c;
-
-	for (s32 i=0; i<size; ++i)
-	{
-		c = Text[i];
-		bool lineBreak = false;
-
-		if (c == L'\r') // Mac or Windows breaks
-		{
-			lineBreak = true;
-			if (Text[i+1] == L'\n') // Windows breaks
-			{
-				Text.erase(i+1);
-				--size;
-			}
-			c = '\0';
-		}
-		else if (c == L'\n') // Unix breaks
-		{
-			lineBreak = true;
-			c = '\0';
-		}
-
-		if (c == L' ' || c == 0 || i == (size-1))
-		{
-			if (word.size())
-			{
-				// here comes the next whitespace, look if
-				// we can break the last word to the next line.
-				s32 whitelgth = font->getDimension(whitespace.c_str()).Width;
-				s32 worldlgth = font->getDimension(word.c_str()).Width;
-
-				if (length + worldlgth + whitelgth > elWidth)
-				{
-					// break to next line
-					length = worldlgth;
-					BrokenText.push_back(line);
-					line = word;
-				}
-				else
-				{
-					// add word to line
-					line += whitespace;
-					line += word;
-					length += whitelgth + worldlgth;
-				}
-
-				word = L"";
-				whitespace = L"";
-			}
-
-			whitespace += c;
-
-			// compute line break
-			if (lineBreak)
-			{
-				line += whitespace;
-				line += word;
-				BrokenText.push_back(line);
-				line = L"";
-				word = L"";
-				whitespace = L"";
-				length = 0;
-			}
-		}
-		else
-		{
-			// yippee this is a word..
-			word += c;
-		}
-	}
-
-	line += whitespace;
-	line += word;
-	BrokenText.push_back(line);
+	// without word wrap, only the width of the text is kept
+	Layout.update(Text, font, RelativeRect.getWidth() - 6, WordWrap, true);
 }
 
 
@@ -375,7 +294,7 @@ s32 CGUIStaticText::getTextHeight() const
 	s32 height = font->getDimension(L"A").Height + font->getKerningHeight();
 
 	if (WordWrap)
-		height *= BrokenText.size();
+		height *= Layout.getLineCount();
 
 	return height;
 }
@@ -395,19 +314,9 @@ s32 CGUIStaticText::getTextWidth() const
 	if(!font)
 		return 0;
 
-	if(WordWrap)
+	if(WordWrap || font == LastBreakFont)
 	{
-		s32 widest = 0;
-
-		for(u32 line = 0; line < BrokenText.size(); ++line)
-		{
-			s32 width = font->getDimension(BrokenText[line].c_str()).Width;
-
-			if(width > widest)
-				widest = width;
-		}
-
-		return widest;
+		return Layout.getWidth();
 	}
 	else
 	{
@@ -9,7 +9,7 @@
 #ifdef _IRR_COMPILE_WITH_GUI_
 
 #include "IGUIStaticText.h"
-#include "irrArray.h"
+#include "CGUITextLayout.h"
 
 namespace irr
 {
@@ -88,7 +88,7 @@ namespace gui
 
 	private:
 
-		//! Breaks the single text line.
+		//! Lays out the text, only changed lines are broken again.
 		void breakText();
 
 		EGUI_ALIGNMENT HAlign, VAlign;
@@ -101,7 +101,7 @@ namespace gui
 		gui::IGUIFont* OverrideFont;
 		gui::IGUIFont* LastBreakFont; // stored because: if skin changes, line break must be recalculated.
 
-		core::array< core::stringw > BrokenText;
+		CGUITextLayout Layout;
 	};
 
 } // end namespace gui
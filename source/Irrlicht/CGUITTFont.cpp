@@ -344,6 +344,13 @@ CGUITTFont::~CGUITTFont()
 
 void CGUITTFont::reset_images()
 {
+    // Draw the collected text while its glyph pages still exist.
+    if (Batch.isCollecting())
+    {
+        Batch.end(Driver);
+        Batch.begin();
+    }
+
     // Delete the glyphs.
     for (u32 i = 0; i != Glyphs.size(); ++i)
         Glyphs[i].unload();
@@ -453,13 +460,6 @@ void CGUITTFont::draw(const core::stringw& text, const core::rect<s32>& position
     if (!Driver)
         return;
 
-    // Clear the glyph pages of their render information.
-    for (u32 i = 0; i < Glyph_Pages.size(); ++i)
-    {
-        Glyph_Pages[i]->render_positions.clear();
-        Glyph_Pages[i]->render_source_rects.clear();
-    }
-
     // Set up some variables.
     core::dimension2d<s32> textDimension;
     core::position2d<s32> offset = position.UpperLeftCorner;
@@ -480,8 +480,7 @@ void CGUITTFont::draw(const core::stringw& text, const core::rect<s32>& position
     core::ustring utext(text);
     //u32 utext_size = utext.size();
 
-    // Set up our render map.
-    core::map<u32, CGUITTGlyphPage*> Render_Map;
+    if (!use_transparency) color.color |= 0xff000000;
 
     // Start parsing characters.
     u32 n;
@@ -527,12 +526,11 @@ void CGUITTFont::draw(const core::stringw& text, const core::rect<s32>& position
             offset.X += k.X;
             offset.Y += k.Y;
 
-            // Determine rendering information.
+            // Add the glyph to the draw of its page.
             SGUITTGlyph& glyph = Glyphs[n-1];
             CGUITTGlyphPage* const page = Glyph_Pages[glyph.glyph_page];
-            page->render_positions.push_back(core::position2di(offset.X + offx, offset.Y + offy));
-            page->render_source_rects.push_back(glyph.source_rect);
-            Render_Map.set(glyph.glyph_page, page);
+            Batch.add(page->texture, core::position2di(offset.X + offx, offset.Y + offy),
+                glyph.source_rect, color, clip);
         }
         offset.X += getWidthFromCharacter(currentChar);
 
@@ -540,20 +538,20 @@ void CGUITTFont::draw(const core::stringw& text, const core::rect<s32>& position
         ++iter;
     }
 
-    // Draw now.
+    // Draw now, unless the text is batched.
     update_glyph_pages();
-    core::map<u32, CGUITTGlyphPage*>::Iterator j = Render_Map.getIterator();
-    while (!j.atEnd())
-    {
-        core::map<u32, CGUITTGlyphPage*>::Node* n = j.getNode();
-        j++;
-        if (n == 0) continue;
+    Batch.draw(Driver);
+}
 
-        CGUITTGlyphPage* page = n->getValue();
+void CGUITTFont::beginBatch()
+{
+    Batch.begin();
+}
 
-        if (!use_transparency) color.color |= 0xff000000;
-        Driver->draw2DImageBatch(page->texture, page->render_positions, page->render_source_rects, clip, color, true);
-    }
+void CGUITTFont::endBatch()
+{
+    update_glyph_pages();
+    Batch.end(Driver);
 }
 
 core::dimension2d<u32> CGUITTFont::getCharDimension(const uchar32_t& ch) const
@@ -667,6 +665,11 @@ u32 CGUITTFont::getGlyphIndexByChar(wchar_t c) const
 
 u32 CGUITTFont::getGlyphIndexByChar(uchar32_t c) const
 {
+    // Characters which were drawn before don't need FreeType.
+    const s32 cached = Glyph_Indices.get(c, 0);
+    if (cached > 0 && Glyphs[cached - 1].isLoaded)
+        return cached;
+
     // Get the glyph.
     u32 glyph = FT_Get_Char_Index(tt_face, c);
 
@@ -676,7 +679,10 @@ u32 CGUITTFont::getGlyphIndexByChar(uchar32_t c) const
 
     // If our glyph is already loaded, don't bother doing any batch loading code.
     if (glyph != 0 && Glyphs[glyph - 1].isLoaded)
+    {
+        Glyph_Indices.set(c, glyph);
         return glyph;
+    }
 
     // Determine our batch loading positions.
     u32 half_size = (batch_load_size / 2);
@@ -700,6 +706,9 @@ u32 CGUITTFont::getGlyphIndexByChar(uchar32_t c) const
     }
     while (++start_pos < end_pos);
 
+    if (glyph != 0)
+        Glyph_Indices.set(c, glyph);
+
     // Return our original character.
     return glyph;
 }
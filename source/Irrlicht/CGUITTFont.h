@@ -6,6 +6,8 @@
 #include <irrlicht.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include "CGUICharacterTable.h"
+#include "CGUITextBatch.h"
 
 //Last updated by arch.jslin 2010.07.21:
 //   * Refactored the glyph loading part, so it doesn't need an additional CImage
@@ -159,9 +161,6 @@ public:
     u32 used_slots;
     bool dirty;
 
-    core::array<core::vector2di> render_positions;
-    core::array<core::recti> render_source_rects;
-
 private:
     core::array<const SGUITTGlyph*> glyph_to_be_paged;
     video::IVideoDriver* driver;
@@ -272,6 +271,12 @@ public:
     virtual void setInvisibleCharacters(const wchar_t *s);
     virtual void setInvisibleCharacters(const core::ustring& s);
 
+    //! Starts to collect the text of the following draw calls.
+    virtual void beginBatch();
+
+    //! Draws all text collected since beginBatch().
+    virtual void endBatch();
+
     void forceGlyphUpdate()
     {
         for (u32 i = 0; i != Glyph_Pages.size(); ++i)
@@ -366,6 +371,12 @@ private:
     mutable core::array<CGUITTGlyphPage*> Glyph_Pages;
     mutable core::array<SGUITTGlyph> Glyphs;
 
+    //! Glyph index of each character drawn so far, saves asking FreeType.
+    mutable CGUICharacterTable Glyph_Indices;
+
+    //! Glyphs of the draw calls, drawn per glyph page.
+    CGUITextBatch Batch;
+
     s32 GlobalKerningWidth;
     s32 GlobalKerningHeight;
     s32 supposed_line_height_;
@@ -26,7 +26,7 @@ namespace gui
 CGUITable::CGUITable(IGUIEnvironment* environment, IGUIElement* parent,
 						s32 id, const core::rect<s32>& rectangle, bool clip,
 						bool drawBack, bool moveOverSelect)
-: IGUITable(environment, parent, id, rectangle), Font(0),
+: IGUITable(environment, parent, id, rectangle), DataProvider(0), Font(0),
 	VerticalScrollBar(0), HorizontalScrollBar(0),
 	Clip(clip), DrawBack(drawBack), MoveOverSelect(moveOverSelect),
 	Selecting(false), CurrentResizedColumn(-1), ResizeStart(0), ResizableColumns(true),
@@ -68,6 +68,9 @@ CGUITable::~CGUITable()
 
 	if (Font)
 		Font->drop();
+
+	if (DataProvider)
+		DataProvider->drop();
 }
 
 
@@ -136,6 +139,9 @@ s32 CGUITable::getColumnCount() const
 
 s32 CGUITable::getRowCount() const
 {
+	if (DataProvider)
+		return DataProvider->getRowCount();
+
 	return Rows.size();
 }
 
@@ -223,12 +229,8 @@ void CGUITable::setColumnWidth(u32 columnIndex, u32 width)
 		if ( width < MIN_WIDTH )
 			width = MIN_WIDTH;
 
+		// the texts are broken again when they are drawn
 		Columns[columnIndex].Width = width;
-
-		for ( u32 i=0; i < Rows.size(); ++i )
-		{
-			breakText( Rows[i].Items[columnIndex].Text, Rows[i].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
-		}
 	}
 	recalculateWidths();
 }
@@ -273,7 +275,7 @@ u32 CGUITable::addRow(u32 rowIndex)
 
 void CGUITable::removeRow(u32 rowIndex)
 {
-	if ( rowIndex > Rows.size() )
+	if ( rowIndex >= Rows.size() )
 		return;
 
 	Rows.erase( rowIndex );
@@ -291,7 +293,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
-		breakText( Rows[rowIndex].Items[columnIndex].Text, Rows[rowIndex].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
+		Rows[rowIndex].Items[columnIndex].BrokenWidth = -1;
 
 		IGUISkin* skin = Environment->getSkin();
 		if ( skin )
@@ -304,7 +306,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
-		breakText( Rows[rowIndex].Items[columnIndex].Text, Rows[rowIndex].Items[columnIndex].BrokenText, Columns[columnIndex].Width );
+		Rows[rowIndex].Items[columnIndex].BrokenWidth = -1;
 		Rows[rowIndex].Items[columnIndex].Color = color;
 	}
 }
@@ -330,6 +332,14 @@ void CGUITable::setCellData(u32 rowIndex, u32 columnIndex, void *data)
 
 const wchar_t* CGUITable::getCellText(u32 rowIndex, u32 columnIndex ) const
 {
+	if ( DataProvider )
+	{
+		if ( rowIndex < DataProvider->getRowCount() && columnIndex < Columns.size() )
+			return DataProvider->getCellText(getProviderRow(rowIndex), columnIndex);
+
+		return 0;
+	}
+
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		return Rows[rowIndex].Items[columnIndex].Text.c_str();
@@ -356,6 +366,7 @@ void CGUITable::clear()
     Selected = -1;
 	Rows.clear();
 	Columns.clear();
+	setDataProvider(0);
 
 	if (VerticalScrollBar)
 		VerticalScrollBar->setPos(0);
@@ -371,6 +382,7 @@ void CGUITable::clearRows()
 {
     Selected = -1;
 	Rows.clear();
+	setDataProvider(0);
 
 	if (VerticalScrollBar)
 		VerticalScrollBar->setPos(0);
@@ -390,7 +402,7 @@ s32 CGUITable::getSelected() const
 void CGUITable::setSelected( s32 index )
 {
 	Selected = -1;
-	if ( index >= 0 && index < (s32) Rows.size() )
+	if ( index >= 0 && index < getRowCount() )
 		Selected = index;
 }
 
@@ -424,8 +436,13 @@ void CGUITable::recalculateHeights()
 			ItemHeight = Font->getDimension(L"A").Height + (CellHeightPadding * 2);
 			Font->grab();
 		}
+
+		// the texts are broken again with the new font
+		for ( u32 i=0; i < Rows.size(); ++i )
+			for ( u32 j=0; j < Rows[i].Items.size(); ++j )
+				Rows[i].Items[j].BrokenWidth = -1;
 	}
-	TotalItemHeight = ItemHeight * Rows.size();		//  header is not counted, because we only want items
+	TotalItemHeight = ItemHeight * getRowCount();		//  header is not counted, because we only want items
 	checkScrollbars();
 }
 
@@ -675,15 +692,27 @@ void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 
 void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 {
-	if ( rowIndexA >= Rows.size() )
+	const u32 count = getRowCount();
+	if ( rowIndexA >= count )
 		return;
 
-	if ( rowIndexB >= Rows.size() )
+	if ( rowIndexB >= count )
 		return;
 
-	Row swap = Rows[rowIndexA];
-	Rows[rowIndexA] = Rows[rowIndexB];
-	Rows[rowIndexB] = swap;
+	if ( DataProvider )
+	{
+		const u32 swap = getProviderRow(rowIndexA);
+		if ( ProviderOrder.empty() )
+		{
+			ProviderOrder.reallocate(count);
+			for ( u32 i=0; i < count; ++i )
+				ProviderOrder.push_back(i);
+		}
+		ProviderOrder[rowIndexA] = ProviderOrder[rowIndexB];
+		ProviderOrder[rowIndexB] = swap;
+	}
+	else
+		Rows[rowIndexA].Items.swap(Rows[rowIndexB].Items);
 
 	if ( Selected == s32(rowIndexA) )
 		Selected = rowIndexB;
@@ -776,51 +805,65 @@ bool CGUITable::selectColumnHeader(s32 xpos, s32 ypos)
 
 void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
 {
-	Row swap;
-
 	if ( columnIndex == -1 )
 		columnIndex = getActiveColumn();
-	if ( columnIndex < 0 )
+	if ( columnIndex < 0 || columnIndex >= (s32)Columns.size() )
+		return;
+
+	if ( mode != EGOM_ASCENDING && mode != EGOM_DESCENDING )
 		return;
 
-	if ( mode == EGOM_ASCENDING )
+	const u32 count = getRowCount();
+
+	// the texts of a provider only stay valid until its next call
+	core::array<core::stringw> providerTexts;
+	if ( DataProvider )
+	{
+		providerTexts.reallocate(count);
+		for ( u32 i=0; i < count; ++i )
+			providerTexts.push_back(DataProvider->getCellText(getProviderRow(i), columnIndex));
+	}
+
+	// only the keys are sorted, the rows are moved once afterwards
+	core::array<RowOrderKey> keys;
+	keys.reallocate(count);
+	for ( u32 i=0; i < count; ++i )
+	{
+		RowOrderKey key;
+		key.Text = DataProvider ? &providerTexts[i] : &Rows[i].Items[columnIndex].Text;
+		key.Index = i;
+		key.Descending = (mode == EGOM_DESCENDING);
+		keys.push_back(key);
+	}
+	keys.sort();
+
+	if ( DataProvider )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
+		core::array<u32> order;
+		order.reallocate(count);
+		for ( u32 i=0; i < count; ++i )
+			order.push_back(getProviderRow(keys[i].Index));
+		ProviderOrder.swap(order);
+	}
+	else
+	{
+		// swapping the cells of the rows doesn't copy them
+		core::array<Row> rows;
+		rows.reallocate(count);
+		for ( u32 i=0; i < count; ++i )
 		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j+1].Items[columnIndex].Text < Rows[j].Items[columnIndex].Text )
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
+			rows.push_back(Row());
+			rows[i].Items.swap(Rows[keys[i].Index].Items);
 		}
+		Rows.swap(rows);
 	}
-	else if ( mode == EGOM_DESCENDING )
+
+	for ( u32 i=0; i < count; ++i )
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
+		if ( (s32)keys[i].Index == Selected )
 		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j].Items[columnIndex].Text < Rows[j+1].Items[columnIndex].Text)
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
+			Selected = i;
+			break;
 		}
 	}
 }
@@ -841,8 +884,8 @@ void CGUITable::selectNew(s32 ypos, bool onlyHover)
 	if (ItemHeight!=0)
 		Selected = ((ypos - AbsoluteRect.UpperLeftCorner.Y - ItemHeight - 1) + VerticalScrollBar->getPos()) / ItemHeight;
 
-	if (Selected >= (s32)Rows.size())
-		Selected = Rows.size() - 1;
+	if (Selected >= getRowCount())
+		Selected = getRowCount() - 1;
 	else if (Selected<0)
 		Selected = 0;
 
@@ -917,11 +960,23 @@ void CGUITable::draw()
 	core::rect<s32> rowRect(scrolledTableClient);
 	rowRect.LowerRightCorner.Y = rowRect.UpperLeftCorner.Y + ItemHeight;
 
+	// start at the first row reaching into the table, so only visible rows are visited
+	const s32 rowCount = getRowCount();
+	s32 first = 0;
+	if ( ItemHeight > 0 && rowRect.LowerRightCorner.Y < AbsoluteRect.UpperLeftCorner.Y )
+	{
+		first = core::min_((AbsoluteRect.UpperLeftCorner.Y - rowRect.LowerRightCorner.Y) / ItemHeight, rowCount);
+		rowRect.UpperLeftCorner.Y += first * ItemHeight;
+		rowRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
 	u32 pos;
-	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+	for ( s32 i = first ; i < rowCount ; ++i )
 	{
-		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		if (rowRect.UpperLeftCorner.Y > AbsoluteRect.LowerRightCorner.Y)
+			break;
+
+		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
 			// draw row seperator
 			if ( DrawFlags & EGTDF_ROWS )
@@ -935,7 +990,7 @@ void CGUITable::draw()
 			pos = rowRect.UpperLeftCorner.X;
 
 			// draw selected row background highlighted
-			if ((s32)i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
+			if (i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
 				driver->draw2DRectangle(skin->getColor(EGDC_HIGH_LIGHT), rowRect, &clientClip);
 
 			for ( u32 j = 0 ; j < Columns.size() ; ++j )
@@ -943,14 +998,35 @@ void CGUITable::draw()
 				textRect.UpperLeftCorner.X = pos + CellWidthPadding;
 				textRect.LowerRightCorner.X = pos + Columns[j].Width - CellWidthPadding;
 
+				// only the texts of drawn cells are broken
+				const core::stringw* brokenText = &ProviderCell;
+				video::SColor color;
+				if (DataProvider)
+				{
+					const u32 row = getProviderRow(i);
+					breakText(DataProvider->getCellText(row, j), ProviderCell, Columns[j].Width);
+					color = DataProvider->getCellColor(row, j, skin->getColor(EGDC_BUTTON_TEXT));
+				}
+				else
+				{
+					Cell& cell = Rows[i].Items[j];
+					if (cell.BrokenWidth != (s32)Columns[j].Width)
+					{
+						breakText(cell.Text, cell.BrokenText, Columns[j].Width);
+						cell.BrokenWidth = Columns[j].Width;
+					}
+					brokenText = &cell.BrokenText;
+					color = cell.Color;
+				}
+
 				// draw item text
-				if ((s32)i == Selected)
+				if (i == Selected)
 				{
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, skin->getColor(IsEnabled ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
+					font->draw(brokenText->c_str(), textRect, skin->getColor(IsEnabled ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 				else
 				{
-					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, IsEnabled ? Rows[i].Items[j].Color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
+					font->draw(brokenText->c_str(), textRect, IsEnabled ? color : skin->getColor(EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
 
 				pos += Columns[j].Width;
@@ -1048,11 +1124,12 @@ void CGUITable::breakText(const core::stringw& text, core::stringw& brokenText,
 		if (c[0] == L'\n')
 			break;
 
+		// the width of the line grows with each character, so it isn't measured again
 		pos += font->getDimension(c).Width;
 		if ( pos > maxLength )
 			break;
 
-		if ( font->getDimension( (line + c).c_str() ).Width > maxLengthDots )
+		if ( pos > maxLengthDots )
 			lineDots = line;
 
 		line += c[0];
@@ -1079,6 +1156,47 @@ s32 CGUITable::getDrawFlags() const
 }
 
 
+//! Sets a provider which supplies the rows instead of the rows added to the table
+void CGUITable::setDataProvider(IGUITableDataProvider* provider)
+{
+	if (provider != DataProvider)
+	{
+		if (provider)
+			provider->grab();
+		if (DataProvider)
+			DataProvider->drop();
+
+		DataProvider = provider;
+		Rows.clear();
+		Selected = -1;
+
+		if (VerticalScrollBar)
+			VerticalScrollBar->setPos(0);
+	}
+
+	// the amount of rows may have changed
+	ProviderOrder.clear();
+	if (Selected >= getRowCount())
+		Selected = getRowCount() - 1;
+
+	recalculateHeights();
+}
+
+
+//! Returns the provider which supplies the rows
+IGUITableDataProvider* CGUITable::getDataProvider() const
+{
+	return DataProvider;
+}
+
+
+//! returns the row of the provider shown at a row of the table
+u32 CGUITable::getProviderRow(u32 rowIndex) const
+{
+	return ProviderOrder.empty() ? rowIndex : ProviderOrder[rowIndex];
+}
+
+
 //! Writes attributes of the element.
 void CGUITable::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
@@ -1153,6 +1271,7 @@ void CGUITable::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWri
 	IGUITable::deserializeAttributes(in, options);
 
 	Columns.clear();
+	setDataProvider(0);
 	u32 columnCount = in->getAttributeAsInt("ColumnCount");
 	u32 i;
 	for (i=0;i<columnCount; ++i)
@@ -1199,7 +1318,6 @@ void CGUITable::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWri
 
 			label = "Row"; label += i; label += "cell"; label += c; label += "text";
 			cell.Text = core::stringw(in->getAttributeAsString(label.c_str()).c_str());
-			breakText( cell.Text, cell.BrokenText, Columns[c].Width );
 			label = "Row"; label += i; label += "cell"; label += c; label += "color";
 			cell.Color = in->getAttributeAsColor(label.c_str());
 			cell.Data = NULL;
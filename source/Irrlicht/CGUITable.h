@@ -140,6 +140,12 @@ namespace gui
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const;
 
+		//! Sets a provider which supplies the rows instead of the rows added to the table
+		virtual void setDataProvider(IGUITableDataProvider* provider);
+
+		//! Returns the provider which supplies the rows, or 0 if the table has its own rows
+		virtual IGUITableDataProvider* getDataProvider() const;
+
 		//! Writes attributes of the object.
 		//! Implement this to expose the attributes of your scene node animator for
 		//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -158,9 +164,11 @@ namespace gui
 
 		struct Cell
 		{
-			Cell() : Data(0) {}
+			Cell() : BrokenWidth(-1), Data(0) {}
 			core::stringw Text;
 			core::stringw BrokenText;
+			// column width the BrokenText was made for, it is made when drawn
+			s32 BrokenWidth;
 			video::SColor Color;
 			void *Data;
 		};
@@ -180,7 +188,23 @@ namespace gui
 			EGUI_COLUMN_ORDERING OrderingMode;
 		};
 
+		//! orders rows by the text of a column, rows with equal text keep their order
+		struct RowOrderKey
+		{
+			bool operator<(const RowOrderKey& other) const
+			{
+				if (*Text == *other.Text)
+					return Index < other.Index;
+				return Descending ? *other.Text < *Text : *Text < *other.Text;
+			}
+
+			const core::stringw* Text;
+			u32 Index;
+			bool Descending;
+		};
+
 		void breakText(const core::stringw &text, core::stringw & brokenText, u32 cellWidth);
+		u32 getProviderRow(u32 rowIndex) const;
 		void selectNew(s32 ypos, bool onlyHover=false);
 		bool selectColumnHeader(s32 xpos, s32 ypos);
 		bool dragColumnStart(s32 xpos, s32 ypos);
@@ -190,6 +214,10 @@ namespace gui
 
 		core::array< Column > Columns;
 		core::array< Row > Rows;
+		IGUITableDataProvider* DataProvider;
+		// rows of the provider in the order they are shown, empty if not ordered
+		core::array< u32 > ProviderOrder;
+		core::stringw ProviderCell;
 		gui::IGUIFont* Font;
 		gui::IGUIScrollBar* VerticalScrollBar;
 		gui::IGUIScrollBar* HorizontalScrollBar;
@@ -0,0 +1,111 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGUITextBatch.h"
+#ifdef _IRR_COMPILE_WITH_GUI_
+
+#include "IVideoDriver.h"
+
+namespace irr
+{
+namespace gui
+{
+
+CGUITextBatch::CGUITextBatch()
+: Used(0), Last(0), Collecting(false)
+{
+}
+
+
+//! starts collecting, draw() only draws when end() is called
+void CGUITextBatch::begin()
+{
+	Collecting = true;
+}
+
+
+//! stops collecting and draws all glyphs
+void CGUITextBatch::end(video::IVideoDriver* driver)
+{
+	Collecting = false;
+	flush(driver);
+}
+
+
+//! adds a glyph
+void CGUITextBatch::add(video::ITexture* texture, const core::position2di& pos,
+		const core::rect<s32>& sourceRect, video::SColor color,
+		const core::rect<s32>* clip)
+{
+	if (!texture)
+		return;
+
+	// glyphs usually belong to the same draw as the one before
+	u32 i = Last;
+	if (i >= Used || Draws[i].Texture != texture || Draws[i].Color != color ||
+		Draws[i].Clipped != (clip != 0) || (clip && Draws[i].Clip != *clip))
+	{
+		for (i=0; i<Used; ++i)
+		{
+			const SDraw& d = Draws[i];
+			if (d.Texture == texture && d.Color == color && d.Clipped == (clip != 0) &&
+				(!clip || d.Clip == *clip))
+				break;
+		}
+
+		if (i == Used)
+		{
+			if (Used == Draws.size())
+				Draws.push_back(SDraw());
+
+			SDraw& d = Draws[Used++];
+			d.Texture = texture;
+			d.Color = color;
+			d.Clipped = clip != 0;
+			if (clip)
+				d.Clip = *clip;
+		}
+
+		Last = i;
+	}
+
+	Draws[i].Positions.push_back(pos);
+	Draws[i].SourceRects.push_back(sourceRect);
+}
+
+
+//! draws all glyphs, unless the batch is collecting
+void CGUITextBatch::draw(video::IVideoDriver* driver)
+{
+	if (!Collecting)
+		flush(driver);
+}
+
+
+//! draws and clears all glyphs
+void CGUITextBatch::flush(video::IVideoDriver* driver)
+{
+	for (u32 i=0; i<Used; ++i)
+	{
+		SDraw& d = Draws[i];
+
+		if (driver)
+			driver->draw2DImageBatch(d.Texture, d.Positions, d.SourceRects,
+				d.Clipped ? &d.Clip : 0, d.Color, true);
+
+		// keeps the memory
+		d.Positions.set_used(0);
+		d.SourceRects.set_used(0);
+	}
+
+	Used = 0;
+	Last = 0;
+}
+
+
+} // end namespace gui
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_GUI_
+
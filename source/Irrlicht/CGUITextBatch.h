@@ -0,0 +1,84 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_GUI_TEXT_BATCH_H_INCLUDED__
+#define __C_GUI_TEXT_BATCH_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_GUI_
+
+#include "irrArray.h"
+#include "rect.h"
+#include "SColor.h"
+
+namespace irr
+{
+
+namespace video
+{
+	class IVideoDriver;
+	class ITexture;
+}
+
+namespace gui
+{
+
+//! Collects the glyphs of text draw calls of a font
+/** The glyphs are drawn with one draw2DImageBatch call per texture, color
+and clip rectangle. The arrays are kept between draws, so drawing text
+does not allocate memory once the batch has grown. */
+class CGUITextBatch
+{
+public:
+
+	CGUITextBatch();
+
+	//! starts collecting, draw() only draws when end() is called
+	void begin();
+
+	//! stops collecting and draws all glyphs
+	void end(video::IVideoDriver* driver);
+
+	//! returns if glyphs are collected for a later end()
+	bool isCollecting() const { return Collecting; }
+
+	//! adds a glyph
+	void add(video::ITexture* texture, const core::position2di& pos,
+		const core::rect<s32>& sourceRect, video::SColor color,
+		const core::rect<s32>* clip);
+
+	//! draws all glyphs, unless the batch is collecting
+	void draw(video::IVideoDriver* driver);
+
+	//! returns the amount of draw calls the glyphs need
+	u32 getDrawCount() const { return Used; }
+
+private:
+
+	struct SDraw
+	{
+		video::ITexture* Texture;
+		video::SColor Color;
+		core::rect<s32> Clip;
+		bool Clipped;
+		core::array<core::position2di> Positions;
+		core::array<core::rect<s32> > SourceRects;
+	};
+
+	//! draws and clears all glyphs
+	void flush(video::IVideoDriver* driver);
+
+	core::array<SDraw> Draws;
+	u32 Used;
+	u32 Last;
+	bool Collecting;
+};
+
+} // end namespace gui
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_GUI_
+
+#endif // __C_GUI_TEXT_BATCH_H_INCLUDED__
+
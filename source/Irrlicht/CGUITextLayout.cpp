@@ -0,0 +1,256 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CGUITextLayout.h"
+#ifdef _IRR_COMPILE_WITH_GUI_
+
+#include "IGUIFont.h"
+
+namespace irr
+{
+namespace gui
+{
+
+//! constructor
+CGUITextLayout::CGUITextLayout()
+: Font(0), MaxWidth(0), Width(0), WordWrap(false), LineBreaks(false)
+{
+}
+
+
+//! destructor
+CGUITextLayout::~CGUITextLayout()
+{
+	if (Font)
+		Font->drop();
+}
+
+
+//! Forgets the layout
+void CGUITextLayout::clear()
+{
+	Paragraphs.clear();
+	Lines.clear();
+	LineStarts.clear();
+	Width = 0;
+}
+
+
+//! Lays out a text, keeping the lines of unchanged paragraphs
+void CGUITextLayout::update(const core::stringw& text, IGUIFont* font, s32 width,
+			bool wordWrap, bool lineBreaks)
+{
+	if (!wordWrap)
+		width = 0;
+
+	if (font != Font || width != MaxWidth || wordWrap != WordWrap || lineBreaks != LineBreaks)
+	{
+		if (font)
+			font->grab();
+		if (Font)
+			Font->drop();
+
+		Font = font;
+		MaxWidth = width;
+		WordWrap = wordWrap;
+		LineBreaks = lineBreaks;
+		clear();
+	}
+
+	if (!Font)
+		return;
+
+	// a paragraph ends after its line break
+	const u32 size = text.size();
+	ParagraphStarts.set_used(0);
+	ParagraphStarts.push_back(0);
+	for (u32 i=0; LineBreaks && i<size; ++i)
+	{
+		if (text[i] == L'\r' && text[i+1] == L'\n')
+			++i;
+
+		if (text[i] == L'\r' || text[i] == L'\n')
+			ParagraphStarts.push_back(i+1);
+	}
+
+	const u32 count = ParagraphStarts.size();
+	ParagraphStarts.push_back(size);
+
+	// paragraphs at the start and at the end of the text which did not change
+	u32 head = 0;
+	while (head < count && head < Paragraphs.size() &&
+		Paragraphs[head].Text.size() == ParagraphStarts[head+1] - ParagraphStarts[head] &&
+		!memcmp(Paragraphs[head].Text.c_str(), text.c_str() + ParagraphStarts[head],
+			Paragraphs[head].Text.size() * sizeof(wchar_t)))
+		++head;
+
+	if (head == count && head == Paragraphs.size())
+		return;
+
+	u32 tail = 0;
+	while (tail < count - head && tail < Paragraphs.size() - head)
+	{
+		const SParagraph& p = Paragraphs[Paragraphs.size() - 1 - tail];
+		const u32 start = ParagraphStarts[count - 1 - tail];
+		if (p.Text.size() != ParagraphStarts[count - tail] - start ||
+			memcmp(p.Text.c_str(), text.c_str() + start, p.Text.size() * sizeof(wchar_t)))
+			break;
+		++tail;
+	}
+
+	if (count == Paragraphs.size())
+	{
+		// break the changed paragraphs in place
+		for (u32 i=head; i<count-tail; ++i)
+		{
+			Paragraphs[i].Text = text.subString(ParagraphStarts[i], ParagraphStarts[i+1] - ParagraphStarts[i]);
+			breakParagraph(Paragraphs[i], i == count-1);
+		}
+	}
+	else
+	{
+		core::array<SParagraph> paragraphs;
+		paragraphs.reallocate(count);
+		for (u32 i=0; i<count; ++i)
+		{
+			paragraphs.push_back(SParagraph());
+			SParagraph& p = paragraphs.getLast();
+
+			if (i < head || i >= count - tail)
+			{
+				SParagraph& old = Paragraphs[i < head ? i : i + Paragraphs.size() - count];
+				p.Text = old.Text;
+				p.Lines.swap(old.Lines);
+			}
+			else
+			{
+				p.Text = text.subString(ParagraphStarts[i], ParagraphStarts[i+1] - ParagraphStarts[i]);
+				breakParagraph(p, i == count-1);
+			}
+		}
+		Paragraphs.swap(paragraphs);
+	}
+
+	Lines.set_used(0);
+	LineStarts.set_used(0);
+	Width = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::array<SLine>& lines = Paragraphs[i].Lines;
+		for (u32 j=0; j<lines.size(); ++j)
+		{
+			Lines.push_back(&lines[j]);
+			LineStarts.push_back(ParagraphStarts[i] + lines[j].Start);
+			Width = core::max_(Width, lines[j].Width);
+		}
+	}
+}
+
+
+//! breaks a paragraph into lines
+/** The last paragraph of the text has no line break, its last character
+never starts a new line. */
+void CGUITextLayout::breakParagraph(SParagraph& paragraph, bool last)
+{
+	const core::stringw& text = paragraph.Text;
+	paragraph.Lines.set_used(0);
+
+	const s32 size = text.size();
+	s32 lineStart = 0;
+	s32 lineEnd = 0;
+	s32 length = 0;
+	s32 wordLength = 0;
+	s32 whitespaceLength = 0;
+
+	for (s32 i=0; i<size; ++i)
+	{
+		wchar_t c = text[i];
+		bool lineBreak = false;
+
+		if (c == L'\r' || c == L'\n')
+		{
+			lineBreak = LineBreaks;
+			c = L' ';
+		}
+
+		if (c == L' ' || (last && i == size-1))
+		{
+			if (wordLength)
+			{
+				// here comes the next whitespace, look if
+				// we can break the last word to the next line.
+				const s32 wordStart = i - wordLength;
+				if (WordWrap)
+				{
+					const s32 whitelgth = measure(text, wordStart - whitespaceLength, whitespaceLength);
+					const s32 worldlgth = measure(text, wordStart, wordLength);
+
+					if (length + worldlgth + whitelgth > MaxWidth)
+					{
+						// break to next line
+						addLine(paragraph, lineStart, lineEnd - lineStart, false);
+						lineStart = wordStart;
+						length = worldlgth;
+					}
+					else
+						length += whitelgth + worldlgth;
+				}
+
+				lineEnd = i;
+				wordLength = 0;
+				whitespaceLength = 0;
+			}
+
+			++whitespaceLength;
+
+			// the rest of the paragraph is the line break
+			if (lineBreak)
+			{
+				addLine(paragraph, lineStart, i - lineStart, true);
+				return;
+			}
+		}
+		else
+		{
+			// yippee this is a word..
+			++wordLength;
+		}
+	}
+
+	addLine(paragraph, lineStart, size - lineStart, false);
+}
+
+
+//! adds a line to a paragraph and measures it
+void CGUITextLayout::addLine(SParagraph& paragraph, u32 start, u32 length, bool lineBreak)
+{
+	paragraph.Lines.push_back(SLine());
+	SLine& line = paragraph.Lines.getLast();
+
+	line.Text = paragraph.Text.subString(start, length);
+	line.Start = start;
+	line.Width = measure(paragraph.Text, start, length);
+	line.Break = lineBreak;
+}
+
+
+//! returns the width of a part of a text, line breaks are measured as spaces
+s32 CGUITextLayout::measure(const core::stringw& text, u32 start, u32 length) const
+{
+	core::stringw part = text.subString(start, length);
+	for (u32 i=0; i<part.size(); ++i)
+	{
+		if (part[i] == L'\r' || part[i] == L'\n')
+			part[i] = L' ';
+	}
+
+	return Font->getDimension(part.c_str()).Width;
+}
+
+
+} // end namespace gui
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_GUI_
+
@@ -0,0 +1,123 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_GUI_TEXT_LAYOUT_H_INCLUDED__
+#define __C_GUI_TEXT_LAYOUT_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_GUI_
+
+#include "irrString.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace gui
+{
+	class IGUIFont;
+
+	//! Breaks a text into lines and keeps them until the text, font or width changes
+	/** The text is laid out in paragraphs, which end with a line break. When
+	the text changes, only the paragraphs which are different are broken and
+	measured again. The lines keep their widths, so they are not measured
+	again when they are drawn. */
+	class CGUITextLayout
+	{
+	public:
+
+		//! constructor
+		CGUITextLayout();
+
+		//! destructor
+		~CGUITextLayout();
+
+		//! Lays out a text, keeping the lines of unchanged paragraphs
+		/** \param text Text to lay out.
+		\param font Font to measure the text with.
+		\param width Lines wider than this are broken when wordWrap is set.
+		\param wordWrap Break lines at spaces when they get too wide.
+		\param lineBreaks Break lines at \\r, \\n and \\r\\n, otherwise they
+		are spaces. */
+		void update(const core::stringw& text, IGUIFont* font, s32 width,
+			bool wordWrap, bool lineBreaks);
+
+		//! Forgets the layout, so the next update lays out the whole text
+		void clear();
+
+		//! Returns the amount of lines
+		u32 getLineCount() const
+		{
+			return Lines.size();
+		}
+
+		//! Returns the text of a line, without the line break
+		const core::stringw& getLineText(u32 line) const
+		{
+			return Lines[line]->Text;
+		}
+
+		//! Returns the position of the first character of a line in the text
+		u32 getLineStart(u32 line) const
+		{
+			return LineStarts[line];
+		}
+
+		//! Returns the width of a line in pixels
+		s32 getLineWidth(u32 line) const
+		{
+			return Lines[line]->Width;
+		}
+
+		//! Returns if a line ends with a line break of the text
+		bool hasLineBreak(u32 line) const
+		{
+			return Lines[line]->Break;
+		}
+
+		//! Returns the width of the widest line
+		s32 getWidth() const
+		{
+			return Width;
+		}
+
+	private:
+
+		struct SLine
+		{
+			core::stringw Text;
+			// position in the paragraph
+			u32 Start;
+			s32 Width;
+			bool Break;
+		};
+
+		struct SParagraph
+		{
+			core::stringw Text;
+			core::array<SLine> Lines;
+		};
+
+		void breakParagraph(SParagraph& paragraph, bool last);
+		void addLine(SParagraph& paragraph, u32 start, u32 length, bool lineBreak);
+		s32 measure(const core::stringw& text, u32 start, u32 length) const;
+
+		core::array<SParagraph> Paragraphs;
+		core::array<const SLine*> Lines;
+		core::array<u32> LineStarts;
+		core::array<u32> ParagraphStarts;
+
+		IGUIFont* Font;
+		s32 MaxWidth;
+		s32 Width;
+		bool WordWrap;
+		bool LineBreaks;
+	};
+
+} // end namespace gui
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_GUI_
+
+#endif
+
@@ -6,6 +6,7 @@
 #include "irrString.h"
 #include "CColorConverter.h"
 #include "CBlit.h"
+#include "os.h"
 
 namespace irr
 {
@@ -14,7 +15,7 @@ namespace video
 
 //! Constructor of empty image
 CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size)
-:Data(0), Size(size), Format(format), DeleteMemory(true)
+:Data(0), MipMapsData(0), Size(size), Format(format), DeleteMemory(true)
 {
 	initData();
 }
@@ -23,7 +24,7 @@ CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size)
 //! Constructor from raw data
 CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size, void* data,
 			bool ownForeignMemory, bool deleteForeignMemory)
-: Data(0), Size(size), Format(format), DeleteMemory(deleteForeignMemory)
+: Data(0), MipMapsData(0), Size(size), Format(format), DeleteMemory(deleteForeignMemory)
 {
 	if (ownForeignMemory)
 	{
@@ -35,7 +36,7 @@ CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size, void* d
 	{
 		Data = 0;
 		initData();
-		memcpy(Data, data, Size.Height * Pitch);
+		memcpy(Data, data, getImageDataSizeInBytes());
 	}
 }
 
@@ -51,8 +52,12 @@ void CImage::initData()
 	// Pitch should be aligned...
 	Pitch = BytesPerPixel * Size.Width;
 
+	// compressed images are stored in rows of blocks
+	if (isCompressedFormat(Format))
+		Pitch = getDataSizeFromFormat(Format, Size.Width, 4);
+
 	if (!Data)
-		Data = new u8[Size.Height * Pitch];
+		Data = new u8[getImageDataSizeInBytes()];
 }
 
 
@@ -61,6 +66,7 @@ CImage::~CImage()
 {
 	if ( DeleteMemory )
 		delete [] Data;
+	delete [] MipMapsData;
 }
 
 
@@ -88,6 +94,9 @@ u32 CImage::getBytesPerPixel() const
 //! Returns image data size in bytes
 u32 CImage::getImageDataSizeInBytes() const
 {
+	if (isCompressedFormat(Format))
+		return getDataSizeFromFormat(Format, Size.Width, Size.Height);
+
 	return Pitch * Size.Height;
 }
 
@@ -208,6 +217,9 @@ void CImage::setPixel(u32 x, u32 y, const SColor &color, bool blend)
 			u32 * dest = (u32*) (Data + ( y * Pitch ) + ( x << 2 ));
 			*dest = blend ? PixelBlend32 ( *dest, color.color ) : color.color;
 		} break;
+
+		default:
+			break;
 	}
 }
 
@@ -231,6 +243,15 @@ SColor CImage::getPixel(u32 x, u32 y) const
 			u8* p = Data+(y*3)*Size.Width + (x*3);
 			return SColor(255,p[0],p[1],p[2]);
 		}
+	case ECF_DXT1:
+	case ECF_DXT5:
+		{
+			u32 colors[16];
+			CColorConverter::decompressDXTBlock(Data + (y >> 2) * Pitch + (x >> 2) * (Format == ECF_DXT1 ? 8 : 16), Format, colors);
+			return colors[((y & 3) << 2) + (x & 3)];
+		}
+	default:
+		break;
 	}
 
 	return SColor(0);
@@ -247,13 +268,50 @@ ECOLOR_FORMAT CImage::getColorFormat() const
 //! copies this surface into another at given position
 void CImage::copyTo(IImage* target, const core::position2d<s32>& pos)
 {
-	Blit(BLITTER_TEXTURE, target, 0, &pos, this, 0, 0);
+	const ECOLOR_FORMAT targetFormat = target->getColorFormat();
+	if (!isCompressedFormat(Format) && !isCompressedFormat(targetFormat))
+	{
+		Blit(BLITTER_TEXTURE, target, 0, &pos, this, 0, 0);
+		return;
+	}
+
+	// whole images are decompressed or compressed block by block
+	if (pos.X == 0 && pos.Y == 0 && target->getDimension() == Size &&
+		(Format == targetFormat || Format == ECF_A8R8G8B8 || !isCompressedFormat(targetFormat)))
+	{
+		if (Format == targetFormat)
+			memcpy(target->lock(), Data, getImageDataSizeInBytes());
+		else if (Format == ECF_A8R8G8B8)
+			CColorConverter::compressDXT(Data, Size.Width, Size.Height, Pitch, target->lock(), targetFormat);
+		else
+			CColorConverter::decompressDXT(Data, Format, Size.Width, Size.Height, target->lock(), targetFormat, target->getPitch());
+		target->unlock();
+		return;
+	}
+
+	if (isCompressedFormat(targetFormat) && (pos.X != 0 || pos.Y != 0 || target->getDimension() != Size))
+	{
+		os::Printer::log("Could not copy image, compressed images can only be copied as a whole.", ELL_WARNING);
+		return;
+	}
+
+	CImage* image = createA8R8G8B8Copy();
+	image->copyTo(target, pos);
+	image->drop();
 }
 
 
 //! copies this surface partially into another at given position
 void CImage::copyTo(IImage* target, const core::position2d<s32>& pos, const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* image = createA8R8G8B8Copy();
+		image->copyTo(target, pos, sourceRect, clipRect);
+		image->drop();
+		return;
+	}
+
 	Blit(BLITTER_TEXTURE, target, clipRect, &pos, this, &sourceRect, 0);
 }
 
@@ -261,6 +319,14 @@ void CImage::copyTo(IImage* target, const core::position2d<s32>& pos, const core
 //! copies this surface into another, using the alpha mask, a cliprect and a color to add with
 void CImage::copyToWithAlpha(IImage* target, const core::position2d<s32>& pos, const core::rect<s32>& sourceRect, const SColor &color, const core::rect<s32>* clipRect)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* image = createA8R8G8B8Copy();
+		image->copyToWithAlpha(target, pos, sourceRect, color, clipRect);
+		image->drop();
+		return;
+	}
+
 	// color blend only necessary on not full spectrum aka. color.color != 0xFFFFFFFF
 	Blit(color.color == 0xFFFFFFFF ? BLITTER_TEXTURE_ALPHA_BLEND: BLITTER_TEXTURE_ALPHA_COLOR_BLEND,
 			target, clipRect, &pos, this, &sourceRect, color.color);
@@ -274,6 +340,30 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 	if (!target || !width || !height)
 		return;
 
+	// compressed images are scaled uncompressed
+	if (isCompressedFormat(Format))
+	{
+		if (Format==format && Size.Width==width && Size.Height==height)
+		{
+			memcpy(target, Data, getImageDataSizeInBytes());
+			return;
+		}
+
+		CImage* image = createA8R8G8B8Copy();
+		image->copyToScaling(target, width, height, format, pitch);
+		image->drop();
+		return;
+	}
+
+	if (isCompressedFormat(format))
+	{
+		CImage* image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(width, height));
+		copyToScaling(image->Data, width, height, ECF_A8R8G8B8, image->Pitch);
+		CColorConverter::compressDXT(image->Data, width, height, image->Pitch, target, format);
+		image->drop();
+		return;
+	}
+
 	const u32 bpp=getBitsPerPixelFromFormat(format)/8;
 	if (0==pitch)
 		pitch = width*bpp;
@@ -346,6 +436,14 @@ void CImage::copyToScaling(IImage* target)
 //! copies this surface into another, scaling it to fit it.
 void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* image = createA8R8G8B8Copy();
+		image->copyToScalingBoxFilter(target, bias, blend);
+		image->drop();
+		return;
+	}
+
 	const core::dimension2d<u32> destSize = target->getDimension();
 
 	const f32 sourceXStep = (f32) Size.Width / (f32) destSize.Width;
@@ -405,6 +503,12 @@ void CImage::fill(const SColor &color)
 			return;
 		}
 		break;
+		case ECF_DXT1:
+		case ECF_DXT5:
+			os::Printer::log("Compressed images cannot be filled", ELL_WARNING);
+			return;
+		default:
+			return;
 	}
 	if (Format != ECF_A1R5G5B5 && Format != ECF_R5G6B5 &&
 			Format != ECF_A8R8G8B8)
@@ -414,6 +518,32 @@ void CImage::fill(const SColor &color)
 }
 
 
+//! Sets the prepared mip map levels of the image
+void CImage::setMipMapsData(void* data, bool ownForeignMemory)
+{
+	if (data == MipMapsData)
+		return;
+
+	delete [] MipMapsData;
+	MipMapsData = 0;
+
+	if (!data)
+		return;
+
+	if (ownForeignMemory)
+		MipMapsData = (u8*)data;
+	else
+	{
+		const u32 size = getMipMapsDataSizeFromFormat(Format, Size.Width, Size.Height);
+		if (size)
+		{
+			MipMapsData = new u8[size];
+			memcpy(MipMapsData, data, size);
+		}
+	}
+}
+
+
 //! get a filtered pixel
 inline SColor CImage::getPixelBox( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const
 {
@@ -448,6 +578,18 @@ inline SColor CImage::getPixelBox( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) cons
 }
 
 
+//! creates an uncompressed A8R8G8B8 copy of the image
+CImage* CImage::createA8R8G8B8Copy()
+{
+	CImage* image = new CImage(ECF_A8R8G8B8, Size);
+	if (isCompressedFormat(Format))
+		CColorConverter::decompressDXT(Data, Format, Size.Width, Size.Height, image->Data, ECF_A8R8G8B8, image->Pitch);
+	else
+		Blit(BLITTER_TEXTURE, image, 0, 0, this, 0, 0);
+	return image;
+}
+
+
 // Methods for Software drivers, non-virtual and not necessary to copy into other image classes
 //! draws a rectangle
 void CImage::drawRectangle(const core::rect<s32>& rect, const SColor &color)
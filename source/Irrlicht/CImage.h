@@ -15,6 +15,8 @@ namespace video
 
 //! IImage implementation with a lot of special image operations for
 //! 16 bit A1R5G5B5/32 Bit A8R8G8B8 images, which are used by the SoftwareDevice.
+/** Images in compressed formats only copy as a whole between formats,
+other operations work on an uncompressed copy. */
 class CImage : public IImage
 {
 public:
@@ -103,6 +105,12 @@ public:
 	//! fills the surface with black or white
 	virtual void fill(const SColor &color);
 
+	//! Returns the prepared mip map levels of the image
+	virtual void* getMipMapsData() const { return MipMapsData; }
+
+	//! Sets the prepared mip map levels of the image
+	virtual void setMipMapsData(void* data, bool ownForeignMemory=false);
+
 	//! draws a rectangle
 	void drawRectangle(const core::rect<s32>& rect, const SColor &color);
 
@@ -116,7 +124,11 @@ private:
 
 	inline SColor getPixelBox ( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const;
 
+	//! creates an uncompressed A8R8G8B8 copy of the image
+	CImage* createA8R8G8B8Copy();
+
 	u8* Data;
+	u8* MipMapsData;
 	core::dimension2d<u32> Size;
 	u32 BytesPerPixel;
 	u32 Pitch;
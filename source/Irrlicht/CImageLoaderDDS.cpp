@@ -0,0 +1,374 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderDDS.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+
+#include "IReadFile.h"
+#include "os.h"
+#include "CColorConverter.h"
+#include "CImage.h"
+#include "irrString.h"
+
+
+namespace irr
+{
+namespace video
+{
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".dds")
+bool CImageLoaderDDS::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "dds" );
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile* file) const
+{
+	if (!file)
+		return false;
+
+	u32 magic = 0;
+	file->read(&magic, sizeof(u32));
+#ifdef __BIG_ENDIAN__
+	magic = os::Byteswap::byteswap(magic);
+#endif
+	return magic == DDS_MAGIC;
+}
+
+
+namespace
+{
+	//! Largest width and height of a dds image, as for Direct3D 11 textures
+	/** Keeps the sizes of all levels of a 32 bit image within 31 bits. */
+	const u32 DDS_MAX_SIZE = 16384;
+
+	//! Layouts of uncompressed pixels the loader can convert
+	enum E_DDS_PIXEL_LAYOUT
+	{
+		EDPL_R5G6B5 = 0,
+		EDPL_A1R5G5B5,
+		EDPL_X1R5G5B5,
+		EDPL_A4R4G4B4,
+		EDPL_B8G8R8,
+		EDPL_R8G8B8,
+		EDPL_A8R8G8B8,
+		EDPL_A8B8G8R8,
+		EDPL_UNKNOWN
+	};
+
+	//! returns the layout of the pixels from their bit masks
+	E_DDS_PIXEL_LAYOUT getDDSPixelLayout(const SDDSPixelFormat& pf)
+	{
+		const bool alpha = (pf.Flags & DDPF_ALPHAPIXELS) != 0;
+		switch (pf.RGBBitCount)
+		{
+		case 16:
+			if (pf.RBitMask == 0xF800 && pf.GBitMask == 0x07E0 && pf.BBitMask == 0x001F)
+				return EDPL_R5G6B5;
+			if (pf.RBitMask == 0x7C00 && pf.GBitMask == 0x03E0 && pf.BBitMask == 0x001F)
+				return (alpha && pf.ABitMask == 0x8000) ? EDPL_A1R5G5B5 : EDPL_X1R5G5B5;
+			if (pf.RBitMask == 0x0F00 && pf.GBitMask == 0x00F0 && pf.BBitMask == 0x000F &&
+				(!alpha || pf.ABitMask == 0xF000))
+				return EDPL_A4R4G4B4;
+			break;
+		case 24:
+			if (pf.RBitMask == 0xFF0000 && pf.GBitMask == 0x00FF00 && pf.BBitMask == 0x0000FF)
+				return EDPL_B8G8R8;
+			if (pf.RBitMask == 0x0000FF && pf.GBitMask == 0x00FF00 && pf.BBitMask == 0xFF0000)
+				return EDPL_R8G8B8;
+			break;
+		case 32:
+			if (pf.RBitMask == 0x00FF0000 && pf.GBitMask == 0x0000FF00 && pf.BBitMask == 0x000000FF &&
+				(!alpha || pf.ABitMask == 0xFF000000))
+				return EDPL_A8R8G8B8;
+			if (pf.RBitMask == 0x000000FF && pf.GBitMask == 0x0000FF00 && pf.BBitMask == 0x00FF0000 &&
+				(!alpha || pf.ABitMask == 0xFF000000))
+				return EDPL_A8B8G8R8;
+			break;
+		}
+		return EDPL_UNKNOWN;
+	}
+
+	//! returns the color format of the image which is loaded for a layout
+	ECOLOR_FORMAT getDDSColorFormat(E_DDS_PIXEL_LAYOUT layout)
+	{
+		switch (layout)
+		{
+		case EDPL_R5G6B5:
+			return ECF_R5G6B5;
+		case EDPL_A1R5G5B5:
+		case EDPL_X1R5G5B5:
+			return ECF_A1R5G5B5;
+		case EDPL_B8G8R8:
+		case EDPL_R8G8B8:
+			return ECF_R8G8B8;
+		case EDPL_A4R4G4B4:
+		case EDPL_A8R8G8B8:
+		case EDPL_A8B8G8R8:
+			return ECF_A8R8G8B8;
+		default:
+			return ECF_UNKNOWN;
+		}
+	}
+
+	//! reads a little endian 16 bit pixel
+	inline u16 readDDS16(const u8* src)
+	{
+		return (u16)(src[0] | (src[1] << 8));
+	}
+}
+
+
+//! converts the rows of an uncompressed level into the color format of the image
+static void convertDDSLevel(const u8* in, u32 inPitch, u8* out, u32 outPitch,
+		u32 width, u32 height, const SDDSPixelFormat& pf, E_DDS_PIXEL_LAYOUT layout)
+{
+	const bool alpha = (pf.Flags & DDPF_ALPHAPIXELS) != 0;
+	for (u32 y=0; y<height; ++y)
+	{
+		const u8* src = in + y * inPitch;
+		u8* dest = out + y * outPitch;
+		switch (layout)
+		{
+		case EDPL_R5G6B5:
+		case EDPL_A1R5G5B5:
+			for (u32 x=0; x<width; ++x)
+				((u16*)dest)[x] = readDDS16(src + x * 2);
+			break;
+		case EDPL_X1R5G5B5:
+			for (u32 x=0; x<width; ++x)
+				((u16*)dest)[x] = readDDS16(src + x * 2) | 0x8000;
+			break;
+		case EDPL_A4R4G4B4:
+			for (u32 x=0; x<width; ++x)
+			{
+				const u32 c = readDDS16(src + x * 2);
+				// each 4 bit channel n becomes n * 17
+				u32 d = ((c & 0x000F) | ((c & 0x00F0) << 4) | ((c & 0x0F00) << 8) | ((c & 0xF000) << 12)) * 17;
+				if (!alpha)
+					d |= 0xFF000000;
+				((u32*)dest)[x] = d;
+			}
+			break;
+		case EDPL_B8G8R8:
+			// stored as blue, green, red
+			CColorConverter::convert24BitTo24Bit(src, dest, width, 1, 0, false, true);
+			break;
+		case EDPL_R8G8B8:
+			memcpy(dest, src, width * 3);
+			break;
+		case EDPL_A8R8G8B8:
+		case EDPL_A8B8G8R8:
+			{
+				for (u32 x=0; x<width; ++x)
+				{
+					const u8* p = src + x * 4;
+					u32 c = p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+					// red in the low byte
+					if (layout == EDPL_A8B8G8R8)
+						c = (c & 0xFF00FF00) | ((c >> 16) & 0xFF) | ((c & 0xFF) << 16);
+					if (!alpha)
+						c |= 0xFF000000;
+					((u32*)dest)[x] = c;
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+
+//! returns true if the header announces all mip map levels down to a single pixel
+static bool hasCompleteMipMaps(const SDDSHeader& header)
+{
+	if (!(header.Flags & DDSD_MIPMAPCOUNT))
+		return false;
+
+	u32 levels = 1;
+	for (u32 size = core::max_(header.Width, header.Height); size > 1; size >>= 1)
+		++levels;
+	return header.MipMapCount >= levels && levels > 1;
+}
+
+
+//! creates a surface from the file
+IImage* CImageLoaderDDS::loadImage(io::IReadFile* file) const
+{
+	SDDSHeader header;
+	if (file->read(&header, sizeof(SDDSHeader)) != sizeof(SDDSHeader))
+		return 0;
+
+#ifdef __BIG_ENDIAN__
+	u32* h = (u32*)&header;
+	for (u32 i=0; i<sizeof(SDDSHeader)/sizeof(u32); ++i)
+		h[i] = os::Byteswap::byteswap(h[i]);
+#endif
+
+	if (header.Magic != DDS_MAGIC || header.Size != 124 || !header.Width || !header.Height)
+	{
+		os::Printer::log("DDS file has an invalid header", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if (header.Width > DDS_MAX_SIZE || header.Height > DDS_MAX_SIZE)
+	{
+		os::Printer::log("DDS image is too big", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// all sizes below are checked against this before anything is allocated
+	const u32 remainingSize = (u32)core::max_(file->getSize() - file->getPos(), 0L);
+
+	const SDDSPixelFormat& pf = header.PixelFormat;
+	const core::dimension2d<u32> size(header.Width, header.Height);
+	const bool mipMaps = hasCompleteMipMaps(header);
+
+	// compressed images are kept compressed
+	if (pf.Flags & DDPF_FOURCC)
+	{
+		ECOLOR_FORMAT format;
+		if (pf.FourCC == DDS_FOURCC_DXT1)
+			format = ECF_DXT1;
+		else if (pf.FourCC == DDS_FOURCC_DXT5)
+			format = ECF_DXT5;
+		else
+		{
+			os::Printer::log("Unsupported compressed DDS format", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		const u32 dataSize = IImage::getDataSizeFromFormat(format, header.Width, header.Height);
+		if (dataSize > remainingSize)
+		{
+			os::Printer::log("DDS file is too short", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		IImage* image = new CImage(format, size);
+		if (file->read(image->lock(), dataSize) != (s32)dataSize)
+		{
+			os::Printer::log("DDS file is too short", file->getFileName(), ELL_ERROR);
+			image->drop();
+			return 0;
+		}
+		image->unlock();
+
+		const s32 mipMapsSize = IImage::getMipMapsDataSizeFromFormat(format, header.Width, header.Height);
+		if (mipMaps && (u32)mipMapsSize > remainingSize - dataSize)
+			os::Printer::log("DDS file misses mip map levels", file->getFileName(), ELL_WARNING);
+		else if (mipMaps)
+		{
+			u8* data = new u8[mipMapsSize];
+			if (file->read(data, mipMapsSize) == mipMapsSize)
+				image->setMipMapsData(data, true);
+			else
+			{
+				os::Printer::log("DDS file misses mip map levels", file->getFileName(), ELL_WARNING);
+				delete [] data;
+			}
+		}
+		return image;
+	}
+
+	if (!(pf.Flags & DDPF_RGB))
+	{
+		os::Printer::log("Unsupported DDS format", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const E_DDS_PIXEL_LAYOUT layout = getDDSPixelLayout(pf);
+	const ECOLOR_FORMAT format = getDDSColorFormat(layout);
+	if (format == ECF_UNKNOWN)
+	{
+		os::Printer::log("Unsupported DDS pixel format", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const u32 bytesPerPixel = pf.RGBBitCount / 8;
+	const u32 rowSize = header.Width * bytesPerPixel;
+	const u32 pitch = ((header.Flags & DDSD_PITCH) && header.PitchOrLinearSize > rowSize) ? header.PitchOrLinearSize : rowSize;
+
+	// the pitch is not limited by the header, so the product could overflow
+	if (pitch > remainingSize / header.Height)
+	{
+		os::Printer::log("DDS file is too short", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	const u32 dataSize = pitch * header.Height;
+
+	u8* data = new u8[dataSize];
+	if (file->read(data, dataSize) != (s32)dataSize)
+	{
+		os::Printer::log("DDS file is too short", file->getFileName(), ELL_ERROR);
+		delete [] data;
+		return 0;
+	}
+
+	IImage* image = new CImage(format, size);
+	convertDDSLevel(data, pitch, (u8*)image->lock(), image->getPitch(), header.Width, header.Height, pf, layout);
+	image->unlock();
+	delete [] data;
+
+	// the levels below are stored without padding, in the size of the file's pixels
+	u32 fileMipMapsSize = 0;
+	for (u32 width = header.Width, height = header.Height; width > 1 || height > 1; )
+	{
+		width = core::max_(width >> 1, 1u);
+		height = core::max_(height >> 1, 1u);
+		fileMipMapsSize += width * height * bytesPerPixel;
+	}
+
+	if (mipMaps && fileMipMapsSize > remainingSize - dataSize)
+		os::Printer::log("DDS file misses mip map levels", file->getFileName(), ELL_WARNING);
+	else if (mipMaps)
+	{
+		data = new u8[fileMipMapsSize];
+		if (file->read(data, fileMipMapsSize) == (s32)fileMipMapsSize)
+		{
+			const s32 mipMapsSize = IImage::getMipMapsDataSizeFromFormat(format, header.Width, header.Height);
+			u8* mipMapsData = new u8[mipMapsSize];
+			const u32 outBytesPerPixel = IImage::getBitsPerPixelFromFormat(format) / 8;
+			u32 offset = 0;
+			u32 outOffset = 0;
+			u32 width = header.Width;
+			u32 height = header.Height;
+			while (width > 1 || height > 1)
+			{
+				width = core::max_(width >> 1, 1u);
+				height = core::max_(height >> 1, 1u);
+				convertDDSLevel(data + offset, width * bytesPerPixel, mipMapsData + outOffset,
+						width * outBytesPerPixel, width, height, pf, layout);
+				offset += width * height * bytesPerPixel;
+				outOffset += width * height * outBytesPerPixel;
+			}
+			image->setMipMapsData(mipMapsData, true);
+		}
+		else
+			os::Printer::log("DDS file misses mip map levels", file->getFileName(), ELL_WARNING);
+		delete [] data;
+	}
+
+	return image;
+}
+
+
+//! creates a loader which is able to load dds images
+IImageLoader* createImageLoaderDDS()
+{
+	return new CImageLoaderDDS();
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
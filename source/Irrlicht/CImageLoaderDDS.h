@@ -0,0 +1,104 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IMAGE_LOADER_DDS_H_INCLUDED__
+#define __C_IMAGE_LOADER_DDS_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#include "IImageLoader.h"
+
+
+namespace irr
+{
+namespace video
+{
+
+#if defined(_IRR_COMPILE_WITH_DDS_LOADER_) || defined(_IRR_COMPILE_WITH_DDS_WRITER_)
+
+	// these structs are also used in the DDS writer
+	// all members are 32 bit, so they need no packing
+	struct SDDSPixelFormat
+	{
+		u32 Size;
+		u32 Flags;
+		u32 FourCC;
+		u32 RGBBitCount;
+		u32 RBitMask;
+		u32 GBitMask;
+		u32 BBitMask;
+		u32 ABitMask;
+	};
+
+	struct SDDSHeader
+	{
+		u32 Magic;
+		u32 Size;
+		u32 Flags;
+		u32 Height;
+		u32 Width;
+		u32 PitchOrLinearSize;
+		u32 Depth;
+		u32 MipMapCount;
+		u32 Reserved1[11];
+		SDDSPixelFormat PixelFormat;
+		u32 Caps;
+		u32 Caps2;
+		u32 Caps3;
+		u32 Caps4;
+		u32 Reserved2;
+	};
+
+	// flags of the header and the pixel format
+	const u32 DDSD_CAPS = 0x1;
+	const u32 DDSD_HEIGHT = 0x2;
+	const u32 DDSD_WIDTH = 0x4;
+	const u32 DDSD_PITCH = 0x8;
+	const u32 DDSD_PIXELFORMAT = 0x1000;
+	const u32 DDSD_MIPMAPCOUNT = 0x20000;
+	const u32 DDSD_LINEARSIZE = 0x80000;
+	const u32 DDSCAPS_COMPLEX = 0x8;
+	const u32 DDSCAPS_TEXTURE = 0x1000;
+	const u32 DDSCAPS_MIPMAP = 0x400000;
+	const u32 DDPF_ALPHAPIXELS = 0x1;
+	const u32 DDPF_FOURCC = 0x4;
+	const u32 DDPF_RGB = 0x40;
+
+	// "DDS ", "DXT1" and "DXT5" read as little endian numbers
+	const u32 DDS_MAGIC = 0x20534444;
+	const u32 DDS_FOURCC_DXT1 = 0x31545844;
+	const u32 DDS_FOURCC_DXT5 = 0x35545844;
+
+#endif // compiled with loader or writer
+
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+
+/*!
+	Surface Loader for DirectDraw Surface images
+	Loads DXT1 and DXT5 compressed images and uncompressed 16, 24 and
+	32 bit images. Complete chains of mip map levels are kept with the
+	image, see IImage::getMipMapsData().
+*/
+class CImageLoaderDDS : public IImageLoader
+{
+public:
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".dds")
+	virtual bool isALoadableFileExtension(const io::path& filename) const;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	virtual bool isALoadableFileFormat(io::IReadFile* file) const;
+
+	//! creates a surface from the file
+	virtual IImage* loadImage(io::IReadFile* file) const;
+};
+
+#endif // compiled with loader
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -131,14 +131,28 @@ bool CImageLoaderJPG::isALoadableFileFormat(io::IReadFile* file) const
 
 //! creates a surface from the file
 IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
+{
+	return loadScaledImage(file, core::dimension2d<u32>(0, 0));
+}
+
+
+//! creates a surface from the file, using the DCT scaling of libjpeg
+IImage* CImageLoaderJPG::loadScaledImage(io::IReadFile* file, const core::dimension2d<u32>& maxSize) const
 {
 	#ifndef _IRR_COMPILE_WITH_LIBJPEG_
 	return 0;
 	#else
 
 	u8 **rowPtr=0;
-	u8* input = new u8[file->getSize()];
-	file->read(input, file->getSize());
+
+	// decode directly from the file content if it is in memory already
+	const u8* mappedInput = (const u8*)file->getMappedPointer();
+	u8* input = 0;
+	if (!mappedInput)
+	{
+		input = new u8[file->getSize()];
+		file->read(input, file->getSize());
+	}
 
 	// allocate and initialize JPEG decompression object
 	struct jpeg_decompress_struct cinfo;
@@ -180,7 +194,7 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 
 	// Set up data pointer
 	jsrc.bytes_in_buffer = file->getSize();
-	jsrc.next_input_byte = (JOCTET*)input;
+	jsrc.next_input_byte = mappedInput ? (const JOCTET*)mappedInput : (const JOCTET*)input;
 	cinfo.src = &jsrc;
 
 	jsrc.init_source = init_source;
@@ -211,13 +225,18 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	}
 	cinfo.do_fancy_upsampling=FALSE;
 
+	// large images are decoded at 1/2, 1/4 or 1/8 of their size if that is enough
+	cinfo.scale_num = 1;
+	cinfo.scale_denom = 1 << getScaleShift(
+			core::dimension2d<u32>(cinfo.image_width, cinfo.image_height), maxSize, 3);
+
 	// Start decompressor
 	jpeg_start_decompress(&cinfo);
 
 	// Get image data
-	u16 rowspan = cinfo.image_width * cinfo.out_color_components;
-	u32 width = cinfo.image_width;
-	u32 height = cinfo.image_height;
+	u32 rowspan = cinfo.output_width * cinfo.out_color_components;
+	u32 width = cinfo.output_width;
+	u32 height = cinfo.output_height;
 
 	// Allocate memory for buffer
 	u8* output = new u8[rowspan * height];
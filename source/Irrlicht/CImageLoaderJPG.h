@@ -51,6 +51,9 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const;
 
+	//! creates a surface from the file, using the DCT scaling of libjpeg
+	virtual IImage* loadScaledImage(io::IReadFile* file, const core::dimension2d<u32>& maxSize) const;
+
 private:
 
     #ifdef _IRR_COMPILE_WITH_LIBJPEG_
@@ -44,6 +44,66 @@ void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t l
 	if (check != length)
 		png_error(png_ptr, "Read Error");
 }
+
+
+// reads the rows of a non interlaced image and averages boxes of 2, 4 or 8 pixels
+static IImage* loadScaledRows(png_structp png_ptr, png_infop info_ptr,
+		u32 width, u32 height, s32 colorType, u32 shift)
+{
+	const u32 factor = 1 << shift;
+	const core::dimension2d<u32> size((width + factor - 1) >> shift, (height + factor - 1) >> shift);
+	IImage* image = new CImage((colorType==PNG_COLOR_TYPE_RGB_ALPHA) ? ECF_A8R8G8B8 : ECF_R8G8B8, size);
+	const u32 channels = image->getBytesPerPixel();
+
+	u8* row = new u8[width * channels];
+	u32* sums = new u32[size.Width * channels];
+
+	// for proper error handling
+	if (setjmp(png_jmpbuf(png_ptr)))
+	{
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+		delete [] row;
+		delete [] sums;
+		image->drop();
+		return 0;
+	}
+
+	u8* data = (u8*)image->lock();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		memset(sums, 0, size.Width * channels * sizeof(u32));
+
+		const u32 rows = core::min_(factor, height - y * factor);
+		for (u32 i=0; i<rows; ++i)
+		{
+			png_read_row(png_ptr, row, NULL);
+			for (u32 x=0; x<width; ++x)
+			{
+				u32* sum = sums + (x >> shift) * channels;
+				const u8* pixel = row + x * channels;
+				for (u32 c=0; c<channels; ++c)
+					sum[c] += pixel[c];
+			}
+		}
+
+		// the boxes at the right and bottom border may be smaller
+		u8* dest = data + y * image->getPitch();
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const u32 count = rows * core::min_(factor, width - x * factor);
+			for (u32 c=0; c<channels; ++c)
+				dest[x * channels + c] = (u8)((sums[x * channels + c] + count / 2) / count);
+		}
+	}
+	image->unlock();
+
+	png_read_end(png_ptr, NULL);
+	png_destroy_read_struct(&png_ptr, &info_ptr, 0);
+	delete [] row;
+	delete [] sums;
+
+	return image;
+}
 #endif // _IRR_COMPILE_WITH_LIBPNG_
 
 
@@ -81,6 +141,13 @@ bool CImageLoaderPng::isALoadableFileFormat(io::IReadFile* file) const
 
 // load in the image data
 IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
+{
+	return loadScaledImage(file, core::dimension2d<u32>(0, 0));
+}
+
+
+// load in the image data, averaging boxes of rows and columns of large images
+IImage* CImageLoaderPng::loadScaledImage(io::IReadFile* file, const core::dimension2d<u32>& maxSize) const
 {
 #ifdef _IRR_COMPILE_WITH_LIBPNG_
 	if (!file)
@@ -213,6 +280,13 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 		Height=h;
 	}
 
+	// large images are read row by row and reduced to 1/2, 1/4 or 1/8 of
+	// their size if that is enough, interlaced images need all rows at once
+	const u32 shift = (png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE) ?
+			getScaleShift(core::dimension2d<u32>(Width, Height), maxSize, 3) : 0;
+	if (shift)
+		return loadScaledRows(png_ptr, info_ptr, Width, Height, ColorType, shift);
+
 	// Create the image structure to be filled by png data
 	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
 		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
@@ -34,6 +34,9 @@ public:
 
    //! creates a surface from the file
    virtual IImage* loadImage(io::IReadFile* file) const;
+
+   //! creates a surface from the file, averaging the rows while they are read
+   virtual IImage* loadScaledImage(io::IReadFile* file, const core::dimension2d<u32>& maxSize) const;
 };
 
 
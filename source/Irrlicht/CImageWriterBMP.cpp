@@ -10,6 +10,7 @@
 #include "IWriteFile.h"
 #include "CColorConverter.h"
 #include "irrString.h"
+#include "os.h"
 
 namespace irr
 {
@@ -80,6 +81,10 @@ bool CImageWriterBMP::writeImage(io::IWriteFile* file, IImage* image, u32 param)
 		CColorConverter_convertFORMATtoFORMAT
 			= CColorConverter::convert_R5G6B5toR8G8B8;
 		break;
+	case ECF_DXT1:
+	case ECF_DXT5:
+		os::Printer::log("BMPWriter: Could not write compressed image", file->getFileName(), ELL_ERROR);
+		return false;
 	}
 
 	// couldn't find a color converter
@@ -0,0 +1,166 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageWriterDDS.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+
+#include "CImageLoaderDDS.h"
+#include "IWriteFile.h"
+#include "CImage.h"
+#include "CColorConverter.h"
+#include "os.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace video
+{
+
+IImageWriter* createImageWriterDDS()
+{
+	return new CImageWriterDDS;
+}
+
+CImageWriterDDS::CImageWriterDDS()
+{
+#ifdef _DEBUG
+	setDebugName("CImageWriterDDS");
+#endif
+}
+
+bool CImageWriterDDS::isAWriteableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "dds" );
+}
+
+//! writes the compressed mip map levels below the image to data
+static void compressMipMaps(IImage* image, ECOLOR_FORMAT format, u8* data)
+{
+	// the levels of the image are converted, missing ones are averaged from the previous level
+	const u8* mipMaps = (const u8*)image->getMipMapsData();
+	core::dimension2d<u32> size = image->getDimension();
+	CImage* level = new CImage(ECF_A8R8G8B8, size);
+	image->copyTo(level);
+
+	while (size.Width > 1 || size.Height > 1)
+	{
+		const core::dimension2d<u32> next(core::max_(size.Width >> 1, 1u), core::max_(size.Height >> 1, 1u));
+		CImage* nextLevel = new CImage(ECF_A8R8G8B8, next);
+		if (mipMaps)
+		{
+			CImage* stored = new CImage(image->getColorFormat(), next, (void*)mipMaps, true, false);
+			stored->copyTo(nextLevel);
+			stored->drop();
+			mipMaps += IImage::getDataSizeFromFormat(image->getColorFormat(), next.Width, next.Height);
+		}
+		else
+		{
+			CColorConverter::createMipMapLevel(level->lock(), ECF_A8R8G8B8, size.Width, size.Height,
+					level->getPitch(), nextLevel->lock(), nextLevel->getPitch());
+		}
+		level->drop();
+		level = nextLevel;
+		size = next;
+
+		CColorConverter::compressDXT(level->lock(), size.Width, size.Height, level->getPitch(), data, format);
+		data += IImage::getDataSizeFromFormat(format, size.Width, size.Height);
+	}
+
+	level->drop();
+}
+
+bool CImageWriterDDS::writeImage(io::IWriteFile *file, IImage *image,u32 param) const
+{
+	const core::dimension2d<u32>& size = image->getDimension();
+
+	// compress the image unless it is already
+	ECOLOR_FORMAT format = image->getColorFormat();
+	IImage* compressed = 0;
+	switch (format)
+	{
+	case ECF_DXT1:
+	case ECF_DXT5:
+		break;
+	case ECF_A8R8G8B8:
+	case ECF_A1R5G5B5:
+		format = ECF_DXT5;
+		break;
+	case ECF_R8G8B8:
+	case ECF_R5G6B5:
+		format = ECF_DXT1;
+		break;
+	default:
+		os::Printer::log("Could not write DDS image, unsupported color format", ELL_ERROR);
+		return false;
+	}
+
+	// stored levels are kept if they are compressed already
+	const u32 mipMapsSize = IImage::getMipMapsDataSizeFromFormat(format, size.Width, size.Height);
+	u8* mipMaps = 0;
+	if (mipMapsSize && (image->getMipMapsData() || param))
+	{
+		mipMaps = new u8[mipMapsSize];
+		if (format == image->getColorFormat() && image->getMipMapsData())
+			memcpy(mipMaps, image->getMipMapsData(), mipMapsSize);
+		else
+			compressMipMaps(image, format, mipMaps);
+	}
+
+	if (format != image->getColorFormat())
+	{
+		compressed = new CImage(format, size);
+		image->copyTo(compressed);
+		image = compressed;
+	}
+
+	SDDSHeader header;
+	memset(&header, 0, sizeof(SDDSHeader));
+	header.Magic = DDS_MAGIC;
+	header.Size = 124;
+	header.Flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE;
+	header.Height = size.Height;
+	header.Width = size.Width;
+	header.PitchOrLinearSize = image->getImageDataSizeInBytes();
+	header.MipMapCount = 1;
+	header.PixelFormat.Size = 32;
+	header.PixelFormat.Flags = DDPF_FOURCC;
+	header.PixelFormat.FourCC = (format == ECF_DXT1) ? DDS_FOURCC_DXT1 : DDS_FOURCC_DXT5;
+	header.Caps = DDSCAPS_TEXTURE;
+	if (mipMaps)
+	{
+		header.Flags |= DDSD_MIPMAPCOUNT;
+		header.Caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+		for (u32 s = core::max_(size.Width, size.Height); s > 1; s >>= 1)
+			++header.MipMapCount;
+	}
+
+#ifdef __BIG_ENDIAN__
+	u32* h = (u32*)&header;
+	for (u32 i=0; i<sizeof(SDDSHeader)/sizeof(u32); ++i)
+		h[i] = os::Byteswap::byteswap(h[i]);
+#endif
+
+	bool result = file->write(&header, sizeof(SDDSHeader)) == sizeof(SDDSHeader);
+
+	const s32 dataSize = image->getImageDataSizeInBytes();
+	if (result)
+		result = file->write(image->lock(), dataSize) == dataSize;
+	image->unlock();
+
+	if (result && mipMaps)
+		result = file->write(mipMaps, mipMapsSize) == (s32)mipMapsSize;
+	delete [] mipMaps;
+
+	if (compressed)
+		compressed->drop();
+
+	return result;
+}
+
+} // namespace video
+} // namespace irr
+
+#endif
+
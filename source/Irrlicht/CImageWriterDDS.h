@@ -0,0 +1,42 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef _C_IMAGE_WRITER_DDS_H_INCLUDED__
+#define _C_IMAGE_WRITER_DDS_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+
+#include "IImageWriter.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Writes DXT1 and DXT5 compressed DDS images
+/** Uncompressed images are compressed on writing, into DXT5 for color
+formats with alpha and into DXT1 for the others. The mip map levels of
+the image are written as well. With a param other than 0 the levels are
+created for images which have none. */
+class CImageWriterDDS : public IImageWriter
+{
+public:
+	//! constructor
+	CImageWriterDDS();
+
+	//! return true if this writer can write a file with the given extension
+	virtual bool isAWriteableFileExtension(const io::path& filename) const;
+
+	//! write image to file
+	virtual bool writeImage(io::IWriteFile *file, IImage *image,u32 param) const;
+};
+
+} // namespace video
+} // namespace irr
+
+#endif // _C_IMAGE_WRITER_DDS_H_INCLUDED__
+#endif
+
@@ -73,6 +73,16 @@ bool CImageWriterPNG::writeImage(io::IWriteFile* file, IImage* image,u32 param)
 	if (!file || !image)
 		return false;
 
+	switch(image->getColorFormat())
+	{
+	case ECF_DXT1:
+	case ECF_DXT5:
+		os::Printer::log("PNGWriter: Could not write compressed image", file->getFileName(), ELL_ERROR);
+		return false;
+	default:
+		break;
+	}
+
 	// Allocate the png write struct
 	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
 		NULL, (png_error_ptr)png_cpexcept_error, NULL);
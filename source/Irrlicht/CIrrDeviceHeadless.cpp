@@ -0,0 +1,464 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CIrrDeviceHeadless.h"
+
+#ifdef _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+
+#include "IFileSystem.h"
+#include "IWriteFile.h"
+#include "IImageWriter.h"
+#include "CMemoryFile.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _IRR_WINDOWS_API_
+#define WIN32_LEAN_AND_MEAN
+#if !defined(_IRR_XBOX_PLATFORM_)
+	#include <windows.h>
+#endif
+#else
+#include <time.h>
+#endif
+
+namespace irr
+{
+
+//! constructor
+CIrrDeviceHeadless::CIrrDeviceHeadless(const SIrrlichtCreationParameters& params)
+	: CIrrDeviceStub(params), FirstFrame(0), QueuedFrames(0), EncodedFrames(0), WriterThread(0),
+	StopWriter(false), ImageWriter(0), RawOutput(0), PresentedFrames(0),
+	FailedFrames(0), StartTime(0), WaitTime(0.0)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrDeviceHeadless");
+	#endif
+
+	switch (params.DriverType)
+	{
+	case video::EDT_SOFTWARE:
+		#ifdef _IRR_COMPILE_WITH_SOFTWARE_
+		VideoDriver = video::createSoftwareDriver(CreationParams.WindowSize, false, FileSystem, this);
+		#else
+		os::Printer::log("Software driver was not compiled in.", ELL_ERROR);
+		#endif
+		break;
+
+	case video::EDT_BURNINGSVIDEO:
+		#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+		VideoDriver = video::createSoftwareDriver2(CreationParams.WindowSize, false, FileSystem, this);
+		#else
+		os::Printer::log("Burning's Video driver was not compiled in.", ELL_ERROR);
+		#endif
+		break;
+
+	case video::EDT_DIRECT3D8:
+	case video::EDT_DIRECT3D9:
+	case video::EDT_OPENGL:
+		os::Printer::log("The headless device cannot use hardware drivers.", ELL_ERROR);
+		break;
+	case video::EDT_NULL:
+		VideoDriver = video::createNullDriver(FileSystem, CreationParams.WindowSize);
+		break;
+	default:
+		break;
+	}
+
+	if (!VideoDriver)
+		return;
+
+	createGUIAndScene();
+
+	if (!CreationParams.FrameOutput.size())
+		return;
+
+	// a name with a number pattern is an image sequence, anything else a raw stream
+	if (getFrameFileName(0).size())
+	{
+		for (u32 i=0; i<VideoDriver->getImageWriterCount() && !ImageWriter; ++i)
+		{
+			if (VideoDriver->getImageWriter(i)->isAWriteableFileExtension(CreationParams.FrameOutput))
+			{
+				ImageWriter = VideoDriver->getImageWriter(i);
+				ImageWriter->grab();
+			}
+		}
+		if (!ImageWriter)
+		{
+			os::Printer::log("No image writer for the frame output", CreationParams.FrameOutput, ELL_ERROR);
+			return;
+		}
+	}
+	else
+	{
+		RawOutput = FileSystem->createAndWriteFile(CreationParams.FrameOutput);
+		if (!RawOutput)
+		{
+			os::Printer::log("Could not open the frame output", CreationParams.FrameOutput, ELL_ERROR);
+			return;
+		}
+	}
+
+	// the back buffer of the driver is one of the frame buffers. Without
+	// the writer thread the one frame only holds the encoded data
+	SFrame frame;
+	frame.Image = 0;
+	frame.Number = 0;
+	frame.DataSize = 0;
+	frame.Encoded = false;
+	Frames.set_used(core::max_(CreationParams.FrameOutputBuffers, 2u) - 1);
+	for (u32 i=0; i<Frames.size(); ++i)
+		Frames[i] = frame;
+
+	if (CreationParams.FrameOutputBuffers > 1)
+	{
+		WriterThread = os::Threads::start(encodeFrames, this);
+		if (!WriterThread)
+		{
+			os::Printer::log("Could not start the frame writer thread, frames are written while rendering.", ELL_WARNING);
+			Frames.set_used(1);
+		}
+	}
+}
+
+
+//! destructor
+CIrrDeviceHeadless::~CIrrDeviceHeadless()
+{
+	// the writer encodes all queued frames before it stops
+	if (WriterThread)
+	{
+		Signal.lock();
+		StopWriter = true;
+		Signal.notify();
+		Signal.unlock();
+		os::Threads::join(WriterThread);
+		saveEncodedFrames();
+	}
+
+	for (u32 i=0; i<Frames.size(); ++i)
+	{
+		if (Frames[i].Image)
+			Frames[i].Image->drop();
+	}
+
+	if (ImageWriter)
+		ImageWriter->drop();
+	if (RawOutput)
+		RawOutput->drop();
+
+	if (PresentedFrames)
+	{
+		// includes writing the last frames, which are part of the batch run
+		const f32 seconds = core::max_(os::Timer::getRealTime() - StartTime, 1u) / 1000.f;
+		c8 tmp[256];
+		snprintf(tmp, 256, "Headless device rendered %u frames in %.2f s, %.1f frames per second, waited %.2f s for the frame writer",
+			PresentedFrames, seconds, PresentedFrames / seconds, WaitTime);
+		os::Printer::log(tmp, ELL_INFORMATION);
+		if (FailedFrames)
+		{
+			snprintf(tmp, 256, "%u frames could not be written", FailedFrames);
+			os::Printer::log(tmp, CreationParams.FrameOutput, ELL_ERROR);
+		}
+	}
+}
+
+
+//! runs the device. Returns false if device wants to be deleted
+bool CIrrDeviceHeadless::run()
+{
+	os::Timer::tick();
+	return !Close;
+}
+
+
+//! Cause the device to temporarily pause execution and let other processes to run
+void CIrrDeviceHeadless::yield()
+{
+#ifdef _IRR_WINDOWS_API_
+	Sleep(1);
+#else
+	struct timespec ts = {0,0};
+	nanosleep(&ts, NULL);
+#endif
+}
+
+
+//! Pause execution and let other processes to run for a specified amount of time.
+void CIrrDeviceHeadless::sleep(u32 timeMs, bool pauseTimer)
+{
+	const bool wasStopped = Timer ? Timer->isStopped() : true;
+	if (pauseTimer && !wasStopped)
+		Timer->stop();
+
+#ifdef _IRR_WINDOWS_API_
+	Sleep(timeMs);
+#else
+	struct timespec ts;
+	ts.tv_sec = (time_t) (timeMs / 1000);
+	ts.tv_nsec = (long) (timeMs % 1000) * 1000000;
+	nanosleep(&ts, NULL);
+#endif
+
+	if (pauseTimer && !wasStopped)
+		Timer->start();
+}
+
+
+//! sets the caption of the window
+void CIrrDeviceHeadless::setWindowCaption(const wchar_t* text)
+{
+}
+
+
+//! returns if window is active. if not, nothing need to be drawn
+bool CIrrDeviceHeadless::isWindowActive() const
+{
+	// there is no window, but rendering is what this device is for
+	return true;
+}
+
+
+//! returns if window has focus
+bool CIrrDeviceHeadless::isWindowFocused() const
+{
+	return false;
+}
+
+
+//! returns if window is minimized
+bool CIrrDeviceHeadless::isWindowMinimized() const
+{
+	return false;
+}
+
+
+//! hands a rendered frame to the frame writer
+bool CIrrDeviceHeadless::present(video::IImage* surface, void* windowId, core::rect<s32>* src)
+{
+	if (!surface)
+		return false;
+
+	if (!PresentedFrames)
+		StartTime = os::Timer::getRealTime();
+	const u32 number = PresentedFrames++;
+
+	if (!ImageWriter && !RawOutput)
+		return true;
+
+	if (!WriterThread)
+	{
+		Frames[0].Number = number;
+		encodeFrame(surface, Frames[0]);
+		return saveFrame(Frames[0]);
+	}
+
+	// all frame buffers are queued, so rendering has to wait for the writer
+	Signal.lock();
+	if (QueuedFrames == Frames.size() && !EncodedFrames)
+	{
+		const u32 start = os::Timer::getRealTimeMicroseconds();
+		while (!EncodedFrames)
+			Signal.wait();
+		WaitTime += (os::Timer::getRealTimeMicroseconds() - start) / 1000000.0;
+	}
+	Signal.unlock();
+
+	// which frees the buffers of the encoded frames
+	saveEncodedFrames();
+
+	Signal.lock();
+	SFrame& frame = Frames[(FirstFrame + QueuedFrames) % Frames.size()];
+	Signal.unlock();
+
+	// the writer only uses queued frames, so this one can be filled unlocked
+	if (!frame.Image || frame.Image->getDimension() != surface->getDimension() ||
+		frame.Image->getColorFormat() != surface->getColorFormat())
+	{
+		if (frame.Image)
+			frame.Image->drop();
+		frame.Image = VideoDriver->createImage(surface->getColorFormat(), surface->getDimension());
+	}
+	memcpy(frame.Image->lock(), surface->lock(), surface->getImageDataSizeInBytes());
+	surface->unlock();
+	frame.Image->unlock();
+	frame.Number = number;
+
+	Signal.lock();
+	++QueuedFrames;
+	Signal.notify();
+	Signal.unlock();
+	return true;
+}
+
+
+//! notifies the device that it should close itself
+void CIrrDeviceHeadless::closeDevice()
+{
+	Close = true;
+}
+
+
+//! Sets if the window should be resizable in windowed mode.
+void CIrrDeviceHeadless::setResizable(bool resize)
+{
+	// do nothing
+}
+
+
+//! Minimize the window.
+void CIrrDeviceHeadless::minimizeWindow()
+{
+	// do nothing
+}
+
+
+//! Maximize window
+void CIrrDeviceHeadless::maximizeWindow()
+{
+	// do nothing
+}
+
+
+//! Restore original window size
+void CIrrDeviceHeadless::restoreWindow()
+{
+	// do nothing
+}
+
+
+//! encodes queued frames until stopped, runs on the writer thread
+void CIrrDeviceHeadless::encodeFrames(void* data, u32 index)
+{
+	CIrrDeviceHeadless* device = (CIrrDeviceHeadless*)data;
+
+	device->Signal.lock();
+	while (true)
+	{
+		while (device->EncodedFrames == device->QueuedFrames && !device->StopWriter)
+			device->Signal.wait();
+
+		if (device->EncodedFrames == device->QueuedFrames)
+			break;
+
+		// the frame stays queued until it is saved, so present() leaves it alone
+		SFrame& frame = device->Frames[(device->FirstFrame + device->EncodedFrames) % device->Frames.size()];
+		device->Signal.unlock();
+
+		device->encodeFrame(frame.Image, frame);
+
+		device->Signal.lock();
+		++device->EncodedFrames;
+		device->Signal.notify();
+	}
+	device->Signal.unlock();
+}
+
+
+//! encodes an image into the data of a frame, without touching the file system
+void CIrrDeviceHeadless::encodeFrame(video::IImage* image, SFrame& frame) const
+{
+	const u32 rowSize = image->getDimension().Width * image->getBytesPerPixel();
+	const u32 rawSize = rowSize * image->getDimension().Height;
+
+	if (RawOutput)
+	{
+		// rows are written without padding
+		if (frame.Data.size() < rawSize)
+			frame.Data.set_used(rawSize);
+		const u8* data = (const u8*)image->lock();
+		for (u32 y=0; y<image->getDimension().Height; ++y)
+			memcpy(frame.Data.pointer() + y * rowSize, data + y * image->getPitch(), rowSize);
+		image->unlock();
+		frame.DataSize = rawSize;
+		frame.Encoded = true;
+		return;
+	}
+
+	// plenty for the uncompressed formats and the worst case of the others
+	const u32 size = 2 * rawSize + 4096;
+	if (frame.Data.size() < size)
+		frame.Data.set_used(size);
+
+	io::CMemoryFile* file = new io::CMemoryFile(frame.Data.pointer(), frame.Data.size(), "", false);
+	frame.Encoded = ImageWriter->writeImage(file, image);
+	frame.DataSize = (u32)file->getPos();
+	file->drop();
+
+	// a full buffer most likely cut the file
+	frame.Encoded &= frame.DataSize < frame.Data.size();
+}
+
+
+//! saves the frames which are encoded, on the main thread
+void CIrrDeviceHeadless::saveEncodedFrames()
+{
+	Signal.lock();
+	const u32 count = EncodedFrames;
+	Signal.unlock();
+
+	// the writer leaves encoded frames alone
+	for (u32 i=0; i<count; ++i)
+		saveFrame(Frames[(FirstFrame + i) % Frames.size()]);
+
+	Signal.lock();
+	FirstFrame = (FirstFrame + count) % Frames.size();
+	QueuedFrames -= count;
+	EncodedFrames -= count;
+	Signal.unlock();
+}
+
+
+//! writes an encoded frame as image file or to the raw stream
+bool CIrrDeviceHeadless::saveFrame(const SFrame& frame)
+{
+	bool result = frame.Encoded;
+	if (result && RawOutput)
+	{
+		result = (RawOutput->write(frame.Data.const_pointer(), frame.DataSize) == (s32)frame.DataSize);
+	}
+	else if (result)
+	{
+		io::IWriteFile* file = FileSystem->createAndWriteFile(getFrameFileName(frame.Number));
+		result = file && (file->write(frame.Data.const_pointer(), frame.DataSize) == (s32)frame.DataSize);
+		if (file)
+			file->drop();
+	}
+
+	if (!result)
+		++FailedFrames;
+	return result;
+}
+
+
+//! returns the file name of a frame of an image sequence, or an empty name
+io::path CIrrDeviceHeadless::getFrameFileName(u32 number) const
+{
+	// the first % followed by an optional width and d or u is the frame number
+	const io::path& pattern = CreationParams.FrameOutput;
+	const s32 begin = pattern.findFirst('%');
+	if (begin < 0)
+		return io::path();
+
+	u32 end = begin + 1;
+	u32 width = 0;
+	while (end < pattern.size() && pattern[end] >= '0' && pattern[end] <= '9')
+		width = width * 10 + (pattern[end++] - '0');
+
+	if (end >= pattern.size() || (pattern[end] != 'd' && pattern[end] != 'u') || width > 16)
+		return io::path();
+
+	c8 tmp[32];
+	snprintf(tmp, 32, "%0*u", (int)width, number);
+
+	io::path name = pattern.subString(0, begin);
+	name += tmp;
+	name += pattern.subString(end + 1, pattern.size() - end - 1);
+	return name;
+}
+
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+
@@ -0,0 +1,138 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IRR_DEVICE_HEADLESS_H_INCLUDED__
+#define __C_IRR_DEVICE_HEADLESS_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+
+#include "SIrrCreationParameters.h"
+#include "CIrrDeviceStub.h"
+#include "IImagePresenter.h"
+#include "os.h"
+
+namespace irr
+{
+namespace video
+{
+	class IImageWriter;
+} // end namespace video
+
+	//! Device without a window, which renders into memory
+	/** The frames the software drivers present are copied into a ring of
+	frame buffers, which a writer thread encodes into memory while the next
+	frames are rendered. The encoded frames are saved as image files or
+	appended to a raw stream on the main thread, which also does all the
+	logging. */
+	class CIrrDeviceHeadless : public CIrrDeviceStub, video::IImagePresenter
+	{
+	public:
+
+		//! constructor
+		CIrrDeviceHeadless(const SIrrlichtCreationParameters& params);
+
+		//! destructor
+		virtual ~CIrrDeviceHeadless();
+
+		//! runs the device. Returns false if device wants to be deleted
+		virtual bool run();
+
+		//! Cause the device to temporarily pause execution and let other processes to run
+		virtual void yield();
+
+		//! Pause execution and let other processes to run for a specified amount of time.
+		virtual void sleep(u32 timeMs, bool pauseTimer);
+
+		//! sets the caption of the window
+		virtual void setWindowCaption(const wchar_t* text);
+
+		//! returns if window is active. if not, nothing need to be drawn
+		virtual bool isWindowActive() const;
+
+		//! returns if window has focus
+		virtual bool isWindowFocused() const;
+
+		//! returns if window is minimized
+		virtual bool isWindowMinimized() const;
+
+		//! hands a rendered frame to the frame writer
+		virtual bool present(video::IImage* surface, void* windowId=0, core::rect<s32>* src=0);
+
+		//! notifies the device that it should close itself
+		virtual void closeDevice();
+
+		//! Sets if the window should be resizable in windowed mode.
+		virtual void setResizable(bool resize=false);
+
+		//! Minimizes the window.
+		virtual void minimizeWindow();
+
+		//! Maximizes the window.
+		virtual void maximizeWindow();
+
+		//! Restores the window size.
+		virtual void restoreWindow();
+
+		//! Get the device type
+		virtual E_DEVICE_TYPE getType() const
+		{
+				return EIDT_HEADLESS;
+		}
+
+	private:
+
+		//! a frame buffer of the ring
+		struct SFrame
+		{
+			video::IImage* Image;
+			u32 Number;
+
+			//! the encoded image file or the rows of the raw stream
+			core::array<u8> Data;
+			u32 DataSize;
+			bool Encoded;
+		};
+
+		//! encodes queued frames until stopped, runs on the writer thread
+		static void encodeFrames(void* data, u32 index);
+
+		//! encodes an image into the data of a frame, without touching the file system
+		void encodeFrame(video::IImage* image, SFrame& frame) const;
+
+		//! saves the frames which are encoded, on the main thread
+		void saveEncodedFrames();
+
+		//! writes an encoded frame as image file or to the raw stream
+		bool saveFrame(const SFrame& frame);
+
+		//! returns the file name of a frame of an image sequence, or an empty name
+		io::path getFrameFileName(u32 number) const;
+
+		//! frame buffers, those from FirstFrame on are queued for writing, of
+		//! which the first EncodedFrames are encoded and only wait to be saved
+		core::array<SFrame> Frames;
+		u32 FirstFrame;
+		u32 QueuedFrames;
+		u32 EncodedFrames;
+
+		//! guards the queue, signals queued and encoded frames
+		os::ThreadSignal Signal;
+		void* WriterThread;
+		bool StopWriter;
+
+		video::IImageWriter* ImageWriter;
+		io::IWriteFile* RawOutput;
+
+		u32 PresentedFrames;
+		u32 FailedFrames;
+		u32 StartTime;
+		f64 WaitTime;
+	};
+
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+#endif // __C_IRR_DEVICE_HEADLESS_H_INCLUDED__
+
@@ -11,6 +11,7 @@
 #include "IrrCompileConfig.h"
 #include "CTimer.h"
 #include "CLogger.h"
+#include "CLoadProfiler.h"
 #include "irrString.h"
 
 namespace irr
@@ -18,7 +19,7 @@ namespace irr
 //! constructor
 CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 : IrrlichtDevice(), VideoDriver(0), GUIEnvironment(0), SceneManager(0),
-	Timer(0), CursorControl(0), UserReceiver(params.EventReceiver), Logger(0), Operator(0),
+	Timer(0), CursorControl(0), UserReceiver(params.EventReceiver), Logger(0), LoadProfiler(0), Operator(0),
 	FileSystem(0), InputReceivingSceneManager(0), CreationParams(params),
 	Close(false)
 {
@@ -38,6 +39,18 @@ CIrrDeviceStub::CIrrDeviceStub(const SIrrlichtCreationParameters& params)
 
 	os::Printer::Logger = Logger;
 
+	// like the logger, the load profiler is shared by all devices
+	if (os::LoadProfiler::Profiler)
+	{
+		os::LoadProfiler::Profiler->grab();
+		LoadProfiler = (CLoadProfiler*)os::LoadProfiler::Profiler;
+	}
+	else
+	{
+		LoadProfiler = new CLoadProfiler();
+		os::LoadProfiler::Profiler = LoadProfiler;
+	}
+
 	FileSystem = io::createFileSystem();
 	core::stringc s = "Irrlicht Engine version ";
 	s.append(getVersion());
@@ -73,6 +86,9 @@ CIrrDeviceStub::~CIrrDeviceStub()
 
 	Timer->drop();
 
+	if (LoadProfiler->drop())
+		os::LoadProfiler::Profiler = 0;
+
 	if (Logger->drop())
 		os::Printer::Logger = 0;
 }
@@ -249,6 +265,13 @@ ILogger* CIrrDeviceStub::getLogger()
 }
 
 
+//! Returns the profiler of loading meshes and textures.
+ILoadProfiler* CIrrDeviceStub::getLoadProfiler()
+{
+	return LoadProfiler;
+}
+
+
 //! Returns the operation system opertator object.
 IOSOperator* CIrrDeviceStub::getOSOperator()
 {
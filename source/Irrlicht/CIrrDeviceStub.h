@@ -15,6 +15,7 @@ namespace irr
 	// lots of prototypes:
 	class ILogger;
 	class CLogger;
+	class CLoadProfiler;
 
 	namespace gui
 	{
@@ -98,6 +99,9 @@ namespace irr
 		//! Returns a pointer to the logger.
 		virtual ILogger* getLogger();
 
+		//! Returns the profiler of loading meshes and textures.
+		virtual ILoadProfiler* getLoadProfiler();
+
 		//! Returns the operation system opertator object.
 		virtual IOSOperator* getOSOperator();
 
@@ -148,6 +152,7 @@ namespace irr
 		gui::ICursorControl* CursorControl;
 		IEventReceiver* UserReceiver;
 		CLogger* Logger;
+		CLoadProfiler* LoadProfiler;
 		IOSOperator* Operator;
 		io::IFileSystem* FileSystem;
 		scene::ISceneManager* InputReceivingSceneManager;
@@ -116,6 +116,18 @@ const io::path& CLimitReadFile::getFileName() const
 }
 
 
+//! returns the file content in memory, if the enclosing file is in memory
+const void* CLimitReadFile::getMappedPointer() const
+{
+	// an area reaching past the end of the file is only read through read()
+	if (!File || AreaStart < 0 || AreaEnd < AreaStart || AreaEnd > File->getSize())
+		return 0;
+
+	const c8* data = (const c8*)File->getMappedPointer();
+	return data ? data + AreaStart : 0;
+}
+
+
 IReadFile* createLimitReadFile(const io::path& fileName, IReadFile* alreadyOpenedFile, long pos, long areaSize)
 {
 	return new CLimitReadFile(alreadyOpenedFile, pos, areaSize, fileName);
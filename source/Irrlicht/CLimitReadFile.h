@@ -46,6 +46,9 @@ namespace io
 		//! returns name of file
 		virtual const io::path& getFileName() const;
 
+		//! returns the file content in memory, if the enclosing file is in memory
+		virtual const void* getMappedPointer() const;
+
 	private:
 
 		io::path Filename;
@@ -0,0 +1,323 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLoadProfiler.h"
+#include "IWriteFile.h"
+#include "os.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace irr
+{
+
+namespace
+{
+	//! orders assets by their total time, the slowest first
+	struct SAssetTime
+	{
+		u32 Time;
+		u32 Index;
+
+		bool operator<(const SAssetTime& other) const
+		{
+			return Time > other.Time || (Time == other.Time && Index < other.Index);
+		}
+	};
+
+	//! appends a name to JSON text, escaping what JSON strings can't contain
+	void appendJSONString(core::stringc& text, const io::path& name)
+	{
+		const core::stringc s(name);
+		text.append('"');
+		for (u32 i=0; i<s.size(); ++i)
+		{
+			const c8 c = s[i];
+			if (c == '"' || c == '\\')
+			{
+				text.append('\\');
+				text.append(c);
+			}
+			else if ((u8)c < 0x20)
+			{
+				c8 tmp[8];
+				snprintf(tmp, 8, "\\u%04x", (u32)(u8)c);
+				text.append(tmp);
+			}
+			else
+				text.append(c);
+		}
+		text.append('"');
+	}
+}
+
+
+CLoadProfiler::CLoadProfiler()
+: StartTime(0), TraceThreshold(10), Enabled(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CLoadProfiler");
+	#endif
+}
+
+
+//! Enables or disables recording
+void CLoadProfiler::setEnabled(bool enabled)
+{
+	if (enabled && !Enabled && !Assets.size())
+		StartTime = os::Timer::getRealTimeMicroseconds();
+	Enabled = enabled;
+}
+
+
+//! Returns if events are recorded
+bool CLoadProfiler::isEnabled() const
+{
+	return Enabled;
+}
+
+
+//! Sets the shortest duration of events kept for the trace
+void CLoadProfiler::setTraceThreshold(u32 microseconds)
+{
+	TraceThreshold = microseconds;
+}
+
+
+//! Removes all recorded assets and events
+void CLoadProfiler::clear()
+{
+	Assets.clear();
+	AssetIndices.clear();
+	OpenEvents.clear();
+	TraceEvents.clear();
+	TraceNames.clear();
+	TraceNameIndices.clear();
+	StartTime = os::Timer::getRealTimeMicroseconds();
+}
+
+
+//! Starts measuring some work
+void CLoadProfiler::beginEvent(E_LOAD_PROFILE_EVENT type, const io::path& name)
+{
+	SOpenEvent e;
+	e.Name = &name;
+	e.NestedTime = 0;
+	e.Type = type;
+
+	// work inside of a load counts for the loaded asset, which is only
+	// looked up when needed, so that small reads stay cheap to measure
+	e.Asset = -1;
+	if (type != ELPE_LOAD)
+	{
+		for (s32 i=(s32)OpenEvents.size()-1; i>=0; --i)
+		{
+			if (OpenEvents[i].Type == ELPE_LOAD)
+			{
+				e.Asset = (s32)getAssetIndex(*OpenEvents[i].Name);
+				OpenEvents[i].Asset = e.Asset;
+				break;
+			}
+		}
+	}
+
+	OpenEvents.push_back(e);
+	OpenEvents.getLast().Start = os::Timer::getRealTimeMicroseconds();
+}
+
+
+//! Ends measuring the work of the last begun event
+void CLoadProfiler::endEvent()
+{
+	const u32 end = os::Timer::getRealTimeMicroseconds();
+
+	// events begun before clear() are ignored
+	if (!OpenEvents.size())
+		return;
+
+	const SOpenEvent e = OpenEvents.getLast();
+	OpenEvents.erase(OpenEvents.size()-1);
+
+	const u32 duration = end - e.Start;
+	if (OpenEvents.size())
+		OpenEvents.getLast().NestedTime += duration;
+
+	const u32 asset = (e.Asset >= 0) ? (u32)e.Asset : getAssetIndex(*e.Name);
+	SLoadProfileAsset& a = Assets[asset];
+	a.Time[e.Type] += duration > e.NestedTime ? duration - e.NestedTime : 0;
+	++a.Count[e.Type];
+
+	if (duration >= TraceThreshold)
+	{
+		STraceEvent t;
+		t.Start = e.Start - StartTime;
+		t.Duration = duration;
+		t.Name = getTraceNameIndex(*e.Name);
+		t.Asset = asset;
+		t.Type = e.Type;
+		TraceEvents.push_back(t);
+	}
+}
+
+
+//! Adds sizes to the asset of the current event
+void CLoadProfiler::addAssetSizes(u32 vertices, u32 indices, u32 texels, u32 bytesAllocated)
+{
+	if (!OpenEvents.size())
+		return;
+
+	SLoadProfileAsset& a = Assets[getCurrentAssetIndex()];
+	a.Vertices += vertices;
+	a.Indices += indices;
+	a.Texels += texels;
+	a.BytesAllocated += bytesAllocated;
+}
+
+
+//! Returns the number of assets recorded so far
+u32 CLoadProfiler::getAssetCount() const
+{
+	return Assets.size();
+}
+
+
+//! Returns what loading an asset cost
+const SLoadProfileAsset& CLoadProfiler::getAsset(u32 index) const
+{
+	return Assets[index];
+}
+
+
+//! Returns the asset with the given name, or 0 if it was not recorded
+const SLoadProfileAsset* CLoadProfiler::getAsset(const io::path& name) const
+{
+	core::map<io::path, u32>::Node* node = AssetIndices.find(name);
+	return node ? &Assets[node->getValue()] : 0;
+}
+
+
+//! Logs the sums of all kinds of work and the slowest assets
+void CLoadProfiler::logSummary(u32 maxAssets) const
+{
+	SLoadProfileAsset sum;
+	core::array<SAssetTime> order;
+	order.reallocate(Assets.size());
+	for (u32 i=0; i<Assets.size(); ++i)
+	{
+		for (u32 t=0; t<ELPE_COUNT; ++t)
+		{
+			sum.Time[t] += Assets[i].Time[t];
+			sum.Count[t] += Assets[i].Count[t];
+		}
+		sum.Vertices += Assets[i].Vertices;
+		sum.Indices += Assets[i].Indices;
+		sum.Texels += Assets[i].Texels;
+		sum.BytesAllocated += Assets[i].BytesAllocated;
+
+		SAssetTime at;
+		at.Time = Assets[i].getTotalTime();
+		at.Index = i;
+		order.push_back(at);
+	}
+	order.sort();
+
+	c8 tmp[512];
+	snprintf(tmp, 512, "Load profile of %u assets, %.1f ms, %u vertices, %u indices, %u texels, %u KB allocated",
+		Assets.size(), sum.getTotalTime() / 1000.f, sum.Vertices, sum.Indices, sum.Texels,
+		sum.BytesAllocated / 1024);
+	os::Printer::log(tmp, ELL_INFORMATION);
+
+	for (u32 t=0; t<ELPE_COUNT; ++t)
+	{
+		snprintf(tmp, 512, "  %-10s %10.1f ms in %u events", LoadProfileEventNames[t],
+			sum.Time[t] / 1000.f, sum.Count[t]);
+		os::Printer::log(tmp, ELL_INFORMATION);
+	}
+
+	if (maxAssets > order.size())
+		maxAssets = order.size();
+	if (!maxAssets)
+		return;
+
+	snprintf(tmp, 512, "Slowest %u assets in ms, total: load open read decompress parse upload", maxAssets);
+	os::Printer::log(tmp, ELL_INFORMATION);
+	for (u32 i=0; i<maxAssets; ++i)
+	{
+		const SLoadProfileAsset& a = Assets[order[i].Index];
+		snprintf(tmp, 512, "  %.1f: %.1f %.1f %.1f %.1f %.1f %.1f, %u vertices, %u indices, %u texels, %u KB",
+			order[i].Time / 1000.f, a.Time[ELPE_LOAD] / 1000.f, a.Time[ELPE_OPEN] / 1000.f,
+			a.Time[ELPE_READ] / 1000.f, a.Time[ELPE_DECOMPRESS] / 1000.f,
+			a.Time[ELPE_PARSE] / 1000.f, a.Time[ELPE_UPLOAD] / 1000.f,
+			a.Vertices, a.Indices, a.Texels, a.BytesAllocated / 1024);
+		os::Printer::log(tmp, a.Name, ELL_INFORMATION);
+	}
+}
+
+
+//! Writes the recorded events in the JSON format of Chrome traces
+bool CLoadProfiler::writeChromeTrace(io::IWriteFile* file) const
+{
+	if (!file)
+		return false;
+
+	const c8* header = "{\"traceEvents\":[";
+	bool result = (file->write(header, (u32)strlen(header)) == (s32)strlen(header));
+	c8 tmp[128];
+	for (u32 i=0; i<TraceEvents.size() && result; ++i)
+	{
+		const STraceEvent& t = TraceEvents[i];
+		core::stringc text(i ? ",\n{\"name\":" : "\n{\"name\":");
+		appendJSONString(text, Assets[t.Asset].Name);
+		snprintf(tmp, 128, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":1,\"args\":{\"file\":",
+			LoadProfileEventNames[t.Type], t.Start, t.Duration);
+		text.append(tmp);
+		appendJSONString(text, TraceNames[t.Name]);
+		text.append("}}");
+		result = (file->write(text.c_str(), text.size()) == (s32)text.size());
+	}
+
+	const c8* footer = "\n]}\n";
+	return result && file->write(footer, (u32)strlen(footer)) == (s32)strlen(footer);
+}
+
+
+//! returns the index of the asset with the name, adding it if needed
+u32 CLoadProfiler::getAssetIndex(const io::path& name)
+{
+	core::map<io::path, u32>::Node* node = AssetIndices.find(name);
+	if (node)
+		return node->getValue();
+
+	const u32 index = Assets.size();
+	Assets.push_back(SLoadProfileAsset());
+	Assets.getLast().Name = name;
+	AssetIndices.insert(name, index);
+	return index;
+}
+
+
+//! returns the index of the name in the trace names, adding it if needed
+u32 CLoadProfiler::getTraceNameIndex(const io::path& name)
+{
+	core::map<io::path, u32>::Node* node = TraceNameIndices.find(name);
+	if (node)
+		return node->getValue();
+
+	const u32 index = TraceNames.size();
+	TraceNames.push_back(name);
+	TraceNameIndices.insert(name, index);
+	return index;
+}
+
+
+//! returns the index of the asset the current event counts for
+u32 CLoadProfiler::getCurrentAssetIndex()
+{
+	SOpenEvent& e = OpenEvents.getLast();
+	if (e.Asset < 0)
+		e.Asset = (s32)getAssetIndex(*e.Name);
+	return (u32)e.Asset;
+}
+
+} // end namespace irr
+
@@ -0,0 +1,103 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LOAD_PROFILER_H_INCLUDED__
+#define __C_LOAD_PROFILER_H_INCLUDED__
+
+#include "ILoadProfiler.h"
+#include "irrArray.h"
+#include "irrMap.h"
+
+namespace irr
+{
+
+//! Records the load events the engine reports through os::LoadEvent
+class CLoadProfiler : public ILoadProfiler
+{
+public:
+
+	CLoadProfiler();
+
+	//! Enables or disables recording
+	virtual void setEnabled(bool enabled);
+
+	//! Returns if events are recorded
+	virtual bool isEnabled() const;
+
+	//! Sets the shortest duration of events kept for the trace
+	virtual void setTraceThreshold(u32 microseconds);
+
+	//! Removes all recorded assets and events
+	virtual void clear();
+
+	//! Starts measuring some work
+	virtual void beginEvent(E_LOAD_PROFILE_EVENT type, const io::path& name);
+
+	//! Ends measuring the work of the last begun event
+	virtual void endEvent();
+
+	//! Adds sizes to the asset of the current event
+	virtual void addAssetSizes(u32 vertices, u32 indices, u32 texels, u32 bytesAllocated);
+
+	//! Returns the number of assets recorded so far
+	virtual u32 getAssetCount() const;
+
+	//! Returns what loading an asset cost
+	virtual const SLoadProfileAsset& getAsset(u32 index) const;
+
+	//! Returns the asset with the given name, or 0 if it was not recorded
+	virtual const SLoadProfileAsset* getAsset(const io::path& name) const;
+
+	//! Logs the sums of all kinds of work and the slowest assets
+	virtual void logSummary(u32 maxAssets=20) const;
+
+	//! Writes the recorded events in the JSON format of Chrome traces
+	virtual bool writeChromeTrace(io::IWriteFile* file) const;
+
+private:
+
+	//! returns the index of the asset with the name, adding it if needed
+	u32 getAssetIndex(const io::path& name);
+
+	//! returns the index of the name in the trace names, adding it if needed
+	u32 getTraceNameIndex(const io::path& name);
+
+	//! returns the index of the asset the current event counts for
+	u32 getCurrentAssetIndex();
+
+	//! an event which has begun, but not ended yet
+	struct SOpenEvent
+	{
+		const io::path* Name;
+		u32 Start;
+		u32 NestedTime;
+		s32 Asset;
+		E_LOAD_PROFILE_EVENT Type;
+	};
+
+	//! an event kept for the trace
+	struct STraceEvent
+	{
+		u32 Start;
+		u32 Duration;
+		u32 Name;
+		u32 Asset;
+		E_LOAD_PROFILE_EVENT Type;
+	};
+
+	core::array<SLoadProfileAsset> Assets;
+	core::map<io::path, u32> AssetIndices;
+	core::array<SOpenEvent> OpenEvents;
+	core::array<STraceEvent> TraceEvents;
+	core::array<io::path> TraceNames;
+	core::map<io::path, u32> TraceNameIndices;
+	u32 StartTime;
+	u32 TraceThreshold;
+	bool Enabled;
+};
+
+} // end namespace irr
+
+#endif
+
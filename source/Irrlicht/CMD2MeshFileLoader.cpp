@@ -91,6 +91,174 @@ namespace scene
 
 #undef PACK_STRUCT
 
+const s32 Q2_VERTEX_NORMAL_TABLE_SIZE = 162;
+
+static const f32 Q2_VERTEX_NORMAL_TABLE[Q2_VERTEX_NORMAL_TABLE_SIZE][3] = {
+	{-0.525731f, 0.000000f, 0.850651f},
+	{-0.442863f, 0.238856f, 0.864188f},
+	{-0.295242f, 0.000000f, 0.955423f},
+	{-0.309017f, 0.500000f, 0.809017f},
+	{-0.162460f, 0.262866f, 0.951056f},
+	{0.000000f, 0.000000f, 1.000000f},
+	{0.000000f, 0.850651f, 0.525731f},
+	{-0.147621f, 0.716567f, 0.681718f},
+	{0.147621f, 0.716567f, 0.681718f},
+	{0.000000f, 0.525731f, 0.850651f},
+	{0.309017f, 0.500000f, 0.809017f},
+	{0.525731f, 0.000000f, 0.850651f},
+	{0.295242f, 0.000000f, 0.955423f},
+	{0.442863f, 0.238856f, 0.864188f},
+	{0.162460f, 0.262866f, 0.951056f},
+	{-0.681718f, 0.147621f, 0.716567f},
+	{-0.809017f, 0.309017f, 0.500000f},
+	{-0.587785f, 0.425325f, 0.688191f},
+	{-0.850651f, 0.525731f, 0.000000f},
+	{-0.864188f, 0.442863f, 0.238856f},
+	{-0.716567f, 0.681718f, 0.147621f},
+	{-0.688191f, 0.587785f, 0.425325f},
+	{-0.500000f, 0.809017f, 0.309017f},
+	{-0.238856f, 0.864188f, 0.442863f},
+	{-0.425325f, 0.688191f, 0.587785f},
+	{-0.716567f, 0.681718f, -0.147621f},
+	{-0.500000f, 0.809017f, -0.309017f},
+	{-0.525731f, 0.850651f, 0.000000f},
+	{0.000000f, 0.850651f, -0.525731f},
+	{-0.238856f, 0.864188f, -0.442863f},
+	{0.000000f, 0.955423f, -0.295242f},
+	{-0.262866f, 0.951056f, -0.162460f},
+	{0.000000f, 1.000000f, 0.000000f},
+	{0.000000f, 0.955423f, 0.295242f},
+	{-0.262866f, 0.951056f, 0.162460f},
+	{0.238856f, 0.864188f, 0.442863f},
+	{0.262866f, 0.951056f, 0.162460f},
+	{0.500000f, 0.809017f, 0.309017f},
+	{0.238856f, 0.864188f, -0.442863f},
+	{0.262866f, 0.951056f, -0.162460f},
+	{0.500000f, 0.809017f, -0.309017f},
+	{0.850651f, 0.525731f, 0.000000f},
+	{0.716567f, 0.681718f, 0.147621f},
+	{0.716567f, 0.681718f, -0.147621f},
+	{0.525731f, 0.850651f, 0.000000f},
+	{0.425325f, 0.688191f, 0.587785f},
+	{0.864188f, 0.442863f, 0.238856f},
+	{0.688191f, 0.587785f, 0.425325f},
+	{0.809017f, 0.309017f, 0.500000f},
+	{0.681718f, 0.147621f, 0.716567f},
+	{0.587785f, 0.425325f, 0.688191f},
+	{0.955423f, 0.295242f, 0.000000f},
+	{1.000000f, 0.000000f, 0.000000f},
+	{0.951056f, 0.162460f, 0.262866f},
+	{0.850651f, -0.525731f, 0.000000f},
+	{0.955423f, -0.295242f, 0.000000f},
+	{0.864188f, -0.442863f, 0.238856f},
+	{0.951056f, -0.162460f, 0.262866f},
+	{0.809017f, -0.309017f, 0.500000f},
+	{0.681718f, -0.147621f, 0.716567f},
+	{0.850651f, 0.000000f, 0.525731f},
+	{0.864188f, 0.442863f, -0.238856f},
+	{0.809017f, 0.309017f, -0.500000f},
+	{0.951056f, 0.162460f, -0.262866f},
+	{0.525731f, 0.000000f, -0.850651f},
+	{0.681718f, 0.147621f, -0.716567f},
+	{0.681718f, -0.147621f, -0.716567f},
+	{0.850651f, 0.000000f, -0.525731f},
+	{0.809017f, -0.309017f, -0.500000f},
+	{0.864188f, -0.442863f, -0.238856f},
+	{0.951056f, -0.162460f, -0.262866f},
+	{0.147621f, 0.716567f, -0.681718f},
+	{0.309017f, 0.500000f, -0.809017f},
+	{0.425325f, 0.688191f, -0.587785f},
+	{0.442863f, 0.238856f, -0.864188f},
+	{0.587785f, 0.425325f, -0.688191f},
+	{0.688191f, 0.587785f, -0.425325f},
+	{-0.147621f, 0.716567f, -0.681718f},
+	{-0.309017f, 0.500000f, -0.809017f},
+	{0.000000f, 0.525731f, -0.850651f},
+	{-0.525731f, 0.000000f, -0.850651f},
+	{-0.442863f, 0.238856f, -0.864188f},
+	{-0.295242f, 0.000000f, -0.955423f},
+	{-0.162460f, 0.262866f, -0.951056f},
+	{0.000000f, 0.000000f, -1.000000f},
+	{0.295242f, 0.000000f, -0.955423f},
+	{0.162460f, 0.262866f, -0.951056f},
+	{-0.442863f, -0.238856f, -0.864188f},
+	{-0.309017f, -0.500000f, -0.809017f},
+	{-0.162460f, -0.262866f, -0.951056f},
+	{0.000000f, -0.850651f, -0.525731f},
+	{-0.147621f, -0.716567f, -0.681718f},
+	{0.147621f, -0.716567f, -0.681718f},
+	{0.000000f, -0.525731f, -0.850651f},
+	{0.309017f, -0.500000f, -0.809017f},
+	{0.442863f, -0.238856f, -0.864188f},
+	{0.162460f, -0.262866f, -0.951056f},
+	{0.238856f, -0.864188f, -0.442863f},
+	{0.500000f, -0.809017f, -0.309017f},
+	{0.425325f, -0.688191f, -0.587785f},
+	{0.716567f, -0.681718f, -0.147621f},
+	{0.688191f, -0.587785f, -0.425325f},
+	{0.587785f, -0.425325f, -0.688191f},
+	{0.000000f, -0.955423f, -0.295242f},
+	{0.000000f, -1.000000f, 0.000000f},
+	{0.262866f, -0.951056f, -0.162460f},
+	{0.000000f, -0.850651f, 0.525731f},
+	{0.000000f, -0.955423f, 0.295242f},
+	{0.238856f, -0.864188f, 0.442863f},
+	{0.262866f, -0.951056f, 0.162460f},
+	{0.500000f, -0.809017f, 0.309017f},
+	{0.716567f, -0.681718f, 0.147621f},
+	{0.525731f, -0.850651f, 0.000000f},
+	{-0.238856f, -0.864188f, -0.442863f},
+	{-0.500000f, -0.809017f, -0.309017f},
+	{-0.262866f, -0.951056f, -0.162460f},
+	{-0.850651f, -0.525731f, 0.000000f},
+	{-0.716567f, -0.681718f, -0.147621f},
+	{-0.716567f, -0.681718f, 0.147621f},
+	{-0.525731f, -0.850651f, 0.000000f},
+	{-0.500000f, -0.809017f, 0.309017f},
+	{-0.238856f, -0.864188f, 0.442863f},
+	{-0.262866f, -0.951056f, 0.162460f},
+	{-0.864188f, -0.442863f, 0.238856f},
+	{-0.809017f, -0.309017f, 0.500000f},
+	{-0.688191f, -0.587785f, 0.425325f},
+	{-0.681718f, -0.147621f, 0.716567f},
+	{-0.442863f, -0.238856f, 0.864188f},
+	{-0.587785f, -0.425325f, 0.688191f},
+	{-0.309017f, -0.500000f, 0.809017f},
+	{-0.147621f, -0.716567f, 0.681718f},
+	{-0.425325f, -0.688191f, 0.587785f},
+	{-0.162460f, -0.262866f, 0.951056f},
+	{0.442863f, -0.238856f, 0.864188f},
+	{0.162460f, -0.262866f, 0.951056f},
+	{0.309017f, -0.500000f, 0.809017f},
+	{0.147621f, -0.716567f, 0.681718f},
+	{0.000000f, -0.525731f, 0.850651f},
+	{0.425325f, -0.688191f, 0.587785f},
+	{0.587785f, -0.425325f, 0.688191f},
+	{0.688191f, -0.587785f, 0.425325f},
+	{-0.955423f, 0.295242f, 0.000000f},
+	{-0.951056f, 0.162460f, 0.262866f},
+	{-1.000000f, 0.000000f, 0.000000f},
+	{-0.850651f, 0.000000f, 0.525731f},
+	{-0.955423f, -0.295242f, 0.000000f},
+	{-0.951056f, -0.162460f, 0.262866f},
+	{-0.864188f, 0.442863f, -0.238856f},
+	{-0.951056f, 0.162460f, -0.262866f},
+	{-0.809017f, 0.309017f, -0.500000f},
+	{-0.864188f, -0.442863f, -0.238856f},
+	{-0.951056f, -0.162460f, -0.262866f},
+	{-0.809017f, -0.309017f, -0.500000f},
+	{-0.681718f, 0.147621f, -0.716567f},
+	{-0.681718f, -0.147621f, -0.716567f},
+	{-0.850651f, 0.000000f, -0.525731f},
+	{-0.688191f, 0.587785f, -0.425325f},
+	{-0.587785f, 0.425325f, -0.688191f},
+	{-0.425325f, 0.688191f, -0.587785f},
+	{-0.425325f, -0.688191f, -0.587785f},
+	{-0.587785f, -0.425325f, -0.688191f},
+	{-0.688191f, -0.587785f, -0.425325f},
+	};
+
+
 //! Constructor
 CMD2MeshFileLoader::CMD2MeshFileLoader()
 {
@@ -168,18 +336,15 @@ bool CMD2MeshFileLoader::loadFile(io::IReadFile* file, CAnimatedMeshMD2* mesh)
 
 	mesh->FrameCount = header.numFrames;
 
-	// create keyframes
-	mesh->FrameTransforms.set_used(header.numFrames);
-
 	// create vertex arrays for each keyframe
 	if (mesh->FrameList)
 		delete [] mesh->FrameList;
-	mesh->FrameList = new core::array<CAnimatedMeshMD2::SMD2Vert>[header.numFrames];
+	mesh->FrameList = new core::array<SFrameVertex>[header.numFrames];
 
 	// allocate space in vertex arrays
 	s32 i;
 	for (i=0; i<header.numFrames; ++i)
-		mesh->FrameList[i].reallocate(header.numVertices);
+		mesh->FrameList[i].set_used(header.numVertices);
 
 	// allocate interpolation buffer vertices
 	mesh->InterpolationBuffer->Vertices.set_used(header.numTriangles*3);
@@ -238,6 +403,20 @@ bool CMD2MeshFileLoader::loadFile(io::IReadFile* file, CAnimatedMeshMD2* mesh)
 	}
 #endif
 
+	// the interpolation buffer has three vertices per triangle,
+	// store which keyframe vertex each of them is made of
+	mesh->FrameVertexIndices.set_used(header.numTriangles*3);
+	for (i=0; i<header.numTriangles; ++i)
+	{
+		for (u32 ti=0; ti<3; ++ti)
+		{
+			u16 num = triangles[i].vertexIndices[ti];
+			if (num >= header.numVertices)
+				num = 0;
+			mesh->FrameVertexIndices[i*3 + ti] = num;
+		}
+	}
+
 	// read Vertices
 
 	u8 buffer[MD2_MAX_VERTS*4+128];
@@ -290,50 +469,28 @@ bool CMD2MeshFileLoader::loadFile(io::IReadFile* file, CAnimatedMeshMD2* mesh)
 			}
 		}
 
-		// save keyframe scale and translation
-
-		mesh->FrameTransforms[i].scale.X = frame->scale[0];
-		mesh->FrameTransforms[i].scale.Z = frame->scale[1];
-		mesh->FrameTransforms[i].scale.Y = frame->scale[2];
-		mesh->FrameTransforms[i].translate.X = frame->translate[0];
-		mesh->FrameTransforms[i].translate.Z = frame->translate[1];
-		mesh->FrameTransforms[i].translate.Y = frame->translate[2];
-
-		// add vertices
-		for (s32 j=0; j<header.numTriangles; ++j)
+		// decode vertices, the scale and translation of the keyframe are applied
+		// here already, so that the mesh only has to interpolate them
+		const core::vector3df* normalTable = (const core::vector3df*)&Q2_VERTEX_NORMAL_TABLE;
+		SFrameVertex* vertices = mesh->FrameList[i].pointer();
+		for (s32 j=0; j<header.numVertices; ++j)
 		{
-			for (u32 ti=0; ti<3; ++ti)
-			{
-				CAnimatedMeshMD2::SMD2Vert v;
-				u32 num = triangles[j].vertexIndices[ti];
-				v.Pos.X = frame->vertices[num].vertex[0];
-				v.Pos.Z = frame->vertices[num].vertex[1];
-				v.Pos.Y = frame->vertices[num].vertex[2];
-				v.NormalIdx = frame->vertices[num].lightNormalIndex;
-
-				mesh->FrameList[i].push_back(v);
-			}
+			const SMD2Vertex& v = frame->vertices[j];
+			vertices[j].Pos.X = f32(v.vertex[0]) * frame->scale[0] + frame->translate[0];
+			vertices[j].Pos.Y = f32(v.vertex[2]) * frame->scale[2] + frame->translate[2];
+			vertices[j].Pos.Z = f32(v.vertex[1]) * frame->scale[1] + frame->translate[1];
+			vertices[j].Normal = normalTable[v.lightNormalIndex < Q2_VERTEX_NORMAL_TABLE_SIZE ? v.lightNormalIndex : 0];
 		}
 
 		// calculate bounding boxes
 		if (header.numVertices)
 		{
-			core::aabbox3d<f32> box;
-			core::vector3df pos;
-			pos.X = f32(mesh->FrameList[i] [0].Pos.X) * mesh->FrameTransforms[i].scale.X + mesh->FrameTransforms[i].translate.X;
-			pos.Y = f32(mesh->FrameList[i] [0].Pos.Y) * mesh->FrameTransforms[i].scale.Y + mesh->FrameTransforms[i].translate.Y;
-			pos.Z = f32(mesh->FrameList[i] [0].Pos.Z) * mesh->FrameTransforms[i].scale.Z + mesh->FrameTransforms[i].translate.Z;
-
-			box.reset(pos);
+			const core::array<u16>& indices = mesh->FrameVertexIndices;
+			core::aabbox3d<f32> box(vertices[indices.empty() ? 0 : indices[0]].Pos);
 
-			for (s32 j=1; j<header.numTriangles*3; ++j)
-			{
-				pos.X = f32(mesh->FrameList[i] [j].Pos.X) * mesh->FrameTransforms[i].scale.X + mesh->FrameTransforms[i].translate.X;
-				pos.Y = f32(mesh->FrameList[i] [j].Pos.Y) * mesh->FrameTransforms[i].scale.Y + mesh->FrameTransforms[i].translate.Y;
-				pos.Z = f32(mesh->FrameList[i] [j].Pos.Z) * mesh->FrameTransforms[i].scale.Z + mesh->FrameTransforms[i].translate.Z;
+			for (u32 j=1; j<indices.size(); ++j)
+				box.addInternalPoint(vertices[indices[j]].Pos);
 
-				box.addInternalPoint(pos);
-			}
 			mesh->BoxList.push_back(box);
 		}
 	}
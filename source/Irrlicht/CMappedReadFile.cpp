@@ -0,0 +1,221 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMappedReadFile.h"
+#include "IrrCompileConfig.h"
+#include "os.h"
+
+#if defined (_IRR_WINDOWS_API_) && !defined(_WIN32_WCE) && !defined(_IRR_XBOX_PLATFORM_)
+	#define _IRR_MAPPED_FILES_WINDOWS_
+	#include <windows.h>
+#elif defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_)
+	#define _IRR_MAPPED_FILES_POSIX_
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+
+CMappedReadFile::CMappedReadFile(const io::path& fileName)
+: Data(0), FileSize(0), Pos(0), Filename(fileName), FileHandle(0), MappingHandle(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CMappedReadFile");
+	#endif
+
+	openFile();
+}
+
+
+CMappedReadFile::~CMappedReadFile()
+{
+	closeFile();
+}
+
+
+//! returns how much was read
+s32 CMappedReadFile::read(void* buffer, u32 sizeToRead)
+{
+	if (!isOpen())
+		return 0;
+
+	s32 amount = static_cast<s32>(sizeToRead);
+	if (Pos + amount > FileSize)
+		amount = FileSize - Pos;
+
+	if (amount <= 0)
+		return 0;
+
+	// the pages of the file are read from disk while copying
+	os::LoadEvent event(ELPE_READ, Filename);
+	memcpy(buffer, Data + Pos, amount);
+	Pos += amount;
+
+	return amount;
+}
+
+
+//! changes position in file, returns true if successful
+//! if relativeMovement==true, the pos is changed relative to current pos,
+//! otherwise from begin of file
+bool CMappedReadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (!isOpen())
+		return false;
+
+	if (relativeMovement)
+		finalPos += Pos;
+
+	if (finalPos < 0 || finalPos > FileSize)
+		return false;
+
+	Pos = finalPos;
+	return true;
+}
+
+
+//! returns size of file
+long CMappedReadFile::getSize() const
+{
+	return FileSize;
+}
+
+
+//! returns where in the file we are.
+long CMappedReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! returns name of file
+const io::path& CMappedReadFile::getFileName() const
+{
+	return Filename;
+}
+
+
+//! returns the file content in memory
+const void* CMappedReadFile::getMappedPointer() const
+{
+	return Data;
+}
+
+
+//! opens and maps the file
+void CMappedReadFile::openFile()
+{
+	if (Filename.size() == 0)
+		return;
+
+#if defined(_IRR_MAPPED_FILES_WINDOWS_)
+
+#if defined ( _IRR_WCHAR_FILESYSTEM )
+	HANDLE file = CreateFileW(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#else
+	HANDLE file = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#endif
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	FileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || size.HighPart)
+	{
+		closeFile();
+		return;
+	}
+
+	HANDLE mapping = CreateFileMapping(file, 0, PAGE_READONLY, 0, 0, 0);
+	if (!mapping)
+	{
+		closeFile();
+		return;
+	}
+
+	MappingHandle = mapping;
+
+	Data = (const u8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!Data)
+	{
+		closeFile();
+		return;
+	}
+
+	FileSize = (long)size.LowPart;
+
+#elif defined(_IRR_MAPPED_FILES_POSIX_)
+
+	const int fd = open(Filename.c_str(), O_RDONLY);
+	if (fd == -1)
+		return;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0 || (off_t)(long)st.st_size != st.st_size)
+	{
+		close(fd);
+		return;
+	}
+
+	void* data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after closing the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return;
+
+	Data = (const u8*)data;
+	FileSize = (long)st.st_size;
+
+#endif
+}
+
+
+//! unmaps and closes the file
+void CMappedReadFile::closeFile()
+{
+#if defined(_IRR_MAPPED_FILES_WINDOWS_)
+	if (Data)
+		UnmapViewOfFile(Data);
+	if (MappingHandle)
+		CloseHandle((HANDLE)MappingHandle);
+	if (FileHandle)
+		CloseHandle((HANDLE)FileHandle);
+#elif defined(_IRR_MAPPED_FILES_POSIX_)
+	if (Data)
+		munmap((void*)Data, FileSize);
+#endif
+
+	Data = 0;
+	FileSize = 0;
+	MappingHandle = 0;
+	FileHandle = 0;
+}
+
+
+IReadFile* createMappedReadFile(const io::path& fileName)
+{
+	CMappedReadFile* file = new CMappedReadFile(fileName);
+	if (file->isOpen())
+		return file;
+
+	file->drop();
+	return 0;
+}
+
+
+} // end namespace io
+} // end namespace irr
+
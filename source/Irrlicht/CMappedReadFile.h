@@ -0,0 +1,80 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MAPPED_READ_FILE_H_INCLUDED__
+#define __C_MAPPED_READ_FILE_H_INCLUDED__
+
+#include "IReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+
+	/*!
+		Class for reading a real file from disk, which is mapped into memory.
+		The file content can be accessed directly with getMappedPointer().
+	*/
+	class CMappedReadFile : public IReadFile
+	{
+	public:
+
+		CMappedReadFile(const io::path& fileName);
+
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		virtual s32 read(void* buffer, u32 sizeToRead);
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false);
+
+		//! returns size of file
+		virtual long getSize() const;
+
+		//! returns if the file is open and mapped
+		virtual bool isOpen() const
+		{
+			return Data != 0;
+		}
+
+		//! returns where in the file we are.
+		virtual long getPos() const;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const;
+
+		//! returns the file content in memory
+		virtual const void* getMappedPointer() const;
+
+	private:
+
+		//! opens and maps the file
+		void openFile();
+
+		//! unmaps and closes the file
+		void closeFile();
+
+		const u8* Data;
+		long FileSize;
+		long Pos;
+		io::path Filename;
+
+		// platform handles of the file and the mapping
+		void* FileHandle;
+		void* MappingHandle;
+	};
+
+	//! Internal function, please do not use.
+	/** Returns 0 if the file could not be mapped, e.g. because the
+	platform does not support it. */
+	IReadFile* createMappedReadFile(const io::path& fileName);
+
+} // end namespace io
+} // end namespace irr
+
+#endif
+
@@ -110,6 +110,13 @@ const io::path& CMemoryFile::getFileName() const
 }
 
 
+//! returns the file content in memory
+const void* CMemoryFile::getMappedPointer() const
+{
+	return Buffer;
+}
+
+
 IReadFile* createMemoryReadFile(void* memory, long size, const io::path& fileName, bool deleteMemoryWhenDropped)
 {
 	CMemoryFile* file = new CMemoryFile(memory, size, fileName, deleteMemoryWhenDropped);
@@ -61,16 +61,13 @@ void CMeshManipulator::flipSurfaces(scene::IMesh* mesh) const
 }
 
 
-//! Recalculates all normals of the mesh buffer.
-/** \param buffer: Mesh buffer on which the operation is performed. */
-void CMeshManipulator::recalculateNormals(IMeshBuffer* buffer, bool smooth, bool angleWeighted) const
+//! Recalculates all normals of a mesh buffer with indices of type T
+template <class T>
+static void recalculateNormalsT(IMeshBuffer* buffer, bool smooth, bool angleWeighted)
 {
-	if (!buffer)
-		return;
-
 	const u32 vtxcnt = buffer->getVertexCount();
 	const u32 idxcnt = buffer->getIndexCount();
-	const u16* idx = buffer->getIndices();
+	const T* idx = (const T*)buffer->getIndices();
 
 	if (!smooth)
 	{
@@ -113,6 +110,20 @@ void CMeshManipulator::recalculateNormals(IMeshBuffer* buffer, bool smooth, bool
 }
 
 
+//! Recalculates all normals of the mesh buffer.
+/** \param buffer: Mesh buffer on which the operation is performed. */
+void CMeshManipulator::recalculateNormals(IMeshBuffer* buffer, bool smooth, bool angleWeighted) const
+{
+	if (!buffer)
+		return;
+
+	if (buffer->getIndexType() == video::EIT_16BIT)
+		recalculateNormalsT<u16>(buffer, smooth, angleWeighted);
+	else
+		recalculateNormalsT<u32>(buffer, smooth, angleWeighted);
+}
+
+
 //! Recalculates all normals of the mesh.
 //! \param mesh: Mesh on which the operation is performed.
 void CMeshManipulator::recalculateNormals(scene::IMesh* mesh, bool smooth, bool angleWeighted) const
@@ -724,6 +735,149 @@ IMesh* CMeshManipulator::createMeshWelded(IMesh *mesh, f32 tolerance) const
 }
 
 
+//! Spreads the lower 10 bits of a value to every third bit
+static inline u32 spreadMortonBits(u32 v)
+{
+	v = (v | (v << 16)) & 0x030000FF;
+	v = (v | (v << 8)) & 0x0300F00F;
+	v = (v | (v << 4)) & 0x030C30C3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+
+//! Adds a mesh buffer to a mesh, split into buffers with 16 bit indices if needed
+u32 CMeshManipulator::addSplitMeshBuffer(SMesh* mesh, IMeshBuffer* buffer, bool allow32BitIndices) const
+{
+	if (!mesh || !buffer)
+		return 0;
+
+	const u32 vtxcnt = buffer->getVertexCount();
+	if ((buffer->getIndexType() != video::EIT_32BIT) ||
+		(buffer->getVertexType() != video::EVT_STANDARD) ||
+		(allow32BitIndices && vtxcnt > 0xFFFF))
+	{
+		mesh->addMeshBuffer(buffer);
+		return 1;
+	}
+
+	const video::S3DVertex* vertices = (const video::S3DVertex*)buffer->getVertices();
+	const u32* indices = (const u32*)buffer->getIndices();
+	const u32 tricnt = buffer->getIndexCount() / 3;
+
+	core::array<u32> order(tricnt);
+	order.set_used(tricnt);
+	u32 t;
+	for (t=0; t<tricnt; ++t)
+		order[t] = t;
+
+	if (vtxcnt > 0xFFFF)
+	{
+		// quantize the triangle centers to 10 bits per axis and
+		// interleave them into the position on the z-order curve
+		core::aabbox3df box(vertices[0].Pos);
+		for (u32 i=1; i<vtxcnt; ++i)
+			box.addInternalPoint(vertices[i].Pos);
+		const core::vector3df extent = box.getExtent();
+		const core::vector3df scale(
+			extent.X > 0.f ? 1023.f / (3.f * extent.X) : 0.f,
+			extent.Y > 0.f ? 1023.f / (3.f * extent.Y) : 0.f,
+			extent.Z > 0.f ? 1023.f / (3.f * extent.Z) : 0.f);
+		const core::vector3df origin = box.MinEdge * 3.f;
+
+		core::array<u32> keys(tricnt);
+		keys.set_used(tricnt);
+		for (t=0; t<tricnt; ++t)
+		{
+			const u32* tri = indices + t*3;
+			const core::vector3df center = (vertices[tri[0]].Pos + vertices[tri[1]].Pos +
+					vertices[tri[2]].Pos - origin) * scale;
+			keys[t] = spreadMortonBits(core::clamp((s32)center.X, 0, 1023)) |
+				(spreadMortonBits(core::clamp((s32)center.Y, 0, 1023)) << 1) |
+				(spreadMortonBits(core::clamp((s32)center.Z, 0, 1023)) << 2);
+		}
+
+		// stable radix sort of the 30 bit keys in three passes
+		core::array<u32> sortedKeys(tricnt);
+		sortedKeys.set_used(tricnt);
+		core::array<u32> sortedOrder(tricnt);
+		sortedOrder.set_used(tricnt);
+		for (u32 shift=0; shift<30; shift+=10)
+		{
+			u32 offsets[1024];
+			memset(offsets, 0, sizeof(offsets));
+			for (t=0; t<tricnt; ++t)
+				++offsets[(keys[t] >> shift) & 1023];
+			u32 sum = 0;
+			for (u32 b=0; b<1024; ++b)
+			{
+				const u32 count = offsets[b];
+				offsets[b] = sum;
+				sum += count;
+			}
+			for (t=0; t<tricnt; ++t)
+			{
+				const u32 pos = offsets[(keys[t] >> shift) & 1023]++;
+				sortedKeys[pos] = keys[t];
+				sortedOrder[pos] = order[t];
+			}
+			keys.swap(sortedKeys);
+			order.swap(sortedOrder);
+		}
+	}
+
+	// fill the parts in this order, a vertex is copied to each part
+	// which uses it
+	core::array<u32> redirects(vtxcnt);
+	redirects.set_used(vtxcnt);
+	core::array<u32> owner(vtxcnt);
+	owner.set_used(vtxcnt);
+	for (u32 i=0; i<vtxcnt; ++i)
+		owner[i] = 0;
+
+	SMeshBuffer* part = 0;
+	u32 parts = 0;
+	for (t=0; t<tricnt; ++t)
+	{
+		if (!part || part->Vertices.size() > 0xFFFF - 3)
+		{
+			if (part)
+			{
+				part->recalculateBoundingBox();
+				mesh->addMeshBuffer(part);
+				part->drop();
+			}
+			part = new SMeshBuffer();
+			part->Material = buffer->getMaterial();
+			part->setHardwareMappingHint(buffer->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+			part->setHardwareMappingHint(buffer->getHardwareMappingHint_Index(), EBT_INDEX);
+			++parts;
+		}
+
+		const u32* tri = indices + order[t]*3;
+		for (u32 c=0; c<3; ++c)
+		{
+			const u32 v = tri[c];
+			if (owner[v] != parts)
+			{
+				owner[v] = parts;
+				redirects[v] = part->Vertices.size();
+				part->Vertices.push_back(vertices[v]);
+			}
+			part->Indices.push_back((u16)redirects[v]);
+		}
+	}
+
+	if (part)
+	{
+		part->recalculateBoundingBox();
+		mesh->addMeshBuffer(part);
+		part->drop();
+	}
+	return parts;
+}
+
+
 //! Creates a copy of the mesh, which will only consist of S3DVertexTangents vertices.
 IMesh* CMeshManipulator::createMeshWithTangents(IMesh* mesh, bool recalculateNormals, bool smooth, bool angleWeighted, bool calculateTangents) const
 {
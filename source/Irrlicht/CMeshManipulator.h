@@ -69,6 +69,9 @@ public:
 	//! Creates a copy of the mesh, which will have all duplicated vertices removed, i.e. maximal amount of vertices are shared via indexing.
 	virtual IMesh* createMeshWelded(IMesh *mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const;
 
+	//! Adds a mesh buffer to a mesh, split into buffers with 16 bit indices if needed.
+	virtual u32 addSplitMeshBuffer(SMesh* mesh, IMeshBuffer* buffer, bool allow32BitIndices) const;
+
 	//! Returns amount of polygons in mesh.
 	virtual s32 getPolyCount(scene::IMesh* mesh) const;
 
@@ -47,6 +47,9 @@ IImageLoader* createImageLoaderPPM();
 //! creates a loader which is able to load rgb images
 IImageLoader* createImageLoaderRGB();
 
+//! creates a loader which is able to load dds images
+IImageLoader* createImageLoaderDDS();
+
 
 //! creates a writer which is able to save bmp images
 IImageWriter* createImageWriterBMP();
@@ -69,6 +72,9 @@ IImageWriter* createImageWriterPNG();
 //! creates a writer which is able to save ppm images
 IImageWriter* createImageWriterPPM();
 
+//! creates a writer which is able to save dds images
+IImageWriter* createImageWriterDDS();
+
 
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
@@ -122,6 +128,9 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 #ifdef _IRR_COMPILE_WITH_RGB_LOADER_
 	SurfaceLoader.push_back(video::createImageLoaderRGB());
 #endif
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+	SurfaceLoader.push_back(video::createImageLoaderDDS());
+#endif
 
 
 #ifdef _IRR_COMPILE_WITH_BMP_WRITER_
@@ -145,6 +154,9 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 #ifdef _IRR_COMPILE_WITH_PPM_WRITER_
 	SurfaceWriter.push_back(video::createImageWriterPPM());
 #endif
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+	SurfaceWriter.push_back(video::createImageWriterDDS());
+#endif
 
 	// set ExposedData to 0
 	memset(&ExposedData, 0, sizeof(ExposedData));
@@ -384,10 +396,12 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 	if (texture)
 		return texture;
 
+	os::LoadEvent loadEvent(ELPE_LOAD, filename);
+
 	// Now try to open the file using the complete path.
 	io::IReadFile* file = FileSystem->createAndOpenFile(absolutePath);
 
-	if(!file)
+	if (!file && absolutePath != filename)
 	{
 		// Try to open it using the raw filename.
 		file = FileSystem->createAndOpenFile(filename);
@@ -435,6 +449,7 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 		if (texture)
 			return texture;
 
+		os::LoadEvent loadEvent(ELPE_LOAD, file->getFileName());
 		texture = loadTextureFromFile(file);
 
 		if (texture)
@@ -455,12 +470,13 @@ ITexture* CNullDriver::getTexture(io::IReadFile* file)
 video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io::path& hashName )
 {
 	ITexture* texture = 0;
-	IImage* image = createImageFromFile(file);
+	// images larger than the driver can use are decoded smaller if possible
+	IImage* image = createScaledImageFromFile(file, getMaxTextureSize());
 
 	if (image)
 	{
 		// create texture from surface
-		texture = createDeviceDependentTexture(image, hashName.size() ? hashName : file->getFileName() );
+		texture = createTextureFromImage(image, hashName.size() ? hashName : file->getFileName() );
 		os::Printer::log("Loaded texture", file->getFileName());
 		image->drop();
 	}
@@ -511,7 +527,7 @@ ITexture* CNullDriver::addTexture(const io::path& name, IImage* image, void* mip
 	if ( 0 == name.size() || !image)
 		return 0;
 
-	ITexture* t = createDeviceDependentTexture(image, name, mipmapData);
+	ITexture* t = createTextureFromImage(image, name, mipmapData);
 	if (t)
 	{
 		addTexture(t);
@@ -535,7 +551,7 @@ ITexture* CNullDriver::addTexture(const core::dimension2d<u32>& size,
 		return 0;
 
 	IImage* image = new CImage(format, size);
-	ITexture* t = createDeviceDependentTexture(image, name);
+	ITexture* t = createTextureFromImage(image, name);
 	image->drop();
 	addTexture(t);
 
@@ -555,6 +571,32 @@ ITexture* CNullDriver::createDeviceDependentTexture(IImage* surface, const io::p
 }
 
 
+//! creates a device dependent texture, decompressing images the driver can not use
+ITexture* CNullDriver::createTextureFromImage(IImage* surface, const io::path& name, void* mipmapData)
+{
+	// images loaded with mip maps bring their own levels
+	if (!mipmapData)
+		mipmapData = surface->getMipMapsData();
+
+	os::LoadEvent uploadEvent(ELPE_UPLOAD, name);
+	ITexture* t = 0;
+	if (!IImage::isCompressedFormat(surface->getColorFormat()) || queryFeature(EVDF_TEXTURE_COMPRESSED_DXT))
+		t = createDeviceDependentTexture(surface, name, mipmapData);
+	else
+	{
+		// the mip map data is compressed as well, so the levels are created again
+		IImage* image = new CImage(ECF_A8R8G8B8, surface->getDimension());
+		surface->copyTo(image);
+		t = createDeviceDependentTexture(image, name);
+		image->drop();
+	}
+
+	if (t)
+		uploadEvent.addAssetSizes(0, 0, 0, t->getPitch() * t->getSize().Height);
+	return t;
+}
+
+
 //! set or reset special render targets
 bool CNullDriver::setRenderTarget(video::E_RENDER_TARGET target, bool clearTarget,
 			bool clearZBuffer, SColor color)
@@ -844,6 +886,21 @@ u32 CNullDriver::getPrimitiveCountDrawn( u32 param ) const
 }
 
 
+//! returns amount of triangles which were hidden in the last frame.
+//! The null driver doesn't test triangles before drawing them.
+u32 CNullDriver::getPrimitiveCountRejected( u32 param ) const
+{
+	return 0;
+}
+
+
+//! returns how often each pixel was drawn on average in the last frame.
+f32 CNullDriver::getOverdraw() const
+{
+	return 0.f;
+}
+
+
 
 //! Sets the dynamic ambient light color. The default color is
 //! (0,0,0,0) which means it is dark.
@@ -1264,10 +1321,18 @@ IImage* CNullDriver::createImageFromFile(const io::path& filename)
 
 //! Creates a software image from a file.
 IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
+{
+	return createScaledImageFromFile(file, core::dimension2du(0, 0));
+}
+
+
+//! Creates a software image from a file, which loaders may decode smaller down to maxSize
+IImage* CNullDriver::createScaledImageFromFile(io::IReadFile* file, const core::dimension2du& maxSize)
 {
 	if (!file)
 		return 0;
 
+	os::LoadEvent parseEvent(ELPE_PARSE, file->getFileName());
 	IImage* image = 0;
 
 	u32 i;
@@ -1279,9 +1344,12 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		{
 			// reset file position which might have changed due to previous loadImage calls
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = SurfaceLoader[i]->loadScaledImage(file, maxSize);
 			if (image)
+			{
+				parseEvent.addAssetSizes(0, 0, image->getDimension().getArea(), image->getImageDataSizeInBytes());
 				return image;
+			}
 		}
 	}
 
@@ -1293,9 +1361,12 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		if (SurfaceLoader[i]->isALoadableFileFormat(file))
 		{
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = SurfaceLoader[i]->loadScaledImage(file, maxSize);
 			if (image)
+			{
+				parseEvent.addAssetSizes(0, 0, image->getDimension().getArea(), image->getImageDataSizeInBytes());
 				return image;
+			}
 		}
 	}
 
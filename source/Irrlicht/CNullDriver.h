@@ -241,6 +241,12 @@ namespace video
 		//! very useful method for statistics.
 		virtual u32 getPrimitiveCountDrawn( u32 param = 0 ) const;
 
+		//! returns amount of triangles which were hidden in the last frame.
+		virtual u32 getPrimitiveCountRejected( u32 param = 0 ) const;
+
+		//! returns how often each pixel was drawn on average in the last frame.
+		virtual f32 getOverdraw() const;
+
 		//! deletes all dynamic lights there are
 		virtual void deleteAllDynamicLights();
 
@@ -606,6 +612,9 @@ namespace video
 		//! opens the file and loads it into the surface
 		video::ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
+		//! Creates a software image from a file, which loaders may decode smaller down to maxSize
+		IImage* createScaledImageFromFile(io::IReadFile* file, const core::dimension2du& maxSize);
+
 		//! adds a surface, not loaded or created by the Irrlicht Engine
 		void addTexture(video::ITexture* surface);
 
@@ -616,6 +625,9 @@ namespace video
 		//! THIS METHOD HAS TO BE OVERRIDDEN BY DERIVED DRIVERS WITH OWN TEXTURES
 		virtual video::ITexture* createDeviceDependentTexture(IImage* surface, const io::path& name, void* mipmapData=0);
 
+		//! creates a device dependent texture, decompressing images the driver can not use
+		video::ITexture* createTextureFromImage(IImage* surface, const io::path& name, void* mipmapData=0);
+
 		//! checks triangle count and print warning if wrong
 		bool checkPrimitiveCount(u32 prmcnt) const;
 
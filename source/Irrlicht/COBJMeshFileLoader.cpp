@@ -28,6 +28,49 @@ namespace scene
 
 static const u32 WORD_BUFFER_LENGTH = 512;
 
+// files are only split into chunks of at least this size, about as many
+// lines as the ply loader parses in one job, smaller files are parsed on
+// the calling thread
+static const long MIN_CHUNK_SIZE = 16384 * 32;
+
+
+// vertices are hashed by the cells of their position, a power of two per
+// unit so the cells are exact. Beyond the range the cell would overflow an
+// s32. The float spacing there is far above the rounding tolerance, so
+// equal coordinates have the same bits, which are hashed instead
+static const f32 VERTEX_CELLS_PER_UNIT = 1024.f;
+static const f32 VERTEX_CELL_RANGE = 2147483648.f / VERTEX_CELLS_PER_UNIT;
+
+
+//! Returns the hash cell of a coordinate of a vertex position
+static inline u32 getVertexCell(f32 x)
+{
+	if (!(core::abs_(x) < VERTEX_CELL_RANGE))
+		return IR(x);
+	return (u32)(s32)floorf(x * VERTEX_CELLS_PER_UNIT);
+}
+
+
+//! Hashes the cells of a vertex position and its color
+static inline u32 hashVertexCells(const u32* cells, u32 color)
+{
+	u32 hash = 2166136261u ^ color;
+	for (u32 i=0; i<3; ++i)
+	{
+		hash ^= cells[i];
+		hash *= 16777619u;
+	}
+	return hash ^ (hash >> 16);
+}
+
+
+//! Hashes a vertex by the cells of its position and its color
+static inline u32 hashVertex(const video::S3DVertex& v)
+{
+	const u32 cells[3] = { getVertexCell(v.Pos.X), getVertexCell(v.Pos.Y), getVertexCell(v.Pos.Z) };
+	return hashVertexCells(cells, v.Color.color);
+}
+
 //! Constructor
 COBJMeshFileLoader::COBJMeshFileLoader(scene::ISceneManager* smgr, io::IFileSystem* fs)
 : SceneManager(smgr), FileSystem(fs)
@@ -69,10 +112,6 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 
 	const u32 WORD_BUFFER_LENGTH = 512;
 
-	core::array<core::vector3df> vertexBuffer;
-	core::array<core::vector3df> normalsBuffer;
-	core::array<core::vector2df> textureCoordBuffer;
-
 	SObjMtl * currMtl = new SObjMtl();
 	Materials.push_back(currMtl);
 	u32 smoothingGroup=0;
@@ -85,107 +124,127 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	file->read((void*)buf, filesize);
 	const c8* const bufEnd = buf+filesize;
 
-	// Process obj information
-	const c8* bufPtr = buf;
+	// split the file into chunks of whole lines, which are parsed on
+	// several threads if the file is large enough
+	u32 threadCount = SceneManager->getParameters()->getAttributeAsInt(MESH_LOADER_THREADS);
+	if (!threadCount)
+		threadCount = os::Threads::getProcessorCount();
+	const u32 chunkCount = core::min_(threadCount, (u32)(filesize / MIN_CHUNK_SIZE) + 1);
+	for (u32 c=0; c<chunkCount; ++c)
+	{
+		SObjChunk chunk;
+		chunk.Begin = c ? Chunks[c-1].End : buf;
+		chunk.End = bufEnd;
+		if (c+1 < chunkCount)
+			chunk.End = core::max_(chunk.Begin, goNextLine(buf + filesize / chunkCount * (c+1), bufEnd));
+		chunk.BufEnd = bufEnd;
+		Chunks.push_back(chunk);
+	}
+
+	// count the vertex data first, so each chunk knows where to store
+	// its own and how to resolve relative indices
+	os::Threads::run(countChunk, this, chunkCount, threadCount);
+	u32 positionCount = 0;
+	u32 tcoordCount = 0;
+	u32 normalCount = 0;
+	for (u32 c=0; c<chunkCount; ++c)
+	{
+		Chunks[c].PositionBase = positionCount;
+		Chunks[c].TCoordBase = tcoordCount;
+		Chunks[c].NormalBase = normalCount;
+		positionCount += Chunks[c].PositionCount;
+		tcoordCount += Chunks[c].TCoordCount;
+		normalCount += Chunks[c].NormalCount;
+	}
+	Positions.set_used(positionCount);
+	TCoords.set_used(tcoordCount);
+	Normals.set_used(normalCount);
+	os::Threads::run(parseChunk, this, chunkCount, threadCount);
+
+	// build the mesh buffers from the faces and statements of all
+	// chunks in the order of the file
 	core::stringc grpName, mtlName;
 	bool mtlChanged=false;
 	bool useGroups = !SceneManager->getParameters()->getAttributeAsBool(OBJ_LOADER_IGNORE_GROUPS);
 	bool useMaterials = !SceneManager->getParameters()->getAttributeAsBool(OBJ_LOADER_IGNORE_MATERIAL_FILES);
-	while(bufPtr != bufEnd)
+	core::array<u32> faceCorners;
+	faceCorners.reallocate(32); // should be large enough
+	for (u32 c=0; c<chunkCount; ++c)
 	{
-		switch(bufPtr[0])
-		{
-		case 'm':	// mtllib (material)
+		const SObjChunk& chunk = Chunks[c];
+		u32 statement = 0;
+		u32 corner = 0;
+		for (u32 face=0; face<=chunk.FaceSizes.size(); ++face)
 		{
-			if (useMaterials)
+			// process the statements before this face
+			for (; statement<chunk.Statements.size() && chunk.StatementFaces[statement]==face; ++statement)
 			{
-				c8 name[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(name, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-#ifdef _IRR_DEBUG_OBJ_LOADER_
-				os::Printer::log("Reading material file",name);
-#endif
-				readMTL(name, relPath);
-			}
-		}
-			break;
-
-		case 'v':               // v, vn, vt
-			switch(bufPtr[1])
-			{
-			case ' ':          // vertex
+				const c8* bufPtr = chunk.Statements[statement];
+				switch(bufPtr[0])
 				{
-					core::vector3df vec;
-					bufPtr = readVec3(bufPtr, vec, bufEnd);
-					vertexBuffer.push_back(vec);
-				}
-				break;
-
-			case 'n':       // normal
-				{
-					core::vector3df vec;
-					bufPtr = readVec3(bufPtr, vec, bufEnd);
-					normalsBuffer.push_back(vec);
-				}
-				break;
-
-			case 't':       // texcoord
+				case 'm':	// mtllib (material)
 				{
-					core::vector2df vec;
-					bufPtr = readUV(bufPtr, vec, bufEnd);
-					textureCoordBuffer.push_back(vec);
+					if (useMaterials)
+					{
+						c8 name[WORD_BUFFER_LENGTH];
+						bufPtr = goAndCopyNextWord(name, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+#ifdef _IRR_DEBUG_OBJ_LOADER_
+						os::Printer::log("Reading material file",name);
+#endif
+						readMTL(name, relPath);
+					}
 				}
-				break;
-			}
-			break;
+					break;
 
-		case 'g': // group name
-			{
-				c8 grp[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(grp, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+				case 'g': // group name
+					{
+						c8 grp[WORD_BUFFER_LENGTH];
+						bufPtr = goAndCopyNextWord(grp, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
 #ifdef _IRR_DEBUG_OBJ_LOADER_
 	os::Printer::log("Loaded group start",grp);
 #endif
-				if (useGroups)
-				{
-					if (0 != grp[0])
-						grpName = grp;
-					else
-						grpName = "default";
-				}
-				mtlChanged=true;
-			}
-			break;
+						if (useGroups)
+						{
+							if (0 != grp[0])
+								grpName = grp;
+							else
+								grpName = "default";
+						}
+						mtlChanged=true;
+					}
+					break;
 
-		case 's': // smoothing can be a group or off (equiv. to 0)
-			{
-				c8 smooth[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(smooth, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+				case 's': // smoothing can be a group or off (equiv. to 0)
+					{
+						c8 smooth[WORD_BUFFER_LENGTH];
+						bufPtr = goAndCopyNextWord(smooth, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
 #ifdef _IRR_DEBUG_OBJ_LOADER_
 	os::Printer::log("Loaded smoothing group start",smooth);
 #endif
-				if (core::stringc("off")==smooth)
-					smoothingGroup=0;
-				else
-					smoothingGroup=core::strtol10(smooth, 0);
-			}
-			break;
+						if (core::stringc("off")==smooth)
+							smoothingGroup=0;
+						else
+							smoothingGroup=core::strtol10(smooth, 0);
+					}
+					break;
 
-		case 'u': // usemtl
-			// get name of material
-			{
-				c8 matName[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(matName, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+				case 'u': // usemtl
+					// get name of material
+					{
+						c8 matName[WORD_BUFFER_LENGTH];
+						bufPtr = goAndCopyNextWord(matName, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
 #ifdef _IRR_DEBUG_OBJ_LOADER_
 	os::Printer::log("Loaded material start",matName);
 #endif
-				mtlName=matName;
-				mtlChanged=true;
+						mtlName=matName;
+						mtlChanged=true;
+					}
+					break;
+				}
 			}
-			break;
+			if (face == chunk.FaceSizes.size())
+				break;
 
-		case 'f':               // face
-		{
-			c8 vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
 			video::S3DVertex v;
 			// Assign vertex color from currently active material's diffuse colour
 			if (mtlChanged)
@@ -200,82 +259,43 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 			if (currMtl)
 				v.Color = currMtl->Meshbuffer->Material.DiffuseColor;
 
-			// get all vertices data in this face (current line of obj file)
-			const core::stringc wordBuffer = copyLine(bufPtr, bufEnd);
-			const c8* linePtr = wordBuffer.c_str();
-			const c8* const endPtr = linePtr+wordBuffer.size();
-
-			core::array<int> faceCorners;
-			faceCorners.reallocate(32); // should be large enough
-
-			// read in all vertices
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0])
+			// get all vertices of this face, the indices of the
+			// vertex data are -1 if not set
+			for (u32 i=0; i<chunk.FaceSizes[face]; ++i, corner+=3)
 			{
-				// Array to communicate with retrieveVertexIndices()
-				// sends the buffer sizes and gets the actual indices
-				// if index not set returns -1
-				s32 Idx[3];
-				Idx[1] = Idx[2] = -1;
-
-				// read in next vertex's data
-				u32 wlength = copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, bufEnd);
-				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(vertexWord, Idx, vertexWord+wlength+1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
-				v.Pos = vertexBuffer[Idx[0]];
+				const s32* Idx = &chunk.Corners[corner];
+				v.Pos = Positions[Idx[0]];
 				if ( -1 != Idx[1] )
-					v.TCoords = textureCoordBuffer[Idx[1]];
+					v.TCoords = TCoords[Idx[1]];
 				else
 					v.TCoords.set(0.0f,0.0f);
 				if ( -1 != Idx[2] )
-					v.Normal = normalsBuffer[Idx[2]];
+					v.Normal = Normals[Idx[2]];
 				else
 				{
 					v.Normal.set(0.0f,0.0f,0.0f);
 					currMtl->RecalculateNormals=true;
 				}
 
-				int vertLocation;
-				core::map<video::S3DVertex, int>::Node* n = currMtl->VertMap.find(v);
-				if (n)
-				{
-					vertLocation = n->getValue();
-				}
-				else
-				{
-					currMtl->Meshbuffer->Vertices.push_back(v);
-					vertLocation = currMtl->Meshbuffer->Vertices.size() -1;
-					currMtl->VertMap.insert(v, vertLocation);
-				}
-
-				faceCorners.push_back(vertLocation);
-
-				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
+				faceCorners.push_back(currMtl->addVertex(v));
 			}
 
 			// triangulate the face
-			for ( u32 i = 1; i < faceCorners.size() - 1; ++i )
+			for ( u32 i = 1; i + 1 < faceCorners.size(); ++i )
 			{
 				// Add a triangle
-				currMtl->Meshbuffer->Indices.push_back( faceCorners[i+1] );
-				currMtl->Meshbuffer->Indices.push_back( faceCorners[i] );
-				currMtl->Meshbuffer->Indices.push_back( faceCorners[0] );
+				currMtl->Meshbuffer->getIndexBuffer().push_back( faceCorners[i+1] );
+				currMtl->Meshbuffer->getIndexBuffer().push_back( faceCorners[i] );
+				currMtl->Meshbuffer->getIndexBuffer().push_back( faceCorners[0] );
 			}
 			faceCorners.set_used(0); // fast clear
-			faceCorners.reallocate(32);
 		}
-		break;
-
-		case '#': // comment
-		default:
-			break;
-		}	// end switch(bufPtr[0])
-		// eat up rest of line
-		bufPtr = goNextLine(bufPtr, bufEnd);
-	}	// end while(bufPtr && (bufPtr-buf<filesize))
+	}
 
 	SMesh* mesh = new SMesh();
+	IMeshManipulator* manipulator = SceneManager->getMeshManipulator();
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const bool allow32BitIndices = !driver || driver->queryFeature(video::EVDF_INDEX_32BIT);
 
 	// Combine all the groups (meshbuffers) into the mesh
 	for ( u32 m = 0; m < Materials.size(); ++m )
@@ -284,17 +304,19 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 		{
 			Materials[m]->Meshbuffer->recalculateBoundingBox();
 			if (Materials[m]->RecalculateNormals)
-				SceneManager->getMeshManipulator()->recalculateNormals(Materials[m]->Meshbuffer);
+				manipulator->recalculateNormals(Materials[m]->Meshbuffer);
 			if (Materials[m]->Meshbuffer->Material.MaterialType == video::EMT_PARALLAX_MAP_SOLID)
 			{
+				// tangents are only created for buffers with 16 bit indices
 				SMesh tmp;
-				tmp.addMeshBuffer(Materials[m]->Meshbuffer);
-				IMesh* tangentMesh = SceneManager->getMeshManipulator()->createMeshWithTangents(&tmp);
-				mesh->addMeshBuffer(tangentMesh->getMeshBuffer(0));
+				manipulator->addSplitMeshBuffer(&tmp, Materials[m]->Meshbuffer, false);
+				IMesh* tangentMesh = manipulator->createMeshWithTangents(&tmp);
+				for (u32 i=0; i<tangentMesh->getMeshBufferCount(); ++i)
+					mesh->addMeshBuffer(tangentMesh->getMeshBuffer(i));
 				tangentMesh->drop();
 			}
 			else
-				mesh->addMeshBuffer( Materials[m]->Meshbuffer );
+				manipulator->addSplitMeshBuffer(mesh, Materials[m]->Meshbuffer, allow32BitIndices);
 		}
 	}
 
@@ -319,6 +341,192 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 }
 
 
+
+//! Counts the positions, texture coordinates and normals of a chunk
+void COBJMeshFileLoader::countChunk(void* loader, u32 index)
+{
+	COBJMeshFileLoader* self = (COBJMeshFileLoader*)loader;
+	SObjChunk& chunk = self->Chunks[index];
+
+	const c8* bufPtr = chunk.Begin;
+	while (bufPtr < chunk.End)
+	{
+		if (bufPtr[0] == 'v')
+		{
+			switch(bufPtr[1])
+			{
+			case ' ':
+				++chunk.PositionCount;
+				break;
+			case 'n':
+				++chunk.NormalCount;
+				break;
+			case 't':
+				++chunk.TCoordCount;
+				break;
+			}
+		}
+		bufPtr = self->goNextLine(bufPtr, chunk.BufEnd);
+	}
+}
+
+
+//! Reads the vertex data and faces of a chunk and remembers the other statements
+void COBJMeshFileLoader::parseChunk(void* loader, u32 index)
+{
+	COBJMeshFileLoader* self = (COBJMeshFileLoader*)loader;
+	SObjChunk& chunk = self->Chunks[index];
+	const c8* const bufEnd = chunk.BufEnd;
+
+	u32 positionCount = chunk.PositionBase;
+	u32 tcoordCount = chunk.TCoordBase;
+	u32 normalCount = chunk.NormalBase;
+
+	const c8* bufPtr = chunk.Begin;
+	while (bufPtr < chunk.End)
+	{
+		switch(bufPtr[0])
+		{
+		case 'v':               // v, vn, vt
+			switch(bufPtr[1])
+			{
+			case ' ':          // vertex
+				bufPtr = self->readVec3(bufPtr, self->Positions[positionCount++], bufEnd);
+				break;
+
+			case 'n':       // normal
+				bufPtr = self->readVec3(bufPtr, self->Normals[normalCount++], bufEnd);
+				break;
+
+			case 't':       // texcoord
+				bufPtr = self->readUV(bufPtr, self->TCoords[tcoordCount++], bufEnd);
+				break;
+			}
+			break;
+
+		case 'f':               // face
+		{
+			c8 vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
+
+			const c8* lineEnd = bufPtr;
+			while (lineEnd != bufEnd && *lineEnd != '\n' && *lineEnd != '\r')
+				++lineEnd;
+
+			// read in all vertices
+			u32 cornerCount = 0;
+			const c8* linePtr = self->goNextWord(bufPtr, lineEnd, false);
+			while (linePtr != lineEnd)
+			{
+				// Array to communicate with retrieveVertexIndices()
+				// sends the buffer sizes and gets the actual indices
+				// if index not set returns -1
+				s32 Idx[3];
+				Idx[1] = Idx[2] = -1;
+
+				// read in next vertex's data
+				u32 wlength = self->copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, lineEnd);
+				// this function will also convert obj's 1-based index to c++'s 0-based index
+				self->retrieveVertexIndices(vertexWord, Idx, vertexWord+wlength+1, positionCount, tcoordCount, normalCount);
+				chunk.Corners.push_back(Idx[0]);
+				chunk.Corners.push_back(Idx[1]);
+				chunk.Corners.push_back(Idx[2]);
+				++cornerCount;
+
+				// go to next vertex
+				linePtr = self->goNextWord(linePtr, lineEnd, false);
+			}
+			chunk.FaceSizes.push_back(cornerCount);
+		}
+		break;
+
+		case 'm':	// mtllib (material)
+		case 'g':	// group name
+		case 's':	// smoothing group
+		case 'u':	// usemtl
+			// these change the state of the following faces
+			chunk.Statements.push_back(bufPtr);
+			chunk.StatementFaces.push_back(chunk.FaceSizes.size());
+			break;
+
+		case '#': // comment
+		default:
+			break;
+		}	// end switch(bufPtr[0])
+		// eat up rest of line
+		bufPtr = self->goNextLine(bufPtr, bufEnd);
+	}
+}
+
+
+//! Returns the index of an equal vertex in the mesh buffer, which is added if there is none
+u32 COBJMeshFileLoader::SObjMtl::addVertex(const video::S3DVertex& v)
+{
+	IVertexBuffer& vertexBuffer = Meshbuffer->getVertexBuffer();
+	const u32 vertexCount = vertexBuffer.size();
+	const video::S3DVertex* vertices = (const video::S3DVertex*)vertexBuffer.pointer();
+
+	// keep the hash table at most half full
+	if (vertexCount * 2 >= VertHash.size())
+	{
+		const u32 size = core::max_(VertHash.size() * 2, 256u);
+		VertHash.set_used(size);
+		for (u32 i=0; i<size; ++i)
+			VertHash[i] = 0xFFFFFFFF;
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			u32 slot = hashVertex(vertices[i]) & (size-1);
+			while (VertHash[slot] != 0xFFFFFFFF)
+				slot = (slot+1) & (size-1);
+			VertHash[slot] = i;
+		}
+	}
+
+	// vertices are equal within the rounding tolerance, so an equal one
+	// can be in the cells on both sides of it. The tolerance is doubled
+	// for the rounding of the comparison, the cells still differ by one
+	const f32 pos[3] = { v.Pos.X, v.Pos.Y, v.Pos.Z };
+	u32 low[3], high[3];
+	for (u32 i=0; i<3; ++i)
+	{
+		low[i] = getVertexCell(pos[i] - 2.f * core::ROUNDING_ERROR_f32);
+		high[i] = getVertexCell(pos[i] + 2.f * core::ROUNDING_ERROR_f32);
+	}
+
+	const u32 mask = VertHash.size()-1;
+	for (u32 n=0; n<8; ++n)
+	{
+		// bit i of n selects the higher cell of coordinate i, if it differs
+		u32 cells[3];
+		bool skip = false;
+		for (u32 i=0; i<3; ++i)
+		{
+			const bool higher = ((n >> i) & 1) != 0;
+			skip |= higher && low[i] == high[i];
+			cells[i] = higher ? high[i] : low[i];
+		}
+		if (skip)
+			continue;
+
+		u32 slot = hashVertexCells(cells, v.Color.color) & mask;
+		while (VertHash[slot] != 0xFFFFFFFF)
+		{
+			const video::S3DVertex& other = vertices[VertHash[slot]];
+			if (other.Pos == v.Pos && other.Normal == v.Normal &&
+				other.TCoords == v.TCoords && other.Color == v.Color)
+				return VertHash[slot];
+			slot = (slot+1) & mask;
+		}
+	}
+
+	u32 slot = hashVertex(v) & mask;
+	while (VertHash[slot] != 0xFFFFFFFF)
+		slot = (slot+1) & mask;
+	VertHash[slot] = vertexCount;
+	vertexBuffer.push_back(v);
+	return vertexCount;
+}
+
+
 const c8* COBJMeshFileLoader::readTextures(const c8* bufPtr, const c8* const bufEnd, SObjMtl* currMaterial, const io::path& relPath)
 {
 	u8 type=0; // map_Kd - diffuse color texture map
@@ -921,6 +1129,11 @@ void COBJMeshFileLoader::cleanUp()
 	}
 
 	Materials.clear();
+
+	Chunks.clear();
+	Positions.clear();
+	TCoords.clear();
+	Normals.clear();
 }
 
 
@@ -9,8 +9,7 @@
 #include "IFileSystem.h"
 #include "ISceneManager.h"
 #include "irrString.h"
-#include "SMeshBuffer.h"
-#include "irrMap.h"
+#include "CDynamicMeshBuffer.h"
 
 namespace irr
 {
@@ -45,7 +44,7 @@ private:
 		SObjMtl() : Meshbuffer(0), Bumpiness (1.0f), Illumination(0),
 			RecalculateNormals(false)
 		{
-			Meshbuffer = new SMeshBuffer();
+			Meshbuffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
 			Meshbuffer->Material.Shininess = 0.0f;
 			Meshbuffer->Material.AmbientColor = video::SColorf(0.2f, 0.2f, 0.2f, 1.0f).toSColor();
 			Meshbuffer->Material.DiffuseColor = video::SColorf(0.8f, 0.8f, 0.8f, 1.0f).toSColor();
@@ -57,12 +56,16 @@ private:
 			Bumpiness(o.Bumpiness), Illumination(o.Illumination),
 			RecalculateNormals(false)
 		{
-			Meshbuffer = new SMeshBuffer();
+			Meshbuffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
 			Meshbuffer->Material = o.Meshbuffer->Material;
 		}
 
-		core::map<video::S3DVertex, int> VertMap;
-		scene::SMeshBuffer *Meshbuffer;
+		//! Returns the index of the vertex, which is added if there is no equal one yet
+		u32 addVertex(const video::S3DVertex& v);
+
+		//! Open addressing hash table of the vertex indices, 0xFFFFFFFF marks free slots
+		core::array<u32> VertHash;
+		scene::CDynamicMeshBuffer *Meshbuffer;
 		core::stringc Name;
 		core::stringc Group;
 		f32 Bumpiness;
@@ -70,6 +73,35 @@ private:
 		bool RecalculateNormals;
 	};
 
+	//! Part of the file which is parsed on its own thread
+	struct SObjChunk
+	{
+		SObjChunk() : Begin(0), End(0), BufEnd(0),
+			PositionBase(0), TCoordBase(0), NormalBase(0),
+			PositionCount(0), TCoordCount(0), NormalCount(0) {}
+
+		//! Whole lines from Begin to End, BufEnd is the end of the file
+		const c8* Begin;
+		const c8* End;
+		const c8* BufEnd;
+		//! Number of vertex data read in previous chunks
+		u32 PositionBase, TCoordBase, NormalBase;
+		//! Number of vertex data read in this chunk
+		u32 PositionCount, TCoordCount, NormalCount;
+		//! Position, texture coordinate and normal indices of all face corners
+		core::array<s32> Corners;
+		//! Number of corners of each face
+		core::array<u32> FaceSizes;
+		//! Group, material and smoothing statements, with the number of faces before them
+		core::array<const c8*> Statements;
+		core::array<u32> StatementFaces;
+	};
+
+	//! Job which counts the vertex data of a chunk
+	static void countChunk(void* loader, u32 index);
+	//! Job which reads the vertex data and faces of a chunk
+	static void parseChunk(void* loader, u32 index);
+
 	// helper method for material reading
 	const c8* readTextures(const c8* bufPtr, const c8* const bufEnd, SObjMtl* currMaterial, const io::path& relPath);
 
@@ -113,6 +145,11 @@ private:
 	io::IFileSystem* FileSystem;
 
 	core::array<SObjMtl*> Materials;
+
+	core::array<SObjChunk> Chunks;
+	core::array<core::vector3df> Positions;
+	core::array<core::vector2df> TCoords;
+	core::array<core::vector3df> Normals;
 };
 
 } // end namespace scene
@@ -612,6 +612,10 @@ bool COpenGLExtensionHandler::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 		return FeatureAvailable[IRR_EXT_draw_buffers2];
 	case EVDF_MRT_BLEND_FUNC:
 		return FeatureAvailable[IRR_ARB_draw_buffers_blend] || FeatureAvailable[IRR_AMD_draw_buffers_blend];
+	case EVDF_TEXTURE_COMPRESSED_DXT:
+		return FeatureAvailable[IRR_EXT_texture_compression_s3tc];
+	case EVDF_INDEX_32BIT:
+		return true;
 	default:
 		return false;
 	};
@@ -104,6 +104,11 @@ ECOLOR_FORMAT COpenGLTexture::getBestColorFormat(ECOLOR_FORMAT format)
 			if (Driver->getTextureCreationFlag(ETCF_ALWAYS_16_BIT) ||
 					Driver->getTextureCreationFlag(ETCF_OPTIMIZED_FOR_SPEED))
 				destFormat = ECF_A1R5G5B5;
+		break;
+		// compressed images are uploaded as they are
+		case ECF_DXT1:
+		case ECF_DXT5:
+			return format;
 		default:
 		break;
 	}
@@ -228,6 +233,12 @@ GLint COpenGLTexture::getOpenGLFormatAndParametersFromColorFormat(ECOLOR_FORMAT
 			return GL_RGBA8;
 #endif
 		}
+#ifdef GL_EXT_texture_compression_s3tc
+		case ECF_DXT1:
+			return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case ECF_DXT5:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+#endif
 		default:
 		{
 			os::Printer::log("Unsupported texture format", ELL_ERROR);
@@ -340,7 +351,10 @@ void COpenGLTexture::uploadTexture(bool newTexture, void* mipmapData, u32 level)
 
 	// now get image data and upload to GPU
 	void* source = image->lock();
-	if (newTexture)
+	if (IImage::isCompressedFormat(image->getColorFormat()))
+		Driver->extGlCompressedTexImage2D(GL_TEXTURE_2D, level, InternalFormat, image->getDimension().Width,
+			image->getDimension().Height, 0, image->getImageDataSizeInBytes(), source);
+	else if (newTexture)
 		glTexImage2D(GL_TEXTURE_2D, level, InternalFormat, image->getDimension().Width,
 			image->getDimension().Height, 0, PixelFormat, PixelType, source);
 	else
@@ -534,32 +548,81 @@ void COpenGLTexture::regenerateMipMapLevels(void* mipmapData)
 	u32 width=Image->getDimension().Width;
 	u32 height=Image->getDimension().Height;
 	u32 i=0;
+
+	// compressed levels are scaled uncompressed and compressed again
+	if (IImage::isCompressedFormat(ColorFormat))
+	{
+		do
+		{
+			if (width>1)
+				width>>=1;
+			if (height>1)
+				height>>=1;
+			++i;
+			const u32 size = IImage::getDataSizeFromFormat(ColorFormat, width, height);
+			if (mipmapData)
+			{
+				Driver->extGlCompressedTexImage2D(GL_TEXTURE_2D, i, InternalFormat, width, height, 0, size, mipmapData);
+				mipmapData = static_cast<u8*>(mipmapData)+size;
+			}
+			else
+			{
+				IImage* mipImage = new CImage(ColorFormat, core::dimension2du(width, height));
+				Image->copyToScaling(mipImage);
+				Driver->extGlCompressedTexImage2D(GL_TEXTURE_2D, i, InternalFormat, width, height, 0, size, mipImage->lock());
+				mipImage->drop();
+			}
+		}
+		while (width!=1 || height!=1);
+		return;
+	}
+
+	// 32 and 16 bit levels are averaged from the previous level,
+	// the levels of other formats are scaled from the image
+	const ECOLOR_FORMAT format = Image->getColorFormat();
+	const u32 bytesPerPixel = Image->getBytesPerPixel();
+	const bool average = (format == ECF_A8R8G8B8 || format == ECF_A1R5G5B5);
+	const bool gamma = Driver->getTextureCreationFlag(ETCF_GAMMA_CORRECT_MIP_MAPS);
+	const u8* source = static_cast<const u8*>(Image->lock());
+	u8* buffers[2] = {0, 0};
 	u8* target = static_cast<u8*>(mipmapData);
 	do
 	{
+		const u32 sourceWidth = width;
+		const u32 sourceHeight = height;
 		if (width>1)
 			width>>=1;
 		if (height>1)
 			height>>=1;
 		++i;
-		if (!target)
-			target = new u8[width*height*Image->getBytesPerPixel()];
 		// create scaled version if no mipdata available
 		if (!mipmapData)
-			Image->copyToScaling(target, width, height, Image->getColorFormat());
+		{
+			// the levels get smaller, so the buffers of the first two levels are reused
+			if (!buffers[i & 1])
+				buffers[i & 1] = new u8[width*height*bytesPerPixel];
+			target = buffers[i & 1];
+			if (average)
+				CColorConverter::createMipMapLevel(source, format, sourceWidth, sourceHeight,
+						sourceWidth*bytesPerPixel, target, width*bytesPerPixel, gamma);
+			else
+				Image->copyToScaling(target, width, height, format);
+		}
 		glTexImage2D(GL_TEXTURE_2D, i, InternalFormat, width, height,
 				0, PixelFormat, PixelType, target);
+		source = target;
 		// get next prepared mipmap data if available
 		if (mipmapData)
 		{
-			mipmapData = static_cast<u8*>(mipmapData)+width*height*Image->getBytesPerPixel();
+			mipmapData = static_cast<u8*>(mipmapData)+width*height*bytesPerPixel;
 			target = static_cast<u8*>(mipmapData);
 		}
 	}
 	while (width!=1 || height!=1);
+	Image->unlock();
 	// cleanup
-	if (!mipmapData)
-		delete [] target;
+	delete [] buffers[0];
+	delete [] buffers[1];
 }
 
 
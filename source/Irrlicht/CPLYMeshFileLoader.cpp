@@ -7,10 +7,12 @@
 
 #include "CPLYMeshFileLoader.h"
 #include "IMeshManipulator.h"
+#include "IVideoDriver.h"
 #include "SMesh.h"
 #include "CDynamicMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "IReadFile.h"
+#include "IAttributes.h"
 #include "fast_atof.h"
 #include "os.h"
 
@@ -21,10 +23,12 @@ namespace scene
 
 // input buffer must be at least twice as long as the longest line in the file
 #define PLY_INPUT_BUFFER_SIZE 51200 // file is loaded in 50k chunks
+// number of lines each thread parses at once in ascii files
+#define PLY_LINES_PER_JOB 16384
 
 // constructor
-CPLYMeshFileLoader::CPLYMeshFileLoader()
-: File(0), Buffer(0)
+CPLYMeshFileLoader::CPLYMeshFileLoader(scene::ISceneManager* smgr)
+: SceneManager(smgr), File(0), Buffer(0)
 {
 }
 
@@ -227,17 +231,29 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 		// now to read the actual data from the file
 		if (continueReading)
 		{
-			// create a mesh buffer
-			CDynamicMeshBuffer *mb = new CDynamicMeshBuffer(video::EVT_STANDARD, vertCount > 65565 ? video::EIT_32BIT : video::EIT_16BIT);
+			// create a mesh buffer, it is split later if the driver
+			// cannot draw 32 bit indices
+			CDynamicMeshBuffer *mb = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
 			mb->getVertexBuffer().reallocate(vertCount);
 			mb->getIndexBuffer().reallocate(vertCount);
 			mb->setHardwareMappingHint(EHM_STATIC);
 
+			// ascii files are parsed on several threads
+			u32 threadCount = SceneManager->getParameters()->getAttributeAsInt(MESH_LOADER_THREADS);
+			if (!threadCount)
+				threadCount = os::Threads::getProcessorCount();
+
 			// loop through each of the elements
 			for (u32 i=0; i<ElementList.size(); ++i)
 			{
-				// do we want this element type?
-				if (ElementList[i]->Name == "vertex")
+				// do we want this element type? Elements which fit into
+				// one job are not worth copying for the threads
+				if (!IsBinaryFile && threadCount > 1 && ElementList[i]->Count > PLY_LINES_PER_JOB &&
+					(ElementList[i]->Name == "vertex" || ElementList[i]->Name == "face"))
+				{
+					readAsciiElement(*ElementList[i], mb, threadCount);
+				}
+				else if (ElementList[i]->Name == "vertex")
 				{
 					// loop through vertex properties
 					for (u32 j=0; j < ElementList[i]->Count; ++j)
@@ -257,8 +273,10 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 				}
 			}
 			mb->recalculateBoundingBox();
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
 			SMesh* m = new SMesh();
-			m->addMeshBuffer(mb);
+			SceneManager->getMeshManipulator()->addSplitMeshBuffer(m, mb,
+					!driver || driver->queryFeature(video::EVDF_INDEX_32BIT));
 			m->recalculateBoundingBox();
 			mb->drop();
 			animMesh = new SAnimatedMesh();
@@ -382,6 +400,87 @@ bool CPLYMeshFileLoader::readFace(const SPLYElement &Element, scene::CDynamicMes
 	return true;
 }
 
+void CPLYMeshFileLoader::readAsciiElement(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb, u32 threadCount)
+{
+	core::array<SPLYAsciiJob> jobs;
+	for (u32 i=0; i<threadCount; ++i)
+	{
+		SPLYAsciiJob job;
+		job.Element = &Element;
+		jobs.push_back(job);
+		jobs[i].Buffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+	}
+
+	u32 remaining = Element.Count;
+	while (remaining)
+	{
+		// copy the next lines of the file for each thread, this is
+		// much faster than parsing them
+		u32 jobCount = 0;
+		for (; jobCount<threadCount && remaining; ++jobCount)
+		{
+			SPLYAsciiJob& job = jobs[jobCount];
+			job.LineCount = core::min_(remaining, (u32)PLY_LINES_PER_JOB);
+			remaining -= job.LineCount;
+			job.Text.set_used(0);
+			for (u32 j=0; j<job.LineCount; ++j)
+			{
+				const c8* line = getNextLine();
+				const u32 length = (u32)strlen(line);
+				const u32 pos = job.Text.size();
+				if (job.Text.allocated_size() < pos + length + 2)
+					job.Text.reallocate((pos + length + 2) * 2);
+				job.Text.set_used(pos + length + 1);
+				memcpy(&job.Text[pos], line, length);
+				job.Text[pos + length] = '\n';
+			}
+			job.Text.push_back(0);
+			job.Buffer->getVertexBuffer().set_used(0);
+			job.Buffer->getIndexBuffer().set_used(0);
+		}
+
+		os::Threads::run(parseAsciiJob, jobs.pointer(), jobCount, jobCount);
+
+		// append the results in the order of the file
+		for (u32 i=0; i<jobCount; ++i)
+		{
+			const IVertexBuffer& vertices = jobs[i].Buffer->getVertexBuffer();
+			for (u32 j=0; j<vertices.size(); ++j)
+				mb->getVertexBuffer().push_back(vertices[j]);
+			const IIndexBuffer& indices = jobs[i].Buffer->getIndexBuffer();
+			for (u32 j=0; j<indices.size(); ++j)
+				mb->getIndexBuffer().push_back(indices[j]);
+		}
+	}
+
+	for (u32 i=0; i<threadCount; ++i)
+		jobs[i].Buffer->drop();
+}
+
+void CPLYMeshFileLoader::parseAsciiJob(void* jobs, u32 index)
+{
+	SPLYAsciiJob& job = ((SPLYAsciiJob*)jobs)[index];
+
+	// a reader which only knows the copied lines
+	CPLYMeshFileLoader reader(0);
+	reader.IsBinaryFile   = false;
+	reader.IsWrongEndian  = false;
+	reader.EndOfFile      = true;
+	reader.StartPointer   = job.Text.pointer();
+	reader.EndPointer     = job.Text.pointer() + job.Text.size();
+	reader.LineEndPointer = reader.StartPointer - 1;
+	reader.WordLength     = -1;
+
+	const bool isVertex = (job.Element->Name == "vertex");
+	for (u32 i=0; i<job.LineCount; ++i)
+	{
+		if (isVertex)
+			reader.readVertex(*job.Element, job.Buffer);
+		else
+			reader.readFace(*job.Element, job.Buffer);
+	}
+}
+
 // skips an element and all properties. return false on EOF
 void CPLYMeshFileLoader::skipElement(const SPLYElement &Element)
 {
@@ -6,6 +6,7 @@
 #define __C_PLY_MESH_FILE_LOADER_H_INCLUDED__
 
 #include "IMeshLoader.h"
+#include "ISceneManager.h"
 #include "CDynamicMeshBuffer.h"
 
 namespace irr
@@ -30,7 +31,7 @@ class CPLYMeshFileLoader : public IMeshLoader
 public:
 
 	//! Constructor
-	CPLYMeshFileLoader();
+	CPLYMeshFileLoader(scene::ISceneManager* smgr);
 
 	//! Destructor
 	virtual ~CPLYMeshFileLoader();
@@ -116,6 +117,24 @@ private:
 		u32 KnownSize;
 	};
 
+	//! Lines of an ascii element which are parsed on their own thread
+	struct SPLYAsciiJob
+	{
+		SPLYAsciiJob() : Element(0), LineCount(0), Buffer(0) {}
+
+		const SPLYElement* Element;
+		//! The lines, each ends with a line break
+		core::array<c8> Text;
+		u32 LineCount;
+		//! Receives the vertices or indices of the lines
+		CDynamicMeshBuffer* Buffer;
+	};
+
+	//! Reads the vertices or faces of an ascii element on several threads
+	void readAsciiElement(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb, u32 threadCount);
+	//! Job which reads the lines of a SPLYAsciiJob
+	static void parseAsciiJob(void* jobs, u32 index);
+
 	bool allocateBuffer();
 	c8* getNextLine();
 	c8* getNextWord();
@@ -132,6 +151,7 @@ private:
 
 	core::array<SPLYElement*> ElementList;
 
+	scene::ISceneManager* SceneManager;
 	io::IReadFile *File;
 	c8 *Buffer;
 	bool IsBinaryFile, IsWrongEndian, EndOfFile;
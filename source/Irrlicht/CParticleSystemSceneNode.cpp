@@ -426,12 +426,14 @@ void CParticleSystemSceneNode::doParticleSystem(u32 time)
 				newParticles=16250-j;
 			Particles.set_used(j+newParticles);
 			for (s32 i=j; i<j+newParticles; ++i)
-			{
 				Particles[i]=array[i-j];
-				AbsoluteTransformation.rotateVect(Particles[i].startVector);
-				if (ParticlesAreGlobal)
-					AbsoluteTransformation.transformVect(Particles[i].pos);
-			}
+
+			SParticle* added = Particles.pointer() + j;
+			AbsoluteTransformation.rotateVects(&added->startVector, &added->startVector,
+				newParticles, sizeof(SParticle), sizeof(SParticle));
+			if (ParticlesAreGlobal)
+				AbsoluteTransformation.transformVects(&added->pos, &added->pos,
+					newParticles, sizeof(SParticle), sizeof(SParticle));
 		}
 	}
 
@@ -13,6 +13,7 @@
 #include "ILightSceneNode.h"
 #include "IQ3Shader.h"
 #include "IFileList.h"
+#include "irrMap.h"
 
 //#define TJUNCTION_SOLVER_ROUND
 //#define TJUNCTION_SOLVER_0125
@@ -156,6 +157,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 
 	cleanMeshes();
 	calcBoundingBoxes();
+	buildVisibility();
 	cleanLoader();
 
 	return true;
@@ -178,6 +180,7 @@ void CQ3LevelMesh::cleanLoader ()
 
 	Lightmap.clear();
 	Tex.clear();
+	FaceBuffers.clear();
 }
 
 //! returns the amount of frames in milliseconds. If the amount is 1, it is a static (=non animated) mesh.
@@ -299,7 +302,22 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek(l->offset);
+	file->read(Planes, NumPlanes * sizeof(tBSPPlane));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i=0; i<NumPlanes; ++i)
+		{
+			Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+			Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+			Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+			Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+		}
+	}
 }
 
 
@@ -307,7 +325,26 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek(l->offset);
+	file->read(Nodes, NumNodes * sizeof(tBSPNode));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i=0; i<NumNodes; ++i)
+		{
+			Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+			Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+			Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+			for ( s32 j=0; j<3; ++j)
+			{
+				Nodes[i].mins[j] = os::Byteswap::byteswap(Nodes[i].mins[j]);
+				Nodes[i].maxs[j] = os::Byteswap::byteswap(Nodes[i].maxs[j]);
+			}
+		}
+	}
 }
 
 
@@ -315,7 +352,29 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek(l->offset);
+	file->read(Leafs, NumLeafs * sizeof(tBSPLeaf));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i=0; i<NumLeafs; ++i)
+		{
+			Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+			Leafs[i].area = os::Byteswap::byteswap(Leafs[i].area);
+			for ( s32 j=0; j<3; ++j)
+			{
+				Leafs[i].mins[j] = os::Byteswap::byteswap(Leafs[i].mins[j]);
+				Leafs[i].maxs[j] = os::Byteswap::byteswap(Leafs[i].maxs[j]);
+			}
+			Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+			Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+			Leafs[i].leafBrush = os::Byteswap::byteswap(Leafs[i].leafBrush);
+			Leafs[i].numOfLeafBrushes = os::Byteswap::byteswap(Leafs[i].numOfLeafBrushes);
+		}
+	}
 }
 
 
@@ -323,15 +382,52 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek(l->offset);
+	file->read(LeafFaces, NumLeafFaces * sizeof(s32));
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i=0; i<NumLeafFaces; ++i)
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+	}
 }
 
 
 /*!
+	the cluster bitsets are kept after loading, see getVisibility
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	Visibility.ClusterCount = 0;
+	Visibility.BytesPerCluster = 0;
+	Visibility.Bitsets.clear();
+
+	if ( l->length < 8 )
+		return;
+
+	s32 header[2];
+	file->seek(l->offset);
+	file->read(header, sizeof(header));
+
+	if ( LoadParam.swapHeader )
+	{
+		header[0] = os::Byteswap::byteswap(header[0]);
+		header[1] = os::Byteswap::byteswap(header[1]);
+	}
+
+	// ignore broken visibility data, everything is visible then
+	if ( header[0] <= 0 || header[1] <= 0 ||
+		header[0] * header[1] > l->length - 8 ||
+		header[1] < (header[0] + 7) / 8 )
+		return;
+
+	Visibility.ClusterCount = header[0];
+	Visibility.BytesPerCluster = header[1];
+	Visibility.Bitsets.set_used(header[0] * header[1]);
+	file->read(Visibility.Bitsets.pointer(), Visibility.Bitsets.size());
 }
 
 
@@ -814,6 +910,221 @@ void CQ3LevelMesh::solveTJunction()
 {
 }
 
+
+/*!
+	converts the bsp tree into irrlicht space and maps the faces to the
+	geometry mesh buffers which are left after cleanMeshes
+*/
+void CQ3LevelMesh::buildVisibility()
+{
+	Visibility.Nodes.clear();
+	Visibility.Leafs.clear();
+	Visibility.LeafFaces.clear();
+	Visibility.UnlinkedFaces.clear();
+
+	s32 i, j;
+
+	core::map<IMeshBuffer*, s32> bufferIndex;
+	const SMesh* geometry = Mesh[E_Q3_MESH_GEOMETRY];
+	for ( i = 0; i != (s32) geometry->MeshBuffers.size(); ++i )
+		bufferIndex.insert(geometry->MeshBuffers[i], i);
+
+	for ( i = 0; i != (s32) Visibility.Faces.size(); ++i )
+	{
+		SBSPVisibility::SFace &face = Visibility.Faces[i];
+		core::map<IMeshBuffer*, s32>::Node* n = FaceBuffers[i] ? bufferIndex.find(FaceBuffers[i]) : 0;
+		face.Buffer = n && face.IndexCount ? n->getValue() : -1;
+	}
+
+	// the tree is only used if all references are valid, children are
+	// stored after their parents so the tree walk always terminates
+	bool valid = NumNodes > 0 && NumLeafs > 0;
+	for ( i = 0; valid && i != NumNodes; ++i )
+	{
+		const tBSPNode &node = Nodes[i];
+		valid = node.plane >= 0 && node.plane < NumPlanes;
+		for ( j = 0; valid && j != 2; ++j )
+		{
+			const s32 child = j ? node.back : node.front;
+			valid = child >= 0 ? child > i && child < NumNodes : -(child+1) < NumLeafs;
+		}
+	}
+
+	if ( !valid )
+	{
+		for ( i = 0; i != (s32) Visibility.Faces.size(); ++i )
+		{
+			if ( Visibility.Faces[i].Buffer >= 0 )
+				Visibility.UnlinkedFaces.push_back(i);
+		}
+		return;
+	}
+
+	Visibility.Nodes.set_used(NumNodes);
+	for ( i = 0; i != NumNodes; ++i )
+	{
+		const tBSPPlane &plane = Planes[Nodes[i].plane];
+		SBSPVisibility::SNode &node = Visibility.Nodes[i];
+
+		node.Plane.Normal.set(plane.vNormal[0], plane.vNormal[2], plane.vNormal[1]);
+		node.Plane.D = -plane.d;
+		node.Children[0] = Nodes[i].front;
+		node.Children[1] = Nodes[i].back;
+	}
+
+	core::array<bool> linked;
+	linked.set_used(Visibility.Faces.size());
+	for ( i = 0; i != (s32) linked.size(); ++i )
+		linked[i] = false;
+
+	Visibility.Leafs.set_used(NumLeafs);
+	for ( i = 0; i != NumLeafs; ++i )
+	{
+		const tBSPLeaf &source = Leafs[i];
+		SBSPVisibility::SLeaf &leaf = Visibility.Leafs[i];
+
+		leaf.Box.MinEdge.set((f32) source.mins[0], (f32) source.mins[2], (f32) source.mins[1]);
+		leaf.Box.MaxEdge.set((f32) source.maxs[0], (f32) source.maxs[2], (f32) source.maxs[1]);
+		leaf.Box.repair();
+		leaf.Cluster = source.cluster;
+		leaf.FirstFace = Visibility.LeafFaces.size();
+
+		for ( j = 0; j < source.numOfLeafFaces; ++j )
+		{
+			const s32 k = source.leafface + j;
+			if ( k < 0 || k >= NumLeafFaces )
+				break;
+
+			const s32 f = LeafFaces[k];
+			if ( f < 0 || f >= (s32) Visibility.Faces.size() || Visibility.Faces[f].Buffer < 0 )
+				continue;
+
+			Visibility.LeafFaces.push_back(f);
+			linked[f] = true;
+		}
+
+		leaf.FaceCount = Visibility.LeafFaces.size() - leaf.FirstFace;
+	}
+
+	// faces of the brush models are not part of the tree
+	for ( i = 0; i != (s32) Visibility.Faces.size(); ++i )
+	{
+		if ( Visibility.Faces[i].Buffer >= 0 && !linked[i] )
+			Visibility.UnlinkedFaces.push_back(i);
+	}
+}
+
+
+//! returns the leaf containing a position
+s32 CQ3LevelMesh::SBSPVisibility::getLeaf(const core::vector3df& pos) const
+{
+	if ( Nodes.empty() )
+		return -1;
+
+	s32 i = 0;
+	while ( i >= 0 )
+	{
+		const SNode &node = Nodes[i];
+		i = node.Children[ node.Plane.getDistanceTo(pos) >= 0.f ? 0 : 1 ];
+	}
+
+	return -(i+1);
+}
+
+//! returns if one of the stages of a shader moves the vertices
+static bool shaderDeformsVertices( const IShader * shader )
+{
+	for ( u32 i = 0; i < shader->VarGroup->VariableGroup.size(); ++i )
+	{
+		if ( shader->getGroup( i )->isDefined( "deformvertexes" ) )
+			return true;
+	}
+	return false;
+}
+
+
+//! returns if one of the stages of a shader blends the lightmap of the face
+static bool shaderUsesLightmap( const IShader * shader )
+{
+	for ( u32 i = 0; i < shader->VarGroup->VariableGroup.size(); ++i )
+	{
+		if ( shader->getGroup( i )->isDefined( "map", "$lightmap" ) )
+			return true;
+	}
+	return false;
+}
+
+
+//! returns the amount of textured stages a shader scene node draws
+static u32 getShaderDrawCalls( const IShader * shader )
+{
+	u32 calls = 0;
+	for ( u32 i = 2; i < shader->VarGroup->VariableGroup.size(); ++i )
+	{
+		const SVarGroup * group = shader->getGroup( i );
+		if ( group->isDefined( "map" ) || group->isDefined( "clampmap" ) ||
+			group->isDefined( "animmap" ) )
+			++calls;
+	}
+	return calls;
+}
+
+
+//! returns the amount of vertices a face adds to a mesh buffer
+u32 CQ3LevelMesh::getFaceVertexCount( const tBSPFace * face ) const
+{
+	switch ( face->type )
+	{
+		case 1: // normal polygons
+		case 3: // meshes
+			return face->numOfVerts;
+
+		case 2: // patches
+		{
+			const u32 biquadWidth = face->size[0] ? (face->size[0] - 1)/2 : 0;
+			const u32 biquadHeight = face->size[1] ? (face->size[1] - 1)/2 : 0;
+			const u32 level = LoadParam.patchTesselation + 1;
+			return biquadWidth * biquadHeight * level * level;
+		}
+	}
+	return 0;
+}
+
+
+//! finds a buffer of the mesh the vertices of a face can be merged into
+SMeshBufferLightMap* CQ3LevelMesh::getMergeBuffer( u32 meshIndex, const video::SMaterial &material,
+					const IShader * shader, u32 vertexCount ) const
+{
+	// static shaders look the same on every face, only the lightmap may differ
+	const bool byShader = meshIndex == E_Q3_MESH_ITEMS && shader &&
+		!shaderDeformsVertices( shader );
+	const bool byLightmap = byShader && shaderUsesLightmap( shader );
+
+	// the last buffers are the ones which are not full yet
+	const SMesh * mesh = Mesh[meshIndex];
+	for ( s32 i = (s32) mesh->getMeshBufferCount() - 1; i >= 0; --i )
+	{
+		SMeshBufferLightMap * buffer = (SMeshBufferLightMap*) mesh->getMeshBuffer( i );
+
+		// 16 bit indices
+		if ( buffer->getVertexCount() + vertexCount > 65536 )
+			continue;
+
+		const video::SMaterial &m = buffer->getMaterial();
+		if ( byShader )
+		{
+			if ( m.MaterialTypeParam2 == material.MaterialTypeParam2 &&
+				( !byLightmap || m.getTexture(1) == material.getTexture(1) ) )
+				return buffer;
+		}
+		else if ( m == material )
+			return buffer;
+	}
+
+	return 0;
+}
+
+
 /*!
 	constructs a mesh from the quake 3 level file.
 */
@@ -847,8 +1158,21 @@ void CQ3LevelMesh::constructMesh()
 	SToBuffer item [ E_Q3_MESH_SIZE ];
 	u32 itemSize;
 
+	// draw calls of the shader scene nodes with one node per face and after merging
+	u32 shaderFaces = 0;
+	u32 faceDrawCalls = 0;
+	u32 mergedDrawCalls = 0;
+
+	Visibility.Faces.set_used(NumFaces);
+	FaceBuffers.set_used(NumFaces);
+
 	for ( i=0; i < NumFaces; ++i)
 	{
+		FaceBuffers[i] = 0;
+		Visibility.Faces[i].Buffer = -1;
+		Visibility.Faces[i].FirstIndex = 0;
+		Visibility.Faces[i].IndexCount = 0;
+
 		const tBSPFace * face = Faces + i;
 
 		s32 shaderState = setShaderMaterial( material, face );
@@ -890,6 +1214,9 @@ void CQ3LevelMesh::constructMesh()
 						item[itemSize].takeVertexColor = 1;
 						item[itemSize].index = E_Q3_MESH_ITEMS;
 						itemSize += 1;
+
+						shaderFaces += 1;
+						faceDrawCalls += getShaderDrawCalls( shader );
 					}
 
 				} break;
@@ -934,13 +1261,17 @@ void CQ3LevelMesh::constructMesh()
 				if ( LoadParam.mergeShaderBuffer == 1 )
 				{
 					// combine
-					buffer = (SMeshBufferLightMap*) Mesh[ item[g].index ]->getMeshBuffer(
-						item[g].index != E_Q3_MESH_FOG ? material : material2 );
+					buffer = getMergeBuffer( item[g].index,
+						item[g].index != E_Q3_MESH_FOG ? material : material2,
+						shader, getFaceVertexCount( face ) );
 				}
 
 				// create a seperate mesh buffer
 				if ( 0 == buffer )
 				{
+					if ( item[g].index == E_Q3_MESH_ITEMS )
+						mergedDrawCalls += getShaderDrawCalls( shader );
+
 					buffer = new scene::SMeshBufferLightMap();
 					Mesh[ item[g].index ]->addMeshBuffer( buffer );
 					buffer->drop();
@@ -951,6 +1282,13 @@ void CQ3LevelMesh::constructMesh()
 			}
 
 
+			// remember the index range of the geometry for the visibility tests
+			if ( item[g].index == E_Q3_MESH_GEOMETRY )
+			{
+				FaceBuffers[i] = buffer;
+				Visibility.Faces[i].FirstIndex = buffer->getIndexCount();
+			}
+
 			switch(Faces[i].type)
 			{
 				case 4: // billboards
@@ -1004,6 +1342,9 @@ void CQ3LevelMesh::constructMesh()
 					break;
 
 			} // end switch
+
+			if ( item[g].index == E_Q3_MESH_GEOMETRY )
+				Visibility.Faces[i].IndexCount = buffer->getIndexCount() - Visibility.Faces[i].FirstIndex;
 		}
 	}
 
@@ -1019,6 +1360,15 @@ void CQ3LevelMesh::constructMesh()
 			NumMeshVerts
 			);
 		os::Printer::log(buf, ELL_INFORMATION);
+
+		snprintf( buf, sizeof ( buf ),
+			"quake3::constructMesh %d shader faces in %d buffers, %d draw calls instead of %d",
+			shaderFaces,
+			Mesh[E_Q3_MESH_ITEMS]->getMeshBufferCount(),
+			mergedDrawCalls,
+			faceDrawCalls
+			);
+		os::Printer::log(buf, ELL_INFORMATION);
 	}
 
 }
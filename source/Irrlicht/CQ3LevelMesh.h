@@ -110,11 +110,75 @@ namespace scene
 			return;
 		}
 
+		//! BSP tree and potentially visible sets of the level geometry
+		/** Planes and boxes are in Irrlicht space, faces refer to index
+		ranges of the mesh buffers of the E_Q3_MESH_GEOMETRY mesh. */
+		struct SBSPVisibility
+		{
+			struct SNode
+			{
+				core::plane3df Plane;
+				//! front and back child, leafs are stored as -(leaf+1)
+				s32 Children[2];
+			};
+
+			struct SLeaf
+			{
+				core::aabbox3df Box;
+				s32 Cluster;
+				u32 FirstFace;
+				u32 FaceCount;
+			};
+
+			struct SFace
+			{
+				s32 Buffer;
+				u32 FirstIndex;
+				u32 IndexCount;
+			};
+
+			SBSPVisibility() : ClusterCount(0), BytesPerCluster(0) {}
+
+			//! returns the leaf containing a position, or -1 without a tree
+			s32 getLeaf(const core::vector3df& pos) const;
+
+			//! returns if cluster to is potentially visible from cluster from
+			/** Everything is visible from outside the level or without
+			visibility data. */
+			bool isClusterVisible(s32 from, s32 to) const
+			{
+				if (from < 0 || from >= ClusterCount)
+					return true;
+				if (to < 0 || to >= ClusterCount)
+					return false;
+				return (Bitsets[from*BytesPerCluster + (to >> 3)] & (1 << (to & 7))) != 0;
+			}
+
+			core::array<SNode> Nodes;
+			core::array<SLeaf> Leafs;
+			//! indices into Faces, referenced by the leafs
+			core::array<u32> LeafFaces;
+			//! one entry for each face of the bsp file
+			core::array<SFace> Faces;
+			//! geometry faces which are not part of any leaf, like doors
+			core::array<u32> UnlinkedFaces;
+			core::array<u8> Bitsets;
+			s32 ClusterCount;
+			s32 BytesPerCluster;
+		};
+
+		//! returns the bsp tree and cluster visibility of the level
+		const SBSPVisibility& getVisibility() const
+		{
+			return Visibility;
+		}
+
 	private:
 
 
 		void constructMesh();
 		void solveTJunction();
+		void buildVisibility();
 		void loadTextures();
 
 		struct STexShader
@@ -390,6 +454,10 @@ namespace scene
 		tBSPBrush* Brushes;
 		s32 NumBrushes;
 
+		SBSPVisibility Visibility;
+		//! geometry mesh buffer of each face until buildVisibility
+		core::array<IMeshBuffer*> FaceBuffers;
+
 		scene::SMesh* Mesh[quake3::E_Q3_MESH_SIZE];
 		video::IVideoDriver* Driver;
 		core::stringc LevelName;
@@ -445,6 +513,15 @@ namespace scene
 		s32 setShaderMaterial( video::SMaterial & material, const tBSPFace * face ) const;
 		s32 setShaderFogMaterial( video::SMaterial &material, const tBSPFace * face ) const;
 
+		//! returns the amount of vertices a face adds to a mesh buffer
+		u32 getFaceVertexCount( const tBSPFace * face ) const;
+
+		//! finds a buffer of the mesh the vertices of a face can be merged into
+		/** Static shaders only need the same shader, animated ones the same material.
+		Returns 0 if a new buffer is needed. */
+		SMeshBufferLightMap* getMergeBuffer( u32 meshIndex, const video::SMaterial &material,
+					const quake3::IShader * shader, u32 vertexCount ) const;
+
 		struct SToBuffer
 		{
 			s32 takeVertexColor;
@@ -0,0 +1,335 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "ICameraSceneNode.h"
+#include "IMaterialRenderer.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(CQ3LevelMesh* level, ISceneNode* parent,
+					ISceneManager* mgr, s32 id)
+	: IMeshSceneNode(parent, mgr, id), Level(level), Mesh(0), Stamp(0),
+	Cluster(-1), ClusterValid(false), PassCount(0), ReadOnlyMaterials(false)
+{
+#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+#endif
+
+	if (!Level)
+		return;
+
+	Level->grab();
+	Mesh = Level->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	if (!Mesh)
+		return;
+
+	Mesh->grab();
+	Box = Mesh->getBoundingBox();
+
+	const u32 count = Mesh->getMeshBufferCount();
+	Materials.reallocate(count);
+	VisibleIndices.reallocate(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		const IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		Materials.push_back(mb->getMaterial());
+
+		// never grows while rendering
+		VisibleIndices.push_back(core::array<u16>());
+		VisibleIndices.getLast().reallocate(mb->getIndexCount());
+	}
+
+	FaceStamps.set_used(Level->getVisibility().Faces.size());
+	for (u32 i=0; i<FaceStamps.size(); ++i)
+		FaceStamps[i] = 0;
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+
+	if (Level)
+		Level->drop();
+}
+
+
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh)
+	{
+		// register the node for each render pass it has materials for
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			const video::SMaterial& material = ReadOnlyMaterials ?
+				Mesh->getMeshBuffer(i)->getMaterial() : Materials[i];
+			const video::IMaterialRenderer* const rnd =
+				driver->getMaterialRenderer(material.MaterialType);
+
+			if (rnd && rnd->isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver)
+		return;
+
+	ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (!camera)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	// the visible faces are the same for both passes
+	if (++PassCount == 1)
+		updateVisibleFaces(camera);
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	for (u32 i=0; i<VisibleIndices.size(); ++i)
+	{
+		const core::array<u16>& indices = VisibleIndices[i];
+		if (indices.empty())
+			continue;
+
+		IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		const video::SMaterial& material = ReadOnlyMaterials ? mb->getMaterial() : Materials[i];
+
+		const video::IMaterialRenderer* const rnd = driver->getMaterialRenderer(material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent != isTransparentPass)
+			continue;
+
+		driver->setMaterial(material);
+
+		// completely visible buffers can use their hardware buffers
+		if (indices.size() == mb->getIndexCount())
+			driver->drawMeshBuffer(mb);
+		else
+			driver->drawVertexPrimitiveList(mb->getVertices(), mb->getVertexCount(),
+				indices.const_pointer(), indices.size() / 3, mb->getVertexType(),
+				scene::EPT_TRIANGLES, video::EIT_16BIT);
+	}
+
+	// for debug purposes only
+	if (DebugDataVisible && PassCount == 1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			const CQ3LevelMesh::SBSPVisibility& vis = Level->getVisibility();
+			for (u32 i=0; i<ClusterLeafs.size(); ++i)
+			{
+				const core::aabbox3df& box = vis.Leafs[ClusterLeafs[i]].Box;
+				if (isBoxVisible(box))
+					driver->draw3DBox(box);
+			}
+		}
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+			driver->draw3DBox(getBoundingBox(), video::SColor(0,255,0,0));
+	}
+}
+
+
+//! finds the camera cluster and collects the faces of all visible leafs
+void CQ3LevelSceneNode::updateVisibleFaces(const ICameraSceneNode* camera)
+{
+	const CQ3LevelMesh::SBSPVisibility& vis = Level->getVisibility();
+
+	SViewFrustum frust = *camera->getViewFrustum();
+	core::vector3df pos = camera->getAbsolutePosition();
+
+	// camera and frustum to object space
+	if (!AbsoluteTransformation.isIdentity())
+	{
+		core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+		frust.transform(invTrans);
+		invTrans.transformVect(pos);
+	}
+
+	const s32 leaf = vis.getLeaf(pos);
+	const s32 cluster = leaf >= 0 ? vis.Leafs[leaf].Cluster : -1;
+
+	bool changed = !ClusterValid || cluster != Cluster;
+	if (changed)
+	{
+		ClusterLeafs.set_used(0);
+		for (u32 i=0; i<vis.Leafs.size(); ++i)
+		{
+			if (vis.Leafs[i].FaceCount && vis.isClusterVisible(cluster, vis.Leafs[i].Cluster))
+				ClusterLeafs.push_back(i);
+		}
+
+		Cluster = cluster;
+		ClusterValid = true;
+	}
+
+	for (u32 i=0; !changed && i<SViewFrustum::VF_PLANE_COUNT; ++i)
+		changed = !(frust.planes[i] == Frustum.planes[i]);
+
+	// nothing moved, the faces of the last update are still valid
+	if (!changed)
+		return;
+
+	Frustum = frust;
+
+	if (++Stamp == 0)
+	{
+		for (u32 i=0; i<FaceStamps.size(); ++i)
+			FaceStamps[i] = 0;
+		Stamp = 1;
+	}
+
+	for (u32 i=0; i<VisibleIndices.size(); ++i)
+		VisibleIndices[i].set_used(0);
+
+	for (u32 i=0; i<ClusterLeafs.size(); ++i)
+	{
+		const CQ3LevelMesh::SBSPVisibility::SLeaf& l = vis.Leafs[ClusterLeafs[i]];
+		if (!isBoxVisible(l.Box))
+			continue;
+
+		for (u32 f=0; f<l.FaceCount; ++f)
+			addVisibleFace(vis.LeafFaces[l.FirstFace + f]);
+	}
+
+	for (u32 i=0; i<vis.UnlinkedFaces.size(); ++i)
+		addVisibleFace(vis.UnlinkedFaces[i]);
+}
+
+
+//! returns if a box in object space is inside or intersects the frustum
+bool CQ3LevelSceneNode::isBoxVisible(const core::aabbox3df& box) const
+{
+	for (u32 i=0; i<SViewFrustum::VF_PLANE_COUNT; ++i)
+	{
+		if (box.classifyPlaneRelation(Frustum.planes[i]) == core::ISREL3D_FRONT)
+			return false;
+	}
+
+	return true;
+}
+
+
+//! appends the indices of a face, unless it was added in this update
+void CQ3LevelSceneNode::addVisibleFace(u32 face)
+{
+	if (FaceStamps[face] == Stamp)
+		return;
+
+	FaceStamps[face] = Stamp;
+
+	const CQ3LevelMesh::SBSPVisibility::SFace& f = Level->getVisibility().Faces[face];
+	const u16* source = Mesh->getMeshBuffer(f.Buffer)->getIndices() + f.FirstIndex;
+
+	core::array<u16>& indices = VisibleIndices[f.Buffer];
+	const u32 used = indices.size();
+	indices.set_used(used + f.IndexCount);
+	memcpy(indices.pointer() + used, source, f.IndexCount * sizeof(u16));
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CQ3LevelSceneNode::getBoundingBox() const
+{
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	if (ReadOnlyMaterials)
+		return Mesh->getMeshBuffer(i)->getMaterial();
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CQ3LevelSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+void CQ3LevelSceneNode::setMesh(IMesh* mesh)
+{
+	// Do nothing
+}
+
+
+IMesh* CQ3LevelSceneNode::getMesh(void)
+{
+	return Mesh;
+}
+
+
+void CQ3LevelSceneNode::setReadOnlyMaterials(bool readonly)
+{
+	ReadOnlyMaterials = readonly;
+}
+
+
+bool CQ3LevelSceneNode::isReadOnlyMaterials() const
+{
+	return ReadOnlyMaterials;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
+
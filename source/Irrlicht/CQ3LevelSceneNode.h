@@ -0,0 +1,100 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+#define __C_Q3_LEVEL_SCENE_NODE_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+#include "CQ3LevelMesh.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+	//! Renders the geometry of a quake3 level with the potentially visible sets of the bsp file
+	/** The camera leaf selects the cluster, all leafs of clusters visible from it
+	are kept until the camera enters another cluster. Each frame only the faces
+	of those leafs whose boxes intersect the view frustum are drawn. */
+	class CQ3LevelSceneNode : public IMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(CQ3LevelMesh* level, ISceneNode* parent, ISceneManager* mgr, s32 id);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		virtual void OnRegisterSceneNode();
+
+		//! renders the node.
+		virtual void render();
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i);
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const { return ESNT_Q3_LEVEL; }
+
+		//! Sets a new mesh to display
+		/** Does nothing, the node can only display the geometry of its level. */
+		virtual void setMesh(IMesh* mesh);
+
+		//! Get the currently defined mesh for display.
+		virtual IMesh* getMesh(void);
+
+		//! Sets if the scene node should not copy the materials of the mesh but use them in a read only style.
+		virtual void setReadOnlyMaterials(bool readonly);
+
+		//! Check if the scene node should not copy the materials of the mesh but use them in a read only style
+		virtual bool isReadOnlyMaterials() const;
+
+	private:
+
+		//! finds the camera cluster and collects the faces of all visible leafs
+		void updateVisibleFaces(const ICameraSceneNode* camera);
+
+		//! returns if a box in object space is inside or intersects the frustum
+		bool isBoxVisible(const core::aabbox3df& box) const;
+
+		//! appends the indices of a face, unless it was added in this update
+		void addVisibleFace(u32 face);
+
+		CQ3LevelMesh* Level;
+		IMesh* Mesh;
+		core::aabbox3d<f32> Box;
+
+		core::array<video::SMaterial> Materials;
+
+		//! indices of the visible faces for each mesh buffer
+		core::array< core::array<u16> > VisibleIndices;
+
+		//! update number in which a face was added last
+		core::array<u32> FaceStamps;
+		u32 Stamp;
+
+		//! leafs in the potentially visible set of Cluster
+		core::array<u32> ClusterLeafs;
+		s32 Cluster;
+		bool ClusterValid;
+
+		//! view frustum in object space of the last update
+		SViewFrustum Frustum;
+
+		s32 PassCount;
+		bool ReadOnlyMaterials;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
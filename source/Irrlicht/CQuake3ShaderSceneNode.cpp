@@ -15,6 +15,10 @@
 #include "SMesh.h"
 #include "IMaterialRenderer.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace scene
@@ -23,6 +27,96 @@ namespace scene
 // who, if not you..
 using namespace quake3;
 
+/*
+	The waveforms sampled over one period, the vertex deformations look them up
+	like the function tables of the quake3 renderer instead of calling sinf
+*/
+struct SWaveTables
+{
+	enum { SIZE = 1024, MASK = SIZE - 1 };
+
+	SWaveTables()
+	{
+		for ( u32 i = 0; i != SIZE; ++i )
+		{
+			const f32 x = (f32) i / (f32) SIZE;
+
+			Table[0][i] = sinf ( x * core::PI * 2.f );
+			Table[1][i] = cosf ( x * core::PI * 2.f );
+			Table[2][i] = x < 0.5f ? 1.f : -1.f;
+			Table[3][i] = x < 0.5f ? ( 4.f * x ) - 1.f : ( -4.f * x ) + 3.f;
+			Table[4][i] = x;
+			Table[5][i] = 1.f - x;
+		}
+	}
+
+	//! returns the table of a waveform, 0 for noise
+	const f32 * get ( eQ3ModifierFunction func ) const
+	{
+		if ( func < SINUS || func > SAWTOOTH_INVERSE )
+			return 0;
+		return Table [ func - SINUS ];
+	}
+
+	f32 Table[6][SIZE];
+};
+
+static const SWaveTables WaveTables;
+
+
+/*
+	Evaluates the waveform of a modifier for many vertices at once.
+	Each vertex adds its phase offset to the phase of the function,
+	value and phase may be the same array.
+*/
+static void evaluateWaves( const SModifierFunction &function, f32 dt,
+				const f32 * phase, f32 * value, u32 count )
+{
+	const f32 * table = WaveTables.get( function.func );
+	if ( 0 == table )
+	{
+		SModifierFunction f ( function );
+		for ( u32 i = 0; i != count; ++i )
+		{
+			f.phase = function.phase + phase[i];
+			value[i] = f.evaluate( dt );
+		}
+		return;
+	}
+
+	// phase in table entries, the time is wrapped first to keep the precision
+	const f32 start = core::fract( ( dt + function.phase ) * function.frequency ) * SWaveTables::SIZE;
+	const f32 scale = function.frequency * SWaveTables::SIZE;
+
+	u32 i = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	const __m128 start4 = _mm_set1_ps( start );
+	const __m128 scale4 = _mm_set1_ps( scale );
+	const __m128 base4 = _mm_set1_ps( function.base );
+	const __m128 amp4 = _mm_set1_ps( function.amp );
+	const __m128i mask4 = _mm_set1_epi32( SWaveTables::MASK );
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const __m128 x = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( phase + i ), scale4 ), start4 );
+
+		s32 k[4];
+		_mm_storeu_si128( (__m128i*) k, _mm_and_si128( _mm_cvttps_epi32( x ), mask4 ) );
+
+		const __m128 y = _mm_set_ps( table[k[3]], table[k[2]], table[k[1]], table[k[0]] );
+		_mm_storeu_ps( value + i, _mm_add_ps( _mm_mul_ps( y, amp4 ), base4 ) );
+	}
+#endif
+
+	for ( ; i != count; ++i )
+	{
+		const s32 k = (s32) ( phase[i] * scale + start ) & SWaveTables::MASK;
+		value[i] = function.base + ( table[k] * function.amp );
+	}
+}
+
+
 /*!
 */
 CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
@@ -33,7 +127,7 @@ CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
 		core::vector3df(0.f, 0.f, 0.f),
 		core::vector3df(0.f, 0.f, 0.f),
 		core::vector3df(1.f, 1.f, 1.f)),
-	Shader(shader), Mesh(0), Original(0), MeshBuffer(0), TimeAbs(0.f)
+	Shader(shader), Mesh(0), Original(0), MeshBuffer(0), TimeAbs(0.f), DeformTime(-1.f)
 {
 	#ifdef _DEBUG
 		core::stringc dName = "CQuake3ShaderSceneNode ";
@@ -63,7 +157,9 @@ CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
 	// load all Textures in all stages
 	loadTextures( fileSystem );
 
-	setAutomaticCulling( scene::EAC_OFF );
+	// nodes outside of the view frustum skip their vertex animation
+	calcDeformBox();
+	setAutomaticCulling( scene::EAC_FRUSTUM_BOX );
 }
 
 
@@ -125,6 +221,87 @@ void CQuake3ShaderSceneNode::cloneBuffer( scene::SMeshBuffer *dest, const scene:
 }
 
 
+/*
+	the box of the mesh grown by the farthest distance
+	the vertex deformations can move a vertex
+*/
+void CQuake3ShaderSceneNode::calcDeformBox()
+{
+	static const c8 * deformList[] =
+	{
+		"wave","move","bulge","autosprite","autosprite2"
+	};
+
+	f32 extent = 0.f;
+
+	for ( u32 stage = 1; stage < Shader->VarGroup->VariableGroup.size(); ++stage )
+	{
+		const SVarGroup *group = Shader->getGroup( stage );
+
+		for ( u32 g = 0; g != group->Variable.size(); ++g )
+		{
+			const SVariable &v = group->Variable[g];
+			if ( v.name != "deformvertexes" )
+				continue;
+
+			SModifierFunction function;
+			u32 pos = 0;
+
+			switch ( isEqual( v.content, pos, deformList, 5 ) )
+			{
+				case 0:
+					// deformVertexes wave <div> <func> <base> <amplitude> <phase> <freq>
+					getAsFloat( v.content, pos );
+					getModifierFunc( function, v.content, pos );
+					extent += core::abs_( function.base ) + core::abs_( function.amp );
+					break;
+
+				case 1:
+				{
+					// deformVertexes move <x> <y> <z> <func> <base> <amplitude> <phase> <freq>
+					const f32 x = core::abs_( getAsFloat( v.content, pos ) );
+					const f32 y = core::abs_( getAsFloat( v.content, pos ) );
+					const f32 z = core::abs_( getAsFloat( v.content, pos ) );
+					getModifierFunc( function, v.content, pos );
+					extent += core::max_( x, y, z ) *
+						( core::abs_( function.base ) + core::abs_( function.amp ) );
+				} break;
+
+				case 2:
+				{
+					// deformVertexes bulge <width> <height> <speed>, the width is the wave base
+					const f32 width = getAsFloat( v.content, pos );
+					const f32 height = getAsFloat( v.content, pos );
+					extent += core::abs_( width ) + core::abs_( height );
+				} break;
+
+				case 3:
+				case 4:
+				{
+					// sprites rotate each quad around its center
+					f32 radius = 0.f;
+					const video::S3DVertex2TCoords * vin = Original->Vertices.const_pointer();
+					for ( u32 i = 0; i + 3 < Original->Vertices.size(); i += 4 )
+					{
+						const core::vector3df center = 0.25f * ( vin[i+0].Pos + vin[i+1].Pos + vin[i+2].Pos + vin[i+3].Pos );
+						for ( u32 k = 0; k != 4; ++k )
+							radius = core::max_( radius, center.getDistanceFrom( vin[i+k].Pos ) );
+					}
+					extent += radius;
+				} break;
+
+				default:
+					break;
+			}
+		}
+	}
+
+	DeformBox = MeshBuffer->getBoundingBox();
+	DeformBox.MinEdge -= core::vector3df( extent, extent, extent );
+	DeformBox.MaxEdge += core::vector3df( extent, extent, extent );
+}
+
+
 /*
 	load the textures for all stages
 */
@@ -388,6 +565,8 @@ void CQuake3ShaderSceneNode::render()
 
 	}
 
+	DeformTime = TimeAbs;
+
 	if ( DebugDataVisible & scene::EDS_MESH_WIRE_OVERLAY )
 	{
 		video::SMaterial deb_m;
@@ -502,10 +681,12 @@ void CQuake3ShaderSceneNode::deformvertexes_wave( f32 dt, SModifierFunction &fun
 {
 	function.wave = core::reciprocal( function.wave );
 
-	const f32 phase = function.phase;
-
 	const u32 vsize = Original->Vertices.size();
-	for ( u32 i = 0; i != vsize; ++i )
+	WaveValues.set_used( vsize );
+	f32 * wave = WaveValues.pointer();
+
+	u32 i;
+	for ( i = 0; i != vsize; ++i )
 	{
 		const video::S3DVertex2TCoords &src = Original->Vertices[i];
 		video::S3DVertex &dst = MeshBuffer->Vertices[i];
@@ -513,10 +694,17 @@ void CQuake3ShaderSceneNode::deformvertexes_wave( f32 dt, SModifierFunction &fun
 		if ( 0 == function.count )
 			dst.Pos = src.Pos - MeshOffset;
 
-		const f32 wavephase = (dst.Pos.X + dst.Pos.Y + dst.Pos.Z) * function.wave;
-		function.phase = phase + wavephase;
+		wave[i] = (dst.Pos.X + dst.Pos.Y + dst.Pos.Z) * function.wave;
+	}
+
+	evaluateWaves( function, dt, wave, wave, vsize );
+
+	for ( i = 0; i != vsize; ++i )
+	{
+		const video::S3DVertex2TCoords &src = Original->Vertices[i];
+		video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-		const f32 f = function.evaluate( dt );
+		const f32 f = wave[i];
 
 		dst.Pos.X += f * src.Normal.X;
 		dst.Pos.Y += f * src.Normal.Y;
@@ -592,26 +780,35 @@ void CQuake3ShaderSceneNode::deformvertexes_move( f32 dt, SModifierFunction &fun
 void CQuake3ShaderSceneNode::deformvertexes_normal( f32 dt, SModifierFunction &function )
 {
 	function.func = SINUS;
+	function.base = 0.f;
+	function.phase = 0.f;
+
 	const u32 vsize = Original->Vertices.size();
-	for ( u32 i = 0; i != vsize; ++i )
+	WaveValues.set_used( vsize * 2 );
+	f32 * lat = WaveValues.pointer();
+	f32 * lng = lat + vsize;
+
+	u32 i;
+	for ( i = 0; i != vsize; ++i )
 	{
 		const video::S3DVertex2TCoords &src = Original->Vertices[i];
-		video::S3DVertex &dst = MeshBuffer->Vertices[i];
-
-		function.base = atan2f ( src.Pos.X, src.Pos.Y );
-		function.phase = src.Pos.X + src.Pos.Z;
-
-		const f32 lat = function.evaluate( dt );
+		lat[i] = src.Pos.X + src.Pos.Z;
+		lng[i] = src.Normal.Z + src.Normal.X;
+	}
 
-		function.base = src.Normal.Y;
-		function.phase = src.Normal.Z + src.Normal.X;
+	evaluateWaves( function, dt, lat, lat, vsize * 2 );
 
-		const f32 lng = function.evaluate( dt );
+	for ( i = 0; i != vsize; ++i )
+	{
+		const video::S3DVertex2TCoords &src = Original->Vertices[i];
+		video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-		dst.Normal.X = cosf ( lat ) * sinf ( lng );
-		dst.Normal.Y = sinf ( lat ) * sinf ( lng );
-		dst.Normal.Z = cosf ( lng );
+		lat[i] += atan2f ( src.Pos.X, src.Pos.Y );
+		lng[i] += src.Normal.Y;
 
+		dst.Normal.X = cosf ( lat[i] ) * sinf ( lng[i] );
+		dst.Normal.Y = sinf ( lat[i] ) * sinf ( lng[i] );
+		dst.Normal.Z = cosf ( lng[i] );
 	}
 }
 
@@ -666,18 +863,23 @@ void CQuake3ShaderSceneNode::deformvertexes_bulge( f32 dt, SModifierFunction &fu
 	function.wave = core::reciprocal( function.bulgewidth );
 
 	dt *= function.bulgespeed * 0.1f;
-	const f32 phase = function.phase;
 
 	const u32 vsize = Original->Vertices.size();
-	for ( u32 i = 0; i != vsize; ++i )
+	WaveValues.set_used( vsize );
+	f32 * wave = WaveValues.pointer();
+
+	u32 i;
+	for ( i = 0; i != vsize; ++i )
+		wave[i] = Original->Vertices[i].TCoords.X * function.wave;
+
+	evaluateWaves( function, dt, wave, wave, vsize );
+
+	for ( i = 0; i != vsize; ++i )
 	{
 		const video::S3DVertex2TCoords &src = Original->Vertices[i];
 		video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-		const f32 wavephase = (Original->Vertices[i].TCoords.X ) * function.wave;
-		function.phase = phase + wavephase;
-
-		const f32 f = function.evaluate( dt );
+		const f32 f = wave[i];
 
 		if ( 0 == function.count )
 			dst.Pos = src.Pos - MeshOffset;
@@ -928,17 +1130,23 @@ void CQuake3ShaderSceneNode::vertextransform_tcgen( f32 dt, SModifierFunction &f
 		{
 			function.wave = core::reciprocal( function.phase );
 
-			const f32 phase = function.phase;
+			WaveValues.set_used( vsize );
+			f32 * wave = WaveValues.pointer();
 
 			for ( i = 0; i != vsize; ++i )
 			{
 				const video::S3DVertex2TCoords &src = Original->Vertices[i];
-				video::S3DVertex &dst = MeshBuffer->Vertices[i];
+				wave[i] = (src.Pos.X + src.Pos.Y + src.Pos.Z) * function.wave;
+			}
 
-				const f32 wavephase = (src.Pos.X + src.Pos.Y + src.Pos.Z) * function.wave;
-				function.phase = phase + wavephase;
+			evaluateWaves( function, dt, wave, wave, vsize );
 
-				const f32 f = function.evaluate( dt );
+			for ( i = 0; i != vsize; ++i )
+			{
+				const video::S3DVertex2TCoords &src = Original->Vertices[i];
+				video::S3DVertex &dst = MeshBuffer->Vertices[i];
+
+				const f32 f = wave[i];
 
 				dst.TCoords.X = src.TCoords.X + f * src.Normal.X;
 				dst.TCoords.Y = src.TCoords.Y + f * src.Normal.Y;
@@ -1056,6 +1264,9 @@ void CQuake3ShaderSceneNode::animate( u32 stage,core::matrix4 &texture )
 
 	f32 f[16];
 
+	// the deformed vertices were already calculated for this time
+	const bool deform = TimeAbs != DeformTime;
+
 	// walk group for all modifiers
 	for ( u32 g = 0; g != group->Variable.size(); ++g )
 	{
@@ -1207,10 +1418,12 @@ void CQuake3ShaderSceneNode::animate( u32 stage,core::matrix4 &texture )
 								switch ( function.masterfunc1 )
 								{
 									case WAVE:
-										deformvertexes_wave( TimeAbs, function );
+										if ( deform )
+											deformvertexes_wave( TimeAbs, function );
 										break;
 									case MOVE:
-										deformvertexes_move( TimeAbs, function );
+										if ( deform )
+											deformvertexes_move( TimeAbs, function );
 										break;
 									default:
 										break;
@@ -1261,7 +1474,8 @@ void CQuake3ShaderSceneNode::animate( u32 stage,core::matrix4 &texture )
 				function.bulgeheight = getAsFloat( v.content, pos );
 				function.bulgespeed = getAsFloat( v.content, pos );
 
-				deformvertexes_bulge(TimeAbs, function);
+				if ( deform )
+					deformvertexes_bulge(TimeAbs, function);
 				break;
 
 			case NORMAL:
@@ -1269,7 +1483,8 @@ void CQuake3ShaderSceneNode::animate( u32 stage,core::matrix4 &texture )
 				function.amp = getAsFloat( v.content, pos );
 				function.frequency = getAsFloat( v.content, pos );
 
-				deformvertexes_normal(TimeAbs, function);
+				if ( deform )
+					deformvertexes_normal(TimeAbs, function);
 				break;
 
 			case AUTOSPRITE:
@@ -1310,7 +1525,7 @@ void CQuake3ShaderSceneNode::OnAnimate(u32 timeMs)
 
 const core::aabbox3d<f32>& CQuake3ShaderSceneNode::getBoundingBox() const
 {
-	return MeshBuffer->getBoundingBox();
+	return DeformBox;
 }
 
 
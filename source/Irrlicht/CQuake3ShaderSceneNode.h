@@ -54,6 +54,12 @@ private:
 	SMeshBuffer* MeshBuffer;
 	core::vector3df MeshOffset;
 
+	//! contains the mesh for every time of the vertex deformations, used for culling
+	core::aabbox3d<f32> DeformBox;
+
+	//! waveform values of all vertices of the current deformation
+	core::array<f32> WaveValues;
+
 	struct SQ3Texture
 	{
 		SQ3Texture () :
@@ -74,6 +80,7 @@ private:
 	core::array< SQ3Texture > Q3Texture;
 
 	void loadTextures ( io::IFileSystem * fileSystem );
+	void calcDeformBox ();
 	void addBuffer ( scene::SMeshBufferLightMap * buffer );
 	void cloneBuffer ( scene::SMeshBuffer *dest, const scene::SMeshBufferLightMap * buffer, bool translateCenter );
 
@@ -92,6 +99,9 @@ private:
 
 	f32 TimeAbs;
 
+	//! time of the last vertex deformation, the vertices are still valid if the time did not change
+	f32 DeformTime;
+
 	void animate( u32 stage, core::matrix4 &texture );
 
 	E_SCENE_NODE_RENDER_PASS getRenderStage() const;
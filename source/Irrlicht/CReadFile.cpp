@@ -3,6 +3,8 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CReadFile.h"
+#include "CMappedReadFile.h"
+#include "os.h"
 
 namespace irr
 {
@@ -34,6 +36,7 @@ s32 CReadFile::read(void* buffer, u32 sizeToRead)
 	if (!isOpen())
 		return 0;
 
+	os::LoadEvent event(ELPE_READ, Filename);
 	return (s32)fread(buffer, 1, sizeToRead, File);
 }
 
@@ -100,9 +103,24 @@ const io::path& CReadFile::getFileName() const
 
 IReadFile* createReadFile(const io::path& fileName)
 {
+	// files of at least this size are mapped into memory
+	const long MAPPED_FILE_MIN_SIZE = 64*1024;
+
 	CReadFile* file = new CReadFile(fileName);
 	if (file->isOpen())
+	{
+		if (file->getSize() >= MAPPED_FILE_MIN_SIZE)
+		{
+			IReadFile* mapped = createMappedReadFile(fileName);
+			if (mapped)
+			{
+				file->drop();
+				return mapped;
+			}
+		}
+
 		return file;
+	}
 
 	file->drop();
 	return 0;
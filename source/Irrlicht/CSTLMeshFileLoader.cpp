@@ -8,7 +8,9 @@
 
 #include "CSTLMeshFileLoader.h"
 #include "SMesh.h"
-#include "SMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
+#include "IMeshManipulator.h"
+#include "IVideoDriver.h"
 #include "SAnimatedMesh.h"
 #include "IReadFile.h"
 #include "fast_atof.h"
@@ -20,6 +22,12 @@ namespace irr
 namespace scene
 {
 
+//! Constructor
+CSTLMeshFileLoader::CSTLMeshFileLoader(scene::ISceneManager* smgr)
+: SceneManager(smgr)
+{
+}
+
 
 //! returns true if the file maybe is able to be loaded by this class
 //! based on the file extension (e.g. ".bsp")
@@ -42,8 +50,9 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 
 	const u32 WORD_BUFFER_LENGTH = 512;
 
+	// the facets are collected with 32 bit indices and split when done
 	SMesh* mesh = new SMesh();
-	SMeshBuffer* meshBuffer = new SMeshBuffer();
+	CDynamicMeshBuffer* meshBuffer = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
 	mesh->addMeshBuffer(meshBuffer);
 	meshBuffer->drop();
 
@@ -137,21 +146,28 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 #endif
 		}
 
-		SMeshBuffer* mb = reinterpret_cast<SMeshBuffer*>(mesh->getMeshBuffer(mesh->getMeshBufferCount()-1));
-		u32 vCount = mb->getVertexCount();
+		const u32 vCount = meshBuffer->getVertexCount();
 		video::SColor color(0xffffffff);
 		if (attrib & 0x8000)
 			color = video::A1R5G5B5toA8R8G8B8(attrib);
 		if (normal==core::vector3df())
 			normal=core::plane3df(vertex[2],vertex[1],vertex[0]).Normal;
-		mb->Vertices.push_back(video::S3DVertex(vertex[2],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[1],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[0],normal,color, core::vector2df()));
-		mb->Indices.push_back(vCount);
-		mb->Indices.push_back(vCount+1);
-		mb->Indices.push_back(vCount+2);
+		meshBuffer->getVertexBuffer().push_back(video::S3DVertex(vertex[2],normal,color, core::vector2df()));
+		meshBuffer->getVertexBuffer().push_back(video::S3DVertex(vertex[1],normal,color, core::vector2df()));
+		meshBuffer->getVertexBuffer().push_back(video::S3DVertex(vertex[0],normal,color, core::vector2df()));
+		meshBuffer->getIndexBuffer().push_back(vCount);
+		meshBuffer->getIndexBuffer().push_back(vCount+1);
+		meshBuffer->getIndexBuffer().push_back(vCount+2);
 	}	// end while (file->getPos() < filesize)
-	mesh->getMeshBuffer(0)->recalculateBoundingBox();
+	meshBuffer->recalculateBoundingBox();
+
+	// replace the buffer by the ones the driver can draw
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	SMesh* splitMesh = new SMesh();
+	SceneManager->getMeshManipulator()->addSplitMeshBuffer(splitMesh, meshBuffer,
+			!driver || driver->queryFeature(video::EVDF_INDEX_32BIT));
+	mesh->drop();
+	mesh = splitMesh;
 
 	// Create the Animated mesh if there's anything in the mesh
 	SAnimatedMesh* pAM = 0;
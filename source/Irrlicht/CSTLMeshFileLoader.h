@@ -6,6 +6,7 @@
 #define __C_STL_MESH_FILE_LOADER_H_INCLUDED__
 
 #include "IMeshLoader.h"
+#include "ISceneManager.h"
 #include "irrString.h"
 #include "vector3d.h"
 
@@ -19,6 +20,9 @@ class CSTLMeshFileLoader : public IMeshLoader
 {
 public:
 
+	//! Constructor
+	CSTLMeshFileLoader(scene::ISceneManager* smgr);
+
 	//! returns true if the file maybe is able to be loaded by this class
 	//! based on the file extension (i.e. ".stl")
 	virtual bool isALoadableFileExtension(const io::path& filename) const;
@@ -40,6 +44,8 @@ private:
 
 	//! Read 3d vector of floats
 	void getNextVector(io::IReadFile* file, core::vector3df& vec, bool binary) const;
+
+	scene::ISceneManager* SceneManager;
 };
 
 } // end namespace scene
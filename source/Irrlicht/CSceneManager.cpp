@@ -151,6 +151,7 @@
 #include "CDefaultSceneNodeAnimatorFactory.h"
 
 #include "CQuake3ShaderSceneNode.h"
+#include "CQ3LevelSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 #include "CGeometryCreator.h"
 
@@ -262,10 +263,10 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	MeshLoaderList.push_back(new CLWOMeshFileLoader(this, FileSystem));
 	#endif
 	#ifdef _IRR_COMPILE_WITH_STL_LOADER_
-	MeshLoaderList.push_back(new CSTLMeshFileLoader());
+	MeshLoaderList.push_back(new CSTLMeshFileLoader(this));
 	#endif
 	#ifdef _IRR_COMPILE_WITH_PLY_LOADER_
-	MeshLoaderList.push_back(new CPLYMeshFileLoader());
+	MeshLoaderList.push_back(new CPLYMeshFileLoader(this));
 	#endif
 
 	// factories
@@ -339,6 +340,36 @@ CSceneManager::~CSceneManager()
 }
 
 
+//! Logs the mesh buffers a loader created, which shows meshes which were split,
+//! and reports their sizes to the load profiler
+static void logLoadedMesh(IAnimatedMesh* msh, const io::path& filename, os::LoadEvent& loadEvent)
+{
+	u32 vertexCount = 0;
+	u32 indexCount = 0;
+	u32 triangleCount = 0;
+	u32 buffers32Bit = 0;
+	u32 bytes = 0;
+	for (u32 i=0; i<msh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = msh->getMeshBuffer(i);
+		const u32 indexSize = (mb->getIndexType() == video::EIT_32BIT) ? 4 : 2;
+		vertexCount += mb->getVertexCount();
+		indexCount += mb->getIndexCount();
+		triangleCount += mb->getIndexCount() / 3;
+		bytes += mb->getVertexCount() * video::getVertexPitchFromType(mb->getVertexType()) +
+			mb->getIndexCount() * indexSize;
+		if (indexSize == 4)
+			++buffers32Bit;
+	}
+	loadEvent.addAssetSizes(vertexCount, indexCount, 0, bytes);
+
+	c8 tmp[256];
+	sprintf(tmp, "Loaded mesh with %u mesh buffers (%u with 32 bit indices), %u vertices and %u triangles",
+		msh->getMeshBufferCount(), buffers32Bit, vertexCount, triangleCount);
+	os::Printer::log(tmp, filename, ELL_INFORMATION);
+}
+
+
 //! gets an animateable mesh. loads it if needed. returned pointer must not be dropped.
 IAnimatedMesh* CSceneManager::getMesh(const io::path& filename)
 {
@@ -346,6 +377,7 @@ IAnimatedMesh* CSceneManager::getMesh(const io::path& filename)
 	if (msh)
 		return msh;
 
+	os::LoadEvent loadEvent(ELPE_LOAD, filename);
 	io::IReadFile* file = FileSystem->createAndOpenFile(filename);
 	if (!file)
 	{
@@ -360,7 +392,10 @@ IAnimatedMesh* CSceneManager::getMesh(const io::path& filename)
 		{
 			// reset file to avoid side effects of previous calls to createMesh
 			file->seek(0);
-			msh = MeshLoaderList[i]->createMesh(file);
+			{
+				os::LoadEvent parseEvent(ELPE_PARSE, file->getFileName());
+				msh = MeshLoaderList[i]->createMesh(file);
+			}
 			if (msh)
 			{
 				MeshCache->addMesh(filename, msh);
@@ -375,7 +410,7 @@ IAnimatedMesh* CSceneManager::getMesh(const io::path& filename)
 	if (!msh)
 		os::Printer::log("Could not load mesh, file format seems to be unsupported", filename, ELL_ERROR);
 	else
-		os::Printer::log("Loaded mesh", filename, ELL_INFORMATION);
+		logLoadedMesh(msh, filename, loadEvent);
 
 	return msh;
 }
@@ -392,6 +427,7 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 	if (msh)
 		return msh;
 
+	os::LoadEvent loadEvent(ELPE_LOAD, name);
 	s32 count = MeshLoaderList.size();
 	for (s32 i=count-1; i>=0; --i)
 	{
@@ -399,7 +435,10 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 		{
 			// reset file to avoid side effects of previous calls to createMesh
 			file->seek(0);
-			msh = MeshLoaderList[i]->createMesh(file);
+			{
+				os::LoadEvent parseEvent(ELPE_PARSE, file->getFileName());
+				msh = MeshLoaderList[i]->createMesh(file);
+			}
 			if (msh)
 			{
 				MeshCache->addMesh(file->getFileName(), msh);
@@ -412,7 +451,7 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 	if (!msh)
 		os::Printer::log("Could not load mesh, file format seems to be unsupported", file->getFileName(), ELL_ERROR);
 	else
-		os::Printer::log("Loaded mesh", file->getFileName(), ELL_INFORMATION);
+		logLoadedMesh(msh, file->getFileName(), loadEvent);
 
 	return msh;
 }
@@ -510,6 +549,28 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node rendering the geometry of a quake3 level with its bsp visibility
+IMeshSceneNode* CSceneManager::addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+					ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	if ( 0 == mesh || mesh->getMeshType() != EAMT_BSP )
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(
+		static_cast<CQ3LevelMesh*>(mesh), parent, this, id);
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -1390,7 +1451,8 @@ void CSceneManager::drawAll()
 			if(ActiveCamera)
 				camWorldPos = ActiveCamera->getAbsolutePosition();
 
-			core::array<DistanceNodeEntry> SortedLights;
+			core::array<DistanceNodeEntry, core::irrAllocatorArena<DistanceNodeEntry> > SortedLights;
+			SortedLights.getAllocator().setArena(&FrameArena);
 			SortedLights.set_used(LightList.size());
 			for(s32 light = (s32)LightList.size() - 1; light >= 0; --light)
 				SortedLights[light].setNodeAndDistanceFromPosition(LightList[light], camWorldPos);
@@ -1574,6 +1636,11 @@ void CSceneManager::drawAll()
 		LightManager->OnPostRender();
 
 	LightList.set_used(0);
+
+	// memory of lists which only lived during this frame
+	Parameters.setAttribute ( "frame_memory", (s32) FrameArena.getUsedBytes() );
+	FrameArena.reset();
+
 // >> added by arch_jslin 2008.3 for animator auto-deletion
 	clearAnimatorDeletionList();
 	clearDeletionList();
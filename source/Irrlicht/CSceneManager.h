@@ -200,6 +200,10 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												);
 
+		//! Adds a scene node rendering the geometry of a quake3 level with its bsp visibility
+		virtual IMeshSceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1);
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -618,6 +622,9 @@ namespace scene
 		core::array<TransparentNodeEntry> TransparentNodeList;
 		core::array<TransparentNodeEntry> TransparentEffectNodeList;
 
+		//! memory for lists which are only used while drawing a frame
+		core::irrMemoryArena FrameArena;
+
 		core::array<IMeshLoader*> MeshLoaderList;
 		core::array<ISceneNode*> DeletionList;
 		core::array<ISceneNodeFactory*> SceneNodeFactoryList;
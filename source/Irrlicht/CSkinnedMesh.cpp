@@ -473,20 +473,26 @@ void CSkinnedMesh::SkinJoint(SJoint *joint, SJoint *parentJoint)
 		core::matrix4 jointVertexPull(core::matrix4::EM4CONST_NOTHING);
 		jointVertexPull.setbyproduct(joint->GlobalAnimatedMatrix, joint->GlobalInversedMatrix);
 
-		core::vector3df thisVertexMove, thisNormalMove;
-
 		core::array<scene::SSkinMeshBuffer*> &buffersUsed=*SkinningBuffers;
 
+		// Pull all vertices of this joint...
+		const u32 count = joint->Weights.size();
+		SkinnedPositions.set_used(count);
+		jointVertexPull.transformVects(SkinnedPositions.pointer(),
+			&joint->Weights[0].StaticPos, count, sizeof(SWeight));
+
+		if (AnimateNormals)
+		{
+			SkinnedNormals.set_used(count);
+			jointVertexPull.rotateVects(SkinnedNormals.pointer(),
+				&joint->Weights[0].StaticNormal, count, sizeof(SWeight));
+		}
+
 		//Skin Vertices Positions and Normals...
-		for (u32 i=0; i<joint->Weights.size(); ++i)
+		for (u32 i=0; i<count; ++i)
 		{
 			SWeight& weight = joint->Weights[i];
-
-			// Pull this vertex...
-			jointVertexPull.transformVect(thisVertexMove, weight.StaticPos);
-
-			if (AnimateNormals)
-				jointVertexPull.rotateVect(thisNormalMove, weight.StaticNormal);
+			const core::vector3df& thisVertexMove = SkinnedPositions[i];
 
 			if (! (*(weight.Moved)) )
 			{
@@ -495,7 +501,7 @@ void CSkinnedMesh::SkinJoint(SJoint *joint, SJoint *parentJoint)
 				buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Pos = thisVertexMove * weight.strength;
 
 				if (AnimateNormals)
-					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal = thisNormalMove * weight.strength;
+					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal = SkinnedNormals[i] * weight.strength;
 
 				//*(weight._Pos) = thisVertexMove * weight.strength;
 			}
@@ -504,7 +510,7 @@ void CSkinnedMesh::SkinJoint(SJoint *joint, SJoint *parentJoint)
 				buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Pos += thisVertexMove * weight.strength;
 
 				if (AnimateNormals)
-					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal += thisNormalMove * weight.strength;
+					buffersUsed[weight.buffer_id]->getVertex(weight.vertex_id)->Normal += SkinnedNormals[i] * weight.strength;
 
 				//*(weight._Pos) += thisVertexMove * weight.strength;
 			}
@@ -186,6 +186,10 @@ private:
 
 		core::array< core::array<bool> > Vertices_Moved;
 
+		//! positions and normals of the weights of a joint, transformed all at once
+		core::array<core::vector3df> SkinnedPositions;
+		core::array<core::vector3df> SkinnedNormals;
+
 		f32 AnimationFrames;
 
 		f32 LastAnimatedFrame;
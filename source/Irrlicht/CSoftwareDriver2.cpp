@@ -28,7 +28,9 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<u32>& windowSiz
 : CNullDriver(io, windowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 )
+	 DepthBuffer(0), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 ),
+	PrimitivesRejected(0), PrimitivesRejectedLast(0), PrimitivesRejectedTotal(0),
+	PixelsDrawn(0.f), Overdraw(0.f)
 {
 	#ifdef _DEBUG
 	setDebugName("CBurningVideoDriver");
@@ -292,6 +294,14 @@ bool CBurningVideoDriver::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 	case EVDF_TEXTURE_NSQUARE:
 		return true;
 
+	// the textures decode compressed images block by block
+	case EVDF_TEXTURE_COMPRESSED_DXT:
+		return true;
+
+	// the vertex cache fetches u16 and u32 indices alike
+	case EVDF_INDEX_32BIT:
+		return true;
+
 	default:
 		return false;
 	}
@@ -357,6 +367,9 @@ bool CBurningVideoDriver::beginScene(bool backBuffer, bool zBuffer,
 		DepthBuffer->clear();
 
 	memset ( TransformationFlag, 0, sizeof ( TransformationFlag ) );
+
+	PrimitivesRejected = 0;
+	PixelsDrawn = 0.f;
 	return true;
 }
 
@@ -366,6 +379,10 @@ bool CBurningVideoDriver::endScene()
 {
 	CNullDriver::endScene();
 
+	PrimitivesRejectedLast = PrimitivesRejected;
+	PrimitivesRejectedTotal += PrimitivesRejected;
+	Overdraw = PixelsDrawn / (f32) core::max_ ( ScreenSize.getArea(), 1u );
+
 	return Presenter->present(BackBuffer, WindowId, SceneSourceRect);
 }
 
@@ -626,6 +643,28 @@ u32 CBurningVideoDriver::clipToFrustum ( s4DVertex *v0, s4DVertex * v1, const u3
 	return vOut;
 }
 
+//! clips only to the near and far plane, for triangles in the guard band
+u32 CBurningVideoDriver::clipToNearFar ( s4DVertex *v0, s4DVertex * v1, const u32 vIn )
+{
+	u32 vOut = vIn;
+
+	vOut = clipToHyperPlane ( v1, v0, vOut, NDCPlane[0] ); if ( vOut < vIn ) return vOut;
+	vOut = clipToHyperPlane ( v0, v1, vOut, NDCPlane[1] );
+	return vOut;
+}
+
+//! returns if the homogenous vertices of a triangle are in the guard band
+inline bool CBurningVideoDriver::isInGuardBand ( const s4DVertex **face ) const
+{
+	for ( u32 g = 0; g != 3; ++g )
+	{
+		const f32 w = face[g]->Pos.w * SOFTWARE_DRIVER_2_GUARDBAND;
+		if ( core::abs_ ( face[g]->Pos.x ) > w || core::abs_ ( face[g]->Pos.y ) > w )
+			return false;
+	}
+	return true;
+}
+
 /*!
  Part I:
 	apply Clip Scale matrix
@@ -749,6 +788,100 @@ inline f32 CBurningVideoDriver::screenarea2 ( const s4DVertex **v ) const
 			( (( v[1] + 1 )->Pos.y - (v[0] + 1 )->Pos.y ) * ( (v[2] + 1 )->Pos.x - (v[0] + 1 )->Pos.x ) );
 }
 
+/*!
+	screen area of a projected triangle inside of a rectangle
+*/
+static f32 screenarea_clipped ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c, const core::rect<s32> &clip )
+{
+	// clip the polygon against the four edges
+	core::vector2df v[2][8];
+	u32 count = 3;
+	v[0][0].set ( a->Pos.x, a->Pos.y );
+	v[0][1].set ( b->Pos.x, b->Pos.y );
+	v[0][2].set ( c->Pos.x, c->Pos.y );
+
+	const f32 edge[4] = { (f32) clip.UpperLeftCorner.X, (f32) clip.UpperLeftCorner.Y,
+						(f32) clip.LowerRightCorner.X, (f32) clip.LowerRightCorner.Y };
+
+	for ( u32 e = 0; e != 4 && count; ++e )
+	{
+		const core::vector2df *in = v[e & 1];
+		core::vector2df *out = v[ ( e & 1 ) ^ 1 ];
+		const f32 sign = e < 2 ? 1.f : -1.f;
+		u32 outCount = 0;
+
+		for ( u32 i = 0; i != count; ++i )
+		{
+			const core::vector2df &p = in[i];
+			const core::vector2df &q = in[ ( i + 1 ) % count ];
+			const f32 dp = ( ( e & 1 ) ? p.Y : p.X ) - edge[e];
+			const f32 dq = ( ( e & 1 ) ? q.Y : q.X ) - edge[e];
+
+			if ( dp * sign >= 0.f )
+				out[outCount++] = p;
+			if ( ( dp * sign >= 0.f ) != ( dq * sign >= 0.f ) )
+				out[outCount++] = p + ( q - p ) * ( dp / ( dp - dq ) );
+		}
+		count = outCount;
+	}
+
+	// the clipped polygon ends in the first array
+	f32 area = 0.f;
+	for ( u32 i = 0; i + 2 < count; ++i )
+	{
+		area += ( ( v[0][i+1].X - v[0][0].X ) * ( v[0][i+2].Y - v[0][0].Y ) ) -
+				( ( v[0][i+1].Y - v[0][0].Y ) * ( v[0][i+2].X - v[0][0].X ) );
+	}
+	return core::abs_ ( area ) * 0.5f;
+}
+
+/*!
+	pixels touched by a projected triangle
+*/
+inline core::rect<s32> CBurningVideoDriver::screenBox ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c ) const
+{
+	return core::rect<s32> (
+		core::floor32 ( core::min_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ),
+		core::floor32 ( core::min_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ),
+		core::floor32 ( core::max_ ( a->Pos.x, b->Pos.x, c->Pos.x ) ) + 1,
+		core::floor32 ( core::max_ ( a->Pos.y, b->Pos.y, c->Pos.y ) ) + 1 );
+}
+
+/*!
+	draws a projected triangle, unless it is behind the depth tiles
+*/
+inline void CBurningVideoDriver::rasterize ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c )
+{
+	core::rect<s32> box = screenBox ( a, b, c );
+
+	if ( CurrentShader->isDepthTested () )
+	{
+#ifdef SOFTWARE_DRIVER_2_USE_WBUFFER
+		const f32 nearest = core::max_ ( a->Pos.w, b->Pos.w, c->Pos.w );
+#else
+		const f32 nearest = core::min_ ( a->Pos.z, b->Pos.z, c->Pos.z );
+#endif
+		if ( DepthBuffer->isOccluded ( box, nearest ) )
+		{
+			PrimitivesRejected += 1;
+			return;
+		}
+	}
+
+	CurrentShader->drawTriangle ( a, b, c );
+	DepthBuffer->invalidateTiles ( box );
+
+	// triangles in the guard band are only drawn on the viewport
+	core::rect<s32> inside ( box );
+	inside.clipAgainst ( ViewPort );
+
+	if ( inside == box )
+		PixelsDrawn += core::abs_ ( ( ( b->Pos.x - a->Pos.x ) * ( c->Pos.y - a->Pos.y ) ) -
+						( ( b->Pos.y - a->Pos.y ) * ( c->Pos.x - a->Pos.x ) ) ) * 0.5f;
+	else
+		PixelsDrawn += screenarea_clipped ( a, b, c, ViewPort );
+}
+
 /*!
 */
 inline f32 CBurningVideoDriver::texelarea2 ( const s4DVertex **v, s32 tex ) const
@@ -851,6 +984,41 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 	const S3DVertex *base = ((S3DVertex*) source );
 	Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
 
+	VertexCache_fillAttributes ( dest, base );
+}
+
+
+/*!
+	transform, light and clip test all vertices from first to first + count - 1
+	at once. the positions are transformed in one pass over the vertices
+*/
+void CBurningVideoDriver::VertexCache_fillBatch ( const u32 first, const u32 count )
+{
+	VertexCache.batchStart = first;
+	VertexCache.batch.resize ( count << 1 );
+
+	const u32 pitch = vSize[VertexCache.vType].Pitch;
+	const u8 * source = (u8*) VertexCache.vertices + ( first * pitch );
+	s4DVertex *dest = VertexCache.batch.data;
+
+	// transform Model * World * Camera * Projection * NDCSpace matrix
+	Transformation [ ETS_CURRENT].transformVects ( &dest->Pos.x, (const core::vector3df*) source,
+		count, pitch, SIZEOF_SVERTEX * 2 );
+
+	for ( u32 i = 0; i != count; ++i )
+	{
+		VertexCache_fillAttributes ( dest, (const S3DVertex*) source );
+		source += pitch;
+		dest += 2;
+	}
+}
+
+
+/*!
+	light, texture and clip test a vertex with transformed position
+*/
+void CBurningVideoDriver::VertexCache_fillAttributes ( s4DVertex *dest, const S3DVertex *base )
+{
 
 #if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
 
@@ -1027,6 +1195,9 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 
 REALINLINE s4DVertex * CBurningVideoDriver::VertexCache_getVertex ( const u32 sourceIndex )
 {
+	if ( VertexCache.batched )
+		return VertexCache.batch.data + ( ( sourceIndex - VertexCache.batchStart ) << 1 );
+
 	for ( s32 i = 0; i < VERTEXCACHE_ELEMENT; ++i )
 	{
 		if ( VertexCache.info[ i ].index == sourceIndex )
@@ -1048,7 +1219,8 @@ REALINLINE void CBurningVideoDriver::VertexCache_get ( s4DVertex ** face )
 	SCacheInfo info[VERTEXCACHE_ELEMENT];
 
 	// next primitive must be complete in cache
-	if (	VertexCache.indicesIndex - VertexCache.indicesRun < 3 &&
+	if (	!VertexCache.batched &&
+			VertexCache.indicesIndex - VertexCache.indicesRun < 3 &&
 			VertexCache.indicesIndex < VertexCache.indexCount
 		)
 	{
@@ -1252,6 +1424,37 @@ void CBurningVideoDriver::VertexCache_reset ( const void* vertices, u32 vertexCo
 	}
 
 	irr::memset32 ( VertexCache.info, VERTEXCACHE_MISS, sizeof ( VertexCache.info ) );
+
+	// when the indices use most vertices between the lowest and the highest
+	// index, transform all of them at once instead of refilling the cache
+	u32 minIndex = 0xFFFFFFFF;
+	u32 maxIndex = 0;
+	u32 i;
+
+	if ( VertexCache.iType == 1 )
+	{
+		const u16 *p = (const u16 *) VertexCache.indices;
+		for ( i = 0; i != VertexCache.indexCount; ++i )
+		{
+			minIndex = core::min_ ( minIndex, (u32) p[i] );
+			maxIndex = core::max_ ( maxIndex, (u32) p[i] );
+		}
+	}
+	else
+	{
+		const u32 *p = (const u32 *) VertexCache.indices;
+		for ( i = 0; i != VertexCache.indexCount; ++i )
+		{
+			minIndex = core::min_ ( minIndex, p[i] );
+			maxIndex = core::max_ ( maxIndex, p[i] );
+		}
+	}
+
+	VertexCache.batched = VertexCache.indexCount &&
+		maxIndex < vertexCount && maxIndex - minIndex < VertexCache.indexCount;
+
+	if ( VertexCache.batched )
+		VertexCache_fillBatch ( minIndex, maxIndex - minIndex + 1 );
 }
 
 
@@ -1270,6 +1473,10 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
 
+	// hidden triangles are skipped with the depth of the last batches
+	if ( CurrentShader->isDepthTested () )
+		DepthBuffer->updateTiles ();
+
 	const s4DVertex * face[3];
 
 	f32 dc_area;
@@ -1288,9 +1495,17 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			)
 			continue;
 
-		// if fully inside
-		if ( ( face[0]->flag & face[1]->flag & face[2]->flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+		// if fully inside, or only outside of the viewport in the guard band
+		const u32 inside = face[0]->flag & face[1]->flag & face[2]->flag & VERTEX4D_CLIPMASK;
+		const bool guardBand = CurrentShader->canScissor () && isInGuardBand ( face );
+
+		if ( inside == VERTEX4D_INSIDE ||
+			( guardBand && ( inside & VERTEX4D_NEARFAR ) == VERTEX4D_NEARFAR ) )
 		{
+			// to DC Space, project homogenous vertex
+			if ( inside != VERTEX4D_INSIDE )
+				ndc_2_dc_and_project2 ( face, 3 );
+
 			dc_area = screenarea2 ( face );
 			if ( Material.org.BackfaceCulling && F32_LOWER_EQUAL_0( dc_area ) )
 				continue;
@@ -1317,7 +1532,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			}
 
 			// rasterize
-			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
+			rasterize ( face[0] + 1, face[1] + 1, face[2] + 1 );
 			continue;
 		}
 
@@ -1334,8 +1549,12 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			Temp.data[g].flag = flag;
 		}
 
+		// the shader clips the scanlines in the guard band
 		u32 vOut;
-		vOut = clipToFrustum ( CurrentOut.data, Temp.data, 3 );
+		if ( guardBand )
+			vOut = clipToNearFar ( CurrentOut.data, Temp.data, 3 );
+		else
+			vOut = clipToFrustum ( CurrentOut.data, Temp.data, 3 );
 /*
 		if ( vOut < 3 )
 		{
@@ -1437,7 +1656,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
 			// rasterize
-			CurrentShader->drawTriangle ( CurrentOut.data + 0 + 1,
+			rasterize ( CurrentOut.data + 0 + 1,
 							CurrentOut.data + g + 3,
 							CurrentOut.data + g + 5);
 		}
@@ -1727,10 +1946,10 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 
 		if (useAlphaChannelOfTexture)
 			((CSoftwareTexture2*)texture)->getImage()->copyToWithAlpha(
-				BackBuffer, destPos, sourceRect, color, clipRect);
+				RenderTargetSurface, destPos, sourceRect, color, clipRect);
 		else
 			((CSoftwareTexture2*)texture)->getImage()->copyTo(
-				BackBuffer, destPos, sourceRect, clipRect);
+				RenderTargetSurface, destPos, sourceRect, clipRect);
 	}
 }
 
@@ -1740,7 +1959,7 @@ void CBurningVideoDriver::draw2DLine(const core::position2d<s32>& start,
 					const core::position2d<s32>& end,
 					SColor color)
 {
-	BackBuffer->drawLine(start, end, color );
+	RenderTargetSurface->drawLine(start, end, color );
 }
 
 
@@ -1764,14 +1983,14 @@ void CBurningVideoDriver::draw2DRectangle(SColor color, const core::rect<s32>& p
 		if(!p.isValid())
 			return;
 
-		BackBuffer->drawRectangle(p, color);
+		RenderTargetSurface->drawRectangle(p, color);
 	}
 	else
 	{
 		if(!pos.isValid())
 			return;
 
-		BackBuffer->drawRectangle(pos, color);
+		RenderTargetSurface->drawRectangle(pos, color);
 	}
 }
 
@@ -1844,6 +2063,38 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 	const s32 yPlus = renderTargetSize.Height-(renderTargetSize.Height>>1);
 	const f32 yFact = 1.0f / (renderTargetSize.Height>>1);
 
+	f32 left = (f32)(pos.UpperLeftCorner.X+xPlus) * xFact;
+	f32 right = (f32)(pos.LowerRightCorner.X+xPlus) * xFact;
+	f32 top = (f32)(yPlus-pos.UpperLeftCorner.Y) * yFact;
+	f32 bottom = (f32)(yPlus-pos.LowerRightCorner.Y) * yFact;
+
+	// A clipped rectangle is rasterized as a whole with the clipping
+	// rectangle as frustum, so it keeps the gradient of the whole rectangle.
+	const core::matrix4 clipScale ( Transformation [ ETS_CLIPSCALE ] );
+	if ( pos != position )
+	{
+		if ( pos.getWidth() == 0 || pos.getHeight() == 0 )
+			return;
+
+		// device coordinates of the clipping rectangle
+		const f32 dcLeft = left * clipScale[0] + clipScale[12];
+		const f32 dcRight = right * clipScale[0] + clipScale[12];
+		const f32 dcTop = top * clipScale[5] + clipScale[13];
+		const f32 dcBottom = bottom * clipScale[5] + clipScale[13];
+
+		core::matrix4& m = Transformation [ ETS_CLIPSCALE ];
+		m[0] = ( dcRight - dcLeft ) * 0.5f;
+		m[12] = ( dcRight + dcLeft ) * 0.5f;
+		m[5] = ( dcTop - dcBottom ) * 0.5f;
+		m[13] = ( dcTop + dcBottom ) * 0.5f;
+
+		// whole rectangle relative to the clipping rectangle
+		left = ( ( (f32)(position.UpperLeftCorner.X+xPlus) * xFact * clipScale[0] + clipScale[12] ) - m[12] ) / m[0];
+		right = ( ( (f32)(position.LowerRightCorner.X+xPlus) * xFact * clipScale[0] + clipScale[12] ) - m[12] ) / m[0];
+		top = ( ( (f32)(yPlus-position.UpperLeftCorner.Y) * yFact * clipScale[5] + clipScale[13] ) - m[13] ) / m[5];
+		bottom = ( ( (f32)(yPlus-position.LowerRightCorner.Y) * yFact * clipScale[5] + clipScale[13] ) - m[13] ) / m[5];
+	}
+
 	// fill VertexCache direct
 	s4DVertex *v;
 
@@ -1856,16 +2107,16 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 
 	v = &VertexCache.mem.data [ 0 ];
 
-	v[0].Pos.set ( (f32)(pos.UpperLeftCorner.X+xPlus) * xFact, (f32)(yPlus-pos.UpperLeftCorner.Y) * yFact, 0.f, 1.f );
+	v[0].Pos.set ( left, top, 0.f, 1.f );
 	v[0].Color[0].setA8R8G8B8 ( colorLeftUp.color );
 
-	v[2].Pos.set ( (f32)(pos.LowerRightCorner.X+xPlus) * xFact, (f32)(yPlus- pos.UpperLeftCorner.Y) * yFact, 0.f, 1.f );
+	v[2].Pos.set ( right, top, 0.f, 1.f );
 	v[2].Color[0].setA8R8G8B8 ( colorRightUp.color );
 
-	v[4].Pos.set ( (f32)(pos.LowerRightCorner.X+xPlus) * xFact, (f32)(yPlus-pos.LowerRightCorner.Y) * yFact, 0.f ,1.f );
+	v[4].Pos.set ( right, bottom, 0.f ,1.f );
 	v[4].Color[0].setA8R8G8B8 ( colorRightDown.color );
 
-	v[6].Pos.set ( (f32)(pos.UpperLeftCorner.X+xPlus) * xFact, (f32)(yPlus-pos.LowerRightCorner.Y) * yFact, 0.f, 1.f );
+	v[6].Pos.set ( left, bottom, 0.f, 1.f );
 	v[6].Color[0].setA8R8G8B8 ( colorLeftDown.color );
 
 	s32 i;
@@ -1912,6 +2163,15 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 		memcpy ( CurrentOut.data + 2, face[1], sizeof ( s4DVertex ) * 2 );
 		memcpy ( CurrentOut.data + 4, face[2], sizeof ( s4DVertex ) * 2 );
 
+		// clipping reorders the vertices, so none of them is projected
+		// yet, and it has to interpolate the color
+		const u32 flag = VERTEX4D_FORMAT_COLOR_1;
+		for ( g = 0; g != CurrentOut.ElementSize; ++g )
+		{
+			CurrentOut.data[g].flag = flag;
+			Temp.data[g].flag = flag;
+		}
+
 		vOut = clipToFrustum ( CurrentOut.data, Temp.data, 3 );
 		if ( vOut < 3 )
 			continue;
@@ -1928,6 +2188,8 @@ void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 		}
 
 	}
+
+	Transformation [ ETS_CLIPSCALE ] = clipScale;
 #else
 	draw2DRectangle ( colorLeftUp, position, clip );
 #endif
@@ -1978,6 +2240,7 @@ void CBurningVideoDriver::draw3DLine(const core::vector3df& start,
 	{
 		// rasterize
 		line->drawLine ( CurrentOut.data + 1, CurrentOut.data + g + 3 );
+		DepthBuffer->invalidateTiles ( screenBox ( CurrentOut.data + 1, CurrentOut.data + g + 3, CurrentOut.data + g + 3 ) );
 	}
 }
 
@@ -2068,6 +2331,7 @@ ITexture* CBurningVideoDriver::createDeviceDependentTexture(IImage* surface, con
 	return new CSoftwareTexture2(
 		surface, name,
 		(getTextureCreationFlag(ETCF_CREATE_MIP_MAPS) ? CSoftwareTexture2::GEN_MIPMAP : 0 ) |
+		(getTextureCreationFlag(ETCF_GAMMA_CORRECT_MIP_MAPS) ? CSoftwareTexture2::GAMMA_MIPMAP : 0 ) |
 		(getTextureCreationFlag(ETCF_ALLOW_NON_POWER_2) ? 0 : CSoftwareTexture2::NP2_SIZE ), mipmapData);
 
 }
@@ -2169,6 +2433,20 @@ core::dimension2du CBurningVideoDriver::getMaxTextureSize() const
 }
 
 
+//! returns amount of triangles which were hidden in the last frame.
+u32 CBurningVideoDriver::getPrimitiveCountRejected( u32 param ) const
+{
+	return (0 == param) ? PrimitivesRejectedLast : PrimitivesRejectedTotal;
+}
+
+
+//! returns how often each pixel was drawn on average in the last frame.
+f32 CBurningVideoDriver::getOverdraw() const
+{
+	return Overdraw;
+}
+
+
 } // end namespace video
 } // end namespace irr
 
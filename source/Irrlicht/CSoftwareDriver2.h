@@ -157,6 +157,12 @@ namespace video
 		//! Returns the maximum texture size supported.
 		virtual core::dimension2du getMaxTextureSize() const;
 
+		//! returns amount of triangles which were hidden in the last frame.
+		virtual u32 getPrimitiveCountRejected( u32 param = 0 ) const;
+
+		//! returns how often each pixel was drawn on average in the last frame.
+		virtual f32 getOverdraw() const;
+
 	protected:
 
 
@@ -177,7 +183,7 @@ namespace video
 		core::rect<s32>* SceneSourceRect;
 
 		video::ITexture* RenderTargetTexture;
-		video::IImage* RenderTargetSurface;
+		video::CImage* RenderTargetSurface;
 		core::dimension2d<u32> RenderTargetSize;
 
 		//! selects the right triangle renderer based on the render states.
@@ -230,6 +236,8 @@ namespace video
 		void VertexCache_getbypass ( s4DVertex ** face );
 
 		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_fillBatch ( const u32 first, const u32 count );
+		void VertexCache_fillAttributes ( s4DVertex *dest, const S3DVertex *base );
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
 
@@ -237,6 +245,12 @@ namespace video
 		u32 clipToHyperPlane ( s4DVertex * dest, const s4DVertex * source, u32 inCount, const sVec4 &plane );
 		u32 clipToFrustumTest ( const s4DVertex * v  ) const;
 		u32 clipToFrustum ( s4DVertex *source, s4DVertex * temp, const u32 vIn );
+		u32 clipToNearFar ( s4DVertex *source, s4DVertex * temp, const u32 vIn );
+		bool isInGuardBand ( const s4DVertex **face ) const;
+
+		// depth tiles
+		core::rect<s32> screenBox ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c ) const;
+		void rasterize ( const s4DVertex *a, const s4DVertex *b, const s4DVertex *c );
 
 
 #ifdef SOFTWARE_DRIVER_2_LIGHTING
@@ -252,6 +266,13 @@ namespace video
 		SAlignedVertex CurrentOut;
 		SAlignedVertex Temp;
 
+		// statistics of the last frame, the current one and all frames
+		u32 PrimitivesRejected;
+		u32 PrimitivesRejectedLast;
+		u32 PrimitivesRejectedTotal;
+		f32 PixelsDrawn;
+		f32 Overdraw;
+
 		void ndc_2_dc_and_project ( s4DVertex *dest,s4DVertex *source, u32 vIn ) const;
 		f32 screenarea ( const s4DVertex *v0 ) const;
 		void select_polygon_mipmap ( s4DVertex *source, u32 vIn, u32 tex, const core::dimension2du& texSize );
@@ -8,6 +8,7 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
+#include "CColorConverter.h"
 #include "os.h"
 
 namespace irr
@@ -37,7 +38,8 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 
 		core::setbit_cond(Flags,
 				image->getColorFormat () == video::ECF_A8R8G8B8 ||
-				image->getColorFormat () == video::ECF_A1R5G5B5,
+				image->getColorFormat () == video::ECF_A1R5G5B5 ||
+				IImage::isCompressedFormat ( image->getColorFormat () ),
 				HAS_ALPHA);
 
 		core::dimension2d<u32> optSize(
@@ -65,6 +67,9 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 			os::Printer::log ( buf, ELL_WARNING );
 			MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, optSize);
 			image->copyToScalingBoxFilter ( MipMap[0],0, false );
+
+			// the prepared levels belong to the original size
+			mipmapData = 0;
 		}
 	}
 
@@ -107,6 +112,10 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 		newSize = MipMap[i-1]->getDimension();
 		newSize.Width = core::s32_max ( 1, newSize.Width >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
 		newSize.Height = core::s32_max ( 1, newSize.Height >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
+
+		// the prepared levels end with a single pixel
+		if (origSize.Width == 1 && origSize.Height == 1)
+			mipmapData = 0;
 		origSize.Width = core::s32_max(1, origSize.Width >> 1);
 		origSize.Height = core::s32_max(1, origSize.Height >> 1);
 
@@ -134,13 +143,23 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 					tmpImage->drop();
 				}
 			}
-			mipmapData = (u8*)mipmapData+origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
+			mipmapData = (u8*)mipmapData+IImage::getDataSizeFromFormat(OriginalFormat, origSize.Width, origSize.Height);
 		}
 		else
 		{
 			MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
+#if SOFTWARE_DRIVER_2_MIPMAPPING_SCALE == 1
+			// each level is averaged from the previous one
+			const core::dimension2d<u32>& size = MipMap[i-1]->getDimension();
+			CColorConverter::createMipMapLevel(MipMap[i-1]->lock(), BURNINGSHADER_COLOR_FORMAT,
+					size.Width, size.Height, MipMap[i-1]->getPitch(),
+					MipMap[i]->lock(), MipMap[i]->getPitch(), (Flags & GAMMA_MIPMAP) != 0);
+			MipMap[i]->unlock();
+			MipMap[i-1]->unlock();
+#else
 			MipMap[i]->fill ( 0 );
 			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+#endif
 		}
 	}
 }
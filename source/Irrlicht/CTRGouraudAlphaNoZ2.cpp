@@ -86,6 +86,13 @@ public:
 	//! draws an indexed triangle list
 	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
 
+#ifdef SUBTEXEL
+	virtual bool canScissor () const { return true; }
+#endif
+#if defined ( CMP_W ) || defined ( CMP_Z )
+	virtual bool isDepthTested () const { return true; }
+#endif
+
 
 private:
 	void scanline_bilinear ();
@@ -144,6 +151,10 @@ void CTRGouraudAlphaNoZ2::scanline_bilinear ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -369,6 +380,10 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 		yStart = core::ceil32( a->Pos.y );
 		yEnd = core::ceil32( b->Pos.y ) - 1;
 
+		// scissor to the viewport
+		yStart = core::s32_max ( yStart, Scissor.UpperLeftCorner.Y );
+		yEnd = core::s32_min ( yEnd, Scissor.LowerRightCorner.Y - 1 );
+
 #ifdef SUBTEXEL
 		subPixel = ( (f32) yStart ) - a->Pos.y;
 
@@ -528,6 +543,10 @@ void CTRGouraudAlphaNoZ2::drawTriangle ( const s4DVertex *a,const s4DVertex *b,c
 		yStart = core::ceil32( b->Pos.y );
 		yEnd = core::ceil32( c->Pos.y ) - 1;
 
+		// scissor to the viewport
+		yStart = core::s32_max ( yStart, Scissor.UpperLeftCorner.Y );
+		yEnd = core::s32_min ( yEnd, Scissor.LowerRightCorner.Y - 1 );
+
 #ifdef SUBTEXEL
 
 		subPixel = ( (f32) yStart ) - b->Pos.y;
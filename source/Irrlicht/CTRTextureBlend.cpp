@@ -86,6 +86,10 @@ public:
 	//! draws an indexed triangle list
 	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
 
+#ifdef SUBTEXEL
+	virtual bool canScissor () const { return true; }
+#endif
+
 	virtual void setZCompareFunc ( u32 func);
 	virtual void setParam ( u32 index, f32 value);
 
@@ -258,6 +262,10 @@ void CTRTextureBlend::fragment_dst_color_src_alpha ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -442,6 +450,10 @@ void CTRTextureBlend::fragment_src_color_src_alpha ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -622,6 +634,10 @@ void CTRTextureBlend::fragment_one_one_minus_src_alpha()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -819,6 +835,10 @@ void CTRTextureBlend::fragment_one_minus_dst_alpha_one ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -1015,6 +1035,10 @@ void CTRTextureBlend::fragment_src_alpha_one ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -1242,6 +1266,10 @@ void CTRTextureBlend::fragment_dst_color_one_minus_dst_alpha ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -1438,6 +1466,10 @@ void CTRTextureBlend::fragment_dst_color_zero ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -1632,6 +1664,10 @@ void CTRTextureBlend::fragment_dst_color_one ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -1829,6 +1865,10 @@ void CTRTextureBlend::fragment_zero_one_minus_scr_color ()
 	xStart = core::ceil32( line.x[0] );
 	xEnd = core::ceil32( line.x[1] ) - 1;
 
+	// scissor to the viewport
+	xStart = core::s32_max ( xStart, Scissor.UpperLeftCorner.X );
+	xEnd = core::s32_min ( xEnd, Scissor.LowerRightCorner.X - 1 );
+
 	dx = xEnd - xStart;
 
 	if ( dx < 0 )
@@ -2095,6 +2135,10 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 		yStart = core::ceil32( a->Pos.y );
 		yEnd = core::ceil32( b->Pos.y ) - 1;
 
+		// scissor to the viewport
+		yStart = core::s32_max ( yStart, Scissor.UpperLeftCorner.Y );
+		yEnd = core::s32_min ( yEnd, Scissor.LowerRightCorner.Y - 1 );
+
 #ifdef SUBTEXEL
 		subPixel = ( (f32) yStart ) - a->Pos.y;
 
@@ -2254,6 +2298,10 @@ void CTRTextureBlend::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const
 		yStart = core::ceil32( b->Pos.y );
 		yEnd = core::ceil32( c->Pos.y ) - 1;
 
+		// scissor to the viewport
+		yStart = core::s32_max ( yStart, Scissor.UpperLeftCorner.Y );
+		yEnd = core::s32_min ( yEnd, Scissor.LowerRightCorner.Y - 1 );
+
 #ifdef SUBTEXEL
 
 		subPixel = ( (f32) yStart ) - b->Pos.y;
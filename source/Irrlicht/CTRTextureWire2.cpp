@@ -83,6 +83,10 @@ public:
 	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
 	virtual void drawLine ( const s4DVertex *a,const s4DVertex *b);
 
+#if defined ( CMP_W ) || defined ( CMP_Z )
+	virtual bool isDepthTested () const { return true; }
+#endif
+
 
 
 private:
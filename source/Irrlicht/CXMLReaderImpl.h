@@ -10,6 +10,10 @@
 #include "irrArray.h"
 #include "fast_atof.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 #ifdef _DEBUG
 #define IRR_DEBUGPRINT(x) printf((x));
 #else // _DEBUG 
@@ -24,6 +28,10 @@ namespace io
 
 
 //! implementation of the IrrXMLReader
+/** The reader parses in place: Node names, attribute names and attribute
+values are terminated directly inside the text buffer and returned as pointers
+into it, so no strings are created while reading. Special characters are only
+decoded for values which contain a '&'. */
 template<class char_type, class superclass>
 class CXMLReaderImpl : public IIrrXMLReader<char_type, superclass>
 {
@@ -32,8 +40,11 @@ public:
 	//! Constructor
 	CXMLReaderImpl(IFileReadCallBack* callback, bool deleteCallBack = true)
 		: TextData(0), P(0), TextBegin(0), TextSize(0), CurrentNodeType(EXN_NONE),
-		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII)
+		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), NodeName(EmptyString),
+		IsEmptyElement(false), TagPending(false)
 	{
+		EmptyString[0] = 0;
+
 		if (!callback)
 			return;
 
@@ -48,10 +59,6 @@ public:
 		if (deleteCallBack)
 			delete callback;
 
-		// create list with special characters
-
-		createSpecialCharacterList();
-
 		// set pointer to text begin
 		P = TextBegin;
 	}
@@ -99,7 +106,7 @@ public:
 		if ((u32)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return Attributes[idx].Name;
 	}
 
 
@@ -109,7 +116,7 @@ public:
 		if ((unsigned int)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return Attributes[idx].Value;
 	}
 
 
@@ -120,7 +127,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -129,9 +136,9 @@ public:
 	{
 		const SAttribute* attr = getAttributeByName(name);
 		if (!attr)
-			return EmptyString.c_str();
+			return EmptyString;
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -157,8 +164,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c = attr->Value.c_str();
-		return core::fast_atof(c.c_str());
+		return toFloat(attr->Value);
 	}
 
 
@@ -169,22 +175,21 @@ public:
 		if (!attrvalue)
 			return 0;
 
-		core::stringc c = attrvalue;
-		return core::fast_atof(c.c_str());
+		return toFloat(attrvalue);
 	}
 
 
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const
 	{
-		return NodeName.c_str();
+		return NodeName;
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const
 	{
-		return NodeName.c_str();
+		return NodeName;
 	}
 
 
@@ -212,24 +217,34 @@ private:
 	// return false if no further node is found
 	bool parseCurrentNode()
 	{
-		char_type* start = P;
+		if (!TagPending)
+		{
+			char_type* start = P;
+			bool hasSpecialCharacters = false;
 
-		// more forward until '<' found
-		while(*P != L'<' && *P)
-			++P;
+			// more forward until '<' found
+			P = findChar(P, L'<', L'&');
+			while (*P == L'&')
+			{
+				hasSpecialCharacters = true;
+				P = findChar(P+1, L'<', L'&');
+			}
 
-		// not a node, so return false
-		if (!*P)
-			return false;
+			// not a node, so return false
+			if (!*P)
+				return false;
 
-		if (P - start > 0)
-		{
-			// we found some text, store it
-			if (setText(start, P))
-				return true;
+			if (P - start > 0)
+			{
+				// we found some text, store it
+				if (setText(start, P, hasSpecialCharacters))
+					return true;
+			}
+
+			++P;
 		}
 
-		++P;
+		TagPending = false;
 
 		// based on current token, parse and report next element
 		switch(*P)
@@ -253,7 +268,7 @@ private:
 
 
 	//! sets the state that text was found. Returns true if set should be set
-	bool setText(char_type* start, char_type* end)
+	bool setText(char_type* start, char_type* end, bool hasSpecialCharacters)
 	{
 		// check if text is more than 2 characters, and if not, check if there is 
 		// only white space, so that this text won't be reported
@@ -268,9 +283,17 @@ private:
 				return false;
 		}
 
-		// set current text to the parsed text, and replace xml special characters
-		core::string<char_type> s(start, (int)(end - start));
-		NodeName = replaceSpecialCharacters(s);
+		// the text is terminated where the '<' of the next tag is, so
+		// remember that this tag has already been found.
+		P = end + 1;
+		TagPending = true;
+
+		// replace xml special characters
+		if (hasSpecialCharacters)
+			end = replaceSpecialCharacters(start, end);
+
+		*end = 0;
+		NodeName = start;
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -286,10 +309,10 @@ private:
 		CurrentNodeType = EXN_UNKNOWN;
 
 		// move until end marked with '>' reached
-		while(*P != L'>')
-			++P;
+		P = findChar(P, L'>', L'>');
 
-		++P;
+		if (*P)
+			++P;
 	}
 
 
@@ -306,18 +329,32 @@ private:
 		// move until end of comment reached
 		while(count)
 		{
+			P = findChar(P, L'>', L'<');
+
+			if (!*P) // malformatted xml file
+			{
+				NodeName = EmptyString;
+				return;
+			}
+
 			if (*P == L'>')
 				--count;
 			else
-			if (*P == L'<')
 				++count;
 
 			++P;
 		}
 
-		P -= 3;
-		NodeName = core::string<char_type>(pCommentBegin+2, (int)(P - pCommentBegin-2));
-		P += 3;
+		char_type* pCommentEnd = P - 3;
+		pCommentBegin += 2;
+
+		if (pCommentEnd >= pCommentBegin)
+		{
+			*pCommentEnd = 0;
+			NodeName = pCommentBegin;
+		}
+		else
+			NodeName = EmptyString;
 	}
 
 
@@ -326,19 +363,19 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		// find name
-		const char_type* startName = P;
+		char_type* startName = P;
 
 		// find end of element
-		while(*P != L'>' && !isWhiteSpace(*P))
+		while(*P != L'>' && !isWhiteSpace(*P) && *P)
 			++P;
 
-		const char_type* endName = P;
+		char_type* endName = P;
 
 		// find Attributes
-		while(*P != L'>')
+		while(*P != L'>' && *P)
 		{
 			if (isWhiteSpace(*P))
 				++P;
@@ -349,12 +386,15 @@ private:
 					// we've got an attribute
 
 					// read the attribute names
-					const char_type* attributeNameBegin = P;
+					char_type* attributeNameBegin = P;
 
-					while(!isWhiteSpace(*P) && *P != L'=')
+					while(!isWhiteSpace(*P) && *P != L'=' && *P)
 						++P;
 
-					const char_type* attributeNameEnd = P;
+					if (!*P) // malformatted xml file
+						return;
+
+					char_type* attributeNameEnd = P;
 					++P;
 
 					// read the attribute value
@@ -368,25 +408,32 @@ private:
 					const char_type attributeQuoteChar = *P;
 
 					++P;
-					const char_type* attributeValueBegin = P;
-					
-					while(*P != attributeQuoteChar && *P)
-						++P;
+					char_type* attributeValueBegin = P;
+					bool hasSpecialCharacters = false;
+
+					P = findChar(P, attributeQuoteChar, L'&');
+					while (*P == L'&')
+					{
+						hasSpecialCharacters = true;
+						P = findChar(P+1, attributeQuoteChar, L'&');
+					}
 
 					if (!*P) // malformatted xml file
 						return;
 
-					const char_type* attributeValueEnd = P;
+					char_type* attributeValueEnd = P;
 					++P;
 
-					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin, 
-						(int)(attributeNameEnd - attributeNameBegin));
+					// both delimiters are behind us now, so terminate the strings in place
+					*attributeNameEnd = 0;
 
-					core::string<char_type> s(attributeValueBegin, 
-						(int)(attributeValueEnd - attributeValueBegin));
+					if (hasSpecialCharacters)
+						attributeValueEnd = replaceSpecialCharacters(attributeValueBegin, attributeValueEnd);
+					*attributeValueEnd = 0;
 
-					attr.Value = replaceSpecialCharacters(s);
+					SAttribute attr;
+					attr.Name = attributeNameBegin;
+					attr.Value = attributeValueBegin;
 					Attributes.push_back(attr);
 				}
 				else
@@ -406,10 +453,15 @@ private:
 			IsEmptyElement = true;
 			endName--;
 		}
-		
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
 
-		++P;
+		// P is either at the closing '>' or at the end of the text
+		const bool endReached = (*P == 0);
+
+		*endName = 0;
+		NodeName = startName;
+
+		if (!endReached)
+			++P;
 	}
 
 
@@ -418,16 +470,20 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		++P;
-		const char_type* pBeginClose = P;
+		char_type* pBeginClose = P;
 
-		while(*P != L'>')
-			++P;
+		P = findChar(P, L'>', L'>');
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
-		++P;
+		NodeName = pBeginClose;
+
+		if (*P)
+		{
+			*P = 0;
+			++P;
+		}
 	}
 
 	//! parses a possible CDATA section, returns false if begin was not a CDATA section
@@ -447,7 +503,10 @@ private:
 		}
 
 		if (!*P)
+		{
+			NodeName = EmptyString;
 			return true;
+		}
 
 		char_type *cDataBegin = P;
 		char_type *cDataEnd = 0;
@@ -455,9 +514,12 @@ private:
 		// find end of CDATA
 		while(*P && !cDataEnd)
 		{
-			if (*P == L'>' && 
-			   (*(P-1) == L']') &&
-			   (*(P-2) == L']'))
+			P = findChar(P, L'>', L'>');
+			if (!*P)
+				break;
+
+			if ((*(P-1) == L']') &&
+				(*(P-2) == L']'))
 			{
 				cDataEnd = P - 2;
 			}
@@ -466,9 +528,12 @@ private:
 		}
 
 		if ( cDataEnd )
-			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
+		{
+			*cDataEnd = 0;
+			NodeName = cDataBegin;
+		}
 		else
-			NodeName = "";
+			NodeName = EmptyString;
 
 		return true;
 	}
@@ -477,8 +542,8 @@ private:
 	// structure for storing attribute-name pairs
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		const char_type* Name;
+		const char_type* Value;
 	};
 
 	// finds a current attribute by name, returns 0 if not found
@@ -487,64 +552,116 @@ private:
 		if (!name)
 			return 0;
 
-		core::string<char_type> n = name;
-
 		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
+			if (equals(Attributes[i].Name, name))
 				return &Attributes[i];
 
 		return 0;
 	}
 
-	// replaces xml special characters in a string and creates a new one
-	core::string<char_type> replaceSpecialCharacters(
-		core::string<char_type>& origstr)
+	//! converts a string of the current character format to float
+	static float toFloat(const char_type* str)
 	{
-		int pos = origstr.findFirst(L'&');
-		int oldPos = 0;
+		// no conversion needed for ASCII and UTF-8
+		if (sizeof(char_type) == 1)
+			return core::fast_atof(reinterpret_cast<const c8*>(str));
 
-		if (pos == -1)
-			return origstr;
+		core::stringc c = str;
+		return core::fast_atof(c.c_str());
+	}
 
-		core::string<char_type> newstr;
+	// replaces xml special characters in place
+	/** Replaced strings are never longer than the original ones, so
+	this can work directly on the text buffer.
+	\return New end of the string. */
+	char_type* replaceSpecialCharacters(char_type* start, char_type* end)
+	{
+		// list of strings containing special symbols, 
+		// the first character is the special character,
+		// the following is the symbol string without trailing &.
+		static const c8* const specialCharacters[] =
+			{ "&amp;", "<lt;", ">gt;", "\"quot;", "'apos;" };
+		const u32 specialCharacterCount = sizeof(specialCharacters)/sizeof(specialCharacters[0]);
 
-		while(pos != -1 && pos < (int)origstr.size()-2)
+		char_type* out = start;
+		while (start != end)
 		{
-			// check if it is one of the special characters
-
-			int specialChar = -1;
-			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
+			if (*start == L'&')
 			{
-				const char_type* p = &origstr.c_str()[pos]+1;
+				u32 i=0;
+				s32 len = 0;
+				for (; i<specialCharacterCount; ++i)
+				{
+					len = matchSymbol(start+1, end, specialCharacters[i]+1);
+					if (len)
+						break;
+				}
 
-				if (equalsn(&SpecialCharacters[i][1], p, SpecialCharacters[i].size()-1))
+				if (i != specialCharacterCount)
 				{
-					specialChar = i;
-					break;
+					*out++ = (char_type)specialCharacters[i][0];
+					start += len + 1;
+					continue;
 				}
 			}
 
-			if (specialChar != -1)
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos));
-				newstr.append(SpecialCharacters[specialChar][0]);
-				pos += SpecialCharacters[specialChar].size();
-			}
-			else
+			*out++ = *start++;
+		}
+
+		return out;
+	}
+
+
+	//! returns the length of the symbol if the text at p starts with it, 0 otherwise
+	static s32 matchSymbol(const char_type* p, const char_type* end, const c8* symbol)
+	{
+		s32 i=0;
+		for (; symbol[i]; ++i)
+			if (p+i == end || p[i] != (char_type)symbol[i])
+				return 0;
+
+		return i;
+	}
+
+
+	//! returns the first position at or after p which contains c1, c2 or the terminating 0
+	/** The text buffer is padded with zeros, so that 16 characters can
+	always be read at once from every position inside of it. */
+	static char_type* findChar(char_type* p, char_type c1, char_type c2)
+	{
+#ifdef _IRR_COMPILE_WITH_SSE2_
+		if (sizeof(char_type) == 1)
+		{
+			const __m128i v1 = _mm_set1_epi8((char)c1);
+			const __m128i v2 = _mm_set1_epi8((char)c2);
+			const __m128i zero = _mm_setzero_si128();
+
+			for (;;)
 			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos + 1));
-				pos += 1;
-			}
+				const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				const __m128i hits = _mm_or_si128(_mm_or_si128(
+						_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)),
+						_mm_cmpeq_epi8(chunk, zero));
 
-			// find next &
-			oldPos = pos;
-			pos = origstr.findNext(L'&', pos);		
-		}
+				u32 mask = (u32)_mm_movemask_epi8(hits);
+				if (mask)
+				{
+					while (!(mask & 1))
+					{
+						mask >>= 1;
+						++p;
+					}
+					return p;
+				}
 
-		if (oldPos < (int)origstr.size()-1)
-			newstr.append(origstr.subString(oldPos, origstr.size()-oldPos));
+				p += 16;
+			}
+		}
+#endif
+		while(*p != c1 && *p != c2 && *p)
+			++p;
 
-		return newstr;
+		return p;
 	}
 
 
@@ -555,12 +672,14 @@ private:
 		long size = callback->getSize();		
 		if (size<0)
 			return false;
-		size += 4; // We need four terminating 0's at the end.
-		           // For ASCII we need 1 0's, for UTF-16 2, for UTF-32 4.
+		// add TEXT_PADDING zeros at the end: they terminate the text in
+		// every format (ASCII needs 1, UTF-16 2 and UTF-32 4 of them)
+		// and allow findChar() to read 16 bytes at once
+		size += TEXT_PADDING;
 
 		char* data8 = new char[size];
 
-		if (!callback->read(data8, size-4))
+		if (!callback->read(data8, size-TEXT_PADDING))
 		{
 			delete [] data8;
 			return false;
@@ -568,7 +687,7 @@ private:
 
 		// add zeros at end
 
-		memset(data8+size-4, 0, 4);
+		memset(data8+size-TEXT_PADDING, 0, TEXT_PADDING);
 
 		char16* data16 = reinterpret_cast<char16*>(data8);
 		char32* data32 = reinterpret_cast<char32*>(data8);	
@@ -657,11 +776,13 @@ private:
 			// copies bytes. This is a problem when there are 
 			// unicode symbols using more than one character.
 
-			TextData = new char_type[sizeWithoutHeader];
+			TextData = new char_type[sizeWithoutHeader + TEXT_PADDING];
 
 			for (int i=0; i<sizeWithoutHeader; ++i)
 				TextData[i] = (char_type)source[i];
 
+			memset(TextData+sizeWithoutHeader, 0, TEXT_PADDING*sizeof(char_type));
+
 			TextBegin = TextData;
 			TextSize = sizeWithoutHeader;
 
@@ -716,33 +837,16 @@ private:
 	}
 
 
-	//! generates a list with xml special characters
-	void createSpecialCharacterList()
-	{
-		// list of strings containing special symbols, 
-		// the first character is the special character,
-		// the following is the symbol string without trailing &.
-
-		SpecialCharacters.push_back("&amp;");
-		SpecialCharacters.push_back("<lt;");
-		SpecialCharacters.push_back(">gt;");
-		SpecialCharacters.push_back("\"quot;");
-		SpecialCharacters.push_back("'apos;");
-		
-	}
-
-
-	//! compares the first n characters of the strings
-	bool equalsn(const char_type* str1, const char_type* str2, int len)
+	//! compares two zero terminated strings
+	static bool equals(const char_type* str1, const char_type* str2)
 	{
-		int i;
-		for(i=0; str1[i] && str2[i] && i < len; ++i)
-			if (str1[i] != str2[i])
-				return false;
+		while (*str1 && *str1 == *str2)
+		{
+			++str1;
+			++str2;
+		}
 
-		// if one (or both) of the strings was smaller then they
-		// are only equal if they have the same lenght
-		return (i == len) || (str1[i] == 0 && str2[i] == 0);
+		return *str1 == *str2;
 	}
 
 
@@ -769,6 +873,10 @@ private:
 	}
 
 
+	//! amount of zeros added behind the text, in bytes for the file data
+	//! and in characters for converted text
+	enum { TEXT_PADDING = 16 };
+
 	// instance variables:
 
 	char_type* TextData;         // data block of the text file
@@ -780,14 +888,13 @@ private:
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in
-	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
+	char_type EmptyString[1];    // empty string to be returned by getSafe() methods
+	const char_type* NodeName;   // name of the node currently in, points into the text
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
+	bool TagPending;           // the '<' of the next tag was already consumed by a text node
 
-	core::array< core::string<char_type> > SpecialCharacters; // see createSpecialCharacterList()
-
-	core::array<SAttribute> Attributes; // attributes of current element
+	core::array<SAttribute> Attributes; // attributes of current element, point into the text
 	
 }; // end CXMLReaderImpl
 
@@ -16,6 +16,14 @@
 #include "IFileSystem.h"
 #include "IReadFile.h"
 
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#ifndef _IRR_USE_NON_SYSTEM_ZLIB_
+	#include <zlib.h> // use system lib
+	#else
+	#include "zlib/zlib.h"
+	#endif
+#endif
+
 #ifdef _DEBUG
 #define _XREADER_DEBUG
 #endif
@@ -165,54 +173,64 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 
 		#ifdef BETTER_MESHBUFFER_SPLITTING_FOR_X
 		{
-			//the same vertex can be used in many different meshbuffers, but it's slow to work out
+			//the same vertex can be used in many different meshbuffers
+			//the buffers of each vertex are stored in one flat array: those
+			//of vertex i start at linkStart[i] and there are linkCount[i]
+			//of them, linkIndex holds the index of the copy in each buffer
 
-			core::array< core::array< u32 > > verticesLinkIndex;
-			verticesLinkIndex.reallocate(mesh->Vertices.size());
-			core::array< core::array< u16 > > verticesLinkBuffer;
-			verticesLinkBuffer.reallocate(mesh->Vertices.size());
+			core::array< u32 > linkStart;
+			linkStart.set_used(mesh->Vertices.size()+1);
+			core::array< u32 > linkCount;
+			linkCount.set_used(mesh->Vertices.size());
 
+			// each corner of a face can add at most one buffer to its vertex,
+			// unused vertices are put into the first buffer
+			for (i=0;i<mesh->Vertices.size();++i)
+				linkCount[i]=0;
+			for (i=0;i<mesh->Indices.size();++i)
+				++linkCount[ mesh->Indices[i] ];
+			linkStart[0]=0;
 			for (i=0;i<mesh->Vertices.size();++i)
 			{
-				verticesLinkIndex.push_back( core::array< u32 >() );
-				verticesLinkBuffer.push_back( core::array< u16 >() );
+				linkStart[i+1]=linkStart[i]+core::max_(linkCount[i], 1u);
+				linkCount[i]=0;
 			}
 
+			core::array< u16 > linkBuffer;
+			linkBuffer.set_used(linkStart.getLast());
+			core::array< u32 > linkIndex;
+			linkIndex.set_used(linkStart.getLast());
+
 			for (i=0;i<mesh->FaceMaterialIndices.size();++i)
 			{
+				const u16 bufferID = (u16)mesh->FaceMaterialIndices[i];
 				for (u32 id=i*3+0;id<=i*3+2;++id)
 				{
-					core::array< u16 > &Array=verticesLinkBuffer[ mesh->Indices[id] ];
-					bool found=false;
-
-					for (u32 j=0; j < Array.size(); ++j)
-					{
-						if (Array[j]==mesh->FaceMaterialIndices[i])
-						{
-							found=true;
-							break;
-						}
-					}
-
-					if (!found)
-						Array.push_back( mesh->FaceMaterialIndices[i] );
+					const u32 v = mesh->Indices[id];
+					u16* links = &linkBuffer[linkStart[v]];
+					u32 j=0;
+					while (j<linkCount[v] && links[j]!=bufferID)
+						++j;
+					if (j==linkCount[v])
+						links[linkCount[v]++]=bufferID;
 				}
 			}
 
-			for (i=0;i<verticesLinkBuffer.size();++i)
+			for (i=0;i<mesh->Vertices.size();++i)
 			{
-				if (!verticesLinkBuffer[i].size())
-					verticesLinkBuffer[i].push_back(0);
+				if (!linkCount[i])
+				{
+					linkBuffer[linkStart[i]]=0;
+					linkCount[i]=1;
+				}
 			}
 
 			for (i=0;i<mesh->Vertices.size();++i)
 			{
-				core::array< u16 > &Array = verticesLinkBuffer[i];
-				verticesLinkIndex[i].reallocate(Array.size());
-				for (u32 j=0; j < Array.size(); ++j)
+				for (u32 j=linkStart[i]; j < linkStart[i]+linkCount[i]; ++j)
 				{
-					scene::SSkinMeshBuffer *buffer = mesh->Buffers[ Array[j] ];
-					verticesLinkIndex[i].push_back( buffer->Vertices_Standard.size() );
+					scene::SSkinMeshBuffer *buffer = mesh->Buffers[ linkBuffer[j] ];
+					linkIndex[j] = buffer->Vertices_Standard.size();
 					buffer->Vertices_Standard.push_back( mesh->Vertices[i] );
 				}
 			}
@@ -223,12 +241,11 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 
 				for (u32 id=i*3+0;id<=i*3+2;++id)
 				{
-					core::array< u16 > &Array=verticesLinkBuffer[ mesh->Indices[id] ];
-
-					for (u32 j=0;j< Array.size() ;++j)
+					const u32 v = mesh->Indices[id];
+					for (u32 j=linkStart[v]; j < linkStart[v]+linkCount[v]; ++j)
 					{
-						if ( Array[j]== mesh->FaceMaterialIndices[i] )
-							buffer->Indices.push_back( verticesLinkIndex[ mesh->Indices[id] ][j] );
+						if ( linkBuffer[j]== mesh->FaceMaterialIndices[i] )
+							buffer->Indices.push_back( linkIndex[j] );
 					}
 				}
 			}
@@ -240,27 +257,24 @@ bool CXMeshFileLoader::load(io::IReadFile* file)
 
 				u32 id = weight.vertex_id;
 
-				if (id>=verticesLinkIndex.size())
+				if (id>=mesh->Vertices.size())
 				{
 					os::Printer::log("X loader: Weight id out of range", ELL_WARNING);
 					id=0;
 					weight.strength=0.f;
 				}
 
-				if (verticesLinkBuffer[id].size()==1)
-				{
-					weight.vertex_id=verticesLinkIndex[id][0];
-					weight.buffer_id=verticesLinkBuffer[id][0];
-				}
-				else if (verticesLinkBuffer[id].size() != 0)
+				// adding weights can move the weight of this vertex
+				const f32 strength = weight.strength;
+				const u32 first = linkStart[id];
+				weight.vertex_id=linkIndex[first];
+				weight.buffer_id=linkBuffer[first];
+				for (u32 k=first+1; k < first+linkCount[id]; ++k)
 				{
-					for (u32 k=1; k < verticesLinkBuffer[id].size(); ++k)
-					{
-						ISkinnedMesh::SWeight* WeightClone = AnimatedMesh->addWeight(joint);
-						WeightClone->strength = weight.strength;
-						WeightClone->vertex_id = verticesLinkIndex[id][k];
-						WeightClone->buffer_id = verticesLinkBuffer[id][k];
-					}
+					ISkinnedMesh::SWeight* WeightClone = AnimatedMesh->addWeight(joint);
+					WeightClone->strength = strength;
+					WeightClone->vertex_id = linkIndex[k];
+					WeightClone->buffer_id = linkBuffer[k];
 				}
 			}
 		}
@@ -423,13 +437,24 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 	MinorVersion = core::strtol10(tmp);
 
 	//! read format
+	bool compressed = false;
 	if (strncmp(&Buffer[8], "txt ", 4) ==0)
 		BinaryFormat = false;
 	else if (strncmp(&Buffer[8], "bin ", 4) ==0)
 		BinaryFormat = true;
+	else if (strncmp(&Buffer[8], "tzip", 4) ==0)
+	{
+		BinaryFormat = false;
+		compressed = true;
+	}
+	else if (strncmp(&Buffer[8], "bzip", 4) ==0)
+	{
+		BinaryFormat = true;
+		compressed = true;
+	}
 	else
 	{
-		os::Printer::log("Only uncompressed x files currently supported.", ELL_WARNING);
+		os::Printer::log("Unknown format of x file.", ELL_WARNING);
 		return false;
 	}
 	BinaryNumCount=0;
@@ -447,6 +472,9 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 
 	P = &Buffer[16];
 
+	if (compressed && !decompressFile())
+		return false;
+
 	readUntilEndOfLine();
 	FilePath = FileSystem->getFileDir(file->getFileName()) + "/";
 
@@ -454,6 +482,85 @@ bool CXMeshFileLoader::readFileIntoMemory(io::IReadFile* file)
 }
 
 
+//! replaces the buffer of a compressed file by the decompressed data
+bool CXMeshFileLoader::decompressFile()
+{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	// the header is followed by the size of the decompressed file and
+	// MSZIP blocks. Each block starts with its decompressed and compressed
+	// size, followed by the signature "CK" and deflated data, for which
+	// the previous block is the dictionary.
+	if (End - P < 4)
+		return false;
+	P += 4;
+
+	// count the decompressed size of the blocks
+	u32 size = 0;
+	const c8* block = P;
+	while (End - block >= 6)
+	{
+		const u32 compressedSize = (u8)block[2] | ((u8)block[3] << 8);
+		if (compressedSize < 2 || block[4] != 'C' || block[5] != 'K' ||
+			(u32)(End - block - 4) < compressedSize)
+		{
+			os::Printer::log("Invalid block in compressed x file.", ELL_WARNING);
+			return false;
+		}
+		size += (u8)block[0] | ((u8)block[1] << 8);
+		block += 4 + compressedSize;
+	}
+
+	// the decompressed data follows a copy of the header, so it can
+	// replace the buffer
+	c8* data = new c8[16 + size];
+	memcpy(data, Buffer, 16);
+	c8* out = data + 16;
+
+	z_stream stream;
+	memset(&stream, 0, sizeof(z_stream));
+	// wbits < 0 indicates no zlib header inside the data.
+	bool result = (inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+	while (result && End - P >= 6)
+	{
+		const u32 blockSize = (u8)P[0] | ((u8)P[1] << 8);
+		const u32 compressedSize = (u8)P[2] | ((u8)P[3] << 8);
+
+		stream.next_in = (Bytef*)P + 6;
+		stream.avail_in = compressedSize - 2;
+		stream.next_out = (Bytef*)out;
+		stream.avail_out = blockSize;
+		const int err = inflate(&stream, Z_SYNC_FLUSH);
+		result = (err == Z_OK || err == Z_STREAM_END) && !stream.avail_out;
+
+		// the next block continues the dictionary of this one
+		if (result)
+			result = (inflateReset(&stream) == Z_OK) &&
+				(inflateSetDictionary(&stream, (Bytef*)out, blockSize) == Z_OK);
+
+		out += blockSize;
+		P += 4 + compressedSize;
+	}
+	inflateEnd(&stream);
+
+	if (!result)
+	{
+		os::Printer::log("Could not decompress x file.", ELL_WARNING);
+		delete [] data;
+		return false;
+	}
+
+	delete [] Buffer;
+	Buffer = data;
+	P = Buffer + 16;
+	End = Buffer + 16 + size;
+	return true;
+#else
+	os::Printer::log("Compressed x files need zlib, which is not compiled in.", ELL_WARNING);
+	return false;
+#endif
+}
+
+
 //! Parses the file
 bool CXMeshFileLoader::parseFile()
 {
@@ -469,14 +576,14 @@ bool CXMeshFileLoader::parseFile()
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
-	core::stringc objectName = getNextToken();
+	SXToken objectName = getNextToken();
 
-	if (objectName.size() == 0)
+	if (objectName.Length == 0)
 		return false;
 
 	// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject:", objectName.c_str() );
+	os::Printer::log("debug DataObject:", objectName.str().c_str() );
 #endif
 
 	if (objectName == "template")
@@ -509,7 +616,7 @@ bool CXMeshFileLoader::parseDataObject()
 	{
 		// template materials now available thanks to joeWright
 		TemplateMaterials.push_back(SXTemplateMaterial());
-		TemplateMaterials.getLast().Name = getNextToken();
+		TemplateMaterials.getLast().Name = getNextToken().str();
 		return parseDataObjectMaterial(TemplateMaterials.getLast().Material);
 	}
 	else
@@ -519,7 +626,7 @@ bool CXMeshFileLoader::parseDataObject()
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	os::Printer::log("Unknown data object in animation of .x file", objectName.str().c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
@@ -548,12 +655,12 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 	// read and ignore data members
 	while(true)
 	{
-		core::stringc s = getNextToken();
+		const SXToken s = getNextToken();
 
 		if (s == "}")
 			break;
 
-		if (s.size() == 0)
+		if (s.Length == 0)
 			return false;
 	}
 
@@ -622,13 +729,13 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str() );
+		os::Printer::log("debug DataObject in frame:", objectName.str().c_str() );
 #endif
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Frame in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -675,7 +782,7 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in frame in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -740,11 +847,10 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	// read vertices
 	mesh.Vertices.set_used(nVertices);
+	if (nVertices)
+		readFloats(&mesh.Vertices[0].Pos.X, nVertices, 3, sizeof(video::S3DVertex));
 	for (u32 n=0; n<nVertices; ++n)
-	{
-		readVector3(mesh.Vertices[n].Pos);
 		mesh.Vertices[n].Color=0xFFFFFFFF;
-	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -780,8 +886,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			mesh.Indices.set_used(mesh.Indices.size() + ((triangles-1)*3));
 			mesh.IndexCountPerFace[k] = (u16)(triangles * 3);
 
-			for (u32 f=0; f<fcnt; ++f)
-				polygonfaces[f] = readInt();
+			readInts(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -794,9 +899,8 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
+			readInts(&mesh.Indices[currentIndex], 3);
+			currentIndex += 3;
 			mesh.IndexCountPerFace[k] = 3;
 		}
 	}
@@ -811,9 +915,9 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Mesh in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -826,7 +930,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh:", objectName.c_str() );
+		os::Printer::log("debug DataObject in mesh:", objectName.str().c_str() );
 #endif
 
 		if (objectName == "MeshNormals")
@@ -973,8 +1077,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			}
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (j=0; j<datasize; ++j)
-				data[j]=readInt();
+			readInts(data, datasize);
 
 			if (!checkForOneFollowingSemicolons())
 			{
@@ -1015,8 +1118,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			const u32 dataformat = readInt();
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (u32 j=0; j<datasize; ++j)
-				data[j]=readInt();
+			readInts(data, datasize);
 			if (dataformat&0x102) // 2nd uv set
 			{
 				mesh.TCoords2.reallocate(mesh.Vertices.size());
@@ -1057,7 +1159,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in mesh in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1125,6 +1227,10 @@ bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 	mesh.WeightJoint.reallocate( mesh.WeightJoint.size() + nWeights );
 	mesh.WeightNum.reallocate( mesh.WeightNum.size() + nWeights );
 
+	core::array<u32> vertexIds;
+	vertexIds.set_used(nWeights);
+	readInts(vertexIds.pointer(), nWeights);
+
 	for (i=0; i<nWeights; ++i)
 	{
 		mesh.WeightJoint.push_back(n);
@@ -1133,13 +1239,13 @@ bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 		CSkinnedMesh::SWeight *weight=AnimatedMesh->addWeight(joint);
 
 		weight->buffer_id=0;
-		weight->vertex_id=readInt();
+		weight->vertex_id=vertexIds[i];
 	}
 
 	// read vertex weights
 
-	for (i=jointStart; i<jointStart+nWeights; ++i)
-		joint->Weights[i].strength = readFloat();
+	if (nWeights)
+		readFloats(&joint->Weights[jointStart].strength, nWeights, 1, sizeof(CSkinnedMesh::SWeight));
 
 	// read matrix offset
 
@@ -1217,8 +1323,8 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 	normals.set_used(nNormals);
 
 	// read normals
-	for (u32 i=0; i<nNormals; ++i)
-		readVector3(normals[i]);
+	if (nNormals)
+		readFloats(&normals[0].X, nNormals, 3, sizeof(core::vector3df));
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -1250,18 +1356,16 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 		if (indexcount == 3)
 		{
 			// default, only one triangle in this face
+			u32 normalnums[3];
+			readInts(normalnums, 3);
 			for (u32 h=0; h<3; ++h)
-			{
-				const u32 normalnum = readInt();
-				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnum]);
-			}
+				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnums[h]]);
 		}
 		else
 		{
 			polygonfaces.set_used(fcnt);
 			// multiple triangles in this face
-			for (u32 h=0; h<fcnt; ++h)
-				polygonfaces[h] = readInt();
+			readInts(polygonfaces.pointer(), fcnt);
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -1303,8 +1407,15 @@ bool CXMeshFileLoader::parseDataObjectMeshTextureCoords(SXMesh &mesh)
 	}
 
 	const u32 nCoords = readInt();
-	for (u32 i=0; i<nCoords; ++i)
-		readVector2(mesh.Vertices[i].TCoords);
+	const u32 nUsed = core::min_(nCoords, mesh.Vertices.size());
+	if (nUsed)
+		readFloats(&mesh.Vertices[0].TCoords.X, nUsed, 2, sizeof(video::S3DVertex));
+	// skip coordinates of vertices which do not exist
+	for (u32 i=nUsed; i<nCoords; ++i)
+	{
+		readFloat();
+		readFloat();
+	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -1395,12 +1506,15 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 	// read non triangulated face indices and create triangulated ones
 	mesh.FaceMaterialIndices.set_used( mesh.Indices.size() / 3);
+	core::array<u32> faceIndices;
+	faceIndices.set_used(nFaceIndices);
+	readInts(faceIndices.pointer(), nFaceIndices);
 	u32 triangulatedindex = 0;
 	u32 ind = 0;
 	for (u32 tfi=0; tfi<mesh.IndexCountPerFace.size(); ++tfi)
 	{
 		if (tfi<nFaceIndices)
-			ind = readInt();
+			ind = faceIndices[tfi];
 		const u32 fc = mesh.IndexCountPerFace[tfi]/3;
 		for (u32 k=0; k<fc; ++k)
 			mesh.FaceMaterialIndices[triangulatedindex++] = ind;
@@ -1418,9 +1532,9 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Mesh Material list in .x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1437,7 +1551,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 			// template materials now available thanks to joeWright
 			objectName = getNextToken();
 			for (u32 i=0; i<TemplateMaterials.size(); ++i)
-				if (TemplateMaterials[i].Name == objectName)
+				if (objectName == TemplateMaterials[i].Name.c_str())
 					mesh.Materials.push_back(TemplateMaterials[i].Material);
 			getNextToken(); // skip }
 		}
@@ -1455,7 +1569,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material list in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1493,9 +1607,9 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 	int textureLayer=0;
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Mesh Material in .x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1507,7 +1621,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 			break; // material finished
 		}
 		else
-		if (objectName.equals_ignore_case("TextureFilename"))
+		if (objectName.equalsIgnoreCase("TextureFilename"))
 		{
 			// some exporters write "TextureFileName" instead.
 			core::stringc TextureFileName;
@@ -1532,7 +1646,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 				material.MaterialType=video::EMT_LIGHTMAP;
 		}
 		else
-		if (objectName.equals_ignore_case("NormalmapFilename"))
+		if (objectName.equalsIgnoreCase("NormalmapFilename"))
 		{
 			// some exporters write "NormalmapFileName" instead.
 			core::stringc TextureFileName;
@@ -1557,7 +1671,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material in .x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material in .x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1584,9 +1698,9 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Animation set in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1605,7 +1719,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation set in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1635,9 +1749,9 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
-		if (objectName.size() == 0)
+		if (objectName.Length == 0)
 		{
 			os::Printer::log("Unexpected ending found in Animation in x file.", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1665,7 +1779,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		if (objectName == "{")
 		{
 			// read frame name
-			FrameName = getNextToken();
+			FrameName = getNextToken().str();
 
 			if (!checkForClosingBrace())
 			{
@@ -1676,7 +1790,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1941,9 +2055,9 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 	// find opening delimiter
 	while(true)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
-		if (t.size() == 0)
+		if (t.Length == 0)
 			return false;
 
 		if (t == "{")
@@ -1956,9 +2070,9 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 
 	while(counter)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
-		if (t.size() == 0)
+		if (t.Length == 0)
 			return false;
 
 		if (t == "{")
@@ -2019,11 +2133,11 @@ bool CXMeshFileLoader::checkForTwoFollowingSemicolons()
 //! if there is one
 bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 {
-	core::stringc nameOrBrace = getNextToken();
+	const SXToken nameOrBrace = getNextToken();
 	if (nameOrBrace != "{")
 	{
 		if (outname)
-			(*outname) = nameOrBrace;
+			(*outname) = nameOrBrace.str();
 
 		if (getNextToken() != "{")
 			return false;
@@ -2033,16 +2147,16 @@ bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 }
 
 
-//! returns next parseable token. Returns empty string if no token there
-core::stringc CXMeshFileLoader::getNextToken()
+//! returns next parseable token. Returns empty token if no token there
+CXMeshFileLoader::SXToken CXMeshFileLoader::getNextToken()
 {
-	core::stringc s;
-
 	// process binary-formatted file
 	if (BinaryFormat)
 	{
 		// in binary mode it will only return NAME and STRING token
 		// and (correctly) skip over other tokens.
+		if (End - P < 2)
+			return SXToken();
 
 		s16 tok = readBinWord();
 		u32 len;
@@ -2051,82 +2165,86 @@ core::stringc CXMeshFileLoader::getNextToken()
 		switch (tok) {
 			case 1:
 				// name token
-				len = readBinDWord();
-				s = core::stringc(P, len);
-				P += len;
-				return s;
+				{
+					len = core::min_(readBinDWord(), (u32)(End - P));
+					const SXToken name(P, len);
+					P += len;
+					return name;
+				}
 			case 2:
 				// string token
-				len = readBinDWord();
-				s = core::stringc(P, len);
-				P += (len + 2);
-				return s;
+				{
+					len = core::min_(readBinDWord(), (u32)(End - P));
+					const SXToken text(P, len);
+					P += (len + 2);
+					return text;
+				}
 			case 3:
 				// integer token
 				P += 4;
-				return "<integer>";
+				return SXToken("<integer>");
 			case 5:
 				// GUID token
 				P += 16;
-				return "<guid>";
+				return SXToken("<guid>");
 			case 6:
 				len = readBinDWord();
 				P += (len * 4);
-				return "<int_list>";
+				return SXToken("<int_list>");
 			case 7:
 				len = readBinDWord();
 				P += (len * FloatSize);
-				return "<flt_list>";
+				return SXToken("<flt_list>");
 			case 0x0a:
-				return "{";
+				return SXToken("{");
 			case 0x0b:
-				return "}";
+				return SXToken("}");
 			case 0x0c:
-				return "(";
+				return SXToken("(");
 			case 0x0d:
-				return ")";
+				return SXToken(")");
 			case 0x0e:
-				return "[";
+				return SXToken("[");
 			case 0x0f:
-				return "]";
+				return SXToken("]");
 			case 0x10:
-				return "<";
+				return SXToken("<");
 			case 0x11:
-				return ">";
+				return SXToken(">");
 			case 0x12:
-				return ".";
+				return SXToken(".");
 			case 0x13:
-				return ",";
+				return SXToken(",");
 			case 0x14:
-				return ";";
+				return SXToken(";");
 			case 0x1f:
-				return "template";
+				return SXToken("template");
 			case 0x28:
-				return "WORD";
+				return SXToken("WORD");
 			case 0x29:
-				return "DWORD";
+				return SXToken("DWORD");
 			case 0x2a:
-				return "FLOAT";
+				return SXToken("FLOAT");
 			case 0x2b:
-				return "DOUBLE";
+				return SXToken("DOUBLE");
 			case 0x2c:
-				return "CHAR";
+				return SXToken("CHAR");
 			case 0x2d:
-				return "UCHAR";
+				return SXToken("UCHAR");
 			case 0x2e:
-				return "SWORD";
+				return SXToken("SWORD");
 			case 0x2f:
-				return "SDWORD";
+				return SXToken("SDWORD");
 			case 0x30:
-				return "void";
+				return SXToken("void");
 			case 0x31:
-				return "string";
+				return SXToken("string");
 			case 0x32:
-				return "unicode";
+				return SXToken("unicode");
 			case 0x33:
-				return "cstring";
+				return SXToken("cstring");
 			case 0x34:
-				return "array";
+				return SXToken("array");
 		}
 	}
 	// process text-formatted file
@@ -2135,25 +2253,22 @@ core::stringc CXMeshFileLoader::getNextToken()
 		findNextNoneWhiteSpace();
 
 		if (P >= End)
-			return s;
+			return SXToken();
 
-		while((P < End) && !core::isspace(P[0]))
+		// the token points into the buffer, it ends at white space or
+		// before a delimiter, which is a token on its own
+		const c8* begin = P;
+		if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
 		{
-			// either keep token delimiters when already holding a token, or return if first valid char
-			if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
-			{
-				if (!s.size())
-				{
-					s.append(P[0]);
-					++P;
-				}
-				break; // stop for delimiter
-			}
-			s.append(P[0]);
 			++P;
+			return SXToken(begin, 1);
 		}
+		while((P < End) && !core::isspace(P[0]) &&
+			P[0]!=';' && P[0]!='}' && P[0]!='{' && P[0]!=',')
+			++P;
+		return SXToken(begin, (u32)(P - begin));
 	}
-	return s;
+	return SXToken();
 }
 
 
@@ -2209,7 +2324,7 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 {
 	if (BinaryFormat)
 	{
-		out=getNextToken();
+		out=getNextToken().str();
 		return true;
 	}
 	findNextNoneWhiteSpace();
@@ -2345,6 +2460,125 @@ f32 CXMeshFileLoader::readFloat()
 }
 
 
+void CXMeshFileLoader::readInts(u32* out, u32 count)
+{
+	if (!BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+		{
+			findNextNoneWhiteSpaceNumber();
+			out[i] = core::strtol10(P, &P);
+		}
+		return;
+	}
+
+	while (count)
+	{
+		if (!BinaryNumCount)
+		{
+			const u16 tmp = readBinWord(); // 0x06 or 0x03
+			if (tmp == 0x06)
+				BinaryNumCount = readBinDWord();
+			else
+				BinaryNumCount = 1; // single int
+		}
+
+		// copy as much of the current list as needed at once
+		u32 n = core::min_(count, BinaryNumCount);
+		if ((u32)(End - P) < n * 4)
+		{
+			os::Printer::log("Unexpected end of int list in x file.", ELL_WARNING);
+			memset(out, 0, count * 4);
+			P = End;
+			BinaryNumCount = 0;
+			return;
+		}
+		memcpy(out, P, n * 4);
+#ifdef __BIG_ENDIAN__
+		for (u32 i=0; i<n; ++i)
+			out[i] = os::Byteswap::byteswap(out[i]);
+#endif
+		P += n * 4;
+		out += n;
+		count -= n;
+		BinaryNumCount -= n;
+	}
+}
+
+
+void CXMeshFileLoader::readFloats(f32* out, u32 count, u32 components, u32 stride)
+{
+	if (!BinaryFormat)
+	{
+		for (u32 i=0; i<count; ++i)
+		{
+			for (u32 c=0; c<components; ++c)
+			{
+				findNextNoneWhiteSpaceNumber();
+				P = core::fast_atof_move(P, out[c]);
+			}
+			out = (f32*)((c8*)out + stride);
+		}
+		return;
+	}
+
+	u32 total = count * components;
+	u32 c = 0;
+	while (total)
+	{
+		if (!BinaryNumCount)
+		{
+			const u16 tmp = readBinWord(); // 0x07 or 0x42
+			if (tmp == 0x07)
+				BinaryNumCount = readBinDWord();
+			else
+				BinaryNumCount = 1; // single float
+		}
+
+		// read as much of the current list as needed without checking
+		// for list headers
+		u32 n = core::min_(total, BinaryNumCount);
+		if ((u32)(End - P) < n * FloatSize)
+		{
+			os::Printer::log("Unexpected end of float list in x file.", ELL_WARNING);
+			P = End;
+			BinaryNumCount = 0;
+			return;
+		}
+		total -= n;
+		BinaryNumCount -= n;
+		for (; n; --n)
+		{
+			if (FloatSize == 8)
+			{
+				f64 tmp;
+				memcpy(&tmp, P, 8);
+#ifdef __BIG_ENDIAN__
+				c8* bytes = (c8*)&tmp;
+				for (u32 i=0; i<4; ++i)
+					core::swap(bytes[i], bytes[7-i]);
+#endif
+				out[c] = (f32)tmp;
+				P += 8;
+			}
+			else
+			{
+				memcpy(&out[c], P, 4);
+#ifdef __BIG_ENDIAN__
+				out[c] = os::Byteswap::byteswap(out[c]);
+#endif
+				P += 4;
+			}
+			if (++c == components)
+			{
+				c = 0;
+				out = (f32*)((c8*)out + stride);
+			}
+		}
+	}
+}
+
+
 // read 2-dimensional vector. Stops at semicolon after second value for text file format
 bool CXMeshFileLoader::readVector2(core::vector2df& vec)
 {
@@ -2392,8 +2626,7 @@ bool CXMeshFileLoader::readRGBA(video::SColor& color)
 // read matrix from list of floats
 bool CXMeshFileLoader::readMatrix(core::matrix4& mat)
 {
-	for (u32 i=0; i<16; ++i)
-		mat[i] = readFloat();
+	readFloats(mat.pointer(), 1, 16, 0);
 	return checkForOneFollowingSemicolons();
 }
 
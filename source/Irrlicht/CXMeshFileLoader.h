@@ -86,10 +86,53 @@ public:
 
 private:
 
+	//! Token of the file, points into the file buffer or to a constant string
+	struct SXToken
+	{
+		SXToken() : Text(""), Length(0) {}
+		SXToken(const c8* text) : Text(text), Length((u32)strlen(text)) {}
+		SXToken(const c8* text, u32 length) : Text(text), Length(length) {}
+
+		//! compares with a null terminated string
+		bool operator==(const c8* other) const
+		{
+			for (u32 i=0; i<Length; ++i)
+				if (!other[i] || Text[i] != other[i])
+					return false;
+			return !other[Length];
+		}
+
+		bool operator!=(const c8* other) const
+		{
+			return !(*this == other);
+		}
+
+		//! compares with a null terminated string, ignoring the case of letters
+		bool equalsIgnoreCase(const c8* other) const
+		{
+			for (u32 i=0; i<Length; ++i)
+				if (!other[i] || core::locale_lower(Text[i]) != core::locale_lower(other[i]))
+					return false;
+			return !other[Length];
+		}
+
+		//! copies the token into a string
+		core::stringc str() const
+		{
+			return core::stringc(Text, Length);
+		}
+
+		const c8* Text;
+		u32 Length;
+	};
+
 	bool load(io::IReadFile* file);
 
 	bool readFileIntoMemory(io::IReadFile* file);
 
+	//! replaces the buffer of a compressed file by the decompressed data
+	bool decompressFile();
+
 	bool parseFile();
 
 	bool parseDataObject();
@@ -133,8 +176,8 @@ private:
 	// and ignores comments
 	void findNextNoneWhiteSpaceNumber();
 
-	//! returns next parseable token. Returns empty string if no token there
-	core::stringc getNextToken();
+	//! returns next parseable token. Returns empty token if no token there
+	SXToken getNextToken();
 
 	//! reads header of dataobject including the opening brace.
 	//! returns false if error happened, and writes name of object
@@ -159,6 +202,10 @@ private:
 	u32 readBinDWord();
 	u32 readInt();
 	f32 readFloat();
+	//! reads a list of ints, in binary files as few lists at once as possible
+	void readInts(u32* out, u32 count);
+	//! reads count groups of floats, each group starts stride bytes after the previous one
+	void readFloats(f32* out, u32 count, u32 components, u32 stride);
 	bool readVector2(core::vector2df& vec);
 	bool readVector3(core::vector3df& vec);
 	bool readMatrix(core::matrix4& mat);
@@ -46,18 +46,482 @@ namespace irr
 namespace io
 {
 
+namespace
+{
+	//! Files bigger than this are decompressed while reading instead of at once
+	const u32 ZIP_STREAMING_MIN_SIZE = 1024*1024;
+
+	//! Distance between two restart points of a streamed file, in uncompressed bytes
+	const u32 ZIP_STREAMING_CHECKPOINT_DISTANCE = 1024*1024;
+
+	//! Size of the buffer for compressed data of streamed files
+	const u32 ZIP_STREAMING_BUFFER_SIZE = 16*1024;
+}
+
+// -----------------------------------------------------------------------------
+// decompressed file cache
+// -----------------------------------------------------------------------------
+
+//! Decompressed data of a file, shared between the cache and all opened files
+class CZipFileData : public virtual IReferenceCounted
+{
+public:
+
+	CZipFileData(c8* data, u32 size)
+		: Data(data), Size(size)
+	{
+		#ifdef _DEBUG
+		setDebugName("CZipFileData");
+		#endif
+	}
+
+	virtual ~CZipFileData()
+	{
+		delete [] Data;
+	}
+
+	c8* Data;
+	u32 Size;
+};
+
+
+//! Read file for data from the decompressed file cache
+class CZipCachedReadFile : public IReadFile
+{
+public:
+
+	CZipCachedReadFile(CZipFileData* data, const io::path& filename)
+		: Data(data), Pos(0), Filename(filename)
+	{
+		#ifdef _DEBUG
+		setDebugName("CZipCachedReadFile");
+		#endif
+
+		Data->grab();
+	}
+
+	virtual ~CZipCachedReadFile()
+	{
+		Data->drop();
+	}
+
+	//! returns how much was read
+	virtual s32 read(void* buffer, u32 sizeToRead)
+	{
+		if (Pos + sizeToRead > Data->Size)
+			sizeToRead = Data->Size - Pos;
+
+		memcpy(buffer, Data->Data + Pos, sizeToRead);
+		Pos += sizeToRead;
+		return sizeToRead;
+	}
+
+	//! changes position in file, returns true if successful
+	virtual bool seek(long finalPos, bool relativeMovement = false)
+	{
+		if (relativeMovement)
+			finalPos += Pos;
+
+		if (finalPos < 0 || finalPos > (long)Data->Size)
+			return false;
+
+		Pos = finalPos;
+		return true;
+	}
+
+	//! returns size of file
+	virtual long getSize() const
+	{
+		return Data->Size;
+	}
+
+	//! returns where in the file we are.
+	virtual long getPos() const
+	{
+		return Pos;
+	}
+
+	//! returns name of file
+	virtual const io::path& getFileName() const
+	{
+		return Filename;
+	}
+
+	//! returns the file content in memory
+	virtual const void* getMappedPointer() const
+	{
+		return Data->Data;
+	}
+
+private:
+
+	CZipFileData* Data;
+	u32 Pos;
+	io::path Filename;
+};
+
+
+CZipFileCache::CZipFileCache()
+	: MaxSize(0), Size(0), UseCounter(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CZipFileCache");
+	#endif
+}
+
+
+CZipFileCache::~CZipFileCache()
+{
+	shrink(0);
+}
+
+
+//! Sets the maximum size of all cached files together, 0 disables the cache
+void CZipFileCache::setMaxSize(u32 size)
+{
+	MaxSize = size;
+	shrink(MaxSize);
+}
+
+
+//! Returns the maximum size of all cached files together
+u32 CZipFileCache::getMaxSize() const
+{
+	return MaxSize;
+}
+
+
+//! Opens a file from the cache
+IReadFile* CZipFileCache::createAndOpenFile(const IFileArchive* archive, u32 id, const io::path& filename)
+{
+	for (u32 i=0; i<Entries.size(); ++i)
+	{
+		if (Entries[i].Archive == archive && Entries[i].ID == id)
+		{
+			Entries[i].LastUse = ++UseCounter;
+			return new CZipCachedReadFile(Entries[i].Data, filename);
+		}
+	}
+
+	return 0;
+}
+
+
+//! Adds decompressed data to the cache and opens it
+IReadFile* CZipFileCache::addAndOpenFile(const IFileArchive* archive, u32 id, c8* data, u32 size, const io::path& filename)
+{
+	if (size > MaxSize)
+		return io::createMemoryReadFile(data, size, filename, true);
+
+	shrink(MaxSize - size);
+
+	SCacheEntry entry;
+	entry.Archive = archive;
+	entry.ID = id;
+	entry.LastUse = ++UseCounter;
+	entry.Data = new CZipFileData(data, size);
+	Entries.push_back(entry);
+	Size += size;
+
+	return new CZipCachedReadFile(entry.Data, filename);
+}
+
+
+//! Removes all files of an archive from the cache
+void CZipFileCache::removeArchive(const IFileArchive* archive)
+{
+	for (u32 i=0; i<Entries.size(); )
+	{
+		if (Entries[i].Archive == archive)
+		{
+			Size -= Entries[i].Data->Size;
+			Entries[i].Data->drop();
+			Entries.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+
+//! removes least recently used files until the cache size is at most maxSize
+void CZipFileCache::shrink(u32 maxSize)
+{
+	while (Size > maxSize && Entries.size())
+	{
+		u32 oldest = 0;
+		for (u32 i=1; i<Entries.size(); ++i)
+		{
+			if (Entries[i].LastUse < Entries[oldest].LastUse)
+				oldest = i;
+		}
+
+		Size -= Entries[oldest].Data->Size;
+		Entries[oldest].Data->drop();
+		Entries.erase(oldest);
+	}
+}
+
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+// -----------------------------------------------------------------------------
+// streamed deflate file
+// -----------------------------------------------------------------------------
+
+//! Reads a deflated file from the archive and decompresses it while reading
+/** Only a small buffer of compressed data is kept in memory, unless the
+archive itself is mapped into memory. Each time
+another ZIP_STREAMING_CHECKPOINT_DISTANCE bytes have been decompressed, a copy
+of the decompressor state is stored, so that seeking backwards can restart
+from there instead of from the beginning of the file. */
+class CZipInflateReadFile : public IReadFile
+{
+public:
+
+	CZipInflateReadFile(IReadFile* archive, long offset, u32 compressedSize,
+			u32 uncompressedSize, const io::path& filename)
+		: Archive(archive), Offset(offset), CompressedSize(compressedSize),
+		UncompressedSize(uncompressedSize), Filename(filename), StreamValid(false),
+		Pos(0), CompressedPos(0)
+	{
+		#ifdef _DEBUG
+		setDebugName("CZipInflateReadFile");
+		#endif
+
+		Archive->grab();
+		restart();
+	}
+
+	virtual ~CZipInflateReadFile()
+	{
+		if (StreamValid)
+			inflateEnd(&Stream);
+
+		for (u32 i=0; i<Checkpoints.size(); ++i)
+		{
+			inflateEnd(Checkpoints[i].Stream);
+			delete Checkpoints[i].Stream;
+		}
+
+		Archive->drop();
+	}
+
+	//! returns if the decompressor could be initialized
+	bool isValid() const
+	{
+		return StreamValid;
+	}
+
+	//! returns how much was read
+	virtual s32 read(void* buffer, u32 sizeToRead)
+	{
+		if (!StreamValid)
+			return 0;
+
+		os::LoadEvent event(ELPE_DECOMPRESS, Filename);
+
+		if (Pos + sizeToRead > UncompressedSize)
+			sizeToRead = UncompressedSize - Pos;
+
+		Stream.next_out = (Bytef*)buffer;
+		Stream.avail_out = sizeToRead;
+
+		while (Stream.avail_out)
+		{
+			if (!Stream.avail_in)
+			{
+				if (CompressedPos == CompressedSize)
+					break;
+
+				const u8* mappedData = (const u8*)Archive->getMappedPointer();
+				if (mappedData)
+				{
+					// the archive is in memory, so all compressed data can be used at once
+					Stream.next_in = const_cast<Bytef*>(mappedData + Offset + CompressedPos);
+					Stream.avail_in = CompressedSize - CompressedPos;
+					CompressedPos = CompressedSize;
+				}
+				else
+				{
+					const u32 toRead = core::min_(CompressedSize - CompressedPos, ZIP_STREAMING_BUFFER_SIZE);
+					if (!Archive->seek(Offset + CompressedPos))
+						break;
+
+					const s32 r = Archive->read(InBuffer, toRead);
+					if (r <= 0)
+						break;
+
+					CompressedPos += r;
+					Stream.next_in = InBuffer;
+					Stream.avail_in = r;
+				}
+			}
+
+			const u32 availableBefore = Stream.avail_out;
+			const int err = inflate(&Stream, Z_SYNC_FLUSH);
+			Pos += availableBefore - Stream.avail_out;
+
+			if (err != Z_OK)
+				break;
+
+			const u32 lastCheckpoint = Checkpoints.size() ? Checkpoints.getLast().Pos : 0;
+			if (Pos >= lastCheckpoint + ZIP_STREAMING_CHECKPOINT_DISTANCE)
+				addCheckpoint();
+		}
+
+		return sizeToRead - Stream.avail_out;
+	}
+
+	//! changes position in file, returns true if successful
+	virtual bool seek(long finalPos, bool relativeMovement = false)
+	{
+		if (relativeMovement)
+			finalPos += Pos;
+
+		if (!StreamValid || finalPos < 0 || finalPos > (long)UncompressedSize)
+			return false;
+
+		// find the nearest restart point in front of the new position
+		s32 i = (s32)Checkpoints.size() - 1;
+		while (i >= 0 && Checkpoints[i].Pos > (u32)finalPos)
+			--i;
+
+		if (i >= 0 && (Checkpoints[i].Pos > Pos || (u32)finalPos < Pos))
+		{
+			if (!restoreCheckpoint(i))
+				return false;
+		}
+		else if ((u32)finalPos < Pos)
+		{
+			if (!restart())
+				return false;
+		}
+
+		// skip forward by decompressing
+		u8 skipBuffer[4096];
+		while (Pos < (u32)finalPos)
+		{
+			const u32 toSkip = core::min_((u32)finalPos - Pos, (u32)sizeof(skipBuffer));
+			if (read(skipBuffer, toSkip) != (s32)toSkip)
+				return false;
+		}
+
+		return true;
+	}
+
+	//! returns size of file
+	virtual long getSize() const
+	{
+		return UncompressedSize;
+	}
+
+	//! returns where in the file we are.
+	virtual long getPos() const
+	{
+		return Pos;
+	}
+
+	//! returns name of file
+	virtual const io::path& getFileName() const
+	{
+		return Filename;
+	}
+
+private:
+
+	//! starts decompression from the beginning of the file
+	bool restart()
+	{
+		if (StreamValid)
+			inflateEnd(&Stream);
+
+		memset(&Stream, 0, sizeof(z_stream));
+
+		// wbits < 0 indicates no zlib header inside the data.
+		StreamValid = (inflateInit2(&Stream, -MAX_WBITS) == Z_OK);
+		Pos = 0;
+		CompressedPos = 0;
+		return StreamValid;
+	}
+
+	//! stores the current decompressor state
+	void addCheckpoint()
+	{
+		SCheckpoint cp;
+		cp.Stream = new z_stream;
+		if (inflateCopy(cp.Stream, &Stream) != Z_OK)
+		{
+			delete cp.Stream;
+			return;
+		}
+
+		cp.Pos = Pos;
+		cp.CompressedPos = CompressedPos - Stream.avail_in;
+		Checkpoints.push_back(cp);
+	}
+
+	//! continues decompression from a stored state
+	bool restoreCheckpoint(u32 index)
+	{
+		if (StreamValid)
+			inflateEnd(&Stream);
+
+		const SCheckpoint& cp = Checkpoints[index];
+		StreamValid = (inflateCopy(&Stream, cp.Stream) == Z_OK);
+
+		// the input buffer content is not valid anymore
+		Stream.avail_in = 0;
+		Pos = cp.Pos;
+		CompressedPos = cp.CompressedPos;
+		return StreamValid;
+	}
+
+	struct SCheckpoint
+	{
+		// allocated separately, zlib does not like z_streams being moved around
+		z_stream* Stream;
+		u32 Pos;
+		u32 CompressedPos;
+	};
+
+	IReadFile* Archive;
+	long Offset;
+	u32 CompressedSize;
+	u32 UncompressedSize;
+	io::path Filename;
+
+	z_stream Stream;
+	bool StreamValid;
+	u32 Pos;
+	u32 CompressedPos;
+
+	core::array<SCheckpoint> Checkpoints;
+	u8 InBuffer[ZIP_STREAMING_BUFFER_SIZE];
+};
+#endif // _IRR_COMPILE_WITH_ZLIB_
+
 
 // -----------------------------------------------------------------------------
 // zip loader
 // -----------------------------------------------------------------------------
 
 //! Constructor
-CArchiveLoaderZIP::CArchiveLoaderZIP(io::IFileSystem* fs)
-: FileSystem(fs)
+CArchiveLoaderZIP::CArchiveLoaderZIP(io::IFileSystem* fs, CZipFileCache* cache)
+: FileSystem(fs), Cache(cache)
 {
 	#ifdef _DEBUG
 	setDebugName("CArchiveLoaderZIP");
 	#endif
+
+	if (Cache)
+		Cache->grab();
+}
+
+//! Destructor
+CArchiveLoaderZIP::~CArchiveLoaderZIP()
+{
+	if (Cache)
+		Cache->drop();
 }
 
 //! returns true if the file maybe is able to be loaded by this class
@@ -111,7 +575,7 @@ IFileArchive* CArchiveLoaderZIP::createArchive(io::IReadFile* file, bool ignoreC
 
 		bool isGZip = (sig == 0x8b1f);
 
-		archive = new CZipReader(file, ignoreCase, ignorePaths, isGZip);
+		archive = new CZipReader(file, ignoreCase, ignorePaths, isGZip, Cache);
 	}
 	return archive;
 }
@@ -137,13 +601,16 @@ bool CArchiveLoaderZIP::isALoadableFileFormat(io::IReadFile* file) const
 // zip archive
 // -----------------------------------------------------------------------------
 
-CZipReader::CZipReader(IReadFile* file, bool ignoreCase, bool ignorePaths, bool isGZip)
- : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths), File(file), IsGZip(isGZip)
+CZipReader::CZipReader(IReadFile* file, bool ignoreCase, bool ignorePaths, bool isGZip, CZipFileCache* cache)
+ : CFileList((file ? file->getFileName() : io::path("")), ignoreCase, ignorePaths), File(file), IsGZip(isGZip), Cache(cache)
 {
 	#ifdef _DEBUG
 	setDebugName("CZipReader");
 	#endif
 
+	if (Cache)
+		Cache->grab();
+
 	if (File)
 	{
 		File->grab();
@@ -160,6 +627,12 @@ CZipReader::CZipReader(IReadFile* file, bool ignoreCase, bool ignorePaths, bool
 
 CZipReader::~CZipReader()
 {
+	if (Cache)
+	{
+		Cache->removeArchive(this);
+		Cache->drop();
+	}
+
 	if (File)
 		File->drop();
 }
@@ -344,6 +817,13 @@ bool CZipReader::scanGZipHeader()
 		// we are now at the start of the data blocks
 		entry.Offset = File->getPos();
 
+		// the data is followed by the crc and the uncompressed size
+		if (entry.Offset + 8 > File->getSize())
+		{
+			os::Printer::log("Truncated gzip archive", Path, ELL_ERROR);
+			return false;
+		}
+
 		entry.header.FilenameLength = ZipFileName.size();
 
 		entry.header.CompressionMethod = header.compressionMethod;
@@ -464,6 +944,15 @@ bool CZipReader::scanZipHeader()
 
 	// store position in file
 	entry.Offset = File->getPos();
+
+	// entries of a truncated or broken archive would be read beyond its end
+	if (entry.Offset > File->getSize() ||
+		entry.header.DataDescriptor.CompressedSize > (u32)(File->getSize() - entry.Offset))
+	{
+		os::Printer::log("Truncated zip archive, ignoring entry", ZipFileName, ELL_ERROR);
+		return false;
+	}
+
 	// move forward length of data
 	File->seek(entry.header.DataDescriptor.CompressedSize, true);
 
@@ -527,6 +1016,18 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 	IReadFile* decrypted=0;
 	u8* decryptedBuf=0;
 	u32 decryptedSize=e.header.DataDescriptor.CompressedSize;
+
+	// encrypted files are never cached, so each access checks the password
+	const bool encrypted = (e.header.GeneralBitFlag & ZIP_FILE_ENCRYPTED) != 0;
+	if (Cache && !encrypted && actualCompressionMethod != 0)
+	{
+		IReadFile* cached = Cache->createAndOpenFile(this, Files[index].ID, Files[index].FullName);
+		if (cached)
+			return cached;
+	}
+
+	os::LoadEvent event(ELPE_DECOMPRESS, Files[index].FullName);
+
 #ifdef _IRR_COMPILE_WITH_ZIP_ENCRYPTION_
 	if ((e.header.GeneralBitFlag & ZIP_FILE_ENCRYPTED) && (e.header.CompressionMethod == 99))
 	{
@@ -618,6 +1119,21 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
   			#ifdef _IRR_COMPILE_WITH_ZLIB_
 
 			const u32 uncompressedSize = e.header.DataDescriptor.UncompressedSize;
+
+			// big files are decompressed while reading, so they don't have to fit into memory
+			if (!decrypted && uncompressedSize >= ZIP_STREAMING_MIN_SIZE)
+			{
+				CZipInflateReadFile* stream = new CZipInflateReadFile(File, e.Offset,
+						decryptedSize, uncompressedSize, Files[index].FullName);
+				if (stream->isValid())
+					return stream;
+
+				stream->drop();
+				swprintf ( buf, 64, L"Error decompressing %s", Files[index].FullName.c_str() );
+				os::Printer::log( buf, ELL_ERROR);
+				return 0;
+			}
+
 			c8* pBuf = new c8[ uncompressedSize ];
 			if (!pBuf)
 			{
@@ -628,8 +1144,13 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 
+			// use the archive content directly if it is in memory anyway
+			const u8* mappedData = decryptedBuf ? 0 : (const u8*)File->getMappedPointer();
+
 			u8 *pcData = decryptedBuf;
-			if (!pcData)
+			if (mappedData)
+				pcData = const_cast<u8*>(mappedData) + e.Offset;
+			else if (!pcData)
 			{
 				pcData = new u8[decryptedSize];
 				if (!pcData)
@@ -670,7 +1191,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 
 			if (decrypted)
 				decrypted->drop();
-			else
+			else if (!mappedData)
 				delete[] pcData;
 
 			if (err != Z_OK)
@@ -681,7 +1202,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 			else
-				return io::createMemoryReadFile(pBuf, uncompressedSize, Files[index].FullName, true);
+				return createDecompressedFile(index, pBuf, uncompressedSize, !encrypted);
 
 			#else
 			return 0; // zlib not compiled, we cannot decompress the data.
@@ -702,8 +1223,13 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 
+			// use the archive content directly if it is in memory anyway
+			const u8* mappedData = decryptedBuf ? 0 : (const u8*)File->getMappedPointer();
+
 			u8 *pcData = decryptedBuf;
-			if (!pcData)
+			if (mappedData)
+				pcData = const_cast<u8*>(mappedData) + e.Offset;
+			else if (!pcData)
 			{
 				pcData = new u8[decryptedSize];
 				if (!pcData)
@@ -741,7 +1267,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 
 			if (decrypted)
 				decrypted->drop();
-			else
+			else if (!mappedData)
 				delete[] pcData;
 
 			if (err != BZ_OK)
@@ -752,7 +1278,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 			else
-				return io::createMemoryReadFile(pBuf, uncompressedSize, Files[index].FullName, true);
+				return createDecompressedFile(index, pBuf, uncompressedSize, !encrypted);
 
 			#else
 			os::Printer::log("bzip2 decompression not supported. File cannot be read.", ELL_ERROR);
@@ -774,8 +1300,13 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 
+			// use the archive content directly if it is in memory anyway
+			const u8* mappedData = decryptedBuf ? 0 : (const u8*)File->getMappedPointer();
+
 			u8 *pcData = decryptedBuf;
-			if (!pcData)
+			if (mappedData)
+				pcData = const_cast<u8*>(mappedData) + e.Offset;
+			else if (!pcData)
 			{
 				pcData = new u8[decryptedSize];
 				if (!pcData)
@@ -802,7 +1333,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 
 			if (decrypted)
 				decrypted->drop();
-			else
+			else if (!mappedData)
 				delete[] pcData;
 
 			if (err != SZ_OK)
@@ -813,7 +1344,7 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 				return 0;
 			}
 			else
-				return io::createMemoryReadFile(pBuf, uncompressedSize, Files[index].FullName, true);
+				return createDecompressedFile(index, pBuf, uncompressedSize, !encrypted);
 
 			#else
 			os::Printer::log("lzma decompression not supported. File cannot be read.", ELL_ERROR);
@@ -832,6 +1363,16 @@ IReadFile* CZipReader::createAndOpenFile(u32 index)
 
 }
 
+
+//! opens decompressed data of a file, and puts it into the cache if possible
+IReadFile* CZipReader::createDecompressedFile(u32 index, c8* data, u32 size, bool cacheable)
+{
+	if (Cache && cacheable)
+		return Cache->addAndOpenFile(this, Files[index].ID, data, size, Files[index].FullName);
+
+	return io::createMemoryReadFile(data, size, Files[index].FullName, true);
+}
+
 } // end namespace io
 } // end namespace irr
 
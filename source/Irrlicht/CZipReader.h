@@ -147,13 +147,71 @@ namespace io
 		SZIPFileHeader header;
 	};
 
+	class CZipFileData;
+
+	//! Size limited cache of decompressed files, shared by all zip archives of a file system
+	/** Files are identified by their archive and their entry id. When the
+	cache is full, the least recently used files are removed first. Files
+	which are still opened keep their data alive until they are dropped. */
+	class CZipFileCache : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Constructor
+		CZipFileCache();
+
+		//! Destructor
+		virtual ~CZipFileCache();
+
+		//! Sets the maximum size of all cached files together, 0 disables the cache
+		void setMaxSize(u32 size);
+
+		//! Returns the maximum size of all cached files together
+		u32 getMaxSize() const;
+
+		//! Opens a file from the cache
+		/** \return The opened file, or 0 if the file is not cached. */
+		IReadFile* createAndOpenFile(const IFileArchive* archive, u32 id, const io::path& filename);
+
+		//! Adds decompressed data to the cache and opens it
+		/** The cache takes over the data, which must have been allocated with new [].
+		If the data does not fit into the cache, it is only opened.
+		\return The opened file. */
+		IReadFile* addAndOpenFile(const IFileArchive* archive, u32 id, c8* data, u32 size, const io::path& filename);
+
+		//! Removes all files of an archive from the cache
+		void removeArchive(const IFileArchive* archive);
+
+	private:
+
+		//! removes least recently used files until the cache size is at most maxSize
+		void shrink(u32 maxSize);
+
+		struct SCacheEntry
+		{
+			const IFileArchive* Archive;
+			u32 ID;
+			u32 LastUse;
+			CZipFileData* Data;
+		};
+
+		core::array<SCacheEntry> Entries;
+		u32 MaxSize;
+		u32 Size;
+		u32 UseCounter;
+	};
+
 	//! Archiveloader capable of loading ZIP Archives
 	class CArchiveLoaderZIP : public IArchiveLoader
 	{
 	public:
 
 		//! Constructor
-		CArchiveLoaderZIP(io::IFileSystem* fs);
+		/** \param cache Optional cache for decompressed files, shared by all created archives */
+		CArchiveLoaderZIP(io::IFileSystem* fs, CZipFileCache* cache=0);
+
+		//! Destructor
+		virtual ~CArchiveLoaderZIP();
 
 		//! returns true if the file maybe is able to be loaded by this class
 		//! based on the file extension (e.g. ".zip")
@@ -182,6 +240,7 @@ namespace io
 
 	private:
 		io::IFileSystem* FileSystem;
+		CZipFileCache* Cache;
 	};
 
 /*!
@@ -192,7 +251,7 @@ namespace io
 	public:
 
 		//! constructor
-		CZipReader(IReadFile* file, bool ignoreCase, bool ignorePaths, bool isGZip=false);
+		CZipReader(IReadFile* file, bool ignoreCase, bool ignorePaths, bool isGZip=false, CZipFileCache* cache=0);
 
 		//! destructor
 		virtual ~CZipReader();
@@ -219,8 +278,14 @@ namespace io
 		//! the same but for gzip files
 		bool scanGZipHeader();
 
+		//! opens decompressed data of a file, and puts it into the cache if possible
+		IReadFile* createDecompressedFile(u32 index, c8* data, u32 size, bool cacheable);
+
 		bool IsGZip;
 
+		// optional cache for decompressed files
+		CZipFileCache* Cache;
+
 		// holds extended info about files
 		core::array<SZipFileEntry> FileInfo;
 	};
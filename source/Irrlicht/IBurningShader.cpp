@@ -61,6 +61,7 @@ namespace video
 			RenderTarget->drop();
 
 		RenderTarget = (video::CImage* ) surface;
+		Scissor = viewPort;
 
 		if (RenderTarget)
 		{
@@ -139,11 +139,24 @@ namespace video
 
 		virtual void setMaterial ( const SBurningShaderMaterial &material ) {};
 
+		//! returns if the shader clips its scanlines to the viewport
+		/** Triangles drawn with such shaders only have to be clipped
+		to the near and far plane, as long as they stay in the guard band. */
+		virtual bool canScissor () const { return false; }
+
+		//! returns if the shader only draws pixels nearer than the depth buffer
+		/** Triangles drawn with such shaders are skipped when they are
+		behind the depth tiles. */
+		virtual bool isDepthTested () const { return false; }
+
 	protected:
 
 		video::CImage* RenderTarget;
 		IDepthBuffer* DepthBuffer;
 
+		//! area of the render target to draw into
+		core::rect<s32> Scissor;
+
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
 		static const tFixPointu dithermask[ 4 * 4];
@@ -7,6 +7,7 @@
 
 #include "IReferenceCounted.h"
 #include "dimension2d.h"
+#include "rect.h"
 #include "S4DVertex.h"
 
 namespace irr
@@ -38,6 +39,25 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const = 0;
 
+		//! marks the depth tiles of an area as changed
+		/** Has to be called for every area whose depth values were
+		written, so isOccluded() doesn't use the old values. */
+		virtual void invalidateTiles(const core::rect<s32>& area) = 0;
+
+		//! searches the farthest depth value of all changed tiles again
+		/** Searching a tile costs about as much as drawing it, so it is
+		done once before a batch of primitives, not for each of them. */
+		virtual void updateTiles() = 0;
+
+		//! returns if a primitive would fail the depth test in a whole area
+		/** Tests against the farthest depth value of each tile of the
+		area. Tiles which changed since the last updateTiles() may be
+		nearer now and are never occluding.
+		\param area Screen area of the primitive.
+		\param nearest Nearest depth value of the primitive.
+		\return True if no pixel of the area can pass the depth test. */
+		virtual bool isOccluded(const core::rect<s32>& area, f32 nearest) = 0;
+
 	};
 
 
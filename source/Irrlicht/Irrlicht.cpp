@@ -42,6 +42,10 @@ static const char* const copyright = "Irrlicht Engine (c) 2002-2009 Nikolaus Geb
 #include "CIrrDeviceConsole.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+#include "CIrrDeviceHeadless.h"
+#endif
+
 namespace irr
 {
 	//! stub for calling createDeviceEx
@@ -102,6 +106,11 @@ namespace irr
 		dev = new CIrrDeviceConsole(params);
 #endif
 
+#ifdef _IRR_COMPILE_WITH_HEADLESS_DEVICE_
+		if (params.DeviceType == EIDT_HEADLESS)
+		dev = new CIrrDeviceHeadless(params);
+#endif
+
 		if (dev && !dev->getVideoDriver() && params.DriverType != video::EDT_NULL)
 		{
 			dev->closeDevice(); // destroy window
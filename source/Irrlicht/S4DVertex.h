@@ -9,6 +9,7 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "SoftwareDriver2_helper.h"
 #include "irrAllocator.h"
+#include "irrArray.h"
 
 namespace irr
 {
@@ -320,6 +321,7 @@ enum e4DVertexFlag
 {
 	VERTEX4D_INSIDE		= 0x0000003F,
 	VERTEX4D_CLIPMASK	= 0x0000003F,
+	VERTEX4D_NEARFAR	= 0x00000003,
 	VERTEX4D_PROJECTED	= 0x00000100,
 
 	VERTEX4D_FORMAT_MASK			= 0xFFFF0000,
@@ -402,11 +404,25 @@ struct s4DVertex
 struct SAlignedVertex
 {
 	SAlignedVertex ( u32 element, u32 aligned )
-		: ElementSize ( element )
+		: data ( 0 ), mem ( 0 ), ElementSize ( 0 ), Aligned ( aligned )
 	{
-		u32 byteSize = (ElementSize << SIZEOF_SVERTEX_LOG2 ) + aligned;
+		resize ( element );
+	}
+
+	//! makes room for at least element vertices, the old ones are lost
+	void resize ( u32 element )
+	{
+		if ( mem && element <= ElementSize )
+			return;
+
+		delete [] mem;
+		ElementSize = element;
+		u32 byteSize = (ElementSize << SIZEOF_SVERTEX_LOG2 ) + Aligned;
 		mem = new u8 [ byteSize ];
-		data = (s4DVertex*) mem;
+
+		// start the vertices at the next aligned address
+		const size_t offset = (size_t) mem & ( Aligned - 1 );
+		data = (s4DVertex*) ( offset ? mem + Aligned - offset : mem );
 	}
 
 	virtual ~SAlignedVertex ()
@@ -417,6 +433,7 @@ struct SAlignedVertex
 	s4DVertex *data;
 	u8 *mem;
 	u32 ElementSize;
+	u32 Aligned;
 };
 
 
@@ -440,7 +457,8 @@ struct SCacheInfo
 #define VERTEXCACHE_MISS 0xFFFFFFFF
 struct SVertexCache
 {
-	SVertexCache (): mem ( VERTEXCACHE_ELEMENT * 2, 128 ) {}
+	SVertexCache (): mem ( VERTEXCACHE_ELEMENT * 2, 128 ), batch ( VERTEXCACHE_ELEMENT * 2, 128 ),
+		batchStart ( 0 ), batched ( false ) {}
 
 	SCacheInfo info[VERTEXCACHE_ELEMENT];
 
@@ -449,6 +467,12 @@ struct SVertexCache
 	// + Clipped, Projected
 	SAlignedVertex mem;
 
+	// all vertices from the lowest to the highest index, transformed at once
+	// instead of going through the cache. two s4DVertex per vertex like mem
+	SAlignedVertex batch;
+	u32 batchStart;
+	bool batched;
+
 	// source
 	const void* vertices;
 	u32 vertexCount;
@@ -0,0 +1,73 @@
+// Copyright (C) 2002-2009 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_FRAME_VERTEX_H_INCLUDED__
+#define __S_FRAME_VERTEX_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "vector3d.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace scene
+{
+
+//! Decoded vertex of a keyframe of a morph target animated mesh
+/** Position and normal are stored in the same order as in S3DVertex,
+so both can be interpolated and written with the same six floats. */
+struct SFrameVertex
+{
+	core::vector3df Pos;
+	core::vector3df Normal;
+};
+
+
+//! Interpolates position and normal of vertices between two keyframes
+/** \param target First vertex to write, any vertex type derived from S3DVertex.
+\param first Vertices of the first keyframe.
+\param second Vertices of the second keyframe.
+\param indices Index into the keyframes for each target vertex, or 0
+if the keyframes hold one vertex per target vertex.
+\param count Amount of target vertices.
+\param t Interpolation factor, 0 returns the first keyframe. */
+template <class T>
+inline void interpolateFrameVertices(T* target, const SFrameVertex* first,
+		const SFrameVertex* second, const u16* indices, u32 count, f32 t)
+{
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	const __m128 t4 = _mm_set1_ps(t);
+#endif
+
+	for (u32 i=0; i<count; ++i, ++target)
+	{
+		const u32 k = indices ? indices[i] : i;
+		const f32* a = &first[k].Pos.X;
+		const f32* b = &second[k].Pos.X;
+		f32* d = &target->Pos.X;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+		// position and normal X in one register, normal Y and Z in the other
+		const __m128 a0 = _mm_loadu_ps(a);
+		const __m128 b0 = _mm_loadu_ps(b);
+		const __m128 a1 = _mm_castpd_ps(_mm_load_sd((const double*)(a+4)));
+		const __m128 b1 = _mm_castpd_ps(_mm_load_sd((const double*)(b+4)));
+
+		_mm_storeu_ps(d, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(b0, a0), t4), a0));
+		_mm_store_sd((double*)(d+4), _mm_castps_pd(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(b1, a1), t4), a1)));
+#else
+		for (u32 j=0; j<6; ++j)
+			d[j] = (b[j] - a[j]) * t + a[j];
+#endif
+	}
+}
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -93,6 +93,11 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (8/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// guard band, in multiples of the viewport size around its center. Triangles
+// inside of it are only clipped to the near and far plane, the rest of the
+// clipping is done by the scanlines of the shaders.
+#define SOFTWARE_DRIVER_2_GUARDBAND	4.f
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
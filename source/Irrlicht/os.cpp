@@ -8,6 +8,7 @@
 #include "irrString.h"
 #include "IrrCompileConfig.h"
 #include "irrMath.h"
+#include "irrArray.h"
 
 #if defined(_IRR_COMPILE_WITH_SDL_DEVICE_)
 	#include <SDL/SDL_endian.h>
@@ -132,6 +133,33 @@ namespace os
 		return GetTickCount();
 	}
 
+	u32 Timer::getRealTimeMicroseconds()
+	{
+		if (HighPerformanceTimerSupport)
+		{
+			LARGE_INTEGER nTime;
+			if (QueryPerformanceCounter(&nTime))
+			{
+				// split the division, the product overflows after some days of uptime
+				const LONGLONG freq = HighPerformanceFreq.QuadPart;
+				return u32((nTime.QuadPart / freq) * 1000000 + (nTime.QuadPart % freq) * 1000000 / freq);
+			}
+		}
+
+		return GetTickCount() * 1000;
+	}
+
+	u32 Threads::getProcessorCount()
+	{
+#if !defined(_WIN32_WCE) && !defined (_IRR_XBOX_PLATFORM_)
+		SYSTEM_INFO sysinfo;
+		GetSystemInfo(&sysinfo);
+		return core::max_((u32)sysinfo.dwNumberOfProcessors, 1u);
+#else
+		return 1;
+#endif
+	}
+
 } // end namespace os
 
 
@@ -144,6 +172,10 @@ namespace os
 #include <stdio.h>
 #include <time.h>
 #include <sys/time.h>
+#include <unistd.h>
+#ifdef _IRR_COMPILE_WITH_THREADS_
+#include <pthread.h>
+#endif
 
 namespace irr
 {
@@ -168,6 +200,23 @@ namespace os
 		return (u32)(tv.tv_sec * 1000) + (tv.tv_usec / 1000);
 	}
 
+	u32 Timer::getRealTimeMicroseconds()
+	{
+		timeval tv;
+		gettimeofday(&tv, 0);
+		return (u32)tv.tv_sec * 1000000 + (u32)tv.tv_usec;
+	}
+
+	u32 Threads::getProcessorCount()
+	{
+#ifdef _SC_NPROCESSORS_ONLN
+		const long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 1 ? (u32)count : 1;
+#else
+		return 1;
+#endif
+	}
+
 } // end namespace os
 
 #endif // end linux / windows
@@ -176,6 +225,7 @@ namespace os
 {
 	// The platform independent implementation of the printer
 	ILogger* Printer::Logger = 0;
+	ILoadProfiler* LoadProfiler::Profiler = 0;
 
 	void Printer::log(const c8* message, ELOG_LEVEL ll)
 	{
@@ -326,6 +376,241 @@ namespace os
 		StartRealTime = StaticTime;
 	}
 
+
+	// ------------------------------------------------------
+	// threads
+
+	//! the jobs one thread does
+	struct SThreadJobs
+	{
+		Threads::Job Job;
+		void* Data;
+		u32 First;
+		u32 Step;
+		u32 Count;
+	};
+
+	static void doThreadJobs(const SThreadJobs& jobs)
+	{
+		for (u32 i=jobs.First; i<jobs.Count; i+=jobs.Step)
+			jobs.Job(jobs.Data, i);
+	}
+
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+	static DWORD WINAPI threadMain(LPVOID jobs)
+	{
+		doThreadJobs(*(const SThreadJobs*)jobs);
+		return 0;
+	}
+
+	static DWORD WINAPI backgroundThreadMain(LPVOID jobs)
+	{
+		doThreadJobs(*(const SThreadJobs*)jobs);
+		delete (SThreadJobs*)jobs;
+		return 0;
+	}
+
+	//! the lock and signal of a ThreadSignal
+	struct SThreadSignal
+	{
+		CRITICAL_SECTION Lock;
+		HANDLE Event;
+	};
+#else
+	static void* threadMain(void* jobs)
+	{
+		doThreadJobs(*(const SThreadJobs*)jobs);
+		return 0;
+	}
+
+	static void* backgroundThreadMain(void* jobs)
+	{
+		doThreadJobs(*(const SThreadJobs*)jobs);
+		delete (SThreadJobs*)jobs;
+		return 0;
+	}
+
+	//! the lock and signal of a ThreadSignal
+	struct SThreadSignal
+	{
+		pthread_mutex_t Lock;
+		pthread_cond_t Condition;
+	};
+#endif
+#endif
+
+	void Threads::run(Job job, void* data, u32 jobCount, u32 threadCount)
+	{
+		if (!jobCount)
+			return;
+		threadCount = core::clamp(threadCount, 1u, jobCount);
+
+		core::array<SThreadJobs> jobs(threadCount);
+		jobs.set_used(threadCount);
+		for (u32 i=0; i<threadCount; ++i)
+		{
+			jobs[i].Job = job;
+			jobs[i].Data = data;
+			jobs[i].First = i;
+			jobs[i].Step = threadCount;
+			jobs[i].Count = jobCount;
+		}
+
+		// jobs of threads which could not be started are done here
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+		core::array<HANDLE> threads(threadCount);
+		for (u32 i=1; i<threadCount; ++i)
+		{
+			HANDLE thread = CreateThread(0, 0, threadMain, &jobs[i], 0, 0);
+			if (thread)
+				threads.push_back(thread);
+			else
+				doThreadJobs(jobs[i]);
+		}
+		doThreadJobs(jobs[0]);
+		for (u32 i=0; i<threads.size(); ++i)
+		{
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		}
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+		core::array<pthread_t> threads(threadCount);
+		for (u32 i=1; i<threadCount; ++i)
+		{
+			pthread_t thread;
+			if (pthread_create(&thread, 0, threadMain, &jobs[i]) == 0)
+				threads.push_back(thread);
+			else
+				doThreadJobs(jobs[i]);
+		}
+		doThreadJobs(jobs[0]);
+		for (u32 i=0; i<threads.size(); ++i)
+			pthread_join(threads[i], 0);
+#else
+		for (u32 i=0; i<threadCount; ++i)
+			doThreadJobs(jobs[i]);
+#endif
+	}
+
+	void* Threads::start(Job job, void* data)
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+		// owned by the thread, which deletes it when done
+		SThreadJobs* jobs = new SThreadJobs;
+		jobs->Job = job;
+		jobs->Data = data;
+		jobs->First = 0;
+		jobs->Step = 1;
+		jobs->Count = 1;
+#if defined(_IRR_WINDOWS_API_)
+		HANDLE thread = CreateThread(0, 0, backgroundThreadMain, jobs, 0, 0);
+		if (thread)
+			return thread;
+#else
+		pthread_t* thread = new pthread_t;
+		if (pthread_create(thread, 0, backgroundThreadMain, jobs) == 0)
+			return thread;
+		delete thread;
+#endif
+		delete jobs;
+#endif
+		return 0;
+	}
+
+	void Threads::join(void* thread)
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+		if (!thread)
+			return;
+#if defined(_IRR_WINDOWS_API_)
+		WaitForSingleObject((HANDLE)thread, INFINITE);
+		CloseHandle((HANDLE)thread);
+#else
+		pthread_join(*(pthread_t*)thread, 0);
+		delete (pthread_t*)thread;
+#endif
+#endif
+	}
+
+	ThreadSignal::ThreadSignal() : Data(0)
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+		SThreadSignal* s = new SThreadSignal;
+#if defined(_IRR_WINDOWS_API_)
+		InitializeCriticalSection(&s->Lock);
+		// auto reset, so that a notify() before wait() is not lost
+		s->Event = CreateEvent(0, FALSE, FALSE, 0);
+#else
+		pthread_mutex_init(&s->Lock, 0);
+		pthread_cond_init(&s->Condition, 0);
+#endif
+		Data = s;
+#endif
+	}
+
+	ThreadSignal::~ThreadSignal()
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+		SThreadSignal* s = (SThreadSignal*)Data;
+#if defined(_IRR_WINDOWS_API_)
+		CloseHandle(s->Event);
+		DeleteCriticalSection(&s->Lock);
+#else
+		pthread_cond_destroy(&s->Condition);
+		pthread_mutex_destroy(&s->Lock);
+#endif
+		delete s;
+#endif
+	}
+
+	void ThreadSignal::lock()
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+		EnterCriticalSection(&((SThreadSignal*)Data)->Lock);
+#else
+		pthread_mutex_lock(&((SThreadSignal*)Data)->Lock);
+#endif
+#endif
+	}
+
+	void ThreadSignal::unlock()
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+		LeaveCriticalSection(&((SThreadSignal*)Data)->Lock);
+#else
+		pthread_mutex_unlock(&((SThreadSignal*)Data)->Lock);
+#endif
+#endif
+	}
+
+	void ThreadSignal::wait()
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+		SThreadSignal* s = (SThreadSignal*)Data;
+#if defined(_IRR_WINDOWS_API_)
+		LeaveCriticalSection(&s->Lock);
+		WaitForSingleObject(s->Event, INFINITE);
+		EnterCriticalSection(&s->Lock);
+#else
+		pthread_cond_wait(&s->Condition, &s->Lock);
+#endif
+#endif
+	}
+
+	void ThreadSignal::notify()
+	{
+#if defined(_IRR_COMPILE_WITH_THREADS_)
+#if defined(_IRR_WINDOWS_API_)
+		SetEvent(((SThreadSignal*)Data)->Event);
+#else
+		pthread_cond_broadcast(&((SThreadSignal*)Data)->Condition);
+#endif
+#endif
+	}
+
 } // end namespace os
 } // end namespace irr
 
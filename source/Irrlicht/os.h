@@ -10,6 +10,7 @@
 #include "irrString.h"
 #include "path.h"
 #include "ILogger.h"
+#include "ILoadProfiler.h"
 
 namespace irr
 {
@@ -102,6 +103,9 @@ namespace os
 		//! returns the current real time in milliseconds
 		static u32 getRealTime();
 
+		//! returns the current real time in microseconds, wraps around after about 71 minutes
+		static u32 getRealTimeMicroseconds();
+
 	private:
 
 		static void initVirtualTimer();
@@ -113,6 +117,96 @@ namespace os
 		static u32 StaticTime;
 	};
 
+
+	class Threads
+	{
+	public:
+
+		//! function doing the job with the given index
+		typedef void (*Job)(void* data, u32 index);
+
+		//! returns the number of processors, at least 1
+		static u32 getProcessorCount();
+
+		//! calls the job for all indices below jobCount on up to threadCount threads
+		/** Thread i does the jobs i, i+threadCount, and so on, the calling
+		thread is one of them. Returns when all jobs are done. Without
+		_IRR_COMPILE_WITH_THREADS_ all jobs run on the calling thread. */
+		static void run(Job job, void* data, u32 jobCount, u32 threadCount);
+
+		//! starts a thread doing the job with index 0 in the background
+		/** Returns the thread for join(), or 0 if no thread could be
+		started, in which case the caller has to do the job itself. */
+		static void* start(Job job, void* data);
+
+		//! waits until a thread returned by start() has done its job
+		static void join(void* thread);
+	};
+
+
+	//! Lock with a signal, for threads which wait for each other
+	/** wait() may return without a call of notify(), so the waited for
+	state has to be checked again. With Windows threads only one thread may
+	wait at a time. Without _IRR_COMPILE_WITH_THREADS_ all calls do nothing. */
+	class ThreadSignal
+	{
+	public:
+		ThreadSignal();
+		~ThreadSignal();
+
+		//! locks the state shared by the threads
+		void lock();
+
+		//! unlocks the state shared by the threads
+		void unlock();
+
+		//! waits for notify() while the lock is released, the caller has to hold it
+		void wait();
+
+		//! wakes up waiting threads
+		void notify();
+
+	private:
+		void* Data;
+	};
+
+
+	class LoadProfiler
+	{
+	public:
+		//! the profiler which load events are reported to
+		static ILoadProfiler* Profiler;
+	};
+
+
+	//! Reports the work done while it exists to the load profiler, if it is enabled
+	class LoadEvent
+	{
+	public:
+		LoadEvent(E_LOAD_PROFILE_EVENT type, const io::path& name)
+			: Recording(LoadProfiler::Profiler && LoadProfiler::Profiler->isEnabled())
+		{
+			if (Recording)
+				LoadProfiler::Profiler->beginEvent(type, name);
+		}
+
+		~LoadEvent()
+		{
+			if (Recording)
+				LoadProfiler::Profiler->endEvent();
+		}
+
+		//! adds sizes to the asset the event counts for
+		void addAssetSizes(u32 vertices, u32 indices, u32 texels, u32 bytesAllocated)
+		{
+			if (Recording)
+				LoadProfiler::Profiler->addAssetSizes(vertices, indices, texels, bytesAllocated);
+		}
+
+	private:
+		bool Recording;
+	};
+
 } // end namespace os
 } // end namespace irr
 
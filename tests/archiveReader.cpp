@@ -181,6 +181,277 @@ bool testEncryptedZip(IFileSystem* fs)
 	return true;
 }
 
+//! the content of big.bin in media/deflated.zip
+static u8 getStreamedByte(u32 pos)
+{
+	return (u8)(pos + (pos >> 16));
+}
+
+//! checks some bytes of big.bin from the current position on
+static bool checkStreamedBytes(IReadFile* file, u32 count)
+{
+	u8 tmp[1024];
+	const u32 pos = file->getPos();
+	if (file->read(tmp, count) != (s32)count)
+	{
+		logTestString("Could not read %u bytes at %u of the streamed file\n", count, pos);
+		return false;
+	}
+	for (u32 i=0; i<count; ++i)
+	{
+		if (tmp[i] != getStreamedByte(pos + i))
+		{
+			logTestString("Read bad data at %u of the streamed file\n", pos + i);
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Big deflated files are decompressed while reading and can be seeked in
+bool testStreamedZip(IFileSystem* fs)
+{
+	if ( !fs->addFileArchive("media/deflated.zip", /*bool ignoreCase=*/true, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting archive failed\n");
+		return false;
+	}
+
+	bool ret = true;
+	const u32 size = 3*1024*1024+123;
+	IReadFile* readFile = fs->createAndOpenFile("big.bin");
+	if ( !readFile || readFile->getSize() != (long)size )
+	{
+		logTestString("createAndOpenFile of the streamed file failed\n");
+		ret = false;
+	}
+	else
+	{
+		ret &= checkStreamedBytes(readFile, 1024);
+
+		// forward over several restart points, back to one of them and to the start
+		ret &= readFile->seek(2500000) && checkStreamedBytes(readFile, 1024);
+		ret &= readFile->seek(1100000) && checkStreamedBytes(readFile, 1024);
+		ret &= readFile->seek(-50000, true) && checkStreamedBytes(readFile, 1024);
+		ret &= readFile->seek(10) && checkStreamedBytes(readFile, 1024);
+
+		// reading stops at the end
+		u8 tmp[1024];
+		ret &= readFile->seek(size - 100) && (readFile->read(tmp, 1024) == 100);
+		ret &= (readFile->getPos() == (long)size) && !readFile->seek(size + 1);
+		ret &= readFile->seek(-1000, true) && checkStreamedBytes(readFile, 1000);
+	}
+	if (readFile)
+		readFile->drop();
+
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	return ret;
+}
+
+//! checks how often a file of media/deflated.zip was decompressed
+static bool checkDecompressed(IrrlichtDevice* device, const io::path& name, u32 count)
+{
+	IReadFile* readFile = device->getFileSystem()->createAndOpenFile(name);
+	c8 tmp[10000];
+	if (!readFile || readFile->read(tmp, 10000) != 10000 || tmp[9999] != name[0])
+	{
+		logTestString("Could not read %s\n", name.c_str());
+		if (readFile)
+			readFile->drop();
+		return false;
+	}
+	readFile->drop();
+
+	const SLoadProfileAsset* asset = device->getLoadProfiler()->getAsset(name);
+	if (!asset || asset->Count[ELPE_DECOMPRESS] != count)
+	{
+		logTestString("%s was decompressed %u times instead of %u\n", name.c_str(),
+			asset ? asset->Count[ELPE_DECOMPRESS] : 0, count);
+		return false;
+	}
+	return true;
+}
+
+//! Decompressed files are cached, the least recently used are removed first
+bool testZipCache(IrrlichtDevice* device)
+{
+	IFileSystem* fs = device->getFileSystem();
+	if ( !fs->addFileArchive("media/deflated.zip", /*bool ignoreCase=*/true, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting archive failed\n");
+		return false;
+	}
+
+	// room for two of the files of 10000 bytes
+	fs->setDecompressedFileCacheSize(25000);
+	device->getLoadProfiler()->setEnabled(true);
+
+	bool ret = checkDecompressed(device, "a.txt", 1);
+	ret &= checkDecompressed(device, "b.txt", 1);
+	ret &= checkDecompressed(device, "a.txt", 1);
+	// b.txt is used least recently, so it makes room for c.txt
+	ret &= checkDecompressed(device, "c.txt", 1);
+	ret &= checkDecompressed(device, "a.txt", 1);
+	ret &= checkDecompressed(device, "c.txt", 1);
+	ret &= checkDecompressed(device, "b.txt", 2);
+
+	// files bigger than the cache are not kept
+	fs->setDecompressedFileCacheSize(5000);
+	ret &= checkDecompressed(device, "a.txt", 2);
+	ret &= checkDecompressed(device, "a.txt", 3);
+
+	// without a cache each open decompresses again
+	fs->setDecompressedFileCacheSize(0);
+	ret &= checkDecompressed(device, "c.txt", 2);
+	ret &= checkDecompressed(device, "c.txt", 3);
+
+	device->getLoadProfiler()->setEnabled(false);
+	device->getLoadProfiler()->clear();
+
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	return ret;
+}
+
+//! writes the first bytes of an archive to a new file
+static bool writeTruncatedArchive(IFileSystem* fs, const io::path& archiveName, const io::path& truncatedName, u32 size)
+{
+	IReadFile* readFile = fs->createAndOpenFile(archiveName);
+	IWriteFile* writeFile = fs->createAndWriteFile(truncatedName);
+	bool ret = readFile && writeFile;
+	if (ret)
+	{
+		core::array<c8> data;
+		data.set_used(size);
+		ret = (readFile->read(data.pointer(), size) == (s32)size) &&
+			(writeFile->write(data.const_pointer(), size) == (s32)size);
+	}
+	if (readFile)
+		readFile->drop();
+	if (writeFile)
+		writeFile->drop();
+	return ret;
+}
+
+//! Entries reaching beyond the end of a truncated archive are ignored
+bool testTruncatedZip(IFileSystem* fs)
+{
+	// cut in the middle of the compressed data of the second, streamed file
+	bool ret = writeTruncatedArchive(fs, "../media/map-20kdm2.pk3", "results/truncated.pk3", 400000);
+	if ( !ret || !fs->addFileArchive("results/truncated.pk3", /*bool ignoreCase=*/true, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting truncated archive failed\n");
+		return false;
+	}
+
+	// the complete file before the cut can still be read, from the mapped archive
+	IReadFile* readFile = fs->createAndOpenFile("levelshots/20kdm2.tga");
+	c8* data = new c8[231381];
+	if (!readFile || readFile->getSize() != 231381 || readFile->read(data, 231381) != 231381)
+	{
+		logTestString("Reading a complete file of the truncated archive failed\n");
+		ret = false;
+	}
+	delete [] data;
+	if (readFile)
+		readFile->drop();
+
+	if (fs->existFile("maps/20kdm2.aas") || fs->existFile("maps/20kdm2.bsp"))
+	{
+		logTestString("Files of the truncated archive beyond its end were found\n");
+		ret = false;
+	}
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+
+	// cut in the middle of the first file, which is decompressed at once
+	ret &= writeTruncatedArchive(fs, "../media/map-20kdm2.pk3", "results/truncated.pk3", 150000);
+	if ( !ret || !fs->addFileArchive("results/truncated.pk3", /*bool ignoreCase=*/true, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting truncated archive failed\n");
+		return false;
+	}
+	readFile = fs->createAndOpenFile("levelshots/20kdm2.tga");
+	if (readFile)
+	{
+		logTestString("A truncated file could be opened\n");
+		readFile->drop();
+		ret = false;
+	}
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+
+	return ret;
+}
+
+//! checks the content of a file with a short text
+static bool checkFileText(IFileSystem* fs, const io::path& filename, const char* text)
+{
+	IReadFile* readFile = fs->createAndOpenFile(filename);
+	if (!text)
+	{
+		if (!readFile && !fs->existFile(filename))
+			return true;
+		logTestString("%s was found\n", filename.c_str());
+		if (readFile)
+			readFile->drop();
+		return false;
+	}
+
+	char tmp[16] = {'\0'};
+	if (readFile)
+	{
+		readFile->read(tmp, 15);
+		readFile->drop();
+	}
+	if (strcmp(tmp, text))
+	{
+		logTestString("Read bad data from %s: %s\n", filename.c_str(), tmp);
+		return false;
+	}
+	return true;
+}
+
+//! Names are compared ignoring case, also in archives which don't ignore case
+bool testArchiveNameCase(IFileSystem* fs)
+{
+	if ( !fs->addFileArchive("media/case.zip", /*bool ignoreCase=*/false, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting archive failed\n");
+		return false;
+	}
+
+	// A.txt and a.txt are the same name for the file list, all spellings
+	// find the one entry which the file list finds
+	const IFileList* list = fs->getFileArchive(fs->getFileArchiveCount()-1)->getFileList();
+	const s32 index = list->findFile("a.txt");
+	if (index < 0)
+	{
+		logTestString("a.txt is not in the file list\n");
+		return false;
+	}
+	const char* text = (list->getFileName(index) == "A.txt") ? "upper" : "lower";
+
+	bool ret = checkFileText(fs, "A.txt", text);
+	ret &= checkFileText(fs, "a.txt", text);
+	ret &= checkFileText(fs, "A.TXT", text);
+	ret &= checkFileText(fs, "dir/B.txt", "only");
+	ret &= checkFileText(fs, "dir\\B.txt", "only");
+	ret &= checkFileText(fs, "DIR/b.txt", "only");
+	ret &= checkFileText(fs, "dir/c.txt", 0);
+
+	// the archive added first still wins for all spellings
+	if ( !fs->addFileArchive("media/file_with_path.zip", /*bool ignoreCase=*/true, /*bool ignorePaths=*/false) )
+	{
+		logTestString("Mounting archive failed\n");
+		return false;
+	}
+	ret &= checkFileText(fs, "TEST/Test.txt", "Hello world!\n");
+	ret &= checkFileText(fs, "A.txt", text);
+	ret &= checkFileText(fs, "a.TXT", text);
+
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	ret &= fs->removeFileArchive(fs->getFileArchiveCount()-1);
+	return ret;
+}
+
 bool archiveReader()
 {
 	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2d<u32>(1, 1));
@@ -201,6 +472,14 @@ bool archiveReader()
 	ret &= testArchive(fs, "media/file_with_path.npk");
 	logTestString("Testing encrypted zip files.\n");
 	ret &= testEncryptedZip(fs);
+	logTestString("Testing streamed zip files.\n");
+	ret &= testStreamedZip(fs);
+	logTestString("Testing the cache of decompressed files.\n");
+	ret &= testZipCache(device);
+	logTestString("Testing truncated zip files.\n");
+	ret &= testTruncatedZip(fs);
+	logTestString("Testing the case of archive names.\n");
+	ret &= testArchiveNameCase(fs);
 	return ret;
 }
 
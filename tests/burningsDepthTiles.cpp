@@ -0,0 +1,76 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+/** Tests that Burning's Video skips triangles behind the depth tiles, and that
+a wall which is larger than the screen is drawn without gaps in the guard band. */
+bool burningsDepthTiles(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+
+	smgr->addCameraSceneNode();
+	smgr->setAmbientLight(video::SColorf(.7f, .1f, .1f, 1.f));
+
+	// a white wall in front of the camera, which reaches out of the screen
+	ISceneNode* wall = smgr->addCubeSceneNode(20.f, 0, -1, vector3df(0.f, 0.f, 15.f));
+	wall->setMaterialFlag(EMF_LIGHTING, false);
+
+	// red cubes behind it
+	ISceneNode* cubes = smgr->addEmptySceneNode();
+	for (u32 i=0; i<50; ++i)
+		smgr->addCubeSceneNode(2.f, cubes, -1, vector3df((f32)(i % 10) - 5.f, (f32)(i / 10) - 2.5f, 40.f + i));
+
+	bool result = true;
+	device->run();
+	if (driver->beginScene(true, true, video::SColor(0, 80, 80, 80)))
+	{
+		// draw the wall first, so the cubes are behind it
+		cubes->setVisible(false);
+		smgr->drawAll();
+		cubes->setVisible(true);
+		wall->setVisible(false);
+		smgr->drawAll();
+		driver->endScene();
+
+		IImage* screenshot = driver->createScreenShot();
+		if (screenshot)
+		{
+			const dimension2du size = screenshot->getDimension();
+			for (u32 y=0; y<size.Height && result; ++y)
+				for (u32 x=0; x<size.Width && result; ++x)
+					if (screenshot->getPixel(x, y) != SColor(255, 255, 255, 255))
+					{
+						logTestString("The wall is not drawn at %u, %u.\n", x, y);
+						result = false;
+					}
+			screenshot->drop();
+		}
+		else
+			result = false;
+	}
+
+	logTestString("Rejected %u triangles, overdraw %f.\n", driver->getPrimitiveCountRejected(), driver->getOverdraw());
+
+	// the visible sides of the cubes are all hidden
+	if (driver->getPrimitiveCountRejected() < 50 * 2)
+		result = false;
+
+	// only the wall is drawn
+	if (driver->getOverdraw() < 0.99f || driver->getOverdraw() > 1.01f)
+		result = false;
+
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+//! Draws a page of strings in two colors, half of them clipped
+static video::IImage* drawStrings(IrrlichtDevice* device, IGUIFont* font, bool batch)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	const rect<s32> clip(0, 0, 80, 120);
+
+	driver->beginScene(true, true, video::SColor(255,40,40,80));
+
+	if (batch)
+		font->beginBatch();
+
+	for (s32 i=0; i<40; ++i)
+	{
+		stringw text(L"Score ");
+		text += i * 37;
+
+		font->draw(text, rect<s32>((i%2)*80, (i/2)*6, (i%2)*80+80, (i/2)*6+12),
+			(i%3) ? video::SColor(255,255,255,255) : video::SColor(255,255,255,0),
+			false, false, (i%4) ? 0 : &clip);
+	}
+
+	if (batch)
+		font->endBatch();
+
+	driver->endScene();
+
+	return driver->createScreenShot();
+}
+
+
+//! Batched text has to look exactly like text drawn with one call per string
+bool fontBatch(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IGUIFont* font = device->getGUIEnvironment()->getBuiltInFont();
+
+	video::IImage* expected = drawStrings(device, font, false);
+	video::IImage* batched = drawStrings(device, font, true);
+
+	bool result = expected && batched;
+	if (result)
+	{
+		const dimension2du size = expected->getDimension();
+		for (u32 y=0; result && y<size.Height; ++y)
+			for (u32 x=0; result && x<size.Width; ++x)
+				result = expected->getPixel(x, y) == batched->getPixel(x, y);
+	}
+
+	if (!result)
+		logTestString("Batched text differs from immediately drawn text.\n");
+
+	if (expected)
+		expected->drop();
+	if (batched)
+		batched->drop();
+
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,129 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+//! Finds the topmost element at a point by testing all elements from back to front
+static IGUIElement* findElement(IGUIElement* element, const position2d<s32>& point)
+{
+	if (!element->isVisible())
+		return 0;
+
+	const list<IGUIElement*>& children = element->getChildren();
+	list<IGUIElement*>::ConstIterator it = children.getLast();
+	for (; it != children.end(); --it)
+	{
+		IGUIElement* target = findElement(*it, point);
+		if (target)
+			return target;
+	}
+
+	return element->isPointInside(point) ? element : 0;
+}
+
+
+//! Compares getElementFromPoint() with testing all elements on a grid of points
+static bool compareHits(IGUIElement* root, const char* state)
+{
+	for (s32 y=-10; y<250; y+=3)
+	{
+		for (s32 x=-10; x<330; x+=3)
+		{
+			const position2d<s32> point(x, y);
+			if (root->getElementFromPoint(point) != findElement(root, point))
+			{
+				logTestString("Wrong element at %d, %d %s.\n", x, y, state);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+//! Moves the mouse over the gui
+static void moveMouse(IrrlichtDevice* device, s32 x, s32 y)
+{
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.Event = EMIE_MOUSE_MOVED;
+	event.MouseInput.X = x;
+	event.MouseInput.Y = y;
+	event.MouseInput.Wheel = 0.f;
+	event.MouseInput.ButtonStates = 0;
+	device->postEventFromUser(event);
+}
+
+
+//! The hit bounds of many elements have to find the same elements as testing each one
+bool guiHitTest(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(320, 240), 32);
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	IGUIElement* root = env->getRootGUIElement();
+
+	// overlapping buttons, some of them with children, and a window over them
+	array<IGUIElement*> elements;
+	for (u32 i=0; i<400; ++i)
+	{
+		const s32 x = (i * 37) % 300;
+		const s32 y = (i * 53) % 220;
+		const s32 size = 6 + (i * 13) % 30;
+		elements.push_back(env->addButton(rect<s32>(x, y, x + size, y + size)));
+
+		if (i % 20 == 0)
+			env->addCheckBox(false, rect<s32>(2, 2, 8, 8), elements.getLast());
+	}
+
+	IGUIWindow* window = env->addWindow(rect<s32>(100, 60, 220, 160));
+	env->addButton(rect<s32>(10, 30, 60, 60), window);
+
+	bool result = compareHits(root, "after adding the elements");
+
+	// layout changes
+	for (u32 i=0; i<elements.size(); i+=7)
+		elements[i]->setRelativePosition(rect<s32>(320 - i % 300, i % 200, 340 - i % 300, 20 + i % 200));
+	for (u32 i=3; i<elements.size(); i+=11)
+		elements[i]->setVisible(false);
+	for (u32 i=5; i<elements.size(); i+=13)
+		root->bringToFront(elements[i]);
+	window->setRelativePosition(rect<s32>(0, 0, 60, 60));
+	result &= compareHits(root, "after changing the layout");
+
+	for (u32 i=1; i<elements.size(); i+=5)
+		elements[i]->remove();
+	elements[2]->setNotClipped(true);
+	elements[2]->setRelativePosition(rect<s32>(-5, -5, 40, 40));
+	result &= compareHits(root, "after removing elements");
+
+	// hover updates over a full gui
+	ITimer* timer = device->getTimer();
+	const u32 moves = 20000;
+	u32 start = timer->getRealTime();
+	for (u32 i=0; i<moves; ++i)
+		moveMouse(device, (i * 7) % 320, (i * 11) % 240);
+	const u32 hoverTime = timer->getRealTime() - start;
+
+	start = timer->getRealTime();
+	for (u32 i=0; i<moves; ++i)
+		findElement(root, position2d<s32>((i * 7) % 320, (i * 11) % 240));
+	const u32 searchTime = timer->getRealTime() - start;
+
+	logTestString("%u hover updates: %u ms, testing each element %u ms\n", moves, hoverTime, searchTime);
+
+	// a modal screen catches all points
+	env->addMessageBox(L"Hit", L"Test");
+	result &= compareHits(root, "with a modal screen");
+
+	device->drop();
+
+	return result;
+}
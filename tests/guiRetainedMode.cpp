@@ -0,0 +1,172 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+//! Draws the gui over a background and returns a screenshot
+static video::IImage* drawGUI(IrrlichtDevice* device, video::SColor background)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	driver->beginScene(true, true, background);
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+
+	return driver->createScreenShot();
+}
+
+
+//! Compares the gui drawn in retained mode to the gui drawn each frame
+/** The retained mode restores the alpha of the gui from two renderings,
+so colors may differ by rounding. The whole gui is repainted afterwards. */
+static bool compareModes(IrrlichtDevice* device, video::SColor background, const char* what)
+{
+	IGUIEnvironment* env = device->getGUIEnvironment();
+
+	video::IImage* retained = drawGUI(device, background);
+	env->setRetainedMode(false);
+	video::IImage* expected = drawGUI(device, background);
+	env->setRetainedMode(true);
+
+	bool result = expected && retained;
+	u32 maxDifference = 0;
+
+	if (result)
+	{
+		const dimension2du size = expected->getDimension();
+		for (u32 y=0; y<size.Height; ++y)
+			for (u32 x=0; x<size.Width; ++x)
+			{
+				const video::SColor a = expected->getPixel(x, y);
+				const video::SColor b = retained->getPixel(x, y);
+				maxDifference = core::max_(maxDifference,
+					(u32)core::abs_((s32)a.getRed() - (s32)b.getRed()),
+					(u32)core::abs_((s32)a.getGreen() - (s32)b.getGreen()));
+				maxDifference = core::max_(maxDifference,
+					(u32)core::abs_((s32)a.getBlue() - (s32)b.getBlue()));
+			}
+	}
+
+	if (maxDifference > 2)
+	{
+		logTestString("Retained mode differs by %u with %s.\n", maxDifference, what);
+		result = false;
+	}
+
+	if (expected)
+		expected->drop();
+	if (retained)
+		retained->drop();
+
+	return result;
+}
+
+
+//! An element which draws beyond its clipping rectangle
+class COverdrawElement : public IGUIElement
+{
+public:
+	COverdrawElement(IGUIEnvironment* env, const rect<s32>& rectangle)
+		: IGUIElement(EGUIET_ELEMENT, env, env->getRootGUIElement(), -1, rectangle)
+	{
+	}
+
+	virtual void draw()
+	{
+		if (!IsVisible)
+			return;
+
+		rect<s32> r(AbsoluteRect);
+		r.UpperLeftCorner -= position2d<s32>(20, 40);
+		r.LowerRightCorner += position2d<s32>(60, 110);
+		Environment->getVideoDriver()->draw2DRectangle(video::SColor(255,0,200,0), r);
+	}
+};
+
+
+//! The retained mode has to look like drawing the gui each frame and only repaint changes
+bool guiRetainedMode(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(320, 240), 32);
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+
+	// below a text, which its drawing covers
+	IGUIElement* overdraw = new COverdrawElement(env, rect<s32>(230, 100, 250, 120));
+	overdraw->drop();
+	env->addStaticText(L"Above", rect<s32>(220, 130, 300, 160), true, true, 0, -1, true);
+
+	IGUIWindow* window = env->addWindow(rect<s32>(10, 10, 200, 200), false, L"Window");
+	env->addButton(rect<s32>(10, 30, 90, 50), window, -1, L"Button");
+	IGUIStaticText* text = env->addStaticText(L"Static text", rect<s32>(10, 60, 180, 80), true, true, window);
+	env->addEditBox(L"Edit box", rect<s32>(10, 90, 180, 110), true, window);
+	IGUIListBox* list = env->addListBox(rect<s32>(10, 120, 180, 180), window);
+	for (u32 i=0; i<20; ++i)
+		list->addItem(L"Item");
+	env->addCheckBox(true, rect<s32>(220, 20, 300, 40), 0, -1, L"Check box");
+
+	if (!env->setRetainedMode(true))
+	{
+		logTestString("Retained mode is not supported.\n");
+		device->drop();
+		return false;
+	}
+
+	bool result = compareModes(device, video::SColor(255,40,90,160), "a blue background");
+	result &= compareModes(device, video::SColor(255,200,30,30), "a red background");
+
+	// nothing changed after the first frame, so nothing is repainted
+	drawGUI(device, video::SColor(255,40,90,160))->drop();
+	drawGUI(device, video::SColor(255,40,90,160))->drop();
+	if (env->getRepaintedArea() != 0)
+	{
+		logTestString("Retained mode repainted %u pixels without changes.\n", env->getRepaintedArea());
+		result = false;
+	}
+
+	// only the changed text is repainted, and it has to fit to the rest
+	text->setText(L"Changed text");
+	drawGUI(device, video::SColor(255,40,90,160))->drop();
+	if (env->getRepaintedArea() != (u32)text->getAbsoluteClippingRect().getArea())
+	{
+		logTestString("Retained mode repainted %u pixels for a changed text.\n", env->getRepaintedArea());
+		result = false;
+	}
+	result &= compareModes(device, video::SColor(255,40,90,160), "a changed text");
+
+	window->move(position2d<s32>(30, 5));
+	result &= compareModes(device, video::SColor(255,40,90,160), "a moved window");
+
+	// only the pixels of the repainted rectangle may change in the cache
+	drawGUI(device, video::SColor(255,40,90,160))->drop();
+	overdraw->invalidate();
+	result &= compareModes(device, video::SColor(255,40,90,160), "an element drawing outside of its rectangle");
+
+	// compare the time of drawing all and drawing the cached gui
+	video::IVideoDriver* driver = device->getVideoDriver();
+	u32 times[2];
+	for (u32 mode=0; mode<2; ++mode)
+	{
+		env->setRetainedMode(mode == 1);
+		const u32 start = device->getTimer()->getRealTime();
+		for (u32 i=0; i<100; ++i)
+		{
+			driver->beginScene(true, true, video::SColor(255,40,90,160));
+			env->drawAll();
+			driver->endScene();
+		}
+		times[mode] = device->getTimer()->getRealTime() - start;
+	}
+	logTestString("100 frames of gui: %u ms drawn each frame, %u ms retained\n", times[0], times[1]);
+
+	device->drop();
+
+	return result;
+}
+
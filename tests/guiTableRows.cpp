@@ -0,0 +1,215 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+//! The value of a cell, many rows have the same value in the first column
+static u32 cellValue(u32 row, u32 column)
+{
+	return column ? row : (row * 7919) % 97;
+}
+
+
+//! Supplies the same cells as the rows added to the stored table
+class LogProvider : public IGUITableDataProvider
+{
+public:
+	LogProvider(u32 rows) : Rows(rows) {}
+
+	virtual u32 getRowCount() const
+	{
+		return Rows;
+	}
+
+	virtual const wchar_t* getCellText(u32 rowIndex, u32 columnIndex) const
+	{
+		Text = columnIndex ? L"Entry " : L"";
+		Text += cellValue(rowIndex, columnIndex);
+		return Text.c_str();
+	}
+
+	u32 Rows;
+	mutable stringw Text;
+};
+
+
+//! Draws the gui and returns a screenshot
+static video::IImage* drawGUI(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	driver->beginScene(true, true, video::SColor(255,100,101,140));
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+
+	return driver->createScreenShot();
+}
+
+
+//! Scrolls a table or list box with the mouse wheel
+static void scroll(IGUIElement* element, f32 wheel)
+{
+	SEvent event;
+	event.EventType = EET_MOUSE_INPUT_EVENT;
+	event.MouseInput.Event = EMIE_MOUSE_WHEEL;
+	event.MouseInput.Wheel = wheel;
+	event.MouseInput.X = element->getAbsolutePosition().UpperLeftCorner.X + 5;
+	event.MouseInput.Y = element->getAbsolutePosition().UpperLeftCorner.Y + 30;
+	event.MouseInput.ButtonStates = 0;
+	element->OnEvent(event);
+}
+
+
+//! Tables with a data provider have to look and order like tables with their own rows
+bool guiTableRows(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(320, 240), 32);
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	const rect<s32> tableRect(10, 10, 310, 230);
+
+	IGUITable* stored = env->addTable(tableRect);
+	IGUITable* provided = env->addTable(tableRect);
+	const u32 rowCount = 500;
+
+	for (u32 c=0; c<2; ++c)
+	{
+		stored->addColumn(c ? L"Text" : L"Value");
+		provided->addColumn(c ? L"Text" : L"Value");
+		stored->setColumnWidth(c, 100);
+		provided->setColumnWidth(c, 100);
+	}
+
+	for (u32 r=0; r<rowCount; ++r)
+	{
+		stored->addRow(r);
+		for (u32 c=0; c<2; ++c)
+		{
+			stringw text(c ? L"Entry " : L"");
+			text += cellValue(r, c);
+			stored->setCellText(r, c, text);
+		}
+		stored->setCellData(r, 0, (void*)(size_t)r);
+	}
+
+	LogProvider* provider = new LogProvider(rowCount);
+	provided->setDataProvider(provider);
+
+	bool result = (provided->getRowCount() == stored->getRowCount());
+
+	// equal values keep the order of their rows
+	stored->setSelected(123);
+	provided->setSelected(123);
+	stored->orderRows(0, EGOM_DESCENDING);
+	provided->orderRows(0, EGOM_DESCENDING);
+
+	for (u32 r=0; r<rowCount && result; ++r)
+	{
+		for (u32 c=0; c<2; ++c)
+		{
+			const stringw text(provided->getCellText(r, c));
+			if (text != stored->getCellText(r, c))
+			{
+				logTestString("Row %u differs after ordering the rows.\n", r);
+				result = false;
+			}
+		}
+
+		if (r > 0)
+		{
+			const stringw value(stored->getCellText(r, 0));
+			const stringw previous(stored->getCellText(r-1, 0));
+			if (previous < value || (value == previous &&
+				stored->getCellData(r, 0) < stored->getCellData(r-1, 0)))
+			{
+				logTestString("Row %u is not ordered.\n", r);
+				result = false;
+			}
+		}
+	}
+
+	if (stored->getSelected() != provided->getSelected() ||
+		stored->getCellData(stored->getSelected(), 0) != (void*)123)
+	{
+		logTestString("The selection did not move with the ordered row.\n");
+		result = false;
+	}
+
+	// both tables have to look the same at a scrolled position
+	for (u32 i=0; i<2 && result; ++i)
+	{
+		if (i)
+		{
+			scroll(stored, -200.f);
+			scroll(provided, -200.f);
+		}
+
+		provided->setVisible(false);
+		stored->setVisible(true);
+		video::IImage* expected = drawGUI(device);
+		stored->setVisible(false);
+		provided->setVisible(true);
+		video::IImage* shown = drawGUI(device);
+
+		if (expected && shown)
+		{
+			const dimension2du size = expected->getDimension();
+			for (u32 y=0; y<size.Height && result; ++y)
+				for (u32 x=0; x<size.Width && result; ++x)
+					if (expected->getPixel(x, y) != shown->getPixel(x, y))
+					{
+						logTestString("The provided table differs at %u, %u.\n", x, y);
+						result = false;
+					}
+		}
+		else
+			result = false;
+
+		if (expected)
+			expected->drop();
+		if (shown)
+			shown->drop();
+	}
+
+	// only the shown rows of a large provider are drawn
+	stored->setVisible(false);
+	provider->Rows = 500000;
+	provided->setDataProvider(provider);
+	provided->setVisible(true);
+	scroll(provided, -100000.f);
+
+	ITimer* timer = device->getTimer();
+	u32 start = timer->getRealTime();
+	for (u32 i=0; i<10; ++i)
+		drawGUI(device)->drop();
+	const u32 drawTime = timer->getRealTime() - start;
+
+	start = timer->getRealTime();
+	provided->orderRows(0, EGOM_ASCENDING);
+	const u32 orderTime = timer->getRealTime() - start;
+
+	logTestString("500000 provided rows: 10 frames %u ms, ordering %u ms\n", drawTime, orderTime);
+
+	provided->setVisible(false);
+	IGUIListBox* list = env->addListBox(tableRect);
+	for (u32 i=0; i<100000; ++i)
+		list->addItem(L"Entry");
+	scroll(list, -1000.f);
+
+	start = timer->getRealTime();
+	for (u32 i=0; i<10; ++i)
+		drawGUI(device)->drop();
+	logTestString("100000 list box items: 10 frames %u ms\n", timer->getRealTime() - start);
+
+	provider->drop();
+	device->drop();
+
+	return result;
+}
+
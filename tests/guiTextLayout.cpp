@@ -0,0 +1,169 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+//! Counts how often a font measures a text
+class CountingFont : public IGUIFont
+{
+public:
+	CountingFont(IGUIFont* font) : Font(font), Measured(0)
+	{
+		Font->grab();
+	}
+
+	~CountingFont()
+	{
+		Font->drop();
+	}
+
+	virtual void draw(const stringw& text, const rect<s32>& position,
+		video::SColor color, bool hcenter=false, bool vcenter=false,
+		const rect<s32>* clip=0)
+	{
+		Font->draw(text, position, color, hcenter, vcenter, clip);
+	}
+
+	virtual dimension2d<u32> getDimension(const wchar_t* text) const
+	{
+		++Measured;
+		return Font->getDimension(text);
+	}
+
+	virtual s32 getCharacterFromPos(const wchar_t* text, s32 pixel_x) const
+	{
+		return Font->getCharacterFromPos(text, pixel_x);
+	}
+
+	virtual void setKerningWidth(s32 kerning)
+	{
+		Font->setKerningWidth(kerning);
+	}
+
+	virtual void setKerningHeight(s32 kerning)
+	{
+		Font->setKerningHeight(kerning);
+	}
+
+	virtual s32 getKerningWidth(const wchar_t* thisLetter=0, const wchar_t* previousLetter=0) const
+	{
+		return Font->getKerningWidth(thisLetter, previousLetter);
+	}
+
+	virtual s32 getKerningHeight() const
+	{
+		return Font->getKerningHeight();
+	}
+
+	virtual void setInvisibleCharacters(const wchar_t *s)
+	{
+		Font->setInvisibleCharacters(s);
+	}
+
+	IGUIFont* Font;
+	mutable u32 Measured;
+};
+
+
+//! Draws the gui and returns a screenshot
+static video::IImage* drawGUI(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	driver->beginScene(true, true, video::SColor(255,100,101,140));
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+
+	return driver->createScreenShot();
+}
+
+
+//! The text of a hud with a changing line
+static stringw hudText(u32 frame)
+{
+	stringw text(L"Position: 10 20 30\nTarget: 40 50 60\nFrame: ");
+	text += frame;
+	text += L"\nLoaded 1234 meshes with many textures and a long line to wrap\nFree memory: a lot";
+	return text;
+}
+
+
+//! Changing a line of a text only measures that line again, and it has to look like a new text
+bool guiTextLayout(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(320, 240), 32);
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	CountingFont* font = new CountingFont(env->getBuiltInFont());
+
+	IGUIStaticText* hud = env->addStaticText(hudText(0).c_str(), rect<s32>(10, 10, 200, 120), true, true);
+	hud->setOverrideFont(font);
+	hud->setTextAlignment(EGUIA_LOWERRIGHT, EGUIA_UPPERLEFT);
+	drawGUI(device)->drop();
+
+	// drawing again only measures the height of a line
+	font->Measured = 0;
+	drawGUI(device)->drop();
+	bool result = (font->Measured <= 1);
+	if (!result)
+		logTestString("Drawing an unchanged text measured %u texts.\n", font->Measured);
+
+	// only the changed line is broken again
+	font->Measured = 0;
+	hud->setText(hudText(1).c_str());
+	const u32 changed = font->Measured;
+
+	IGUIStaticText* fresh = env->addStaticText(L"", rect<s32>(10, 10, 200, 120), true, true);
+	fresh->setOverrideFont(font);
+	fresh->setTextAlignment(EGUIA_LOWERRIGHT, EGUIA_UPPERLEFT);
+	font->Measured = 0;
+	fresh->setText(hudText(1).c_str());
+	const u32 all = font->Measured;
+
+	logTestString("Changing a hud line measured %u texts, a new text %u.\n", changed, all);
+	if (changed * 3 > all)
+		result = false;
+
+	if (hud->getTextHeight() != fresh->getTextHeight() || hud->getTextWidth() != fresh->getTextWidth())
+	{
+		logTestString("The changed text has a different size than the new text.\n");
+		result = false;
+	}
+
+	fresh->setVisible(false);
+	video::IImage* changedImage = drawGUI(device);
+	hud->setVisible(false);
+	fresh->setVisible(true);
+	video::IImage* freshImage = drawGUI(device);
+
+	if (changedImage && freshImage)
+	{
+		const dimension2du size = freshImage->getDimension();
+		for (u32 y=0; y<size.Height && result; ++y)
+			for (u32 x=0; x<size.Width && result; ++x)
+				if (changedImage->getPixel(x, y) != freshImage->getPixel(x, y))
+				{
+					logTestString("The changed text differs from the new text at %u, %u.\n", x, y);
+					result = false;
+				}
+	}
+	else
+		result = false;
+
+	if (changedImage)
+		changedImage->drop();
+	if (freshImage)
+		freshImage->drop();
+
+	font->drop();
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,95 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+static const u32 FrameCount = 5;
+
+//! the clear color of a frame
+static SColor getFrameColor(u32 frame)
+{
+	return SColor(255, frame * 50, 255 - frame * 50, 100);
+}
+
+
+//! Renders frames with different clear colors into the frame output
+static bool renderFrames(const io::path& output, u32 buffers)
+{
+	SIrrlichtCreationParameters params;
+	params.DeviceType = EIDT_HEADLESS;
+	params.DriverType = EDT_BURNINGSVIDEO;
+	params.WindowSize = dimension2d<u32>(64, 48);
+	params.FrameOutput = output;
+	params.FrameOutputBuffers = buffers;
+
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	bool result = (device->getType() == EIDT_HEADLESS);
+	for (u32 i=0; i<FrameCount && device->run(); ++i)
+	{
+		result &= device->getVideoDriver()->beginScene(true, true, getFrameColor(i));
+		result &= device->getVideoDriver()->endScene();
+	}
+
+	// the last frames are written when the device is destroyed
+	device->drop();
+	return result;
+}
+
+
+//! Frames rendered without a window are written as image files or a raw stream
+bool headlessDevice(void)
+{
+	bool result = renderFrames("results/headlessDevice%03d.png", 3);
+	result &= renderFrames("results/headlessDevice.raw", 2);
+
+	// a device without frame output only reads the results back
+	SIrrlichtCreationParameters params;
+	params.DeviceType = EIDT_HEADLESS;
+	params.DriverType = EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return false;
+
+	for (u32 i=0; i<FrameCount; ++i)
+	{
+		c8 name[64];
+		snprintf(name, 64, "results/headlessDevice%03u.png", i);
+		IImage* image = device->getVideoDriver()->createImageFromFile(name);
+		if (!image || image->getDimension() != dimension2d<u32>(64, 48) ||
+			image->getPixel(10, 10).color != getFrameColor(i).color)
+		{
+			logTestString("%s was not written with the color of frame %u.\n", name, i);
+			result = false;
+		}
+		if (image)
+			image->drop();
+	}
+
+	io::IReadFile* file = device->getFileSystem()->createAndOpenFile("results/headlessDevice.raw");
+	if (!file || file->getSize() != (long)(FrameCount * 64 * 48 * 4))
+	{
+		logTestString("The raw frame stream has %ld bytes.\n", file ? file->getSize() : 0);
+		result = false;
+	}
+	if (file)
+	{
+		// the pixels of the last frame are at the end
+		u32 pixel = 0;
+		file->seek(file->getSize() - 4);
+		file->read(&pixel, 4);
+		result &= (pixel == getFrameColor(FrameCount - 1).color);
+		file->drop();
+	}
+
+	device->drop();
+
+	return result;
+}
+
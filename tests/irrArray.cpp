@@ -60,6 +60,34 @@ static bool testSwap()
 	return result;
 }
 
+// Arrays in an arena take the same memory again after it was reset
+static bool testArena()
+{
+	bool result = true;
+
+	irrMemoryArena arena(1024);
+	for ( int frame=0; frame<10; ++frame )
+	{
+		core::array<int, irrAllocatorArena<int> > array1;
+		array1.getAllocator().setArena(&arena);
+		for ( int i=0; i<1000; ++i )
+			array1.push_back(i);
+		for ( int i=0; i<1000; ++i )
+			result &= (array1[i] == i);
+
+		result &= (arena.getUsedBytes() >= 1000*sizeof(int));
+		arena.reset();
+	}
+
+	// the blocks of the first frame are merged, later frames fit into them
+	result &= (arena.getHeapAllocationCount() < 10);
+	result &= (arena.getUsedBytes() == 0);
+
+	assert( result );
+
+	return result;
+}
+
 // Test the functionality of core::array
 bool testIrrArray(void)
 {
@@ -69,6 +97,7 @@ bool testIrrArray(void)
 	crashTestFastAlloc();
 	allExpected &= testSelfAssignment();
 	allExpected &= testSwap();
+	allExpected &= testArena();
 
 	if(allExpected)
 		logTestString("\nAll tests passed\n");
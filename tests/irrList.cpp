@@ -58,6 +58,48 @@ static bool testSwap()
 	return result;
 }
 
+// Lists with pooled nodes have to reuse their nodes and keep them when swapped
+static bool testPool()
+{
+	bool result = true;
+
+	core::list<int, irrAllocatorPool> list1, list2;
+	core::list<int> compare;
+	for ( int i=0; i<1000; ++i )
+	{
+		list1.push_back(i);
+		compare.push_back(i);
+	}
+
+	// removing and adding elements again takes no more memory from the heap
+	const u32 heapAllocations = list1.getAllocator().getHeapAllocationCount();
+	for ( int k=0; k<10; ++k )
+	{
+		core::list<int, irrAllocatorPool>::Iterator iter = list1.begin();
+		while ( iter != list1.end() )
+			iter = list1.erase(iter);
+		for ( int i=0; i<1000; ++i )
+			list1.push_back(i);
+	}
+	result &= (list1.getAllocator().getHeapAllocationCount() == heapAllocations);
+	result &= (heapAllocations < 20);
+
+	list2.push_back(5);
+	list1.swap(list2);
+	list1.clear();	// the node of list2 has to be released by the pool of list2
+	list1.push_back(7);
+
+	core::list<int, irrAllocatorPool>::ConstIterator iter = list2.begin();
+	core::list<int>::ConstIterator iterCompare = compare.begin();
+	for ( ; iter != list2.end() && iterCompare != compare.end(); ++iter, ++iterCompare )
+		result &= (*iter == *iterCompare);
+	result &= (list2.size() == compare.size() && *list1.begin() == 7);
+
+	assert( result );
+
+	return result;
+}
+
 // Test the functionality of core::list
 bool testIrrList(void)
 {
@@ -67,6 +109,7 @@ bool testIrrList(void)
 	constIteratorCompileTest(compileThisList);
 
 	success &= testSwap();
+	success &= testPool();
 
 	if(success)
 		logTestString("\nAll tests passed\n");
@@ -49,12 +49,59 @@ static bool testSwap()
 	return result;
 }
 
+// Maps with pooled nodes have to behave like maps with nodes on the heap
+static bool testPool()
+{
+	bool result = true;
+
+	core::map<int, int, irrAllocatorPool> pooled;
+	core::map<int, int> compare;
+	for ( int i=0; i<500; ++i )
+	{
+		pooled[(i*7919)%500] = i;
+		compare[(i*7919)%500] = i;
+	}
+	for ( int i=0; i<500; i+=3 )
+	{
+		pooled.remove(i);
+		compare.remove(i);
+	}
+
+	// removed nodes are used again
+	const u32 heapAllocations = pooled.getAllocator().getHeapAllocationCount();
+	for ( int i=0; i<500; i+=3 )
+		pooled.insert(i, -i);
+	for ( int i=0; i<500; i+=3 )
+		pooled.remove(i);
+	result &= (pooled.getAllocator().getHeapAllocationCount() == heapAllocations);
+
+	result &= (pooled.size() == compare.size());
+	core::map<int, int, irrAllocatorPool>::Iterator iter = pooled.getIterator();
+	core::map<int, int>::Iterator iterCompare = compare.getIterator();
+	for ( ; !iter.atEnd() && !iterCompare.atEnd(); iter++, iterCompare++ )
+	{
+		result &= (iter->getKey() == iterCompare->getKey());
+		result &= (iter->getValue() == iterCompare->getValue());
+	}
+
+	core::map<int, int, irrAllocatorPool> other;
+	other.insert(1, 1);
+	other.swap(pooled);
+	pooled.clear();	// the node has to be released by the pool of the other map
+	result &= (other.size() == compare.size() && pooled.empty());
+
+	assert( result );
+
+	return result;
+}
+
 // Test the functionality of core::list
 bool testIrrMap(void)
 {
 	bool success = true;
 
 	success &= testSwap();
+	success &= testPool();
 
 	if(success)
 		logTestString("\nAll tests passed\n");
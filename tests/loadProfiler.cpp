@@ -0,0 +1,143 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+//! Checks how often a kind of work was recorded for an asset
+static bool checkCount(const SLoadProfileAsset* asset, E_LOAD_PROFILE_EVENT type, u32 minCount, u32 maxCount)
+{
+	if (asset && asset->Count[type] >= minCount && asset->Count[type] <= maxCount)
+		return true;
+
+	logTestString("%s was recorded %u times for %s.\n", LoadProfileEventNames[type],
+		asset ? asset->Count[type] : 0, asset ? stringc(asset->Name).c_str() : "a missing asset");
+	return false;
+}
+
+
+//! Returns the loaded texture asset with the most texels
+static const SLoadProfileAsset* getLargestTexture(ILoadProfiler* profiler)
+{
+	const SLoadProfileAsset* result = 0;
+	for (u32 i=0; i<profiler->getAssetCount(); ++i)
+	{
+		const SLoadProfileAsset& a = profiler->getAsset(i);
+		if (a.Count[ELPE_UPLOAD] && (!result || a.Texels > result->Texels))
+			result = &a;
+	}
+	return result;
+}
+
+
+//! Loading meshes and textures is recorded per asset and written as a trace
+bool loadProfiler(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ILoadProfiler* profiler = device->getLoadProfiler();
+
+	// nothing is recorded until asked for
+	bool result = profiler && !profiler->isEnabled();
+	if (!result)
+	{
+		device->drop();
+		return false;
+	}
+	smgr->getMesh("../media/earth.x");
+	result &= (profiler->getAssetCount() == 0);
+
+	profiler->setEnabled(true);
+	const char* dwarf = "../media/dwarf.x";
+	IAnimatedMesh* mesh = smgr->getMesh(dwarf);
+	result &= (mesh != 0);
+
+	// work on the mesh file counts for the mesh, its textures are assets of their own
+	const SLoadProfileAsset* asset = profiler->getAsset(dwarf);
+	result &= checkCount(asset, ELPE_LOAD, 1, 1);
+	result &= checkCount(asset, ELPE_OPEN, 1, 1);
+	result &= checkCount(asset, ELPE_READ, 1, 0xFFFFFFFF);
+	result &= checkCount(asset, ELPE_PARSE, 1, 1);
+	result &= checkCount(asset, ELPE_UPLOAD, 0, 0);
+	if (asset && (asset->Vertices != 1479 || asset->Indices != 5688 ||
+		asset->BytesAllocated < 1479 * sizeof(S3DVertex)))
+	{
+		logTestString("%s has %u vertices, %u indices and %u bytes.\n", dwarf,
+			asset->Vertices, asset->Indices, asset->BytesAllocated);
+		result = false;
+	}
+
+	const SLoadProfileAsset* texture = getLargestTexture(profiler);
+	result &= checkCount(texture, ELPE_LOAD, 1, 1);
+	result &= checkCount(texture, ELPE_PARSE, 1, 1);
+	result &= checkCount(texture, ELPE_UPLOAD, 1, 1);
+	if (!texture || texture->Texels < 256 * 256 || texture->Vertices)
+	{
+		logTestString("The texture of %s was not recorded.\n", dwarf);
+		result = false;
+	}
+
+	// cached meshes cost nothing
+	const u32 assetCount = profiler->getAssetCount();
+	smgr->getMesh(dwarf);
+	result &= (profiler->getAssetCount() == assetCount) && checkCount(asset, ELPE_LOAD, 1, 1);
+
+	// files of archives are decompressed
+	device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	const char* lamp = "models/mapobjects/timlamp/timlamp.tga";
+	result &= (device->getVideoDriver()->getTexture(lamp) != 0);
+	asset = profiler->getAsset(lamp);
+	result &= checkCount(asset, ELPE_DECOMPRESS, 1, 1);
+	result &= checkCount(asset, ELPE_UPLOAD, 1, 1);
+	if (asset && asset->Texels != 128 * 128)
+	{
+		logTestString("%s has %u texels.\n", lamp, asset->Texels);
+		result = false;
+	}
+
+	profiler->logSummary(5);
+
+	// the trace holds the load events of both assets
+	profiler->setEnabled(false);
+	const char* filename = "results/loadProfiler.json";
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	result &= profiler->writeChromeTrace(file);
+	if (file)
+		file->drop();
+
+	io::IReadFile* readFile = device->getFileSystem()->createAndOpenFile(filename);
+	if (readFile)
+	{
+		array<c8> text;
+		text.set_used(readFile->getSize() + 1);
+		readFile->read(text.pointer(), readFile->getSize());
+		text[readFile->getSize()] = 0;
+		readFile->drop();
+
+		const stringc trace(text.const_pointer());
+		if (trace.find("{\"traceEvents\":[") != 0 ||
+			trace.find("{\"name\":\"../media/dwarf.x\",\"cat\":\"load\",\"ph\":\"X\"") < 0 ||
+			trace.find("\"cat\":\"decompress\"") < 0 || trace.find("\n]}\n") < 0)
+		{
+			logTestString("%s is not the expected trace.\n", filename);
+			result = false;
+		}
+	}
+	else
+		result = false;
+
+	profiler->clear();
+	result &= (profiler->getAssetCount() == 0);
+
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,136 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+//! Loads an image with the loader of its file extension
+static IImage* loadImage(IrrlichtDevice* device, const char* filename, const dimension2du& maxSize)
+{
+	IVideoDriver* driver = device->getVideoDriver();
+	io::IReadFile* file = device->getFileSystem()->createAndOpenFile(filename);
+	if (!file)
+		return 0;
+
+	IImage* image = 0;
+	for (u32 i=0; i<driver->getImageLoaderCount() && !image; ++i)
+	{
+		if (driver->getImageLoader(i)->isALoadableFileExtension(filename))
+		{
+			file->seek(0);
+			image = driver->getImageLoader(i)->loadScaledImage(file, maxSize);
+		}
+	}
+	file->drop();
+	return image;
+}
+
+
+//! Returns the largest difference between the image and boxes of pixels of the reference
+static u32 compareBoxes(IImage* image, IImage* reference, u32 factor)
+{
+	const dimension2du size = reference->getDimension();
+	u32 difference = 0;
+	for (u32 y=0; y<image->getDimension().Height; ++y)
+	{
+		for (u32 x=0; x<image->getDimension().Width; ++x)
+		{
+			// the boxes at the right and bottom border are smaller
+			u32 sum[4] = {0, 0, 0, 0};
+			u32 count = 0;
+			for (u32 by=y*factor; by<min_((y+1)*factor, size.Height); ++by)
+			{
+				for (u32 bx=x*factor; bx<min_((x+1)*factor, size.Width); ++bx)
+				{
+					const SColor c = reference->getPixel(bx, by);
+					sum[0] += c.getAlpha();
+					sum[1] += c.getRed();
+					sum[2] += c.getGreen();
+					sum[3] += c.getBlue();
+					++count;
+				}
+			}
+
+			const SColor c = image->getPixel(x, y);
+			const u32 channels[4] = {c.getAlpha(), c.getRed(), c.getGreen(), c.getBlue()};
+			for (u32 i=0; i<4; ++i)
+				difference = max_(difference, (u32)abs_((s32)channels[i] - (s32)((sum[i] + count / 2) / count)));
+		}
+	}
+	return difference;
+}
+
+
+//! Checks the size of a scaled image and how much it differs from the full image
+static bool checkScaledImage(IrrlichtDevice* device, const char* filename, IImage* reference,
+		const dimension2du& maxSize, const dimension2du& expected, u32 factor, u32 tolerance)
+{
+	IImage* image = loadImage(device, filename, maxSize);
+	if (!image || image->getDimension() != expected)
+	{
+		logTestString("%s is not loaded at %ux%u for %ux%u.\n", filename,
+				expected.Width, expected.Height, maxSize.Width, maxSize.Height);
+		if (image)
+			image->drop();
+		return false;
+	}
+
+	const u32 difference = compareBoxes(image, reference, factor);
+	image->drop();
+	logTestString("%s at %ux%u differs by %u.\n", filename, expected.Width, expected.Height, difference);
+	return difference <= tolerance;
+}
+
+
+//! JPG and PNG images are decoded smaller if the size asked for allows
+bool loadScaledImage(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+
+	// a png with alpha in a size which no power of two divides
+	IImage* image = driver->createImage(ECF_A8R8G8B8, dimension2du(37, 21));
+	for (u32 y=0; y<21; ++y)
+		for (u32 x=0; x<37; ++x)
+			image->setPixel(x, y, SColor(255 - y * 10, x * 6, (x * y) % 256, y * 12));
+	const char* png = "results/loadScaledImage.png";
+	bool result = driver->writeImageToFile(image, png);
+
+	// sides are only reduced while they stay at least as large as asked for
+	result &= checkScaledImage(device, png, image, dimension2du(10, 6), dimension2du(10, 6), 4, 1);
+	result &= checkScaledImage(device, png, image, dimension2du(11, 6), dimension2du(19, 11), 2, 1);
+	result &= checkScaledImage(device, png, image, dimension2du(1, 1), dimension2du(5, 3), 8, 1);
+	result &= checkScaledImage(device, png, image, dimension2du(0, 0), dimension2du(37, 21), 1, 0);
+	image->drop();
+
+	// a jpg of smooth gradients, which the scaled DCT reproduces closely
+	image = driver->createImage(ECF_R8G8B8, dimension2du(128, 64));
+	for (u32 y=0; y<64; ++y)
+		for (u32 x=0; x<128; ++x)
+			image->setPixel(x, y, SColor(255, x * 2, 255 - y * 4, (x + y) & 0xFF));
+	const char* jpg = "results/loadScaledImage.jpg";
+	result &= driver->writeImageToFile(image, jpg, 100);
+	image->drop();
+
+	image = loadImage(device, jpg, dimension2du(0, 0));
+	if (image)
+	{
+		result &= checkScaledImage(device, jpg, image, dimension2du(64, 32), dimension2du(64, 32), 2, 6);
+		result &= checkScaledImage(device, jpg, image, dimension2du(16, 8), dimension2du(16, 8), 8, 6);
+		result &= checkScaledImage(device, jpg, image, dimension2du(30, 8), dimension2du(32, 16), 4, 6);
+		image->drop();
+	}
+	else
+		result = false;
+
+	device->drop();
+
+	return result;
+}
+
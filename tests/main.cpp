@@ -89,6 +89,15 @@ int main(int argumentCount, char * arguments[])
 	TEST(softwareDevice);
 	TEST(b3dAnimation);
 	TEST(burningsVideo);
+	TEST(burningsDepthTiles);
+	TEST(textureCompression);
+	TEST(textureMipMaps);
+	TEST(loadScaledImage);
+	TEST(meshLoader32BitIndices);
+	TEST(meshLoaderThreads);
+	TEST(meshLoaderX);
+	TEST(loadProfiler);
+	TEST(headlessDevice);
 	TEST(cursorSetVisible);
 	TEST(drawRectOutline);
 	TEST(flyCircleAnimator);
@@ -106,12 +115,19 @@ int main(int argumentCount, char * arguments[])
 	TEST(transparentAlphaChannelRef);
 	TEST(antiAliasing);
 	TEST(draw2DImage);
+	TEST(fontBatch);
+	TEST(guiRetainedMode);
+	TEST(guiTableRows);
+	TEST(guiTextLayout);
+	TEST(guiHitTest);
 	// TODO: Needs to be fixed first.
 //	TEST(projectionMatrix);
 	// large scenes
 	TEST(planeMatrix);
 	TEST(terrainSceneNode);
 	TEST(lightMaps);
+	TEST(q3LevelSceneNode);
+	TEST(q3ShaderSceneNode);
 
 	unsigned int numberOfTests = tests.size();
 	unsigned int testToRun = 0;
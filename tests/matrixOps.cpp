@@ -195,6 +195,168 @@ bool isOrthogonal(void)
 	return true;
 }
 
+// Random matrix entries, a few of them zero
+f32 randomEntry(u32& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	const u32 value = (seed >> 16) & 0x7fff;
+	return (value % 7 == 0) ? 0.f : (value / 16384.f - 1.f) * 10.f;
+}
+
+// Products and transformations have to be exactly like the generic code
+bool simdOperations(void)
+{
+	bool result = true;
+	u32 seed = 1;
+
+	for (u32 n=0; n<1000 && result; ++n)
+	{
+		matrix4 a(matrix4::EM4CONST_NOTHING), b(matrix4::EM4CONST_NOTHING);
+		for (u32 i=0; i<16; ++i)
+		{
+			a[i] = randomEntry(seed);
+			b[i] = randomEntry(seed);
+		}
+
+		f32 product[16];
+		for (u32 i=0; i<4; ++i)
+			for (u32 j=0; j<4; ++j)
+				product[i*4+j] = a[j]*b[i*4] + a[4+j]*b[i*4+1] + a[8+j]*b[i*4+2] + a[12+j]*b[i*4+3];
+
+		matrix4 c(a*b);
+		matrix4 d(matrix4::EM4CONST_NOTHING);
+		d.setbyproduct(a, b);
+		matrix4 e(a);
+		e *= b;
+		for (u32 i=0; i<16; ++i)
+			if (c[i] != product[i] || d[i] != product[i] || e[i] != product[i])
+			{
+				logTestString("Matrix product differs at element %u.\n", i);
+				result = false;
+			}
+
+		const vector3df v(randomEntry(seed), randomEntry(seed), randomEntry(seed));
+		vector3df t, r;
+		a.transformVect(t, v);
+		a.rotateVect(r, v);
+		if (t != vector3df(v.X*a[0] + v.Y*a[4] + v.Z*a[8] + a[12],
+				v.X*a[1] + v.Y*a[5] + v.Z*a[9] + a[13],
+				v.X*a[2] + v.Y*a[6] + v.Z*a[10] + a[14]) ||
+			r != vector3df(v.X*a[0] + v.Y*a[4] + v.Z*a[8],
+				v.X*a[1] + v.Y*a[5] + v.Z*a[9],
+				v.X*a[2] + v.Y*a[6] + v.Z*a[10]))
+		{
+			logTestString("Transformed vector differs.\n");
+			result = false;
+		}
+
+		// well conditioned matrices have to be inverted precisely
+		for (u32 i=0; i<16; i+=5)
+			a[i] += 40.f;
+		matrix4 inverse;
+		if (!a.getInverse(inverse) || !(a*inverse).equals(IdentityMatrix, 0.00001f))
+		{
+			logTestString("Inverse is wrong.\n");
+			result = false;
+		}
+	}
+
+	matrix4 singular;
+	singular[5] = 0.f;
+	matrix4 inverse;
+	if (singular.getInverse(inverse) || singular.makeInverse())
+	{
+		logTestString("Singular matrix was inverted.\n");
+		result = false;
+	}
+
+	return result;
+}
+
+// Batch transformations have to be like transforming each vector and box
+bool batchTransformations(void)
+{
+	bool result = true;
+	u32 seed = 7;
+
+	matrix4 m;
+	m.setRotationDegrees(vector3df(30, 40, 50));
+	m.setScale(vector3df(2, -3, 0.5f));
+	m.setTranslation(vector3df(5, 6, 7));
+
+	array<S3DVertex> vertices;
+	for (u32 i=0; i<1001; ++i)
+		vertices.push_back(S3DVertex(randomEntry(seed), randomEntry(seed), randomEntry(seed),
+			randomEntry(seed), randomEntry(seed), randomEntry(seed), SColor(i), 0.5f, 0.25f));
+
+	array<vector3df> positions;
+	positions.set_used(vertices.size());
+	array<S3DVertex> transformed(vertices);
+	m.transformVects(positions.pointer(), &vertices[0].Pos, vertices.size(), sizeof(S3DVertex));
+	m.transformVects(&transformed[0].Pos, &transformed[0].Pos, transformed.size(), sizeof(S3DVertex), sizeof(S3DVertex));
+	m.rotateVects(&transformed[0].Normal, &transformed[0].Normal, transformed.size(), sizeof(S3DVertex), sizeof(S3DVertex));
+	array<f32> homogeneous;
+	homogeneous.set_used(vertices.size()*4);
+	m.transformVects(homogeneous.pointer(), &vertices[0].Pos, vertices.size(), sizeof(S3DVertex));
+
+	for (u32 i=0; i<vertices.size(); ++i)
+	{
+		vector3df pos, normal;
+		m.transformVect(pos, vertices[i].Pos);
+		m.rotateVect(normal, vertices[i].Normal);
+		if (positions[i] != pos || transformed[i].Pos != pos || transformed[i].Normal != normal ||
+			transformed[i].Color != vertices[i].Color || transformed[i].TCoords != vertices[i].TCoords)
+		{
+			logTestString("Vertex %u was transformed wrong.\n", i);
+			result = false;
+			break;
+		}
+
+		const vector3df& v = vertices[i].Pos;
+		for (u32 j=0; j<4; ++j)
+		{
+			if (homogeneous[i*4+j] != v.X*m[j] + v.Y*m[4+j] + v.Z*m[8+j] + m[12+j])
+			{
+				logTestString("Vertex %u was transformed wrong into 4 floats.\n", i);
+				result = false;
+				break;
+			}
+		}
+	}
+
+	array<aabbox3df> boxes;
+	for (u32 i=0; i<100; ++i)
+	{
+		aabbox3df box(vector3df(randomEntry(seed), randomEntry(seed), randomEntry(seed)));
+		box.addInternalPoint(randomEntry(seed), randomEntry(seed), randomEntry(seed));
+		boxes.push_back(box);
+	}
+
+	array<aabbox3df> transformedBoxes(boxes);
+	m.transformBoxesEx(transformedBoxes.pointer(), transformedBoxes.size());
+	for (u32 i=0; i<boxes.size(); ++i)
+	{
+		// the box around the transformed corners
+		vector3df edges[8];
+		boxes[i].getEdges(edges);
+		for (u32 j=0; j<8; ++j)
+			m.transformVect(edges[j]);
+		aabbox3df box(edges[0]);
+		for (u32 j=1; j<8; ++j)
+			box.addInternalPoint(edges[j]);
+
+		if (!transformedBoxes[i].MinEdge.equals(box.MinEdge, 0.0001f) ||
+			!transformedBoxes[i].MaxEdge.equals(box.MaxEdge, 0.0001f))
+		{
+			logTestString("Box %u was transformed wrong.\n", i);
+			result = false;
+			break;
+		}
+	}
+
+	return result;
+}
+
 }
 
 bool matrixOps(void)
@@ -204,6 +366,8 @@ bool matrixOps(void)
 	result &= rotations();
 	result &= isOrthogonal();
 	result &= transformations();
+	result &= simdOperations();
+	result &= batchTransformations();
 	return result;
 }
 
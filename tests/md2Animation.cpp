@@ -12,7 +12,7 @@ using namespace gui;
 
 // Tests MD2 animations.
 /** At the moment, this just verifies that the last frame of the animation produces the expected bitmap. */
-bool md2Animation(void)
+static bool renderLastFrame(void)
 {
 	// Use EDT_BURNINGSVIDEO since it is not dependent on (e.g.) OpenGL driver versions.
 	IrrlichtDevice *device = createDevice( EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
@@ -77,3 +77,108 @@ bool md2Animation(void)
 	return result;
 }
 
+
+// Animates a crowd of nodes sharing one mesh.
+/** Checks that the interpolated frame is updated whenever another frame or
+loop is requested, and logs how long it takes to animate the crowd. */
+static bool animateCrowd(void)
+{
+	IrrlichtDevice *device = createDevice(EDT_NULL, dimension2d<u32>(160, 120));
+	if (!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+	IAnimatedMesh* mesh = smgr->getMesh("../media/sydney.md2");
+	if (!mesh)
+	{
+		device->drop();
+		return false;
+	}
+
+	bool result = true;
+
+	// remember some frames, then request them again in a different order
+	const s32 frames[] = { 0, 5, 37, 37, 100, 0 };
+	const u32 frameCount = sizeof(frames)/sizeof(frames[0]);
+	array<vector3df> positions[frameCount];
+	u32 i;
+	for (i=0; i<frameCount; ++i)
+	{
+		IMeshBuffer* mb = mesh->getMesh(frames[i])->getMeshBuffer(0);
+		for (u32 v=0; v<mb->getVertexCount(); ++v)
+			positions[i].push_back(mb->getPosition(v));
+	}
+	for (i=frameCount; i>0; --i)
+	{
+		IMeshBuffer* mb = mesh->getMesh(frames[i-1])->getMeshBuffer(0);
+		for (u32 v=0; v<mb->getVertexCount(); ++v)
+		{
+			if (mb->getPosition(v) != positions[i-1][v])
+			{
+				logTestString("md2 frame %d not interpolated again.\n", frames[i-1]);
+				result = false;
+				break;
+			}
+		}
+	}
+
+	// the same frame inside another loop interpolates towards another keyframe
+	IMeshBuffer* mb = mesh->getMesh(159, 255, 154, 159)->getMeshBuffer(0);
+	array<vector3df> loopEnd;
+	for (i=0; i<mb->getVertexCount(); ++i)
+		loopEnd.push_back(mb->getPosition(i));
+	mb = mesh->getMesh(159, 255, 0, 159)->getMeshBuffer(0);
+	for (i=0; i<mb->getVertexCount(); ++i)
+		if (mb->getPosition(i) != loopEnd[i])
+			break;
+	if (i == mb->getVertexCount())
+	{
+		logTestString("md2 loop change not interpolated.\n");
+		result = false;
+	}
+
+	// a crowd running in step, and a crowd with all nodes at different frames
+	enum { CROWD_SIZE = 100, ITERATIONS = 100 };
+	IAnimatedMeshSceneNode* nodes[CROWD_SIZE];
+	for (i=0; i<CROWD_SIZE; ++i)
+	{
+		nodes[i] = smgr->addAnimatedMeshSceneNode(mesh, 0, -1, vector3df((f32)(i%10)*40.f, 0, (f32)(i/10)*40.f));
+		nodes[i]->setMD2Animation(EMAT_RUN);
+		nodes[i]->setAnimationSpeed(0);
+	}
+	(void)smgr->addCameraSceneNode(0, vector3df(200, 100, -100), vector3df(200, 0, 200));
+
+	ITimer* timer = device->getTimer();
+	u32 then = timer->getRealTime();
+	s32 n;
+	for (n=0; n<ITERATIONS; ++n)
+	{
+		for (i=0; i<CROWD_SIZE; ++i)
+			nodes[i]->setCurrentFrame((f32)(nodes[i]->getStartFrame() + n % 20));
+		smgr->drawAll();
+	}
+	const u32 inStepTime = timer->getRealTime() - then;
+
+	then += inStepTime;
+	for (n=0; n<ITERATIONS; ++n)
+	{
+		for (i=0; i<CROWD_SIZE; ++i)
+			nodes[i]->setCurrentFrame((f32)(nodes[i]->getStartFrame() + (n + i) % 20));
+		smgr->drawAll();
+	}
+	const u32 scatteredTime = timer->getRealTime() - then;
+
+	logTestString("%d md2 nodes in step time = %d\n%d md2 nodes scattered time = %d\n",
+		CROWD_SIZE, inStepTime, CROWD_SIZE, scatteredTime);
+
+	device->drop();
+	return result;
+}
+
+
+bool md2Animation(void)
+{
+	bool result = renderLastFrame();
+	result &= animateCrowd();
+	return result;
+}
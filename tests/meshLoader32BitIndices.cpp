@@ -0,0 +1,147 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+static const u32 GridSize = 1001;
+
+//! Writes a binary ply file with a grid of quads, which has 2 million triangles
+static bool writeGrid(IrrlichtDevice* device, const char* filename)
+{
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	if (!file)
+		return false;
+
+	c8 header[256];
+	sprintf(header, "ply\nformat binary_little_endian 1.0\n"
+		"element vertex %u\nproperty float x\nproperty float y\nproperty float z\n"
+		"element face %u\nproperty list uchar int vertex_indices\nend_header\n",
+		GridSize * GridSize, (GridSize - 1) * (GridSize - 1));
+	file->write(header, (s32)strlen(header));
+
+	array<u8> data;
+	for (u32 y=0; y<GridSize; ++y)
+	{
+		for (u32 x=0; x<GridSize; ++x)
+		{
+			const f32 pos[3] = { (f32)x, (f32)y, 0.f };
+			for (u32 i=0; i<sizeof(pos); ++i)
+				data.push_back(((const u8*)pos)[i]);
+		}
+	}
+	for (u32 y=0; y<GridSize-1; ++y)
+	{
+		for (u32 x=0; x<GridSize-1; ++x)
+		{
+			const s32 quad[4] = { (s32)(y*GridSize + x), (s32)(y*GridSize + x + 1),
+				(s32)((y+1)*GridSize + x + 1), (s32)((y+1)*GridSize + x) };
+			data.push_back(4);
+			for (u32 i=0; i<sizeof(quad); ++i)
+				data.push_back(((const u8*)quad)[i]);
+		}
+	}
+	const bool result = file->write(data.const_pointer(), data.size()) == (s32)data.size();
+	file->drop();
+	return result;
+}
+
+
+//! Sums the grid positions of all triangle corners, which does not depend on the buffers
+static f64 getCornerSum(IMesh* mesh, u32& triangleCount)
+{
+	f64 sum = 0;
+	triangleCount = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		for (u32 i=0; i<mb->getIndexCount(); ++i)
+		{
+			const u32 index = (mb->getIndexType() == EIT_32BIT) ?
+				((const u32*)mb->getIndices())[i] : mb->getIndices()[i];
+			const vector3df& pos = mb->getPosition(index);
+			sum += (f64)pos.X + (f64)pos.Z * GridSize;
+		}
+		triangleCount += mb->getIndexCount() / 3;
+	}
+	return sum;
+}
+
+
+//! Loads the grid with a driver and checks the mesh buffers the loader created
+static bool loadGrid(E_DRIVER_TYPE driverType, const char* filename, bool expect32Bit, f64& cornerSum)
+{
+	IrrlichtDevice *device = createDevice(driverType, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	if (cornerSum == 0 && !writeGrid(device, filename))
+	{
+		logTestString("Could not write %s.\n", filename);
+		device->drop();
+		return false;
+	}
+
+	IAnimatedMesh* mesh = device->getSceneManager()->getMesh(filename);
+	bool result = (mesh != 0);
+	if (result)
+	{
+		u32 triangleCount = 0;
+		const f64 sum = getCornerSum(mesh, triangleCount);
+		if (cornerSum == 0)
+			cornerSum = sum;
+		if (triangleCount != 2 * (GridSize - 1) * (GridSize - 1) || sum != cornerSum)
+		{
+			logTestString("The grid has %u triangles with a corner sum of %.0f.\n", triangleCount, sum);
+			result = false;
+		}
+
+		if (expect32Bit)
+		{
+			result &= mesh->getMeshBufferCount() == 1 &&
+				mesh->getMeshBuffer(0)->getIndexType() == EIT_32BIT &&
+				mesh->getMeshBuffer(0)->getVertexCount() == GridSize * GridSize;
+		}
+		else
+		{
+			// the parts are about as many as needed and their boxes overlap little
+			const u32 minParts = (GridSize * GridSize + 0xFFFE) / 0xFFFF;
+			f32 area = 0.f;
+			for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+			{
+				IMeshBuffer* mb = mesh->getMeshBuffer(b);
+				result &= mb->getIndexType() == EIT_16BIT && mb->getVertexCount() <= 0xFFFF;
+				const vector3df extent = mb->getBoundingBox().getExtent();
+				area += extent.X * extent.Z;
+			}
+			const f32 gridArea = (f32)((GridSize - 1) * (GridSize - 1));
+			logTestString("The grid is split into %u buffers, at least %u are needed, covering %.2f of its area.\n",
+				mesh->getMeshBufferCount(), minParts, area / gridArea);
+			result &= mesh->getMeshBufferCount() <= minParts + minParts / 2 && area < 3.f * gridArea;
+		}
+	}
+
+	if (!result)
+		logTestString("The grid was not loaded as expected with driver %d.\n", driverType);
+	device->drop();
+	return result;
+}
+
+
+//! A mesh with more vertices than 16 bit indices can address is loaded
+//! with 32 bit indices if the driver can draw them, else split
+bool meshLoader32BitIndices(void)
+{
+	const char* filename = "results/meshLoader32BitIndices.ply";
+	f64 cornerSum = 0;
+
+	bool result = loadGrid(EDT_BURNINGSVIDEO, filename, true, cornerSum);
+	result &= loadGrid(EDT_NULL, filename, false, cornerSum);
+
+	return result;
+}
+
@@ -0,0 +1,258 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+static const u32 GridSize = 300;
+
+//! Writes an obj file with groups, quads, negative indices and faces without normals
+static bool writeObj(IrrlichtDevice* device, const char* filename)
+{
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	if (!file)
+		return false;
+
+	stringc text;
+	c8 line[128];
+	for (u32 y=0; y<GridSize; ++y)
+	{
+		if (y % 100 == 0)
+		{
+			sprintf(line, "g part%u\ns %u\n", y / 100, y / 100);
+			text += line;
+		}
+		for (u32 x=0; x<GridSize; ++x)
+		{
+			sprintf(line, "v %u.5 %u.25 %g\nvt %g %g\nvn 0 1 0\n", x, y, (x * y % 7) * 0.125, x / 300.0, y / 300.0);
+			text += line;
+		}
+		if (y == 0)
+			continue;
+		for (u32 x=1; x<GridSize; ++x)
+		{
+			// the vertices of this row are at the end, the others one row before
+			const s32 a = (s32)x - (s32)GridSize - 1;
+			const s32 b = (s32)(y * GridSize + x);
+			if (x % 3 == 0)
+				sprintf(line, "f %d %u %u %d\n", a - (s32)GridSize, (y-1) * GridSize + x + 1, b + 1, a);
+			else
+				sprintf(line, "f %u/%u/%u %u/%u/%u %d/%d/%d %d/%d/%d\n",
+					b - GridSize, b - GridSize, b - GridSize,
+					b - GridSize + 1, b - GridSize + 1, b - GridSize + 1,
+					a + 1, a + 1, a + 1, a, a, a);
+			text += line;
+		}
+		file->write(text.c_str(), text.size());
+		text = "";
+	}
+	file->write(text.c_str(), text.size());
+	file->drop();
+	return true;
+}
+
+
+//! Writes an ascii ply file with colored vertices and mixed triangles and quads
+static bool writePly(IrrlichtDevice* device, const char* filename)
+{
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	if (!file)
+		return false;
+
+	stringc text;
+	c8 line[128];
+	sprintf(line, "ply\nformat ascii 1.0\nelement vertex %u\n", GridSize * GridSize);
+	text += line;
+	text += "property float x\nproperty float y\nproperty float z\n"
+		"property uchar red\nproperty uchar green\nproperty uchar blue\n";
+	sprintf(line, "element face %u\n", (GridSize - 1) * (GridSize - 1));
+	text += line;
+	text += "property list uchar int vertex_indices\nend_header\n";
+	for (u32 y=0; y<GridSize; ++y)
+	{
+		for (u32 x=0; x<GridSize; ++x)
+		{
+			sprintf(line, "%u.5 %u.25 %g %u %u %u\n", x, y, (x * y % 7) * 0.125, x % 256, y % 256, (x + y) % 256);
+			text += line;
+		}
+		file->write(text.c_str(), text.size());
+		text = "";
+	}
+	for (u32 y=1; y<GridSize; ++y)
+	{
+		for (u32 x=1; x<GridSize; ++x)
+		{
+			const u32 b = y * GridSize + x;
+			if (x % 2)
+				sprintf(line, "4 %u %u %u %u\n", b - GridSize - 1, b - GridSize, b, b - 1);
+			else
+				sprintf(line, "3 %u %u %u\n", b - GridSize - 1, b - GridSize, b);
+			text += line;
+		}
+		file->write(text.c_str(), text.size());
+		text = "";
+	}
+	file->drop();
+	return true;
+}
+
+
+//! Loads a mesh with the given number of threads and logs the time it took
+static IMesh* loadMesh(IrrlichtDevice* device, const char* filename, s32 threads)
+{
+	ISceneManager* smgr = device->getSceneManager();
+	smgr->getParameters()->setAttribute(MESH_LOADER_THREADS, threads);
+
+	const u32 start = device->getTimer()->getRealTime();
+	IAnimatedMesh* mesh = smgr->getMesh(filename);
+	const u32 time = device->getTimer()->getRealTime() - start;
+	logTestString("%s loaded with %d threads in %u ms.\n", filename, threads, time);
+	if (!mesh)
+		return 0;
+
+	// keep the mesh, but load it again next time
+	IMesh* result = mesh->getMesh(0);
+	result->grab();
+	smgr->getMeshCache()->removeMesh(mesh);
+	return result;
+}
+
+
+//! Tests whether two meshes have the same buffers, vertices and indices
+static bool compareMeshes(IMesh* a, IMesh* b)
+{
+	if (!a || !b || !a->getMeshBufferCount() || a->getMeshBufferCount() != b->getMeshBufferCount())
+		return false;
+
+	for (u32 i=0; i<a->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* ma = a->getMeshBuffer(i);
+		IMeshBuffer* mb = b->getMeshBuffer(i);
+		if (ma->getVertexType() != EVT_STANDARD || mb->getVertexType() != EVT_STANDARD ||
+			ma->getVertexCount() != mb->getVertexCount() ||
+			ma->getIndexType() != mb->getIndexType() ||
+			ma->getIndexCount() != mb->getIndexCount())
+			return false;
+
+		const S3DVertex* va = (const S3DVertex*)ma->getVertices();
+		const S3DVertex* vb = (const S3DVertex*)mb->getVertices();
+		for (u32 v=0; v<ma->getVertexCount(); ++v)
+		{
+			if (va[v].Pos != vb[v].Pos || va[v].Normal != vb[v].Normal ||
+				va[v].TCoords != vb[v].TCoords || va[v].Color != vb[v].Color)
+				return false;
+		}
+
+		const u32 indexSize = (ma->getIndexType() == EIT_32BIT) ? 4 : 2;
+		if (memcmp(ma->getIndices(), mb->getIndices(), ma->getIndexCount() * indexSize))
+			return false;
+	}
+	return true;
+}
+
+
+//! Loads a mesh on the calling thread and on several threads and compares the results
+static bool compareThreads(IrrlichtDevice* device, const char* filename, u32 bufferCount)
+{
+	IMesh* serial = loadMesh(device, filename, 1);
+	IMesh* threaded = loadMesh(device, filename, 4);
+
+	bool result = serial && threaded && serial->getMeshBufferCount() == bufferCount &&
+		compareMeshes(serial, threaded);
+	if (!result)
+		logTestString("%s is not loaded the same way on several threads.\n", filename);
+
+	if (serial)
+		serial->drop();
+	if (threaded)
+		threaded->drop();
+	return result;
+}
+
+
+//! Loads a mesh on the calling thread and tests its number of vertices
+static bool checkVertexCount(IrrlichtDevice* device, const char* filename, u32 expected)
+{
+	IMesh* mesh = loadMesh(device, filename, 1);
+	u32 count = 0;
+	for (u32 i=0; mesh && i<mesh->getMeshBufferCount(); ++i)
+		count += mesh->getMeshBuffer(i)->getVertexCount();
+	if (mesh)
+		mesh->drop();
+
+	if (count != expected)
+		logTestString("%s has %u vertices instead of %u.\n", filename, count, expected);
+	return count == expected;
+}
+
+
+//! Large obj and ascii ply files are parsed on several threads with the same results
+bool meshLoaderThreads(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	const char* obj = "results/meshLoaderThreads.obj";
+	bool result = writeObj(device, obj);
+	result &= compareThreads(device, obj, 3);
+
+	// as many vertices as the loader had before it parsed on several threads
+	result &= checkVertexCount(device, obj, 150396);
+
+	// vertices which are only equal within the rounding tolerance are merged,
+	// even when they are on both sides of a boundary of the hashed cells
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile("results/meshLoaderThreads_tolerance.obj");
+	if (file)
+	{
+		const char text[] = "v 0.0009765625 0.0005 2\nv 0.0009770625 0.0004995 1.9999995\n"
+			"v 1 0 0\nv 1 1 0\nvn 0 0 1\nvt 0 0\nf 1/1/1 3/1/1 4/1/1\nf 2/1/1 4/1/1 3/1/1\n";
+		file->write(text, sizeof(text) - 1);
+		file->drop();
+	}
+	result &= checkVertexCount(device, "results/meshLoaderThreads_tolerance.obj", 3);
+
+	// far away vertices are hashed apart as well, else this takes minutes
+	file = device->getFileSystem()->createAndWriteFile("results/meshLoaderThreads_far.obj");
+	if (file)
+	{
+		stringc text;
+		c8 line[128];
+		for (u32 y=0; y<GridSize; ++y)
+		{
+			for (u32 x=0; x<GridSize; ++x)
+			{
+				sprintf(line, "v %.1f %.2f -20000\n", 16384 + x * 0.5, 3000000 + y * 0.25);
+				text += line;
+			}
+			file->write(text.c_str(), text.size());
+			text = "";
+		}
+		for (u32 y=1; y<GridSize; ++y)
+		{
+			for (u32 x=1; x<GridSize; ++x)
+			{
+				const u32 b = y * GridSize + x + 1;
+				sprintf(line, "f %u %u %u %u\n", b - GridSize - 1, b - GridSize, b, b - 1);
+				text += line;
+			}
+			file->write(text.c_str(), text.size());
+			text = "";
+		}
+		file->drop();
+	}
+	result &= checkVertexCount(device, "results/meshLoaderThreads_far.obj", GridSize * GridSize);
+
+	const char* ply = "results/meshLoaderThreads.ply";
+	result &= writePly(device, ply);
+	result &= compareThreads(device, ply, 1);
+
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,457 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+static const u32 GridSize = 120;
+
+//! Returns the vertex index of a grid position
+static u32 gridIndex(u32 x, u32 y)
+{
+	return y * GridSize + x;
+}
+
+
+//! Text which grows faster than strings do
+struct SText
+{
+	SText& operator+=(const c8* str)
+	{
+		while (*str)
+			Data.push_back(*str++);
+		return *this;
+	}
+
+	SText& operator+=(const SText& other)
+	{
+		for (u32 i=0; i<other.Data.size(); ++i)
+			Data.push_back(other.Data[i]);
+		return *this;
+	}
+
+	array<c8> Data;
+};
+
+
+//! Writes the grid as text, the quads of the left half use the first material
+static array<c8> writeText()
+{
+	SText text;
+	text += "xof 0303txt 0032\n// a grid of triangles and quads\nMesh grid {\n";
+	c8 line[256];
+	const u32 vertexCount = GridSize * GridSize;
+	const u32 faceCount = (GridSize - 1) * (GridSize - 1);
+
+	sprintf(line, " %u;\n", vertexCount);
+	text += line;
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		sprintf(line, " %.2f;%.2f;%.3f;%s\n", (i % GridSize) * 0.25f, (i / GridSize) * 0.5f,
+			(i % 13) * 0.125f, (i + 1 < vertexCount) ? "," : ";");
+		text += line;
+	}
+
+	// every third face is split into triangles
+	sprintf(line, " %u;\n", faceCount + faceCount / 3 + (faceCount % 3 ? 1 : 0));
+	text += line;
+	SText faces;
+	u32 face = 0;
+	for (u32 y=0; y<GridSize-1; ++y)
+	{
+		for (u32 x=0; x<GridSize-1; ++x, ++face)
+		{
+			const u32 a = gridIndex(x, y), b = gridIndex(x+1, y), c = gridIndex(x+1, y+1), d = gridIndex(x, y+1);
+			if (face % 3 == 0)
+				sprintf(line, " 3;%u,%u,%u;,\n 3;%u,%u,%u;", a, b, c, a, c, d);
+			else
+				sprintf(line, " 4;%u,%u,%u,%u;", a, b, c, d);
+			faces += line;
+			faces += (face + 1 < faceCount) ? ",\n" : ";\n";
+		}
+	}
+	text += faces;
+
+	// normals with the same face indices
+	text += " MeshNormals {\n";
+	sprintf(line, "  %u;\n", vertexCount);
+	text += line;
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		sprintf(line, "  %.3f;%.3f;%.3f;%s\n", (i % 3) * 0.5f, 1.f, (i % 5) * 0.25f, (i + 1 < vertexCount) ? "," : ";");
+		text += line;
+	}
+	sprintf(line, "  %u;\n", faceCount + faceCount / 3 + (faceCount % 3 ? 1 : 0));
+	text += line;
+	text += faces;
+	text += " }\n";
+
+	text += " MeshTextureCoords {\n";
+	sprintf(line, "  %u;\n", vertexCount);
+	text += line;
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		sprintf(line, "  %.4f;%.4f;%s\n", (i % GridSize) * 0.125f, (i / GridSize) * 0.0625f, (i + 1 < vertexCount) ? "," : ";");
+		text += line;
+	}
+	text += " }\n";
+
+	// the material list counts faces before triangulation
+	text += " MeshMaterialList {\n  2;\n";
+	sprintf(line, "  %u;\n", faceCount + faceCount / 3 + (faceCount % 3 ? 1 : 0));
+	text += line;
+	face = 0;
+	for (u32 y=0; y<GridSize-1; ++y)
+	{
+		for (u32 x=0; x<GridSize-1; ++x, ++face)
+		{
+			const u32 material = (x < GridSize / 2) ? 0 : 1;
+			if (face % 3 == 0)
+				sprintf(line, "  %u,\n  %u", material, material);
+			else
+				sprintf(line, "  %u", material);
+			text += line;
+			text += (face + 1 < faceCount) ? ",\n" : ";;\n";
+		}
+	}
+	text += "  Material {\n   1.000;0.500;0.250;1.000;;\n   8.000;\n   0.500;0.500;0.500;;\n   0.000;0.000;0.000;;\n  }\n";
+	text += "  Material {\n   0.250;0.500;1.000;1.000;;\n   4.000;\n   1.000;1.000;1.000;;\n   0.000;0.250;0.000;;\n  }\n";
+	text += " }\n";
+
+	// the upper half of the grid is weighted to a bone
+	const u32 weightCount = vertexCount / 2;
+	text += " SkinWeights {\n  \"bone\";\n";
+	sprintf(line, "  %u;\n", weightCount);
+	text += line;
+	for (u32 i=0; i<weightCount; ++i)
+	{
+		sprintf(line, "  %u%s\n", vertexCount - weightCount + i, (i + 1 < weightCount) ? "," : ";");
+		text += line;
+	}
+	for (u32 i=0; i<weightCount; ++i)
+	{
+		sprintf(line, "  %.3f%s\n", (i % 8 + 1) * 0.125f, (i + 1 < weightCount) ? "," : ";");
+		text += line;
+	}
+	text += "  1.000,0.000,0.000,0.000,0.000,1.000,0.000,0.000,0.000,0.000,1.000,0.000,0.000,2.000,0.000,1.000;;\n }\n";
+	text += "}\n";
+	return text.Data;
+}
+
+
+//! Appends binary tokens to a buffer
+class BinaryWriter
+{
+public:
+	void word(u16 value) { append(&value, 2); }
+	void dword(u32 value) { append(&value, 4); }
+	void name(const c8* name) { word(1); dword((u32)strlen(name)); append(name, (u32)strlen(name)); }
+	void string(const c8* text) { word(2); dword((u32)strlen(text)); append(text, (u32)strlen(text)); word(0x14); }
+	void open() { word(0x0a); }
+	void close() { word(0x0b); }
+	void ints(const array<u32>& values) { word(6); dword(values.size()); append(values.const_pointer(), values.size() * 4); }
+	void floats(const array<f32>& values) { word(7); dword(values.size()); append(values.const_pointer(), values.size() * 4); }
+
+	array<c8> Data;
+
+private:
+	void append(const void* data, u32 size)
+	{
+		for (u32 i=0; i<size; ++i)
+			Data.push_back(((const c8*)data)[i]);
+	}
+};
+
+
+//! Writes the same grid as writeText in the binary format
+static array<c8> writeBinary()
+{
+	BinaryWriter out;
+	const c8* header = "xof 0303bin 0032";
+	for (u32 i=0; i<16; ++i)
+		out.Data.push_back(header[i]);
+
+	const u32 vertexCount = GridSize * GridSize;
+	const u32 faceCount = (GridSize - 1) * (GridSize - 1);
+	array<u32> ints;
+	array<f32> floats;
+
+	out.name("Mesh");
+	out.name("grid");
+	out.open();
+	ints.push_back(vertexCount);
+	out.ints(ints);
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		floats.push_back((i % GridSize) * 0.25f);
+		floats.push_back((i / GridSize) * 0.5f);
+		floats.push_back((i % 13) * 0.125f);
+	}
+	out.floats(floats);
+
+	array<u32> faces;
+	faces.push_back(faceCount + faceCount / 3 + (faceCount % 3 ? 1 : 0));
+	u32 face = 0;
+	for (u32 y=0; y<GridSize-1; ++y)
+	{
+		for (u32 x=0; x<GridSize-1; ++x, ++face)
+		{
+			const u32 a = gridIndex(x, y), b = gridIndex(x+1, y), c = gridIndex(x+1, y+1), d = gridIndex(x, y+1);
+			if (face % 3 == 0)
+			{
+				const u32 tris[8] = { 3, a, b, c, 3, a, c, d };
+				for (u32 i=0; i<8; ++i)
+					faces.push_back(tris[i]);
+			}
+			else
+			{
+				const u32 quad[5] = { 4, a, b, c, d };
+				for (u32 i=0; i<5; ++i)
+					faces.push_back(quad[i]);
+			}
+		}
+	}
+	out.ints(faces);
+
+	out.name("MeshNormals");
+	out.open();
+	ints.set_used(0);
+	ints.push_back(vertexCount);
+	out.ints(ints);
+	floats.set_used(0);
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		floats.push_back((i % 3) * 0.5f);
+		floats.push_back(1.f);
+		floats.push_back((i % 5) * 0.25f);
+	}
+	out.floats(floats);
+	out.ints(faces);
+	out.close();
+
+	out.name("MeshTextureCoords");
+	out.open();
+	out.ints(ints);
+	floats.set_used(0);
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		floats.push_back((i % GridSize) * 0.125f);
+		floats.push_back((i / GridSize) * 0.0625f);
+	}
+	out.floats(floats);
+	out.close();
+
+	out.name("MeshMaterialList");
+	out.open();
+	ints.set_used(0);
+	ints.push_back(2);
+	ints.push_back(faces[0]);
+	face = 0;
+	for (u32 y=0; y<GridSize-1; ++y)
+	{
+		for (u32 x=0; x<GridSize-1; ++x, ++face)
+		{
+			const u32 material = (x < GridSize / 2) ? 0 : 1;
+			ints.push_back(material);
+			if (face % 3 == 0)
+				ints.push_back(material);
+		}
+	}
+	out.ints(ints);
+	const f32 materials[2][11] = {
+		{ 1.f, 0.5f, 0.25f, 1.f, 8.f, 0.5f, 0.5f, 0.5f, 0.f, 0.f, 0.f },
+		{ 0.25f, 0.5f, 1.f, 1.f, 4.f, 1.f, 1.f, 1.f, 0.f, 0.25f, 0.f } };
+	for (u32 m=0; m<2; ++m)
+	{
+		out.name("Material");
+		out.open();
+		floats.set_used(0);
+		for (u32 i=0; i<11; ++i)
+			floats.push_back(materials[m][i]);
+		out.floats(floats);
+		out.close();
+	}
+	out.close();
+
+	const u32 weightCount = vertexCount / 2;
+	out.name("SkinWeights");
+	out.open();
+	out.string("bone");
+	ints.set_used(0);
+	ints.push_back(weightCount);
+	for (u32 i=0; i<weightCount; ++i)
+		ints.push_back(vertexCount - weightCount + i);
+	out.ints(ints);
+	floats.set_used(0);
+	for (u32 i=0; i<weightCount; ++i)
+		floats.push_back((i % 8 + 1) * 0.125f);
+	const f32 matrix[16] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 2.f, 0.f, 1.f };
+	for (u32 i=0; i<16; ++i)
+		floats.push_back(matrix[i]);
+	out.floats(floats);
+	out.close();
+
+	out.close();
+	return out.Data;
+}
+
+
+//! Packs text into a compressed x file, with deflate blocks which store the data
+static array<c8> writeCompressed(const array<c8>& text)
+{
+	array<c8> data;
+	const c8* header = "xof 0303tzip0032";
+	for (u32 i=0; i<16; ++i)
+		data.push_back(header[i]);
+
+	// the size of the file after decompression
+	const u32 size = text.size();
+	for (u32 i=0; i<4; ++i)
+		data.push_back((c8)((size + 16) >> (i * 8)));
+
+	for (u32 pos=0; pos<size; pos+=4096)
+	{
+		const u32 length = min_(size - pos, 4096u);
+		const u32 compressed = length + 7;
+		const u8 block[11] = { (u8)length, (u8)(length >> 8), (u8)compressed, (u8)(compressed >> 8), 'C', 'K',
+			1, (u8)length, (u8)(length >> 8), (u8)~length, (u8)(~length >> 8) };
+		for (u32 i=0; i<11; ++i)
+			data.push_back(block[i]);
+		for (u32 i=0; i<length; ++i)
+			data.push_back(text[pos + i]);
+	}
+	return data;
+}
+
+
+//! Writes data to a file
+static bool writeFile(IrrlichtDevice* device, const char* filename, const c8* data, u32 size)
+{
+	io::IWriteFile* file = device->getFileSystem()->createAndWriteFile(filename);
+	if (!file)
+		return false;
+	const bool result = file->write(data, size) == (s32)size;
+	file->drop();
+	return result;
+}
+
+
+//! Loads a mesh and logs the time it took
+static ISkinnedMesh* loadMesh(IrrlichtDevice* device, const char* filename)
+{
+	const u32 start = device->getTimer()->getRealTime();
+	IAnimatedMesh* mesh = device->getSceneManager()->getMesh(filename);
+	logTestString("%s loaded in %u ms.\n", filename, device->getTimer()->getRealTime() - start);
+	if (!mesh || mesh->getMeshType() != EAMT_SKINNED)
+	{
+		logTestString("%s could not be loaded.\n", filename);
+		return 0;
+	}
+	return (ISkinnedMesh*)mesh;
+}
+
+
+//! Tests whether two skinned meshes have the same buffers and weights
+static bool compareMeshes(ISkinnedMesh* a, ISkinnedMesh* b)
+{
+	if (!a || !b || a->getMeshBufferCount() != b->getMeshBufferCount() ||
+		a->getJointCount() != b->getJointCount())
+		return false;
+
+	for (u32 i=0; i<a->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* ma = a->getMeshBuffer(i);
+		IMeshBuffer* mb = b->getMeshBuffer(i);
+		if (ma->getVertexCount() != mb->getVertexCount() || ma->getIndexCount() != mb->getIndexCount() ||
+			ma->getMaterial() != mb->getMaterial())
+			return false;
+		for (u32 v=0; v<ma->getVertexCount(); ++v)
+		{
+			if (ma->getPosition(v) != mb->getPosition(v) || ma->getNormal(v) != mb->getNormal(v) ||
+				ma->getTCoords(v) != mb->getTCoords(v))
+				return false;
+		}
+		if (memcmp(ma->getIndices(), mb->getIndices(), ma->getIndexCount() * 2))
+			return false;
+	}
+
+	for (u32 j=0; j<a->getJointCount(); ++j)
+	{
+		const ISkinnedMesh::SJoint* ja = a->getAllJoints()[j];
+		const ISkinnedMesh::SJoint* jb = b->getAllJoints()[j];
+		if (ja->Name != jb->Name || ja->Weights.size() != jb->Weights.size() ||
+			ja->GlobalInversedMatrix != jb->GlobalInversedMatrix)
+			return false;
+		for (u32 w=0; w<ja->Weights.size(); ++w)
+		{
+			if (ja->Weights[w].vertex_id != jb->Weights[w].vertex_id ||
+				ja->Weights[w].buffer_id != jb->Weights[w].buffer_id ||
+				!equals(ja->Weights[w].strength, jb->Weights[w].strength))
+				return false;
+		}
+	}
+	return true;
+}
+
+
+//! Text, binary and compressed x files are loaded the same way
+bool meshLoaderX(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_NULL, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	const array<c8> text = writeText();
+	const array<c8> binary = writeBinary();
+	const array<c8> compressed = writeCompressed(text);
+	bool result = writeFile(device, "results/meshLoaderX.x", text.const_pointer(), text.size());
+	result &= writeFile(device, "results/meshLoaderX_bin.x", binary.const_pointer(), binary.size());
+	result &= writeFile(device, "results/meshLoaderX_zip.x", compressed.const_pointer(), compressed.size());
+
+	ISkinnedMesh* mesh = loadMesh(device, "results/meshLoaderX.x");
+	if (mesh)
+	{
+		// quads are split into two triangles, both materials have half of them
+		const u32 triangles = 2 * (GridSize - 1) * (GridSize - 1);
+		result &= mesh->getMeshBufferCount() == 2 &&
+			mesh->getMeshBuffer(0)->getIndexCount() + mesh->getMeshBuffer(1)->getIndexCount() == triangles * 3 &&
+			mesh->getMeshBuffer(1)->getMaterial().Shininess == 4.f &&
+			mesh->getJointCount() == 1 && mesh->getAllJoints()[0]->Weights.size() == GridSize * GridSize / 2;
+		if (!result)
+			logTestString("The text x file was loaded into %u buffers with %u and %u indices and %u joints.\n",
+				mesh->getMeshBufferCount(), mesh->getMeshBuffer(0)->getIndexCount(),
+				mesh->getMeshBufferCount() > 1 ? mesh->getMeshBuffer(1)->getIndexCount() : 0, mesh->getJointCount());
+	}
+	else
+		result = false;
+
+	if (!compareMeshes(mesh, loadMesh(device, "results/meshLoaderX_bin.x")))
+	{
+		logTestString("The binary x file does not match the text file.\n");
+		result = false;
+	}
+	if (!compareMeshes(mesh, loadMesh(device, "results/meshLoaderX_zip.x")))
+	{
+		logTestString("The compressed x file does not match the text file.\n");
+		result = false;
+	}
+
+	// an animated mesh exported by a modeller
+	mesh = loadMesh(device, "../media/dwarf.x");
+	if (!mesh || mesh->getMeshBufferCount() != 2 || mesh->getJointCount() != 46 ||
+		mesh->getMeshBuffer(0)->getVertexCount() + mesh->getMeshBuffer(1)->getVertexCount() != 1479 ||
+		mesh->getMeshBuffer(0)->getIndexCount() + mesh->getMeshBuffer(1)->getIndexCount() != 5688)
+	{
+		logTestString("dwarf.x was not loaded as expected.\n");
+		result = false;
+	}
+
+	device->drop();
+
+	return result;
+}
+
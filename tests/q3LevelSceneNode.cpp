@@ -0,0 +1,139 @@
+// Copyright (C) 2008-2009 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+using namespace io;
+
+//! Renders the scene a few times and returns the time it took
+static u32 renderFrames(IrrlichtDevice* device, u32 frames)
+{
+	IVideoDriver* driver = device->getVideoDriver();
+	const u32 start = device->getTimer()->getRealTime();
+
+	for (u32 i=0; i<frames; ++i)
+	{
+		driver->beginScene(true, true, SColor(255,0,0,0));
+		device->getSceneManager()->drawAll();
+		driver->endScene();
+	}
+
+	return device->getTimer()->getRealTime() - start;
+}
+
+
+//! Counts the pixels which differ in two images of the same size
+static u32 countDifferentPixels(IImage* a, IImage* b)
+{
+	u32 count = 0;
+	const dimension2du size = a->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+		for (u32 x=0; x<size.Width; ++x)
+			if (a->getPixel(x, y) != b->getPixel(x, y))
+				++count;
+
+	return count;
+}
+
+
+//! The visibility culled level has to look exactly like the octree from each spawn point
+/** Also logs the frame times of both scene nodes. */
+bool q3LevelSceneNode(void)
+{
+	IrrlichtDevice *device = createDevice(EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager * smgr = device->getSceneManager();
+
+	bool result = device->getFileSystem()->addZipFileArchive("../media/map-20kdm2.pk3");
+	IQ3LevelMesh* mesh = result ? (IQ3LevelMesh*) smgr->getMesh("20kdm2.bsp") : 0;
+	assert(mesh);
+
+	if (!mesh)
+	{
+		device->drop();
+		return false;
+	}
+
+	ISceneNode* octree = smgr->addOctreeSceneNode(mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY), 0, -1, 1024);
+	ISceneNode* level = smgr->addQuake3LevelSceneNode(mesh);
+	ICameraSceneNode* camera = smgr->addCameraSceneNode();
+
+	if (!octree || !level || level->getType() != ESNT_Q3_LEVEL)
+	{
+		logTestString("Could not create the quake3 level scene node.\n");
+		device->drop();
+		return false;
+	}
+
+	quake3::tQ3EntityList &entityList = mesh->getEntityList();
+	quake3::IEntity search;
+	search.name = "info_player_deathmatch";
+
+	u32 views = 0;
+	u32 octreeTime = 0;
+	u32 levelTime = 0;
+
+	for (s32 index = entityList.binary_search(search);
+		index >= 0 && index < (s32) entityList.size() && entityList[index].name == search.name;
+		++index)
+	{
+		u32 parsepos = 0;
+		const vector3df pos = quake3::getAsVector3df(entityList[index].getGroup(1)->get("origin"), parsepos);
+
+		for (u32 angle=0; angle<360; angle+=90)
+		{
+			vector3df target(0.f, 0.f, 1.f);
+			target.rotateXZBy(angle);
+			camera->setPosition(pos);
+			camera->setTarget(pos + target);
+
+			octree->setVisible(true);
+			level->setVisible(false);
+			octreeTime += renderFrames(device, 4);
+			IImage* expected = driver->createScreenShot();
+
+			octree->setVisible(false);
+			level->setVisible(true);
+			levelTime += renderFrames(device, 4);
+			IImage* culled = driver->createScreenShot();
+
+			if (expected && culled)
+			{
+				const u32 different = countDifferentPixels(expected, culled);
+				if (different)
+				{
+					logTestString("%u pixels differ from the octree at spawn point %d, angle %u.\n",
+						different, index, angle);
+					result = false;
+				}
+			}
+			else
+				result = false;
+
+			if (expected)
+				expected->drop();
+			if (culled)
+				culled->drop();
+
+			++views;
+		}
+	}
+
+	logTestString("20kdm2 from %u views: octree %u ms, bsp visibility %u ms\n",
+		views, octreeTime, levelTime);
+
+	if (!views)
+		result = false;
+
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,115 @@
+// Copyright (C) 2008-2009 Christian Stehno, Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+using namespace video;
+
+//! returns if one of the stages of a shader moves the vertices
+static bool shaderDeformsVertices(const quake3::IShader* shader)
+{
+	for (u32 i=0; i<shader->getGroupSize(); ++i)
+		if (shader->getGroup(i)->isDefined("deformvertexes"))
+			return true;
+	return false;
+}
+
+
+//! Faces of shaders which don't deform vertices share one buffer per shader and lightmap
+static bool checkMergedBuffers(IQ3LevelMesh* mesh)
+{
+	const IMesh* items = mesh->getMesh(quake3::E_Q3_MESH_ITEMS);
+	bool result = true;
+	for (u32 i=0; i<items->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* a = items->getMeshBuffer(i);
+		const quake3::IShader* shader = mesh->getShader((s32)a->getMaterial().MaterialTypeParam2);
+		if (!shader || shaderDeformsVertices(shader))
+			continue;
+
+		for (u32 j=i+1; j<items->getMeshBufferCount(); ++j)
+		{
+			const IMeshBuffer* b = items->getMeshBuffer(j);
+			if (a->getMaterial().MaterialTypeParam2 == b->getMaterial().MaterialTypeParam2 &&
+				a->getMaterial().getTexture(1) == b->getMaterial().getTexture(1) &&
+				a->getVertexCount() + b->getVertexCount() <= 65536)
+			{
+				logTestString("Buffers %u and %u of shader %s were not merged.\n", i, j, shader->name.c_str());
+				result = false;
+			}
+		}
+	}
+	return result;
+}
+
+
+//! Renders the level and its shaders from a position looking at a point
+static bool renderShaderView(IrrlichtDevice* device, const vector3df& position,
+		const vector3df& target, const char* fileName)
+{
+	ICameraSceneNode* camera = device->getSceneManager()->getActiveCamera();
+	camera->setPosition(position);
+	camera->setTarget(target);
+
+	device->getVideoDriver()->beginScene(true, true, SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	device->getVideoDriver()->endScene();
+
+	// the references were rendered before the faces were merged and the
+	// waveforms were taken from tables, and match all but single pixels. The
+	// level without any shader nodes matches only 99.4 to 99.6 percent.
+	return takeScreenshotAndCompareAgainstReference(device->getVideoDriver(), fileName, 99.9f);
+}
+
+
+//! Quake3 shaders look the same with merged faces and table driven waveforms
+bool q3ShaderSceneNode(void)
+{
+	IrrlichtDevice *device = createDevice(EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	ISceneManager * smgr = device->getSceneManager();
+
+	// the pixels of the textures themselves, independent of how mip maps are filtered
+	device->getVideoDriver()->setTextureCreationFlag(ETCF_CREATE_MIP_MAPS, false);
+
+	bool result = device->getFileSystem()->addZipFileArchive("../media/map-20kdm2.pk3");
+	IQ3LevelMesh* mesh = result ? (IQ3LevelMesh*) smgr->getMesh("20kdm2.bsp") : 0;
+	if (!mesh)
+	{
+		logTestString("Could not load 20kdm2.bsp.\n");
+		device->drop();
+		return false;
+	}
+
+	result &= checkMergedBuffers(mesh);
+
+	smgr->addOctreeSceneNode(mesh->getMesh(quake3::E_Q3_MESH_GEOMETRY), 0, -1, 1024);
+
+	const IMesh* items = mesh->getMesh(quake3::E_Q3_MESH_ITEMS);
+	for (u32 i=0; i<items->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* buffer = items->getMeshBuffer(i);
+		const quake3::IShader* shader = mesh->getShader((s32)buffer->getMaterial().MaterialTypeParam2);
+		if (shader)
+			smgr->addQuake3SceneNode(buffer, shader);
+	}
+	smgr->addCameraSceneNode();
+
+	// the waveforms depend on the time
+	device->getTimer()->setTime(1500);
+	device->getTimer()->stop();
+
+	// a torch of a gratelamp, and the flames in front of the lava
+	result &= renderShaderView(device, vector3df(1830.f, 330.f, 1344.f), vector3df(1736.f, 321.f, 1344.f), "-q3Shaders-torch.png");
+	result &= renderShaderView(device, vector3df(1400.f, 190.f, 1344.f), vector3df(1536.f, 165.f, 1224.f), "-q3Shaders-flames.png");
+
+	device->drop();
+
+	return result;
+}
+
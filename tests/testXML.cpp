@@ -6,6 +6,43 @@
 using namespace irr;
 using namespace core;
 
+/** Special characters are replaced in attribute values and texts */
+static bool testSpecialCharacters(IrrlichtDevice* device)
+{
+	io::IXMLReaderUTF8* reader = device->getFileSystem()->createXMLReaderUTF8("media/entities.xml");
+	if (!reader)
+	{
+		logTestString("Could not create XML reader.\n");
+		return false;
+	}
+
+	bool retVal = true;
+	u32 found = 0;
+	while(reader->read())
+	{
+		if (reader->getNodeType() == io::EXN_ELEMENT && core::stringc("b") == reader->getNodeName())
+		{
+			++found;
+			if (core::stringc("x&y<z") != reader->getAttributeValueSafe("v") ||
+				core::stringc("\"q\"!") != reader->getAttributeValueSafe("w"))
+			{
+				logTestString("Special characters in XML attribute not replaced.\n");
+				retVal = false;
+			}
+		}
+		else if (reader->getNodeType() == io::EXN_TEXT && core::stringc("1<2&3>0.") == reader->getNodeData())
+			++found;
+	}
+	if (found != 2)
+	{
+		logTestString("Special characters in XML text not replaced.\n");
+		retVal = false;
+	}
+
+	reader->drop();
+	return retVal;
+}
+
 /** Tests for XML handling */
 bool testXML(void)
 {
@@ -38,6 +75,10 @@ bool testXML(void)
 	}
 
 	reader->drop();
+
+	retVal &= testSpecialCharacters(device);
+
+	device->drop();
 	return retVal;
 }
 
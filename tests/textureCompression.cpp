@@ -0,0 +1,233 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+//! Returns the largest difference of a color channel between two images
+static u32 compareImages(IImage* image, IImage* reference, bool alpha)
+{
+	u32 difference = 0;
+	const dimension2du size = reference->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const SColor a = image->getPixel(x, y);
+			const SColor b = reference->getPixel(x, y);
+			difference = max_(difference, (u32)abs_((s32)a.getRed() - (s32)b.getRed()));
+			difference = max_(difference, (u32)abs_((s32)a.getGreen() - (s32)b.getGreen()));
+			difference = max_(difference, (u32)abs_((s32)a.getBlue() - (s32)b.getBlue()));
+			if (alpha)
+				difference = max_(difference, (u32)abs_((s32)a.getAlpha() - (s32)b.getAlpha()));
+		}
+	}
+	return difference;
+}
+
+
+//! Compresses an image, writes and reads it as dds and compares the result
+static bool compressImage(IVideoDriver* driver, ECOLOR_FORMAT format, const char* filename)
+{
+	// smooth gradients in a size which is no multiple of the block size
+	const dimension2du size(37, 21);
+	IImage* original = driver->createImage(format == ECF_DXT5 ? ECF_A8R8G8B8 : ECF_R8G8B8, size);
+	for (u32 y=0; y<size.Height; ++y)
+		for (u32 x=0; x<size.Width; ++x)
+			original->setPixel(x, y, SColor(255 - y * 10, x * 6, 255 - x * 6, y * 12));
+
+	IImage* compressed = driver->createImage(format, size);
+	original->copyTo(compressed);
+
+	bool result = driver->writeImageToFile(compressed, filename);
+	IImage* loaded = driver->createImageFromFile(filename);
+	if (!result || !loaded || loaded->getColorFormat() != format || loaded->getDimension() != size)
+	{
+		logTestString("Could not write and read %s.\n", filename);
+		result = false;
+	}
+	else
+	{
+		const u32 difference = compareImages(loaded, original, format == ECF_DXT5);
+		logTestString("%s differs by %u.\n", filename, difference);
+		result = (difference <= 20) &&
+			!memcmp(loaded->lock(), compressed->lock(), compressed->getImageDataSizeInBytes());
+		loaded->unlock();
+		compressed->unlock();
+	}
+
+	// textures are created from the compressed image
+	ITexture* texture = result ? driver->getTexture(filename) : 0;
+	if (texture)
+	{
+		IImage* decoded = driver->createImageFromData(texture->getColorFormat(), texture->getSize(), texture->lock(), false);
+		texture->unlock();
+		const u32 difference = compareImages(decoded, loaded, false);
+		if (difference > 8)
+		{
+			logTestString("The texture of %s differs by %u.\n", filename, difference);
+			result = false;
+		}
+		decoded->drop();
+	}
+	else
+		result = false;
+
+	if (loaded)
+		loaded->drop();
+	compressed->drop();
+	original->drop();
+
+	return result;
+}
+
+
+//! Writes a dds file of uncompressed pixels with the given bit masks
+static bool writeDDS(io::IFileSystem* fs, const char* filename, u32 width, u32 height,
+		u32 bits, u32 red, u32 green, u32 blue, u32 alpha, const void* data, u32 dataSize)
+{
+	u32 header[32];
+	memset(header, 0, sizeof(header));
+	header[0] = 0x20534444; // "DDS "
+	header[1] = 124;
+	header[2] = 0x1007; // caps, height, width and pixel format
+	header[3] = height;
+	header[4] = width;
+	header[19] = 32;
+	header[20] = 0x40 | (alpha ? 0x1 : 0); // rgb with alpha pixels
+	header[22] = bits;
+	header[23] = red;
+	header[24] = green;
+	header[25] = blue;
+	header[26] = alpha;
+	header[27] = 0x1000; // texture
+
+	io::IWriteFile* file = fs->createAndWriteFile(filename);
+	if (!file)
+		return false;
+	bool result = (file->write(header, sizeof(header)) == (s32)sizeof(header));
+	if (dataSize)
+		result &= (file->write(data, dataSize) == (s32)dataSize);
+	file->drop();
+	return result;
+}
+
+
+//! Uncompressed dds files are decoded by their bit masks, broken ones are rejected
+static bool loadUncompressedDDS(IVideoDriver* driver, io::IFileSystem* fs)
+{
+	bool result = true;
+
+	// A4R4G4B4 and X1R5G5B5, which share the bit count of A1R5G5B5
+	const u16 pixels16[2] = { 0x8F40, 0x7C1F };
+	const struct
+	{
+		u32 red, green, blue, alpha;
+		SColor expected[2];
+	} formats16[] = {
+		{ 0x0F00, 0x00F0, 0x000F, 0xF000, { SColor(0x88, 0xFF, 0x44, 0x00), SColor(0x77, 0xCC, 0x11, 0xFF) } },
+		{ 0x7C00, 0x03E0, 0x001F, 0, { SColor(0xFF, 0x18, 0xD6, 0x00), SColor(0xFF, 0xFF, 0x00, 0xFF) } }
+	};
+	for (u32 i=0; i<2; ++i)
+	{
+		IImage* image = 0;
+		if (writeDDS(fs, "results/textureCompression_16.dds", 2, 1, 16, formats16[i].red,
+				formats16[i].green, formats16[i].blue, formats16[i].alpha, pixels16, sizeof(pixels16)))
+			image = driver->createImageFromFile("results/textureCompression_16.dds");
+		for (u32 x=0; x<2; ++x)
+		{
+			if (!image || image->getPixel(x, 0).color != formats16[i].expected[x].color)
+			{
+				logTestString("Pixel %u of the 16 bit dds file %u is %08x.\n", x, i, image ? image->getPixel(x, 0).color : 0);
+				result = false;
+			}
+		}
+		if (image)
+			image->drop();
+	}
+
+	// unknown bit masks are not guessed
+	if (writeDDS(fs, "results/textureCompression_unknown.dds", 2, 1, 16, 0x001F, 0x07E0, 0xF800, 0, pixels16, sizeof(pixels16)))
+	{
+		IImage* image = driver->createImageFromFile("results/textureCompression_unknown.dds");
+		if (image)
+		{
+			logTestString("A dds file with unknown bit masks was loaded.\n");
+			image->drop();
+			result = false;
+		}
+	}
+
+	// headers which announce more pixels than the file has, or far too many
+	const u32 pixels32[4] = { 0 };
+	if (writeDDS(fs, "results/textureCompression_short.dds", 64, 64, 32, 0xFF0000, 0xFF00, 0xFF, 0, pixels32, sizeof(pixels32)) &&
+		writeDDS(fs, "results/textureCompression_huge.dds", 0x80000000, 0x80000000, 32, 0xFF0000, 0xFF00, 0xFF, 0, pixels32, sizeof(pixels32)))
+	{
+		IImage* image = driver->createImageFromFile("results/textureCompression_short.dds");
+		IImage* huge = driver->createImageFromFile("results/textureCompression_huge.dds");
+		if (image || huge)
+		{
+			logTestString("A truncated or oversized dds file was loaded.\n");
+			result = false;
+		}
+		if (image)
+			image->drop();
+		if (huge)
+			huge->drop();
+	}
+	else
+		result = false;
+
+	return result;
+}
+
+
+//! DXT1 and DXT5 images survive compressing, writing and loading as textures,
+//! uncompressed dds files are decoded by their bit masks
+bool textureCompression(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	driver->setTextureCreationFlag(ETCF_ALLOW_NON_POWER_2, true);
+
+	bool result = compressImage(driver, ECF_DXT1, "results/textureCompression_dxt1.dds");
+	result &= compressImage(driver, ECF_DXT5, "results/textureCompression_dxt5.dds");
+	result &= loadUncompressedDDS(driver, device->getFileSystem());
+
+	// transparent pixels of DXT1 images stay transparent
+	IImage* image = driver->createImage(ECF_A8R8G8B8, dimension2du(8, 8));
+	image->fill(SColor(255, 200, 100, 50));
+	image->setPixel(1, 2, SColor(0, 0, 0, 0));
+	IImage* compressed = driver->createImage(ECF_DXT1, dimension2du(8, 8));
+	image->copyTo(compressed);
+	if (compressed->getPixel(1, 2).getAlpha() != 0 || compressed->getPixel(2, 2).getAlpha() != 255)
+	{
+		logTestString("DXT1 lost the transparent pixel.\n");
+		result = false;
+	}
+
+	// the writers of uncompressed files refuse compressed images
+	const char* const uncompressed[] = { "bmp", "jpg", "png", "tga" };
+	for (u32 i=0; i<sizeof(uncompressed) / sizeof(*uncompressed); ++i)
+	{
+		const stringc filename = stringc("results/textureCompression_dxt1.") + uncompressed[i];
+		if (driver->writeImageToFile(compressed, filename))
+		{
+			logTestString("%s was written from a compressed image.\n", filename.c_str());
+			result = false;
+		}
+	}
+	compressed->drop();
+	image->drop();
+
+	device->drop();
+
+	return result;
+}
+
@@ -0,0 +1,157 @@
+// Copyright (C) 2008-2009 Colin MacDonald
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+//! Returns the first pixel of a mip map level of the texture
+static SColor getMipMapPixel(ITexture* texture, u32 level)
+{
+	const void* data = texture->lock(true, level);
+	const SColor color = (texture->getColorFormat() == ECF_A8R8G8B8) ?
+			SColor(*(const u32*)data) : SColor(A1R5G5B5toA8R8G8B8(*(const u16*)data));
+	texture->unlock();
+	texture->lock(true, 0);
+	texture->unlock();
+	return color;
+}
+
+
+//! Tests all channels of two colors with a tolerance
+static bool isColor(const SColor& color, const SColor& expected, u32 tolerance)
+{
+	return (u32)abs_((s32)color.getRed() - (s32)expected.getRed()) <= tolerance &&
+		(u32)abs_((s32)color.getGreen() - (s32)expected.getGreen()) <= tolerance &&
+		(u32)abs_((s32)color.getBlue() - (s32)expected.getBlue()) <= tolerance &&
+		(u32)abs_((s32)color.getAlpha() - (s32)expected.getAlpha()) <= tolerance;
+}
+
+
+//! Tests the levels below the first one of a texture
+static bool checkMipMaps(ITexture* texture, const SColor& expected, u32 tolerance, const char* name)
+{
+	bool result = (texture != 0);
+	for (u32 level=1; result && level<6; ++level)
+	{
+		const SColor color = getMipMapPixel(texture, level);
+		if (!isColor(color, expected, tolerance))
+		{
+			logTestString("Level %u of %s is %08x instead of %08x.\n", level, name, color.color, expected.color);
+			result = false;
+		}
+	}
+	return result;
+}
+
+
+//! Compares the second level of a large texture, which is created on several threads, with the averaged image
+static bool checkLargeMipMap(IVideoDriver* driver)
+{
+	// a pattern which differs in every band of rows
+	const dimension2du size(1024, 1024);
+	IImage* image = driver->createImage(ECF_A8R8G8B8, size);
+	for (u32 y=0; y<size.Height; ++y)
+		for (u32 x=0; x<size.Width; ++x)
+			image->setPixel(x, y, SColor(255, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF));
+
+	ITexture* texture = driver->addTexture("large", image);
+	const u32* level = texture ? (const u32*)texture->lock(true, 1) : 0;
+	u32 errors = 0;
+	for (u32 y=0; level && y<size.Height / 2; ++y)
+	{
+		for (u32 x=0; x<size.Width / 2; ++x)
+		{
+			const SColor a = image->getPixel(2 * x, 2 * y);
+			const SColor b = image->getPixel(2 * x + 1, 2 * y);
+			const SColor c = image->getPixel(2 * x, 2 * y + 1);
+			const SColor d = image->getPixel(2 * x + 1, 2 * y + 1);
+			const SColor expected(255,
+				(a.getRed() + b.getRed() + c.getRed() + d.getRed() + 2) / 4,
+				(a.getGreen() + b.getGreen() + c.getGreen() + d.getGreen() + 2) / 4,
+				(a.getBlue() + b.getBlue() + c.getBlue() + d.getBlue() + 2) / 4);
+			if (level[y * (size.Width / 2) + x] != expected.color && !errors++)
+				logTestString("Pixel %u,%u of the large texture is %08x instead of %08x.\n", x, y,
+					level[y * (size.Width / 2) + x], expected.color);
+		}
+	}
+	if (texture)
+	{
+		texture->unlock();
+		texture->lock(true, 0);
+		texture->unlock();
+	}
+	image->drop();
+	return level && !errors;
+}
+
+
+//! Mip map levels are averaged from the previous level, or taken from the image
+bool textureMipMaps(void)
+{
+	IrrlichtDevice *device = createDevice(video::EDT_BURNINGSVIDEO, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+
+	// a checker board of single pixels becomes gray
+	IImage* checker = driver->createImage(ECF_A8R8G8B8, dimension2du(32, 32));
+	for (u32 y=0; y<32; ++y)
+		for (u32 x=0; x<32; ++x)
+			checker->setPixel(x, y, ((x ^ y) & 1) ? SColor(255, 255, 255, 255) : SColor(255, 0, 0, 0));
+
+	bool result = checkMipMaps(driver->addTexture("checker", checker), SColor(255, 128, 128, 128), 1, "checker");
+
+	// which is brighter when averaged in linear space
+	driver->setTextureCreationFlag(ETCF_GAMMA_CORRECT_MIP_MAPS, true);
+	result &= checkMipMaps(driver->addTexture("gamma", checker), SColor(255, 187, 187, 187), 1, "gamma");
+	driver->setTextureCreationFlag(ETCF_GAMMA_CORRECT_MIP_MAPS, false);
+
+	result &= checkLargeMipMap(driver);
+
+	// prepared levels of the image are used instead of creating them
+	IImage* image = driver->createImage(ECF_A8R8G8B8, dimension2du(32, 32));
+	image->fill(SColor(255, 255, 0, 0));
+	const u32 mipMapsSize = IImage::getMipMapsDataSizeFromFormat(ECF_A8R8G8B8, 32, 32);
+	u32* mipMaps = new u32[mipMapsSize / 4];
+	for (u32 i=0; i<mipMapsSize / 4; ++i)
+		mipMaps[i] = SColor(255, 0, 255, 0).color;
+	image->setMipMapsData(mipMaps);
+	delete [] mipMaps;
+	result &= checkMipMaps(driver->addTexture("prepared", image), SColor(255, 0, 255, 0), 0, "prepared");
+
+	// and survive writing and loading a dds file
+	const char* filename = "results/textureMipMaps.dds";
+	result &= driver->writeImageToFile(image, filename);
+	IImage* loaded = driver->createImageFromFile(filename);
+	if (!loaded || !loaded->getMipMapsData())
+	{
+		logTestString("The mip maps of %s were not loaded.\n", filename);
+		result = false;
+	}
+	if (loaded)
+		loaded->drop();
+	result &= checkMipMaps(driver->getTexture(filename), SColor(255, 0, 255, 0), 4, filename);
+
+	// levels are created on writing if asked for
+	const char* checkerFilename = "results/textureMipMaps_checker.dds";
+	result &= driver->writeImageToFile(checker, checkerFilename, 1);
+	loaded = driver->createImageFromFile(checkerFilename);
+	if (!loaded || !loaded->getMipMapsData())
+	{
+		logTestString("The mip maps of %s were not created.\n", checkerFilename);
+		result = false;
+	}
+	if (loaded)
+		loaded->drop();
+
+	image->drop();
+	checker->drop();
+	device->drop();
+
+	return result;
+}
+